@@ -117,6 +117,10 @@ Returns:
                         If value is FALSE, will always not take reabse action\n\
                         If not specified, will take rebase action if rebase address greater than zero, \n\
                         will not take rebase action if rebase address is zero.\n");
+  fprintf (stdout, "  --threads ThreadNumber\n\
+                        ThreadNumber is the number of threads rebasing the\n\
+                        FFS files, from 1 to 64. The default is 1. The FV\n\
+                        image does not depend on the number of threads.\n");
   fprintf (stdout, "  -a AddressFile, --addrfile AddressFile\n\
                         AddressFile is one file used to record the child\n\
                         FV base address when current FV base address is set.\n");
@@ -394,6 +398,26 @@ Returns:
       continue;
     }
 
+    if (stricmp (argv[0], "--threads") == 0) {
+      //
+      // Get the number of threads rebasing the FFS files
+      //
+      if (argv[1] == NULL) {
+        Error (NULL, 0, 1003, "Option value is not set", "%s = %s", argv[0], argv[1]);
+        return STATUS_ERROR;
+      }
+      Status = AsciiStringToUint64 (argv[1], FALSE, &TempNumber);
+      if (EFI_ERROR (Status) || (TempNumber == 0) || (TempNumber > MAX_NUMBER_OF_REBASE_THREADS)) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        return STATUS_ERROR;
+      }
+      mFvRebaseThreads = (UINT32) TempNumber;
+      DebugMsg (NULL, 0, 9, "Rebase threads", "%s = %s", argv[0], argv[1]);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
     if (stricmp (argv[0], "--capheadsize") == 0) {
       //
       // Get Capsule Image Header Size
@@ -21,6 +21,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef __GNUC__
 #include <io.h>
 #endif
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 #include <assert.h>
 
 #include <Guid/FfsSectionAlignmentPadding.h>
@@ -123,6 +126,34 @@ BOOLEAN                     mIsLargeFfs = FALSE;
 EFI_PHYSICAL_ADDRESS mFvBaseAddress[0x10];
 UINT32               mFvBaseAddressNumber = 0;
 
+//
+// Number of threads rebasing the FFS files. With more than one thread, the
+// files are first all placed in the FV image, and then rebased in place by a
+// pool of threads. The Windows build always rebases the files one by one.
+//
+UINT32               mFvRebaseThreads = 1;
+
+#ifndef _WIN32
+typedef struct {
+  CHAR8                 *FileName;
+  EFI_FFS_FILE_HEADER   *FfsFile;
+  UINTN                 XipOffset;
+  CHAR8                 *MapBuffer;
+  size_t                MapBufferSize;
+  EFI_STATUS            Status;
+} FFS_REBASE_JOB;
+
+STATIC FFS_REBASE_JOB    mFfsRebaseJobs[MAX_NUMBER_OF_FILES_IN_FV];
+STATIC UINTN             mFfsRebaseJobCount = 0;
+STATIC UINTN             mFfsRebaseNextJob  = 0;
+STATIC volatile BOOLEAN  mFfsRebaseAborted  = FALSE;
+
+//
+// Serializes the relocation of the RISC-V images, see RelocateFfsImage
+//
+STATIC pthread_mutex_t   mRiscVRelocationLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 EFI_STATUS
 ParseFvInf (
   IN  MEMORY_FILE  *InfFile,
@@ -1296,18 +1327,18 @@ Returns:
         return EFI_ABORTED;
       }
       //
-      // Rebase the PE or TE image in FileBuffer of FFS file for XIP
+      // copy VTF File
+      //
+      memcpy (*VtfFileImage, FileBuffer, FileSize);
+      //
+      // Rebase the PE or TE image of the VTF file for XIP
       // Rebase for the debug genfvmap tool
       //
-      Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage, FvMapFile);
+      Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], *VtfFileImage, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage, FvMapFile);
       if (EFI_ERROR (Status)) {
         Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
         return Status;
       }
-      //
-      // copy VTF File
-      //
-      memcpy (*VtfFileImage, FileBuffer, FileSize);
 
       PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
       fprintf (FvReportFile, "0x%08X %s\n", (unsigned)(UINTN) (((UINT8 *)*VtfFileImage) - (UINTN)FvImage->FileImage), FileGuidString);
@@ -1341,19 +1372,20 @@ Returns:
   // Add file
   //
   if ((UINTN) (FvImage->CurrentFilePointer + FileSize) <= (UINTN) (*VtfFileImage)) {
-    //
-    // Rebase the PE or TE image in FileBuffer of FFS file for XIP.
-    // Rebase Bs and Rt drivers for the debug genfvmap tool.
-    //
-    Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage, FvMapFile);
-  if (EFI_ERROR (Status)) {
-    Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
-    return Status;
-  }
     //
     // Copy the file
     //
     memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
+    //
+    // Rebase the PE or TE image of the FFS file in the FV image for XIP.
+    // Rebase Bs and Rt drivers for the debug genfvmap tool.
+    //
+    Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FvImage->CurrentFilePointer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage, FvMapFile);
+    if (EFI_ERROR (Status)) {
+      Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
+      free (FileBuffer);
+      return Status;
+    }
     PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
     fprintf (FvReportFile, "0x%08X %s\n", (unsigned) (FvImage->CurrentFilePointer - FvImage->FileImage), FileGuidString);
     FvImage->CurrentFilePointer += FileSize;
@@ -2905,6 +2937,15 @@ Returns:
     }
   }
 
+  //
+  // Rebase the files queued by FfsRebase, before the reset vector is
+  // computed from the entry points of the SEC and PEI cores.
+  //
+  Status = RunFfsRebaseJobs (&mFvDataInfo, FvMapFile);
+  if (EFI_ERROR (Status)) {
+    goto Finish;
+  }
+
   //
   // If there is a VTF file, some special actions need to occur.
   //
@@ -3367,6 +3408,44 @@ Returns:
   return EFI_SUCCESS;
 }
 
+STATIC
+EFI_STATUS
+RelocateFfsImage (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+  )
+/*++
+
+Routine Description:
+
+  This function relocates a loaded PE or TE image. The relocation of RISC-V
+  images is serialized, as it keeps state in a global of the PE/COFF loader
+  and the FFS files may be rebased by several threads.
+
+Arguments:
+
+  ImageContext      The context of the loaded image.
+
+Returns:
+
+  The status returned by PeCoffLoaderRelocateImage.
+
+--*/
+{
+  EFI_STATUS  Status;
+
+#ifndef _WIN32
+  if (ImageContext->Machine == IMAGE_FILE_MACHINE_RISCV64) {
+    pthread_mutex_lock (&mRiscVRelocationLock);
+    Status = PeCoffLoaderRelocateImage (ImageContext);
+    pthread_mutex_unlock (&mRiscVRelocationLock);
+    return Status;
+  }
+#endif
+
+  Status = PeCoffLoaderRelocateImage (ImageContext);
+  return Status;
+}
+
 EFI_STATUS
 GetChildFvFromFfs (
   IN      FV_INFO               *FvInfo,
@@ -3447,9 +3526,10 @@ Returns:
   return EFI_SUCCESS;
 }
 
+STATIC
 EFI_STATUS
-FfsRebase (
-  IN OUT  FV_INFO               *FvInfo,
+RebaseFfsImages (
+  IN      FV_INFO               *FvInfo,
   IN      CHAR8                 *FileName,
   IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
   IN      UINTN                 XipOffset,
@@ -3459,8 +3539,8 @@ FfsRebase (
 
 Routine Description:
 
-  This function determines if a file is XIP and should be rebased.  It will
-  rebase any PE32 sections found in the file using the base address.
+  This function rebases any PE32 and TE sections found in a file using the
+  base address, and records them in the FvMap file.
 
 Arguments:
 
@@ -3510,21 +3590,6 @@ Returns:
   PeFile             = NULL;
   PeFileBuffer       = NULL;
 
-  //
-  // Don't need to relocate image when BaseAddress is zero and no ForceRebase Flag specified.
-  //
-  if ((FvInfo->BaseAddress == 0) && (FvInfo->ForceRebase == -1)) {
-    return EFI_SUCCESS;
-  }
-
-  //
-  // If ForceRebase Flag specified to FALSE, will always not take rebase action.
-  //
-  if (FvInfo->ForceRebase == 0) {
-    return EFI_SUCCESS;
-  }
-
-
   XipBase = FvInfo->BaseAddress + XipOffset;
 
   //
@@ -3539,11 +3604,6 @@ Returns:
     case EFI_FV_FILETYPE_DXE_CORE:
       break;
     case EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE:
-      //
-      // Rebase the inside FvImage.
-      //
-      GetChildFvFromFfs (FvInfo, FfsFile, XipOffset);
-
       //
       // Search PE/TE section in FV sectin.
       //
@@ -3748,7 +3808,7 @@ Returns:
     }
 
     ImageContext.DestinationAddress = NewPe32BaseAddress;
-    Status                          = PeCoffLoaderRelocateImage (&ImageContext);
+    Status                          = RelocateFfsImage (&ImageContext);
     if (EFI_ERROR (Status)) {
       Error (NULL, 0, 3000, "Invalid", "RelocateImage() call failed on rebase of %s Status=%d", FileName, Status);
       free ((VOID *) MemoryImagePointer);
@@ -3990,7 +4050,7 @@ Returns:
     // Reloacate TeImage
     //
     ImageContext.DestinationAddress = NewPe32BaseAddress;
-    Status                          = PeCoffLoaderRelocateImage (&ImageContext);
+    Status                          = RelocateFfsImage (&ImageContext);
     if (EFI_ERROR (Status)) {
       Error (NULL, 0, 3000, "Invalid", "RelocateImage() call failed on rebase of TE image %s", FileName);
       free ((VOID *) MemoryImagePointer);
@@ -4068,6 +4128,227 @@ Returns:
   return EFI_SUCCESS;
 }
 
+EFI_STATUS
+FfsRebase (
+  IN OUT  FV_INFO               *FvInfo,
+  IN      CHAR8                 *FileName,
+  IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
+  IN      UINTN                 XipOffset,
+  IN      FILE                  *FvMapFile
+  )
+/*++
+
+Routine Description:
+
+  This function determines if a file is XIP and should be rebased.  It will
+  record the base address of the child FV images, and rebase any PE32 sections
+  found in the file using the base address. When several rebase threads are
+  used, the file is only queued to be rebased by RunFfsRebaseJobs.
+
+Arguments:
+
+  FvInfo            A pointer to FV_INFO structure.
+  FileName          Ffs File PathName
+  FfsFile           A pointer to Ffs file image in the FV image.
+  XipOffset         The offset address to use for rebasing the XIP file image.
+  FvMapFile         FvMapFile to record the function address in one Fvimage
+
+Returns:
+
+  EFI_SUCCESS             The image was properly rebased or queued.
+  EFI_INVALID_PARAMETER   An input parameter is invalid.
+  EFI_ABORTED             An error occurred while rebasing the input file image.
+  EFI_OUT_OF_RESOURCES    Could not allocate a required resource.
+  EFI_NOT_FOUND           No compressed sections could be found.
+
+--*/
+{
+#ifndef _WIN32
+  FFS_REBASE_JOB  *Job;
+#endif
+
+  //
+  // Don't need to relocate image when BaseAddress is zero and no ForceRebase Flag specified.
+  //
+  if ((FvInfo->BaseAddress == 0) && (FvInfo->ForceRebase == -1)) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // If ForceRebase Flag specified to FALSE, will always not take rebase action.
+  //
+  if (FvInfo->ForceRebase == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (FfsFile->Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE) {
+    //
+    // Rebase the inside FvImage. The child FV base addresses are recorded
+    // here so that they keep the order of the files.
+    //
+    GetChildFvFromFfs (FvInfo, FfsFile, XipOffset);
+  }
+
+#ifndef _WIN32
+  if (mFvRebaseThreads > 1 && mFfsRebaseJobCount < MAX_NUMBER_OF_FILES_IN_FV) {
+    Job                 = &mFfsRebaseJobs[mFfsRebaseJobCount++];
+    Job->FileName       = FileName;
+    Job->FfsFile        = FfsFile;
+    Job->XipOffset      = XipOffset;
+    Job->MapBuffer      = NULL;
+    Job->MapBufferSize  = 0;
+    Job->Status         = EFI_SUCCESS;
+    return EFI_SUCCESS;
+  }
+#endif
+
+  return RebaseFfsImages (FvInfo, FileName, FfsFile, XipOffset, FvMapFile);
+}
+
+#ifndef _WIN32
+STATIC
+VOID *
+FfsRebaseWorker (
+  IN VOID  *Context
+  )
+/*++
+
+Routine Description:
+
+  This function is run by each thread of the rebase pool. It takes the queued
+  FFS files in order, and rebases them with their map information written to
+  a memory buffer of the job, until all the files are rebased or one of them
+  fails. mArm, mRiscV and mLoongArch are only ever set to TRUE by the threads,
+  and are read after all of them are joined.
+
+Arguments:
+
+  Context           A pointer to FV_INFO structure.
+
+Returns:
+
+  NULL
+
+--*/
+{
+  FV_INFO         *FvInfo;
+  FFS_REBASE_JOB  *Job;
+  FILE            *MapFile;
+  UINTN           Index;
+
+  FvInfo = (FV_INFO *) Context;
+  while (!mFfsRebaseAborted) {
+    Index = __sync_fetch_and_add (&mFfsRebaseNextJob, 1);
+    if (Index >= mFfsRebaseJobCount) {
+      break;
+    }
+
+    Job     = &mFfsRebaseJobs[Index];
+    MapFile = open_memstream (&Job->MapBuffer, &Job->MapBufferSize);
+    if (MapFile == NULL) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", Job->FileName);
+      Job->Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      Job->Status = RebaseFfsImages (FvInfo, Job->FileName, Job->FfsFile, Job->XipOffset, MapFile);
+      fclose (MapFile);
+    }
+
+    if (EFI_ERROR (Job->Status)) {
+      mFfsRebaseAborted = TRUE;
+    }
+  }
+
+  return NULL;
+}
+#endif
+
+EFI_STATUS
+RunFfsRebaseJobs (
+  IN      FV_INFO               *FvInfo,
+  IN      FILE                  *FvMapFile
+  )
+/*++
+
+Routine Description:
+
+  This function rebases the FFS files queued by FfsRebase with a pool of
+  mFvRebaseThreads threads, the calling thread being one of them. The files
+  are already at their final location in the FV image, so each thread rebases
+  and checksums its files in place. The map information of the files is then
+  added to the FvMap file in the order of the files, so that the FV image and
+  the FvMap file are the same as when the files are rebased one by one.
+
+Arguments:
+
+  FvInfo            A pointer to FV_INFO structure.
+  FvMapFile         FvMapFile to record the function address in one Fvimage
+
+Returns:
+
+  EFI_SUCCESS       All the queued files were rebased.
+  Others            The status of the first file that could not be rebased.
+
+--*/
+{
+  EFI_STATUS      Status;
+#ifndef _WIN32
+  pthread_t       Threads[MAX_NUMBER_OF_REBASE_THREADS];
+  UINTN           ThreadCount;
+  UINTN           Index;
+  FFS_REBASE_JOB  *Job;
+
+  if (mFfsRebaseJobCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DebugMsg (NULL, 0, 9, "Rebase FFS files", "%u files with %u threads", (unsigned) mFfsRebaseJobCount, (unsigned) mFvRebaseThreads);
+
+  mFfsRebaseNextJob = 0;
+  mFfsRebaseAborted = FALSE;
+  for (ThreadCount = 0; ThreadCount + 1 < mFvRebaseThreads && ThreadCount + 1 < mFfsRebaseJobCount; ThreadCount++) {
+    if (pthread_create (&Threads[ThreadCount], NULL, FfsRebaseWorker, FvInfo) != 0) {
+      //
+      // The files left are rebased by the threads already running.
+      //
+      break;
+    }
+  }
+
+  FfsRebaseWorker (FvInfo);
+  for (Index = 0; Index < ThreadCount; Index++) {
+    pthread_join (Threads[Index], NULL);
+  }
+
+  //
+  // The files are taken in order, so all the files before the first failed
+  // one were rebased.
+  //
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < mFfsRebaseJobCount; Index++) {
+    Job = &mFfsRebaseJobs[Index];
+    if (!EFI_ERROR (Status)) {
+      if (EFI_ERROR (Job->Status)) {
+        Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", Job->FileName);
+        Status = Job->Status;
+      } else if (Job->MapBufferSize != 0) {
+        fwrite (Job->MapBuffer, 1, Job->MapBufferSize, FvMapFile);
+      }
+    }
+
+    if (Job->MapBuffer != NULL) {
+      free (Job->MapBuffer);
+      Job->MapBuffer = NULL;
+    }
+  }
+
+  mFfsRebaseJobCount = 0;
+#else
+  Status = EFI_SUCCESS;
+#endif
+
+  return Status;
+}
+
 EFI_STATUS
 ParseCapInf (
   IN  MEMORY_FILE  *InfFile,
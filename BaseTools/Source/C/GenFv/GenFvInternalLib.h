@@ -48,6 +48,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MAX_NUMBER_OF_FILES_IN_FV       1000
 #define MAX_NUMBER_OF_FILES_IN_CAP      1000
 #define EFI_FFS_FILE_HEADER_ALIGNMENT   8
+
+//
+// The maximum number of threads rebasing the FFS files of the FV
+//
+#define MAX_NUMBER_OF_REBASE_THREADS    64
 //
 // INF file strings
 //
@@ -245,6 +250,7 @@ extern UINT32     mFvTakenSize;
 
 extern EFI_PHYSICAL_ADDRESS mFvBaseAddress[];
 extern UINT32               mFvBaseAddressNumber;
+extern UINT32               mFvRebaseThreads;
 //
 // Local function prototypes
 //
@@ -336,6 +342,12 @@ FfsRebase (
   IN      FILE                  *FvMapFile
   );
 
+EFI_STATUS
+RunFfsRebaseJobs (
+  IN      FV_INFO               *FvInfo,
+  IN      FILE                  *FvMapFile
+  );
+
 //
 // Exported function prototypes
 //
@@ -44,6 +44,7 @@ static CONVERTER_TYPE mConType = NoConverter;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mThreadCount = 2;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -65,6 +66,8 @@ void PrintHelp(char *buffer)
              "  --debug [0-9]: set debug level\n"
              "  -a: set compression mode 0 = fast, 1 = normal, default: 1 (normal)\n"
              "  d: sets Dictionary size - [0, 27], default: 24 (16MB)\n"
+             "  --threads [1, 2]: set the number of threads, 2 finds the matches\n"
+             "                    in separate threads, default: 2\n"
              "  --version: display the program version and exit\n"
              "  -h, --help: display this help text\n"
              );
@@ -309,6 +312,18 @@ int main2(int numArgs, const char *args[], char *rs)
       } else {
         return PrintError(rs, kInvalidParamValMessage);
       }
+    } else if (strcmp(args[param], "--threads") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[param + 1],FALSE,&mThreadCount);
+      if ((mThreadCount == 1)||(mThreadCount == 2)){
+        props.numThreads = (int)mThreadCount;
+        param++;
+        continue;
+      } else {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
     } else if (
                 strcmp(args[param], "-h") == 0 ||
                 strcmp(args[param], "--help") == 0
@@ -280,9 +280,11 @@ class AutoGenWorkerInProcess(mp.Process):
                     else:
                         self.cache_q.put((Ma.MetaFile.Path, Ma.Arch, "PreMakeCache", False))
 
+                Skipped = Ma.CanSkip()
                 Ma.CreateCodeFile(False)
                 Ma.CreateMakeFile(False,GenFfsList=FfsCmd.get((Ma.MetaFile.Path, Ma.Arch),[]))
                 Ma.CreateAsBuiltInf()
+                self.cache_q.put((Ma.MetaFile.Path, Ma.Arch, "AutoGen", Skipped))
                 if GlobalData.gBinCacheSource and CommandTarget in [None, "", "all"]:
                     try:
                         CacheResult = Ma.CanSkipbyMakeCache()
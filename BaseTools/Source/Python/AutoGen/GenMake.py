@@ -1614,6 +1614,10 @@ class TopLevelMakefile(BuildFile):
             ExtraOption += " --no-genfds-multi-thread"
         if GlobalData.gIgnoreSource:
             ExtraOption += " --ignore-sources"
+        if GlobalData.gSectionCacheDir:
+            ExtraOption += " --section-cache %s" % GlobalData.gSectionCacheDir
+            if GlobalData.gBinCacheSource:
+                ExtraOption += " --section-cache-read-only"
 
         for pcd in GlobalData.BuildOptionPcd:
             if pcd[2]:
@@ -1812,6 +1812,15 @@ class ModuleAutoGen(AutoGen):
             for LibraryAutoGen in self.LibraryAutoGenList:
                 LibraryAutoGen.CreateCodeFile()
 
+        # CanSkip uses timestamps to determine the AutoGen files are up to date
+        if self.CanSkip():
+            DpxFile = gAutoGenDepexFileName % {"module_name" : self.Name}
+            self.DepexGenerated = os.path.exists(path.join(self.OutputDir, DpxFile))
+            self.IsCodeFileCreated = True
+            EdkLogger.debug(EdkLogger.DEBUG_9, "Skipped the generation of AutoGen files for module %s [%s]" %
+                            (self.Name, self.Arch))
+            return []
+
         self.LibraryAutoGenList
         AutoGenList = []
         IgoredAutoGenList = []
@@ -566,7 +566,7 @@ class WorkspaceAutoGen(AutoGen):
         for f in AllWorkSpaceMetaFiles:
             if os.stat(f)[8] > SrcTimeStamp:
                 SrcTimeStamp = os.stat(f)[8]
-        self._SrcTimeStamp = SrcTimeStamp
+        self._SrcTimeStamp = self._GetMetaFilesTimeStamp(AllWorkSpaceMetaFileList, SrcTimeStamp)
 
         if GlobalData.gUseHashCache:
             FileList = []
@@ -658,6 +658,34 @@ class WorkspaceAutoGen(AutoGen):
             CopyFileOnChange(HashFile, CacheFileDir)
             CopyFileOnChange(HashChainFile, CacheFileDir)
 
+    ## Return the time stamp the modules must be generated after
+    #
+    #   The metafiles whose content is the same as in the last build, such as
+    #   the ones only touched or checked out again, do not make the AutoGen
+    #   files and makefiles of all the modules out of date. The time stamp is
+    #   the one of the last build in which the content of the metafiles changed.
+    #
+    #   @param  MetaFileList    The sorted list of the metafiles of the platform
+    #   @param  SrcTimeStamp    The latest modification time of the metafiles
+    #
+    def _GetMetaFilesTimeStamp(self, MetaFileList, SrcTimeStamp):
+        m = hashlib.sha256()
+        for File in MetaFileList:
+            m.update(str(File).encode('utf-8') + b'\0')
+            with open(File, 'rb') as f:
+                m.update(hashlib.sha256(f.read()).digest())
+        Digest = m.hexdigest()
+        DigestFile = path.join(self.BuildDir, 'MetaFiles.digest')
+        try:
+            with open(DigestFile, 'r') as f:
+                LastDigest, LastTimeStamp = f.read().split()
+            if LastDigest == Digest and int(LastTimeStamp) <= SrcTimeStamp:
+                return int(LastTimeStamp)
+        except (IOError, OSError, ValueError):
+            pass
+        SaveFileOnChange(DigestFile, '%s %d' % (Digest, SrcTimeStamp), False)
+        return SrcTimeStamp
+
     def _GetMetaFiles(self, Target, Toolchain):
         AllWorkSpaceMetaFiles = set()
         #
@@ -901,6 +929,9 @@ class WorkspaceAutoGen(AutoGen):
         FdsCommandDict["GenfdsMultiThread"] = GlobalData.gEnableGenfdsMultiThread
         if GlobalData.gIgnoreSource:
             FdsCommandDict["IgnoreSources"] = True
+        if GlobalData.gSectionCacheDir:
+            FdsCommandDict["SectionCache"] = GlobalData.gSectionCacheDir
+            FdsCommandDict["SectionCacheReadOnly"] = bool(GlobalData.gBinCacheSource)
 
         FdsCommandDict["OptionPcd"] = []
         for pcd in GlobalData.BuildOptionPcd:
@@ -105,6 +105,7 @@ gConditionalPcds = []
 gUseHashCache = None
 gBinCacheDest = None
 gBinCacheSource = None
+gSectionCacheDir = None
 gPlatformHash = None
 gPlatformHashFile = None
 gPackageHash = None
@@ -34,6 +34,7 @@ from Workspace.WorkspaceDatabase import WorkspaceDatabase
 
 from .FdfParser import FdfParser, Warning
 from .GenFdsGlobalVariable import GenFdsGlobalVariable
+from .SectionCache import SectionCache
 from .FfsFileStatement import FileStatement
 import Common.DataType as DataType
 from struct import Struct
@@ -94,6 +95,8 @@ def resetFdsGlobalVariable():
     GenFdsGlobalVariable.CopyList   = []
     GenFdsGlobalVariable.ModuleFile = ''
     GenFdsGlobalVariable.EnableGenfdsMultiThread = True
+    GenFdsGlobalVariable.EnableInProcessTools = True
+    SectionCache.Enable(None)
 
     GenFdsGlobalVariable.LargeFileInFvFlags = []
     GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
@@ -142,6 +145,10 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = True
             else:
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = False
+            if FdsCommandDict.get("NoInProcessTools"):
+                GenFdsGlobalVariable.EnableInProcessTools = False
+            if FdsCommandDict.get("SectionCache"):
+                SectionCache.Enable(os.path.abspath(FdsCommandDict.get("SectionCache")), FdsCommandDict.get("SectionCacheReadOnly"))
         os.chdir(GenFdsGlobalVariable.WorkSpaceDir)
 
         # set multiple workspace
@@ -376,6 +383,9 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
         """Display FV space info."""
         GenFds.DisplayFvSpaceInfo(FdfParserObj)
 
+        if SectionCache.CacheDir:
+            GenFdsGlobalVariable.VerboseLogger("Section cache %s: %d hits, %d misses" % (SectionCache.CacheDir, SectionCache.Hits, SectionCache.Misses))
+
     except Warning as X:
         EdkLogger.error(X.ToolName, FORMAT_INVALID, File=X.FileName, Line=X.LineNumber, ExtraData=X.Message, RaiseError=False)
         ReturnCode = FORMAT_INVALID
@@ -407,6 +417,9 @@ def OptionsToCommandDict(Options):
     FdsCommandDict["debug"] = Options.debug
     FdsCommandDict["Workspace"] = Options.Workspace
     FdsCommandDict["GenfdsMultiThread"] = not Options.NoGenfdsMultiThread
+    FdsCommandDict["NoInProcessTools"] = Options.NoInProcessTools
+    FdsCommandDict["SectionCache"] = Options.SectionCache
+    FdsCommandDict["SectionCacheReadOnly"] = Options.SectionCacheReadOnly
     FdsCommandDict["fdf_file"] = [PathClass(Options.filename)] if Options.filename else []
     FdsCommandDict["build_target"] = Options.BuildTarget
     FdsCommandDict["toolchain_tag"] = Options.ToolChain
@@ -465,6 +478,9 @@ def myOptionParser():
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
     Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
     Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+    Parser.add_option("--no-inprocess-tools", action="store_true", dest="NoInProcessTools", default=False, help="Call GenSec and GenFfs to generate all sections and ffs files instead of generating the simple ones in process.")
+    Parser.add_option("--section-cache", action="store", type="string", dest="SectionCache", help="Reuse the compressed and GUIDed sections stored in the specified directory, and store the new ones in it.")
+    Parser.add_option("--section-cache-read-only", action="store_true", dest="SectionCacheReadOnly", default=False, help="Only reuse the sections stored in the section cache directory, do not store the new ones.")
 
     Options, _ = Parser.parse_args()
     return Options
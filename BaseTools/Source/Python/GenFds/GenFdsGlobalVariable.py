@@ -33,6 +33,8 @@ from Common.MultipleWorkspace import MultipleWorkspace as mws
 import Common.GlobalData as GlobalData
 from Common.BuildToolError import *
 from AutoGen.AutoGen import CalculatePriorityValue
+from . import InProcessTools
+from .SectionCache import SectionCache
 
 ## Global variables
 #
@@ -73,6 +75,11 @@ class GenFdsGlobalVariable:
     CopyList   = []
     ModuleFile = ''
     EnableGenfdsMultiThread = True
+    #
+    # Generate the leaf sections and the FFS files in the GenFds process
+    # instead of calling GenSec and GenFfs.
+    #
+    EnableInProcessTools = True
 
     #
     # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
@@ -503,6 +510,7 @@ class GenFdsGlobalVariable:
                     return
                 GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
         else:
+            CacheOptions = Cmd[1:]
             Cmd += ("-o", Output)
             Cmd += Input
 
@@ -516,7 +524,22 @@ class GenFdsGlobalVariable:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                SectionData = None
+                if (GenFdsGlobalVariable.EnableInProcessTools and not CompressionType and not Guid and
+                    not DummyFile and not GuidHdrLen and not GuidAttr and not InputAlign):
+                    SectionData = InProcessTools.GenerateLeafSection(Type, Input)
+                if SectionData is not None:
+                    GenFdsGlobalVariable.WriteOutputFile(Output, SectionData)
+                elif CompressionType == 'PI_STD':
+                    #
+                    # Compressed sections only depend on the options and the inputs of GenSec
+                    #
+                    Key = SectionCache.GetKey(Cmd[0], CacheOptions, Input)
+                    if not SectionCache.Get(Key, Output):
+                        GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                        SectionCache.Put(Key, Output)
+                else:
+                    GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
                     GenFdsGlobalVariable.LargeFileInFvFlags):
                     GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
@@ -572,7 +595,31 @@ class GenFdsGlobalVariable:
         else:
             if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 return
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            FfsData = None
+            if GenFdsGlobalVariable.EnableInProcessTools:
+                FfsData = InProcessTools.GenerateFfs(Input, Type, Guid, Fixed, CheckSum, Align, SectionAlign)
+            if FfsData is not None:
+                GenFdsGlobalVariable.WriteOutputFile(Output, FfsData)
+            else:
+                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+
+    ## WriteOutputFile()
+    #
+    #   Write a section or an FFS file generated in process
+    #
+    #   @param  Output      The output file
+    #   @param  Data        The content of the output file
+    #
+    @staticmethod
+    def WriteOutputFile(Output, Data):
+        DirName = os.path.dirname(Output)
+        if not CreateDirectory(DirName):
+            EdkLogger.error(None, FILE_CREATE_FAILURE, "Could not create directory %s" % DirName)
+        try:
+            with open(Output, "wb") as Fd:
+                Fd.write(Data)
+        except IOError as X:
+            EdkLogger.error(None, FILE_CREATE_FAILURE, ExtraData='IOError %s' % X)
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
@@ -687,7 +734,7 @@ class GenFdsGlobalVariable:
             GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate option rom")
 
     @staticmethod
-    def GuidTool(Output, Input, ToolPath, Options='', returnValue=[], IsMakefile=False):
+    def GuidTool(Output, Input, ToolPath, Options='', returnValue=[], IsMakefile=False, Guid=None):
         if not GenFdsGlobalVariable.NeedsUpdate(Output, Input) and not IsMakefile:
             return
         GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
@@ -700,7 +747,16 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
+            Key = None
+            if SectionCache.IsCacheableGuid(Guid):
+                Key = SectionCache.GetKey(ToolPath, Options.split(' '), Input)
+            if SectionCache.Get(Key, Output):
+                if returnValue != []:
+                    returnValue[0] = 0
+                return
             GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue)
+            if returnValue == [] or returnValue[0] == 0:
+                SectionCache.Put(Key, Output)
 
     @staticmethod
     def CallExternalTool (cmd, errorMess, returnValue=[]):
@@ -180,7 +180,7 @@ class GuidSection(GuidSectionClassObject) :
                 ReturnValue = [1]
                 if FirstCall:
                     #first try to call the guided tool with -z option and CmdOption for the no process required guided tool.
-                    GenFdsGlobalVariable.GuidTool(TempFile, [DummyFile], ExternalTool, '-z' + ' ' + CmdOption, ReturnValue)
+                    GenFdsGlobalVariable.GuidTool(TempFile, [DummyFile], ExternalTool, '-z' + ' ' + CmdOption, ReturnValue, Guid=self.NameGuid)
 
                 #
                 # when no call or first call failed, ReturnValue are not 1.
@@ -189,7 +189,7 @@ class GuidSection(GuidSectionClassObject) :
                 if ReturnValue[0] != 0:
                     FirstCall = False
                     ReturnValue[0] = 0
-                    GenFdsGlobalVariable.GuidTool(TempFile, [DummyFile], ExternalTool, CmdOption)
+                    GenFdsGlobalVariable.GuidTool(TempFile, [DummyFile], ExternalTool, CmdOption, Guid=self.NameGuid)
                 #
                 # There is external tool which does not follow standard rule which return nonzero if tool fails
                 # The output file has to be checked
@@ -228,7 +228,7 @@ class GuidSection(GuidSectionClassObject) :
 
                 if FirstCall and 'PROCESSING_REQUIRED' in Attribute:
                     # Guided data by -z option on first call is the process required data. Call the guided tool with the real option.
-                    GenFdsGlobalVariable.GuidTool(TempFile, [DummyFile], ExternalTool, CmdOption)
+                    GenFdsGlobalVariable.GuidTool(TempFile, [DummyFile], ExternalTool, CmdOption, Guid=self.NameGuid)
 
                 #
                 # Call Gensection Add Section Header
@@ -0,0 +1,302 @@
+## @file
+# Generate leaf sections and FFS files in the GenFds process
+#
+# The sections and FFS files are the same as the ones generated by the GenSec
+# and GenFfs tools, without starting a process for each of them. Inputs which
+# are not supported return None, so that the caller falls back to the tools,
+# which also report the errors.
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import absolute_import
+from struct import pack, unpack_from
+import uuid
+
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+#
+# Sections GenSec generates as a section header followed by the input file
+#
+LeafSectionTypes = {
+    'EFI_SECTION_PE32'                  : 0x10,
+    'EFI_SECTION_PIC'                   : 0x11,
+    'EFI_SECTION_TE'                    : 0x12,
+    'EFI_SECTION_DXE_DEPEX'             : 0x13,
+    'EFI_SECTION_COMPATIBILITY16'       : 0x16,
+    'EFI_SECTION_FIRMWARE_VOLUME_IMAGE' : 0x17,
+    'EFI_SECTION_RAW'                   : 0x19,
+    'EFI_SECTION_PEI_DEPEX'             : 0x1B,
+    'EFI_SECTION_SMM_DEPEX'             : 0x1C,
+}
+
+FfsFileTypes = {
+    'EFI_FV_FILETYPE_RAW'                   : 0x01,
+    'EFI_FV_FILETYPE_FREEFORM'              : 0x02,
+    'EFI_FV_FILETYPE_SECURITY_CORE'         : 0x03,
+    'EFI_FV_FILETYPE_PEI_CORE'              : 0x04,
+    'EFI_FV_FILETYPE_DXE_CORE'              : 0x05,
+    'EFI_FV_FILETYPE_PEIM'                  : 0x06,
+    'EFI_FV_FILETYPE_DRIVER'                : 0x07,
+    'EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER'  : 0x08,
+    'EFI_FV_FILETYPE_APPLICATION'           : 0x09,
+    'EFI_FV_FILETYPE_SMM'                   : 0x0A,
+    'EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE' : 0x0B,
+    'EFI_FV_FILETYPE_COMBINED_SMM_DXE'      : 0x0C,
+    'EFI_FV_FILETYPE_SMM_CORE'              : 0x0D,
+    'EFI_FV_FILETYPE_MM_STANDALONE'         : 0x0E,
+    'EFI_FV_FILETYPE_MM_CORE_STANDALONE'    : 0x0F,
+}
+
+#
+# File types which must have one and only one PE or TE section, and file
+# types which must have at least one
+#
+SinglePeFileTypes = (0x03, 0x04, 0x05)
+PeFileTypes = (0x06, 0x07, 0x08, 0x09)
+
+EFI_SECTION_GUID_DEFINED = 0x02
+EFI_SECTION_COMPRESSION = 0x01
+EFI_SECTION_PE32 = 0x10
+EFI_SECTION_TE = 0x12
+EFI_SECTION_FIRMWARE_VOLUME_IMAGE = 0x17
+EFI_SECTION_FREEFORM_SUBTYPE_GUID = 0x18
+EFI_SECTION_RAW = 0x19
+EFI_GUIDED_SECTION_PROCESSING_REQUIRED = 0x01
+EFI_TE_IMAGE_HEADER_SIGNATURE = 0x5A56
+EFI_TE_IMAGE_HEADER_SIZE = 40
+
+FFS_ATTRIB_LARGE_FILE = 0x01
+FFS_ATTRIB_DATA_ALIGNMENT2 = 0x02
+FFS_ATTRIB_FIXED = 0x04
+FFS_ATTRIB_CHECKSUM = 0x40
+FFS_FIXED_CHECKSUM = 0xAA
+EFI_FILE_STATE_VALID = 0x07
+
+MAX_SECTION_SIZE = 0x1000000
+MAX_FFS_SIZE = 0x1000000
+
+#
+# Machine and subsystem types of the images GenFfs gets the alignment of
+#
+ImageMachineTypes = (0x014C, 0x8664, 0x01C2, 0x0EBC, 0xAA64, 0x5064, 0x6264)
+ImageSubsystemTypes = (10, 11, 12, 13)
+
+EFI_FFS_SECTION_ALIGNMENT_PADDING_GUID = uuid.UUID('04132C8D-0A22-4FA8-826E-8BBFEFDB836C').bytes_le
+
+#
+# Section alignments GenFfs accepts, and FFS file alignments in the order of
+# the FFS_ATTRIB_DATA_ALIGNMENT values
+#
+SectionAlignNames = ["1", "2", "4", "8", "16", "32", "64", "128", "256", "512",
+                     "1K", "2K", "4K", "8K", "16K", "32K", "64K", "128K", "256K",
+                     "512K", "1M", "2M", "4M", "8M", "16M"]
+FfsAlignNames = ["8", "16", "128", "512", "1K", "4K", "32K", "64K", "128K", "256K",
+                 "512K", "1M", "2M", "4M", "8M", "16M"]
+FfsAligns = [0, 8, 16, 128, 512, 1024, 4096, 32768, 65536, 131072, 262144,
+             524288, 1048576, 2097152, 4194304, 8388608, 16777216]
+
+## Read a file
+#
+#   @param  FileName    The file to read
+#   @retval bytes       The content of the file
+#
+def ReadFile(FileName):
+    with open(FileName, 'rb') as File:
+        return File.read()
+
+## Build the header of a section
+#
+#   @param  Type        The section type
+#   @param  DataSize    The size of the section data following the header
+#   @retval bytes       The EFI_COMMON_SECTION_HEADER, or EFI_COMMON_SECTION_HEADER2
+#                       if the section does not fit in 16MB
+#
+def SectionHeader(Type, DataSize):
+    if DataSize + 4 >= MAX_SECTION_SIZE:
+        return pack('<3sBI', b'\xff\xff\xff', Type, DataSize + 8)
+    return pack('<I', (DataSize + 4) | (Type << 24))
+
+## Generate a leaf section, as GenSec -s <Type> does
+#
+#   @param  Type        The section type name
+#   @param  Input       The list of input files
+#   @retval bytes       The section
+#   @retval None        The section type or the input files are not supported
+#
+def GenerateLeafSection(Type, Input):
+    if Type not in LeafSectionTypes or len(Input) != 1:
+        return None
+    Data = ReadFile(Input[0])
+    return SectionHeader(LeafSectionTypes[Type], len(Data)) + Data
+
+## Get the alignment of a section from the PE or TE image it contains
+#
+#   @param  Section     The section
+#   @retval string      The alignment as a section alignment name
+#   @retval None        The section does not contain a valid image
+#
+def GetImageAlignment(Section):
+    Offset = 8 if Section[0:3] == b'\xff\xff\xff' else 4
+    if Section[Offset:Offset + 2] == b'VZ':
+        if len(Section) < Offset + EFI_TE_IMAGE_HEADER_SIZE:
+            return None
+        Machine, Subsystem = unpack_from('<HxB', Section, Offset + 2)
+        Alignment = 0x1000
+    else:
+        if Section[Offset:Offset + 2] == b'MZ':
+            if len(Section) < Offset + 0x40:
+                return None
+            Offset += unpack_from('<I', Section, Offset + 0x3C)[0]
+        if len(Section) < Offset + 24 + 70 or Section[Offset:Offset + 4] != b'PE\0\0':
+            return None
+        Machine = unpack_from('<H', Section, Offset + 4)[0]
+        Alignment = unpack_from('<I', Section, Offset + 24 + 32)[0]
+        Subsystem = unpack_from('<H', Section, Offset + 24 + 68)[0]
+    if Machine not in ImageMachineTypes or Subsystem not in ImageSubsystemTypes:
+        return None
+
+    if Alignment < 0x400:
+        Name = '%d' % Alignment
+    elif Alignment >= 0x100000:
+        Name = '%dM' % (Alignment // 0x100000)
+    else:
+        Name = '%dK' % (Alignment // 0x400)
+    if Name not in SectionAlignNames:
+        return None
+    return Name
+
+## Calculate the 8-bit checksum of a buffer
+#
+#   @param  Buffer      The buffer
+#   @retval int         The value which makes the sum of the buffer zero
+#
+def CalculateChecksum8(Buffer):
+    return (0x100 - (sum(Buffer) & 0xFF)) & 0xFF
+
+## Generate an FFS file, as GenFfs does
+#
+#   @param  Input       The list of input section files
+#   @param  Type        The FFS file type name
+#   @param  Guid        The FFS file name GUID
+#   @param  Fixed       Set the FFS_ATTRIB_FIXED attribute
+#   @param  CheckSum    Set the FFS_ATTRIB_CHECKSUM attribute
+#   @param  Align       The FFS file alignment name, or None
+#   @param  SectionAlign  The list of section alignment names, or None
+#   @retval bytes       The FFS file
+#   @retval None        The parameters or the input files are not supported
+#
+def GenerateFfs(Input, Type, Guid, Fixed=False, CheckSum=False, Align=None, SectionAlign=None):
+    if Type not in FfsFileTypes or not Input:
+        return None
+    try:
+        Name = uuid.UUID(Guid).bytes_le
+    except ValueError:
+        return None
+    if Name == bytes(16):
+        return None
+
+    Attributes = 0
+    if Fixed:
+        Attributes |= FFS_ATTRIB_FIXED
+    if CheckSum:
+        Attributes |= FFS_ATTRIB_CHECKSUM
+
+    FfsAlign = 0
+    if Align:
+        if Align in FfsAlignNames:
+            FfsAlign = FfsAlignNames.index(Align)
+        elif Align not in ('1', '2', '4'):
+            return None
+
+    Data = bytearray()
+    PeSectionNum = 0
+    MaxAlignment = 1
+    for Index, FileName in enumerate(Input):
+        Data += bytes(-len(Data) & 0x03)
+        Section = ReadFile(FileName)
+
+        SectionAlignment = 1
+        if SectionAlign and SectionAlign[Index]:
+            AlignName = SectionAlign[Index]
+            if AlignName == '0':
+                AlignName = GetImageAlignment(Section)
+            if AlignName not in SectionAlignNames:
+                return None
+            SectionAlignment = 1 << SectionAlignNames.index(AlignName)
+
+        #
+        # Same header size and Pe/Te section count as GenFfs
+        #
+        HeaderSize = 8 if len(Section) >= MAX_FFS_SIZE else 4
+        TeOffset = 0
+        SectionType = Section[3] if len(Section) >= 4 else None
+        if SectionType == EFI_SECTION_TE:
+            PeSectionNum += 1
+            if Section[HeaderSize:HeaderSize + 2] == b'VZ':
+                TeOffset = unpack_from('<H', Section, HeaderSize + 6)[0] - EFI_TE_IMAGE_HEADER_SIZE
+        elif SectionType == EFI_SECTION_PE32:
+            PeSectionNum += 1
+        elif SectionType == EFI_SECTION_GUID_DEFINED:
+            GuidHeaderSize = 8 if len(Section) >= MAX_SECTION_SIZE else 4
+            if len(Section) >= GuidHeaderSize + 20:
+                DataOffset, GuidAttributes = unpack_from('<HH', Section, GuidHeaderSize + 16)
+                if (GuidAttributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0:
+                    HeaderSize = DataOffset
+            PeSectionNum += 1
+        elif SectionType in (EFI_SECTION_COMPRESSION, EFI_SECTION_FIRMWARE_VOLUME_IMAGE):
+            PeSectionNum += 1
+
+        if TeOffset != 0:
+            TeOffset = (SectionAlignment - (TeOffset % SectionAlignment)) % SectionAlignment
+
+        #
+        # Add a pad section so that the section data meets its alignment
+        #
+        Size = len(Data)
+        if (Size + HeaderSize + TeOffset) % SectionAlignment != 0:
+            Offset = (Size + 4 + HeaderSize + TeOffset + SectionAlignment - 1) & ~(SectionAlignment - 1)
+            Offset -= Size + HeaderSize + TeOffset
+            Pad = bytearray(Offset)
+            if Fixed and MaxAlignment <= 1 and Offset >= 20:
+                Pad[0:20] = SectionHeader(EFI_SECTION_FREEFORM_SUBTYPE_GUID, Offset - 4) + EFI_FFS_SECTION_ALIGNMENT_PADDING_GUID
+            else:
+                Pad[0:4] = SectionHeader(EFI_SECTION_RAW, Offset - 4)
+            Data += Pad
+
+        MaxAlignment = max(MaxAlignment, SectionAlignment)
+        Data += Section
+
+    FfsType = FfsFileTypes[Type]
+    if FfsType in SinglePeFileTypes and PeSectionNum != 1:
+        return None
+    if FfsType in PeFileTypes and PeSectionNum < 1:
+        return None
+
+    for Index in range(len(FfsAligns) - 1):
+        if MaxAlignment > FfsAligns[Index] and MaxAlignment <= FfsAligns[Index + 1]:
+            break
+    FfsAlign = max(FfsAlign, Index)
+
+    FileSize = len(Data) + 24
+    if FileSize >= MAX_FFS_SIZE:
+        FileSize += 8
+        Attributes |= FFS_ATTRIB_LARGE_FILE
+    if FfsAlign < 8:
+        Attributes |= FfsAlign << 3
+    else:
+        Attributes |= ((FfsAlign & 0x7) << 3) | FFS_ATTRIB_DATA_ALIGNMENT2
+
+    if Attributes & FFS_ATTRIB_LARGE_FILE:
+        Header = bytearray(Name + pack('<BBBB3sBQ', 0, 0, FfsType, Attributes, bytes(3), 0, FileSize))
+    else:
+        Header = bytearray(Name + pack('<BBBBI', 0, 0, FfsType, Attributes, FileSize)[:7] + b'\0')
+    Header[16] = CalculateChecksum8(Header)
+    Header[17] = CalculateChecksum8(Data) if Attributes & FFS_ATTRIB_CHECKSUM else FFS_FIXED_CHECKSUM
+    Header[23] = EFI_FILE_STATE_VALID
+    return bytes(Header + Data)
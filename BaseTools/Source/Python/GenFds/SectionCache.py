@@ -0,0 +1,204 @@
+## @file
+# Content addressed cache of the sections generated by the compression tools
+#
+# The output of a compression or CRC32 GUIDed section tool such as LzmaCompress
+# or BrotliCompress, and of the compression done by GenSec, only depends on the
+# tool, its options and the content of its input files. The outputs are stored
+# in a directory under the SHA-256 of these, so that an unchanged section
+# payload is never compressed again, in the same build, in the next build, or
+# in the build of another platform which shares the cache directory.
+#
+# Other GUIDed section tools, such as the signing tools, read files named in
+# their options or are scripts running other code, so they are never cached.
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import absolute_import
+import hashlib
+import os
+import shutil
+
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+#
+# Increase when the layout of the cache or the computation of the keys changes
+#
+SECTION_CACHE_VERSION = 2
+
+#
+# Name of the directory of the section cache in the build cache directories
+#
+SECTION_CACHE_DIRECTORY = 'SectionCache'
+
+#
+# GUIDed sections whose tool output only depends on the input file: the LZMA,
+# LZMA F86, Tiano and Brotli compressions, and the CRC32
+#
+SECTION_CACHE_GUIDS = (
+    'EE4E5898-3914-4259-9D6E-DC7BD79403CF',
+    'D42AE6BD-1352-4BFB-909A-CA72A6EAE889',
+    'A31280AD-481E-41B6-95E8-127F4C984779',
+    '3D532050-5CDA-4FD0-879E-0F7F630D5AFB',
+    'FC1BCDB0-7D31-49AA-936A-A4600D9DD083',
+    )
+
+class SectionCache(object):
+    #
+    # The cache directory, None when the cache is disabled
+    #
+    CacheDir = None
+    ReadOnly = False
+    Hits = 0
+    Misses = 0
+    _ToolDigests = {}
+
+    ## Enable() method
+    #
+    #   Enable the cache and reset its statistics
+    #
+    #   @param  CacheDir    The cache directory, or None to disable the cache
+    #   @param  ReadOnly    Only use the outputs in the cache, do not add new ones
+    #
+    @staticmethod
+    def Enable(CacheDir, ReadOnly=False):
+        SectionCache.CacheDir = CacheDir
+        SectionCache.ReadOnly = ReadOnly
+        SectionCache.Hits = 0
+        SectionCache.Misses = 0
+        SectionCache._ToolDigests = {}
+
+    ## IsCacheableGuid() method
+    #
+    #   @param  Guid        The GUID of a GUIDed section
+    #   @retval True        The output of the tool of the section can be cached
+    #
+    @staticmethod
+    def IsCacheableGuid(Guid):
+        return Guid is not None and Guid.upper() in SECTION_CACHE_GUIDS
+
+    ## _HashFile() method
+    #
+    #   @param  Hash        The hash object to update
+    #   @param  FileName    The file to hash
+    #
+    @staticmethod
+    def _HashFile(Hash, FileName):
+        with open(FileName, 'rb') as File:
+            while True:
+                Data = File.read(0x100000)
+                if not Data:
+                    break
+                Hash.update(Data)
+
+    ## _ToolDigest() method
+    #
+    #   Hash the executable of a tool, and the binary the BaseTools wrappers
+    #   run, so that rebuilding the tool invalidates its cached outputs. The
+    #   wrapper found in the PATH is only a script, the binary is looked for
+    #   in the C tools directories of EDK_TOOLS_PATH and EDK_TOOLS_BIN.
+    #
+    #   @param  ToolPath    The tool as it is called
+    #   @retval string      The digest of the tool
+    #
+    @staticmethod
+    def _ToolDigest(ToolPath):
+        Digest = SectionCache._ToolDigests.get(ToolPath)
+        if Digest is None:
+            Hash = hashlib.sha256(os.path.basename(ToolPath).encode('utf-8'))
+            ToolName = os.path.basename(ToolPath)
+            Candidates = [shutil.which(ToolPath)]
+            if os.environ.get('EDK_TOOLS_PATH'):
+                Candidates.append(os.path.join(os.environ['EDK_TOOLS_PATH'], 'Source', 'C', 'bin', ToolName))
+            if os.environ.get('EDK_TOOLS_BIN'):
+                Candidates.append(os.path.join(os.environ['EDK_TOOLS_BIN'], ToolName))
+                Candidates.append(os.path.join(os.environ['EDK_TOOLS_BIN'], ToolName + '.exe'))
+            for Candidate in Candidates:
+                if Candidate and os.path.isfile(Candidate):
+                    SectionCache._HashFile(Hash, Candidate)
+            Digest = Hash.hexdigest()
+            SectionCache._ToolDigests[ToolPath] = Digest
+        return Digest
+
+    ## GetKey() method
+    #
+    #   @param  ToolPath    The tool generating the output
+    #   @param  Options     The options of the tool, without the file names
+    #   @param  Input       The input files of the tool
+    #   @retval string      The key of the output, None if the cache is disabled
+    #
+    @staticmethod
+    def GetKey(ToolPath, Options, Input):
+        if SectionCache.CacheDir is None:
+            return None
+        Hash = hashlib.sha256(('%d\n%s\n' % (SECTION_CACHE_VERSION, SectionCache._ToolDigest(ToolPath))).encode('utf-8'))
+        for Option in Options:
+            Hash.update(Option.encode('utf-8') + b'\0')
+        for FileName in Input:
+            FileHash = hashlib.sha256()
+            SectionCache._HashFile(FileHash, FileName)
+            Hash.update(FileHash.digest())
+        return Hash.hexdigest()
+
+    ## _GetPath() method
+    #
+    #   @param  Key         The key of the output
+    #   @retval string      The cache file of the output
+    #
+    @staticmethod
+    def _GetPath(Key):
+        return os.path.join(SectionCache.CacheDir, Key[:2], Key)
+
+    ## Get() method
+    #
+    #   Copy a cached output to the output file
+    #
+    #   @param  Key         The key of the output
+    #   @param  Output      The output file
+    #   @retval True        The output file was copied from the cache
+    #   @retval False       The output is not in the cache
+    #
+    @staticmethod
+    def Get(Key, Output):
+        if Key is None:
+            return False
+        CacheFile = SectionCache._GetPath(Key)
+        if not os.path.isfile(CacheFile):
+            SectionCache.Misses += 1
+            return False
+        try:
+            shutil.copyfile(CacheFile, Output)
+        except (IOError, OSError):
+            SectionCache.Misses += 1
+            return False
+        SectionCache.Hits += 1
+        return True
+
+    ## Put() method
+    #
+    #   Add an output file to the cache. The file is first copied under a
+    #   temporary name and then renamed, so that the concurrent builds sharing
+    #   the cache never see a partial file. Errors are ignored, as the cache
+    #   is only an optimization.
+    #
+    #   @param  Key         The key of the output
+    #   @param  Output      The output file
+    #
+    @staticmethod
+    def Put(Key, Output):
+        if Key is None or SectionCache.ReadOnly or not os.path.isfile(Output):
+            return
+        CacheFile = SectionCache._GetPath(Key)
+        TempFile = '%s.%d.tmp' % (CacheFile, os.getpid())
+        try:
+            os.makedirs(os.path.dirname(CacheFile), exist_ok=True)
+            shutil.copyfile(Output, TempFile)
+            os.replace(TempFile, CacheFile)
+        except (IOError, OSError):
+            if os.path.exists(TempFile):
+                os.remove(TempFile)
@@ -0,0 +1,217 @@
+## @file
+# Persistent cache of the records parsed from the INF and DEC files
+#
+# The records the InfParser and DecParser store in their tables only depend
+# on the content of the file, as the macros of INF and DEC files are local to
+# them. The records are saved in the Conf cache directory, and loaded instead
+# of parsing the file again in the next build when the file is unchanged. An
+# entry is valid when the modification time and the size of the file are the
+# same as when the file was parsed, or else when the SHA-256 of its content is.
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import absolute_import
+import hashlib
+import os
+import pickle
+import time
+
+import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+#
+# Increase when the records the parsers store, or the layout of the entries,
+# change
+#
+METAFILE_CACHE_VERSION = 1
+
+#
+# Name of the directory of the meta-data cache in the Conf cache directory
+#
+METAFILE_CACHE_DIRECTORY = 'MetaFileCache'
+
+#
+# A file modified less than this number of seconds before it is parsed may be
+# modified again without a change of its modification time, so its entry is
+# always validated with the SHA-256 of its content.
+#
+METAFILE_CACHE_RACY_TIME = 2
+
+class MetaFileCache(object):
+    #
+    # The cache directory, None when the cache is disabled
+    #
+    CacheDir = None
+    Hits = 0
+    Misses = 0
+    #
+    # The time spent to parse the meta-files, or to load them from the cache
+    #
+    ParseTime = 0.0
+    _Depth = 0
+
+    ## Enable() method
+    #
+    #   Enable the cache and reset its statistics
+    #
+    #   @param  CacheDir    The cache directory, or None to disable the cache
+    #
+    @staticmethod
+    def Enable(CacheDir):
+        MetaFileCache.CacheDir = CacheDir
+        MetaFileCache.Hits = 0
+        MetaFileCache.Misses = 0
+        MetaFileCache.ParseTime = 0.0
+
+    ## _GetPath() method
+    #
+    #   @param  Parser      The parser of the file
+    #   @retval string      The cache file of the records of the file
+    #
+    @staticmethod
+    def _GetPath(Parser):
+        Key = '%s\n%s' % (type(Parser).__name__, os.path.normcase(os.path.normpath(str(Parser.MetaFile))))
+        Key = hashlib.sha256(Key.encode('utf-8')).hexdigest()
+        return os.path.join(MetaFileCache.CacheDir, Key[:2], Key)
+
+    ## _Digest() method
+    #
+    #   @param  FilePath    The file to hash
+    #   @retval string      The SHA-256 of the content of the file
+    #
+    @staticmethod
+    def _Digest(FilePath):
+        with open(FilePath, 'rb') as File:
+            return hashlib.sha256(File.read()).hexdigest()
+
+    ## _Load() method
+    #
+    #   Fill the table of the parser with the records of the cache
+    #
+    #   @param  Parser      The parser of the file
+    #   @param  Stat        The status of the file
+    #   @retval True        The records were loaded from the cache
+    #   @retval False       The file must be parsed
+    #
+    @staticmethod
+    def _Load(Parser, Stat):
+        CacheFile = MetaFileCache._GetPath(Parser)
+        try:
+            with open(CacheFile, 'rb') as File:
+                Entry = pickle.load(File)
+            if Entry['Version'] != METAFILE_CACHE_VERSION or Entry['Path'] != str(Parser.MetaFile):
+                return False
+            if Entry['Stat'] != (Stat.st_mtime_ns, Stat.st_size):
+                if Entry['Digest'] != MetaFileCache._Digest(str(Parser.MetaFile)):
+                    return False
+        except Exception as Excpt:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Cannot load %s: %s" % (CacheFile, str(Excpt)))
+            return False
+
+        #
+        # The records are inserted again, so that they get the IDs the table
+        # gives them, which depend on the order in which the files are added
+        # to the database.
+        #
+        Table = Parser._RawTable
+        IdList = []
+        for Record in Entry['Records']:
+            Record = list(Record)
+            if Record[6] >= 0:
+                Record[6] = IdList[Record[6]]
+            IdList.append(Table.Insert(*Record))
+        Parser._Done()
+        return True
+
+    ## _Save() method
+    #
+    #   Save the records of the table of the parser. Errors are ignored, as the
+    #   cache is only an optimization.
+    #
+    #   @param  Parser      The parser of the file
+    #   @param  Stat        The status of the file before it was parsed
+    #
+    @staticmethod
+    def _Save(Parser, Stat):
+        #
+        # The records are saved without their IDs, and the records they
+        # belong to are saved as indexes in the list of records.
+        #
+        Content = Parser._RawTable.CurrentContent
+        if not Content or Content[-1][0] >= 0:
+            return
+        Records = []
+        IndexDict = {}
+        for Row in Content[:-1]:
+            Record = list(Row[1:])
+            if Record[6] >= 0:
+                if Record[6] not in IndexDict:
+                    return
+                Record[6] = IndexDict[Record[6]]
+            IndexDict[Row[0]] = len(Records)
+            Records.append(Record)
+        Entry = {
+            'Version'   : METAFILE_CACHE_VERSION,
+            'Path'      : str(Parser.MetaFile),
+            'Stat'      : (Stat.st_mtime_ns, Stat.st_size),
+            'Digest'    : None,
+            'Records'   : Records,
+            }
+        if time.time() - Stat.st_mtime < METAFILE_CACHE_RACY_TIME:
+            Entry['Stat'] = None
+        CacheFile = MetaFileCache._GetPath(Parser)
+        TempFile = '%s.%d.tmp' % (CacheFile, os.getpid())
+        try:
+            Entry['Digest'] = MetaFileCache._Digest(str(Parser.MetaFile))
+            os.makedirs(os.path.dirname(CacheFile), exist_ok=True)
+            with open(TempFile, 'wb') as File:
+                pickle.dump(Entry, File, pickle.HIGHEST_PROTOCOL)
+            os.replace(TempFile, CacheFile)
+        except (IOError, OSError, pickle.PicklingError):
+            if os.path.exists(TempFile):
+                os.remove(TempFile)
+
+    ## Parse() method
+    #
+    #   Parse a meta-file, or load its records from the cache
+    #
+    #   @param  Parser      The parser of the file
+    #
+    @staticmethod
+    def Parse(Parser):
+        StartTime = time.time()
+        MetaFileCache._Depth += 1
+        try:
+            #
+            # The usage of the items is only checked when the file is parsed
+            #
+            if MetaFileCache.CacheDir is None or not Parser.Cacheable or \
+               (GlobalData.gOptions and GlobalData.gOptions.CheckUsage):
+                Parser.Start()
+                return
+            try:
+                Stat = os.stat(str(Parser.MetaFile))
+            except OSError:
+                Parser.Start()
+                return
+            if MetaFileCache._Load(Parser, Stat):
+                MetaFileCache.Hits += 1
+                return
+            MetaFileCache.Misses += 1
+            Parser.Start()
+            if Parser.Finished:
+                MetaFileCache._Save(Parser, Stat)
+        finally:
+            #
+            # The DSC files included by a DSC file are parsed with it
+            #
+            MetaFileCache._Depth -= 1
+            if MetaFileCache._Depth == 0:
+                MetaFileCache.ParseTime += time.time() - StartTime
@@ -29,6 +29,7 @@ from CommonDataClass.Exceptions import *
 from Common.LongFilePathSupport import OpenLongFilePath as open
 from collections import defaultdict
 from .MetaFileTable import MetaFileStorage
+from .MetaFileCache import MetaFileCache
 from .MetaFileCommentParser import CheckInfComment
 from Common.DataType import TAB_COMMENT_EDK_START, TAB_COMMENT_EDK_END
 
@@ -122,6 +123,10 @@ class MetaFileParser(object):
     # Parser objects used to implement singleton
     MetaFiles = {}
 
+    # The records of the files whose content is the only input of the parser
+    # can be saved in the MetaFileCache
+    Cacheable = False
+
     ## Factory method
     #
     # One file, one parser object. This factory method makes sure that there's
@@ -258,7 +263,7 @@ class MetaFileParser(object):
             else:
                 self._Table = self._RawTable
                 self._PostProcessed = False
-                self.Start()
+                MetaFileCache.Parse(self)
     ## Data parser for the common format in different type of file
     #
     #   The common format in the meatfile is like
@@ -558,6 +563,8 @@ class InfParser(MetaFileParser):
         TAB_USER_EXTENSIONS.upper() : MODEL_META_DATA_USER_EXTENSION
     }
 
+    Cacheable = True
+
     ## Constructor of InfParser
     #
     #  Initialize object of InfParser
@@ -1770,6 +1777,8 @@ class DecParser(MetaFileParser):
         TAB_USER_EXTENSIONS.upper()                 :   MODEL_META_DATA_USER_EXTENSION,
     }
 
+    Cacheable = True
+
     ## Constructor of DecParser
     #
     #  Initialize object of DecParser
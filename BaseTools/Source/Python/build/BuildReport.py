@@ -2199,8 +2199,9 @@ class PlatformReport(object):
     # @param MakeTime        The total time of Make Phase
     # @param GenFdsTime      The total time of GenFds Phase
     # @param ReportType      The kind of report items in the final report file
+    # @param AutoGenStatistics The (name, value) pairs of the statistics of AutoGen Phase
     #
-    def GenerateReport(self, File, BuildDuration, AutoGenTime, MakeTime, GenFdsTime, ReportType):
+    def GenerateReport(self, File, BuildDuration, AutoGenTime, MakeTime, GenFdsTime, ReportType, AutoGenStatistics=None):
         FileWrite(File, "Platform Summary")
         FileWrite(File, "Platform Name:        %s" % self.PlatformName)
         FileWrite(File, "Platform DSC Path:    %s" % self.PlatformDscPath)
@@ -2216,6 +2217,9 @@ class PlatformReport(object):
         FileWrite(File, "Build Duration:       %s" % BuildDuration)
         if AutoGenTime:
             FileWrite(File, "AutoGen Duration:     %s" % AutoGenTime)
+        if AutoGenStatistics:
+            for (Name, Value) in AutoGenStatistics:
+                FileWrite(File, "%-22s%s" % (Name + ":", Value))
         if MakeTime:
             FileWrite(File, "Make Duration:        %s" % MakeTime)
         if GenFdsTime:
@@ -2297,8 +2301,9 @@ class BuildReport(object):
     # @param AutoGenTime     The total time of AutoGen phase
     # @param MakeTime        The total time of Make phase
     # @param GenFdsTime      The total time of GenFds phase
+    # @param AutoGenStatistics The (name, value) pairs of the statistics of AutoGen phase
     #
-    def GenerateReport(self, BuildDuration, AutoGenTime, MakeTime, GenFdsTime):
+    def GenerateReport(self, BuildDuration, AutoGenTime, MakeTime, GenFdsTime, AutoGenStatistics=None):
         if self.ReportFile:
             try:
 
@@ -2307,7 +2312,7 @@ class BuildReport(object):
 
                 File = []
                 for (Wa, MaList) in self.ReportList:
-                    PlatformReport(Wa, MaList, self.ReportType).GenerateReport(File, BuildDuration, AutoGenTime, MakeTime, GenFdsTime, self.ReportType)
+                    PlatformReport(Wa, MaList, self.ReportType).GenerateReport(File, BuildDuration, AutoGenTime, MakeTime, GenFdsTime, self.ReportType, AutoGenStatistics)
                 Content = FileLinesSplit(''.join(File), gLineMaxLength)
                 SaveFileOnChange(self.ReportFile, Content, False)
                 EdkLogger.quiet("Build report can be found at %s" % os.path.abspath(self.ReportFile))
@@ -64,6 +64,8 @@ from AutoGen.ModuleAutoGenHelper import WorkSpaceInfo, PlatformInfo
 from GenFds.FdfParser import FdfParser
 from AutoGen.IncludesAutoGen import IncludesAutoGen
 from GenFds.GenFds import resetFdsGlobalVariable
+from GenFds.SectionCache import SECTION_CACHE_DIRECTORY
+from Workspace.MetaFileCache import MetaFileCache, METAFILE_CACHE_DIRECTORY
 from AutoGen.AutoGen import CalculatePriorityValue
 
 ## standard targets of build command
@@ -794,9 +796,27 @@ class Build():
             if GlobalData.gBinCacheDest is not None:
                 EdkLogger.error("build", OPTION_VALUE_INVALID, ExtraData="Invalid value of option --binary-destination.")
 
+        #
+        # The sections compressed by GenFds are cached next to the module binaries,
+        # or in the Conf cache directory when only --hash is used
+        #
+        GlobalData.gSectionCacheDir = None
+        if GlobalData.gUseHashCache:
+            CacheDir = GlobalData.gBinCacheDest or GlobalData.gBinCacheSource or os.path.join(GlobalData.gConfDirectory, '.cache')
+            GlobalData.gSectionCacheDir = os.path.join(CacheDir, SECTION_CACHE_DIRECTORY)
+
         GlobalData.gDatabasePath = os.path.normpath(os.path.join(GlobalData.gConfDirectory, GlobalData.gDatabasePath))
         if not os.path.exists(os.path.join(GlobalData.gConfDirectory, '.cache')):
             os.makedirs(os.path.join(GlobalData.gConfDirectory, '.cache'))
+
+        #
+        # The records parsed from the INF and DEC files are saved in the Conf
+        # cache directory, unless all the meta-data files must be parsed again
+        #
+        if self.Reparse:
+            MetaFileCache.Enable(None)
+        else:
+            MetaFileCache.Enable(os.path.join(GlobalData.gConfDirectory, '.cache', METAFILE_CACHE_DIRECTORY))
         self.Db = BuildDB
         self.BuildDatabase = self.Db.BuildObject
         self.Platform = None
@@ -886,9 +906,11 @@ class Build():
                     if GlobalData.gUseHashCache and not GlobalData.gBinCacheDest and self.Target in [None, "", "all"]:
                         cqueue.put((PcdMa.MetaFile.Path, PcdMa.Arch, "PreMakeCache", False))
 
+                    Skipped = PcdMa.CanSkip()
                     PcdMa.CreateCodeFile(False)
                     PcdMa.CreateMakeFile(False,GenFfsList = DataPipe.Get("FfsCommand").get((PcdMa.MetaFile.Path, PcdMa.Arch),[]))
                     PcdMa.CreateAsBuiltInf()
+                    cqueue.put((PcdMa.MetaFile.Path, PcdMa.Arch, "AutoGen", Skipped))
                     # Force cache miss for PCD driver
                     if GlobalData.gBinCacheSource and self.Target in [None, "", "all"]:
                         cqueue.put((PcdMa.MetaFile.Path, PcdMa.Arch, "MakeCache", False))
@@ -2520,6 +2542,21 @@ class Build():
         for Module in self.BuildModules:
             Module.CreateAsBuiltInf()
 
+    ## Return the statistics of the AutoGen phase for the build report
+    #
+    #   @retval list    The (name, value) pairs of the statistics
+    #
+    def GetAutoGenStatistics(self):
+        Statistics = []
+        if MetaFileCache.ParseTime:
+            Statistics.append(("Meta-data Parsing", "%.3fs" % MetaFileCache.ParseTime))
+        if MetaFileCache.Hits or MetaFileCache.Misses:
+            Statistics.append(("Meta-data Cache", "%d hit(s), %d miss(es)" % (MetaFileCache.Hits, MetaFileCache.Misses)))
+        AutoGenStatus = [Item[3] for Item in GlobalData.gModuleAllCacheStatus or () if Item[2] == "AutoGen"]
+        if AutoGenStatus:
+            Statistics.append(("AutoGen Modules", "%d regenerated, %d up to date" % (AutoGenStatus.count(False), AutoGenStatus.count(True))))
+        return Statistics
+
     def GenDestCache(self):
         for Module in self.AllModules:
             Module.GenPreMakefileHashList()
@@ -2789,7 +2826,7 @@ def Main():
         BuildDurationStr = time.strftime("%H:%M:%S", BuildDuration)
     if MyBuild is not None:
         if not BuildError:
-            MyBuild.BuildReport.GenerateReport(BuildDurationStr, LogBuildTime(MyBuild.AutoGenTime), LogBuildTime(MyBuild.MakeTime), LogBuildTime(MyBuild.GenFdsTime))
+            MyBuild.BuildReport.GenerateReport(BuildDurationStr, LogBuildTime(MyBuild.AutoGenTime), LogBuildTime(MyBuild.MakeTime), LogBuildTime(MyBuild.GenFdsTime), MyBuild.GetAutoGenStatistics())
 
     EdkLogger.SetLevel(EdkLogger.QUIET)
     EdkLogger.quiet("\n- %s -" % Conclusion)
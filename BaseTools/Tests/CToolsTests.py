@@ -14,8 +14,16 @@ import sys
 import unittest
 
 import TianoCompress
+import LzmaCompress
+import GenFv
+import GenFdsInProcessTools
+import GenFdsSectionCache
 modules = (
     TianoCompress,
+    LzmaCompress,
+    GenFv,
+    GenFdsInProcessTools,
+    GenFdsSectionCache,
     )
 
 
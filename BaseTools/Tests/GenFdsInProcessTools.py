@@ -0,0 +1,147 @@
+## @file
+# Unit tests for the sections and FFS files GenFds generates in process
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import struct
+import time
+import unittest
+
+import TestTools
+
+from GenFds import InProcessTools
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+
+    def GetPeImage(self, SectionAlignment, Size=0x400):
+        #
+        # DOS header, PE signature, COFF header and the start of a PE32+
+        # optional header with the section alignment.
+        #
+        Image = bytearray(Size)
+        Image[0:2] = b'MZ'
+        struct.pack_into('<I', Image, 0x3C, 0x80)
+        Image[0x80:0x84] = b'PE\0\0'
+        struct.pack_into('<HHIIIHH', Image, 0x84, 0x8664, 0, 0, 0, 0, 0xF0, 0x22)
+        struct.pack_into('<H', Image, 0x98, 0x20B)
+        struct.pack_into('<II', Image, 0x98 + 32, SectionAlignment, 0x20)
+        struct.pack_into('<H', Image, 0x98 + 68, 0xB)
+        return bytes(Image)
+
+    def GetTeImage(self, StrippedSize, Size=0x400):
+        Image = bytearray(Size)
+        Image[0:2] = b'VZ'
+        struct.pack_into('<HBBH', Image, 2, 0x8664, 0, 0xA, StrippedSize)
+        return bytes(Image)
+
+    def GenSec(self, Name, Type, Input):
+        Output = self.GetTmpFilePath(Name + '.sec')
+        self.assertEqual(self.RunTool('-s', Type, '-o', Output, Input, toolName='GenSec'), 0)
+        return self.ReadTmpFile(Name + '.sec')
+
+    def GenFfs(self, Name, Input, Type, Guid, Fixed=False, CheckSum=False, Align=None, SectionAlign=None):
+        Args = ['-t', Type, '-g', Guid]
+        if Fixed:
+            Args.append('-x')
+        if CheckSum:
+            Args.append('-s')
+        if Align:
+            Args += ['-a', Align]
+        Args += ['-o', self.GetTmpFilePath(Name + '.ffs')]
+        for Index, File in enumerate(Input):
+            Args += ['-i', File]
+            if SectionAlign and SectionAlign[Index]:
+                Args += ['-n', SectionAlign[Index]]
+        self.assertEqual(self.RunTool(*Args, toolName='GenFfs'), 0)
+        return self.ReadTmpFile(Name + '.ffs')
+
+    def WriteSection(self, Name, Type, Data):
+        self.WriteTmpFile(Name, Data)
+        Section = InProcessTools.GenerateLeafSection(Type, [self.GetTmpFilePath(Name)])
+        self.assertEqual(Section, self.GenSec(Name, Type, self.GetTmpFilePath(Name)))
+        self.WriteTmpFile(Name + '.sec', Section)
+        return self.GetTmpFilePath(Name + '.sec')
+
+    def CheckFfs(self, Name, Input, Type, Guid, **Options):
+        Ffs = InProcessTools.GenerateFfs(Input, Type, Guid, **Options)
+        self.assertIsNotNone(Ffs)
+        self.assertEqual(Ffs, self.GenFfs(Name, Input, Type, Guid, **Options))
+
+    def testLeafSections(self):
+        for Type in InProcessTools.LeafSectionTypes:
+            for Size in (0, 1, 3, 0x1234):
+                self.WriteSection('%s_%x' % (Type, Size), Type, os.urandom(Size))
+        self.assertIsNone(InProcessTools.GenerateLeafSection('EFI_SECTION_COMPRESSION', [self.GetTmpFilePath('EFI_SECTION_RAW_1')]))
+        self.assertIsNone(InProcessTools.GenerateLeafSection('EFI_SECTION_RAW', []))
+
+    def testLargeSection(self):
+        self.WriteSection('large', 'EFI_SECTION_RAW', os.urandom(InProcessTools.MAX_SECTION_SIZE))
+
+    def testDriverFfs(self):
+        Pe = self.WriteSection('pe', 'EFI_SECTION_PE32', self.GetPeImage(0x1000, 0x2345))
+        Depex = self.WriteSection('depex', 'EFI_SECTION_DXE_DEPEX', os.urandom(9))
+        Raw = self.WriteSection('raw', 'EFI_SECTION_RAW', os.urandom(0x123))
+        Guid = '2DA39E11-7BBE-4C9B-9F31-5A3B4C8D6E70'
+        self.CheckFfs('driver', [Depex, Pe, Raw], 'EFI_FV_FILETYPE_DRIVER', Guid)
+        self.CheckFfs('driver_auto', [Depex, Pe, Raw], 'EFI_FV_FILETYPE_DRIVER', Guid, SectionAlign=[None, '0', None])
+        self.CheckFfs('driver_align', [Depex, Pe, Raw], 'EFI_FV_FILETYPE_DRIVER', Guid, SectionAlign=['16', '4K', '8'])
+        self.CheckFfs('driver_fixed', [Raw, Pe], 'EFI_FV_FILETYPE_DRIVER', Guid, Fixed=True, SectionAlign=[None, '64K'])
+        self.CheckFfs('driver_checksum', [Depex, Pe], 'EFI_FV_FILETYPE_DRIVER', Guid, CheckSum=True, Align='32K')
+        self.CheckFfs('app_aligned', [Pe], 'EFI_FV_FILETYPE_APPLICATION', Guid, Align='2M', SectionAlign=['1M'])
+
+        #
+        # Invalid files are left to GenFfs to report
+        #
+        self.assertIsNone(InProcessTools.GenerateFfs([Depex], 'EFI_FV_FILETYPE_DRIVER', Guid))
+        self.assertIsNone(InProcessTools.GenerateFfs([Pe, Pe], 'EFI_FV_FILETYPE_DXE_CORE', Guid))
+        self.assertIsNone(InProcessTools.GenerateFfs([Raw], 'EFI_FV_FILETYPE_DRIVER', Guid, SectionAlign=['0']))
+        self.assertIsNone(InProcessTools.GenerateFfs([Pe], 'EFI_FV_FILETYPE_UNKNOWN', Guid))
+
+    def testTeFfs(self):
+        Te = self.WriteSection('te', 'EFI_SECTION_TE', self.GetTeImage(0x1F8, 0x1000))
+        Guid = '6F0D3E2B-1C4A-4B58-9E7D-8A1B2C3D4E5F'
+        self.CheckFfs('peim', [Te], 'EFI_FV_FILETYPE_PEIM', Guid, SectionAlign=['32'])
+        self.CheckFfs('peim_auto', [Te], 'EFI_FV_FILETYPE_PEIM', Guid, SectionAlign=['0'])
+        self.CheckFfs('pei_core', [Te], 'EFI_FV_FILETYPE_PEI_CORE', Guid, Fixed=True, SectionAlign=['4K'])
+
+    def testLargeFfs(self):
+        Raw = self.WriteSection('large', 'EFI_SECTION_RAW', os.urandom(InProcessTools.MAX_FFS_SIZE - 8))
+        self.CheckFfs('large', [Raw], 'EFI_FV_FILETYPE_FREEFORM', 'C7A4E3B2-9D1F-4E6A-8B5C-3F2E1D0C9B8A', CheckSum=True)
+
+    def testPerformance(self):
+        Pe = self.WriteSection('pe', 'EFI_SECTION_PE32', self.GetPeImage(0x1000, 0x10000))
+        Depex = self.WriteSection('depex', 'EFI_SECTION_DXE_DEPEX', os.urandom(9))
+        Guid = '2DA39E11-7BBE-4C9B-9F31-5A3B4C8D6E70'
+        Count = 100
+
+        Start = time.time()
+        for Index in range(Count):
+            self.GenSec('pe%d' % Index, 'EFI_SECTION_PE32', self.GetTmpFilePath('pe'))
+            self.GenFfs('driver%d' % Index, [Depex, Pe], 'EFI_FV_FILETYPE_DRIVER', Guid, SectionAlign=[None, '0'])
+        ToolTime = time.time() - Start
+
+        Start = time.time()
+        for Index in range(Count):
+            InProcessTools.GenerateLeafSection('EFI_SECTION_PE32', [self.GetTmpFilePath('pe')])
+            InProcessTools.GenerateFfs([Depex, Pe], 'EFI_FV_FILETYPE_DRIVER', Guid, SectionAlign=[None, '0'])
+        InProcessTime = time.time() - Start
+
+        print('\n%d sections and FFS files: %.3fs with GenSec and GenFfs, %.3fs in process' % (Count, ToolTime, InProcessTime))
+        self.assertLess(InProcessTime, ToolTime)
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
@@ -0,0 +1,122 @@
+## @file
+# Unit tests for the cache of the compressed sections generated by GenFds
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import time
+import unittest
+
+import TestTools
+
+from GenFds.GenFdsGlobalVariable import GenFdsGlobalVariable
+from GenFds.SectionCache import SectionCache
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.CacheDir = self.GetTmpFilePath('cache')
+        SectionCache.Enable(self.CacheDir)
+
+    def tearDown(self):
+        SectionCache.Enable(None)
+        TestTools.BaseToolsTest.tearDown(self)
+
+    def GetPayload(self, Size):
+        #
+        # Compressible data, like the code of the drivers in a firmware volume
+        #
+        Data = bytearray()
+        while len(Data) < Size:
+            Data += os.urandom(64) * 16
+        return bytes(Data[:Size])
+
+    def Compress(self, Name, Input, Options='-e', Guid='EE4E5898-3914-4259-9D6E-DC7BD79403CF'):
+        Output = self.GetTmpFilePath(Name + '.tmp')
+        GenFdsGlobalVariable.GuidTool(Output, [Input], 'LzmaCompress', Options, Guid=Guid)
+        return self.ReadTmpFile(Name + '.tmp')
+
+    def testGuidTool(self):
+        self.WriteTmpFile('payload', self.GetPayload(0x10000))
+        Payload = self.GetTmpFilePath('payload')
+
+        Compressed = self.Compress('first', Payload)
+        self.assertEqual((SectionCache.Hits, SectionCache.Misses), (0, 1))
+        self.assertEqual(self.RunTool('-e', '-o', self.GetTmpFilePath('tool.tmp'), Payload, toolName='LzmaCompress'), 0)
+        self.assertEqual(Compressed, self.ReadTmpFile('tool.tmp'))
+
+        #
+        # Same payload in another file
+        #
+        self.WriteTmpFile('copy', self.ReadTmpFile('payload'))
+        self.assertEqual(self.Compress('second', self.GetTmpFilePath('copy')), Compressed)
+        self.assertEqual((SectionCache.Hits, SectionCache.Misses), (1, 1))
+
+        #
+        # The options and the content of the input are part of the key
+        #
+        self.Compress('x86', Payload, '-e --f86')
+        self.assertEqual((SectionCache.Hits, SectionCache.Misses), (1, 2))
+        self.WriteTmpFile('copy', self.GetPayload(0x10000))
+        self.assertNotEqual(self.Compress('third', self.GetTmpFilePath('copy')), Compressed)
+        self.assertEqual((SectionCache.Hits, SectionCache.Misses), (1, 3))
+
+    def testReadOnly(self):
+        self.WriteTmpFile('payload', self.GetPayload(0x1000))
+        Payload = self.GetTmpFilePath('payload')
+        Compressed = self.Compress('first', Payload)
+
+        SectionCache.Enable(self.CacheDir, ReadOnly=True)
+        self.assertEqual(self.Compress('second', Payload), Compressed)
+        self.WriteTmpFile('payload', self.GetPayload(0x1000))
+        self.Compress('third', Payload)
+        self.Compress('fourth', Payload)
+        self.assertEqual((SectionCache.Hits, SectionCache.Misses), (1, 2))
+
+    def testDisabled(self):
+        SectionCache.Enable(None)
+        self.WriteTmpFile('payload', self.GetPayload(0x1000))
+        self.Compress('first', self.GetTmpFilePath('payload'))
+        self.assertEqual((SectionCache.Hits, SectionCache.Misses), (0, 0))
+        self.assertFalse(os.path.exists(self.CacheDir))
+
+    def testUncachedGuid(self):
+        #
+        # The tools of the other GUIDs, such as the signing tools, may read
+        # files named in their options
+        #
+        self.WriteTmpFile('payload', self.GetPayload(0x1000))
+        Payload = self.GetTmpFilePath('payload')
+        self.Compress('first', Payload, Guid='A7717414-C616-4977-9420-844712A735BF')
+        self.Compress('second', Payload, Guid=None)
+        self.assertEqual((SectionCache.Hits, SectionCache.Misses), (0, 0))
+        self.assertFalse(os.path.exists(self.CacheDir))
+
+    def testPerformance(self):
+        self.WriteTmpFile('payload', self.GetPayload(0x400000))
+        Payload = self.GetTmpFilePath('payload')
+
+        Start = time.time()
+        Compressed = self.Compress('first', Payload)
+        CompressTime = time.time() - Start
+
+        Start = time.time()
+        self.assertEqual(self.Compress('second', Payload), Compressed)
+        CacheTime = time.time() - Start
+
+        print('\n4MB section: %.3fs with LzmaCompress, %.3fs from the cache' % (CompressTime, CacheTime))
+        self.assertLess(CacheTime, CompressTime)
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
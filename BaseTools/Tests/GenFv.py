@@ -0,0 +1,135 @@
+## @file
+# Unit tests and benchmark for the rebase of the FFS files by GenFv
+#
+# The FV images, map files and child FV address files generated with several
+# rebase threads must be the same as the ones of the serial rebase.
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import struct
+import time
+import unittest
+import uuid
+
+import TestTools
+
+ThreadCounts = (1, 2, 8)
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'GenFv'
+
+    def GetRelocations(self, Rvas):
+        Relocations = b''
+        Pages = {}
+        for Rva in Rvas:
+            Pages.setdefault(Rva & ~0xFFF, []).append((0xA << 12) | (Rva & 0xFFF))
+        for Page in sorted(Pages):
+            Entries = Pages[Page]
+            if len(Entries) % 2:
+                Entries.append(0)
+            Relocations += struct.pack('<II', Page, 8 + 2 * len(Entries))
+            Relocations += struct.pack('<%dH' % len(Entries), *Entries)
+        return Relocations
+
+    def GetPeImage(self, Size, Seed):
+        #
+        # PE32+ image with a .text section made of 64-bit pointers to itself,
+        # and the DIR64 relocations of all of them in a .reloc section. The
+        # section and file alignments are the same, as required for XIP.
+        #
+        TextSize = (Size + 0x1F) & ~0x1F
+        RelocRva = 0x200 + TextSize
+        Relocations = self.GetRelocations(range(0x200, RelocRva, 8))
+        RelocSize = (len(Relocations) + 0x1F) & ~0x1F
+        Image = bytearray(RelocRva + RelocSize)
+        Image[0:2] = b'MZ'
+        struct.pack_into('<I', Image, 0x3C, 0x40)
+        Image[0x40:0x44] = b'PE\0\0'
+        struct.pack_into('<HHIIIHH', Image, 0x44, 0x8664, 2, 0, 0, 0, 0xF0, 0x22)
+        struct.pack_into('<HBBIIIII', Image, 0x58, 0x20B, 0, 0, TextSize, RelocSize, 0, 0x200, 0x200)
+        struct.pack_into('<QII', Image, 0x58 + 24, 0, 0x20, 0x20)
+        struct.pack_into('<II', Image, 0x58 + 56, len(Image), 0x200)
+        struct.pack_into('<H', Image, 0x58 + 68, 0xB)
+        struct.pack_into('<I', Image, 0x58 + 108, 16)
+        struct.pack_into('<II', Image, 0x58 + 112 + 5 * 8, RelocRva, len(Relocations))
+        struct.pack_into('<8sIIIIIIHHI', Image, 0x148, b'.text', TextSize, 0x200, TextSize, 0x200, 0, 0, 0, 0, 0x60000020)
+        struct.pack_into('<8sIIIIIIHHI', Image, 0x170, b'.reloc', RelocSize, RelocRva, RelocSize, RelocRva, 0, 0, 0, 0, 0x42000040)
+        for Offset in range(0, TextSize, 8):
+            struct.pack_into('<Q', Image, 0x200 + Offset, 0x200 + (Offset * Seed) % TextSize)
+        Image[RelocRva:RelocRva + len(Relocations)] = Relocations
+        return bytes(Image)
+
+    def GenFfs(self, Name, Section, Type, Options=()):
+        self.assertEqual(self.RunTool('-s', Section, '-o', self.GetTmpFilePath(Name + '.sec'), self.GetTmpFilePath(Name), toolName='GenSec'), 0)
+        Guid = str(uuid.uuid4())
+        Args = ('-t', Type, '-g', Guid, '-i', self.GetTmpFilePath(Name + '.sec'), '-o', self.GetTmpFilePath(Name + '.ffs')) + tuple(Options)
+        self.assertEqual(self.RunTool(*Args, toolName='GenFfs'), 0)
+        return self.GetTmpFilePath(Name + '.ffs')
+
+    def GetFfsFiles(self, Count, Size):
+        Types = ('EFI_FV_FILETYPE_PEIM', 'EFI_FV_FILETYPE_DRIVER', 'EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER', 'EFI_FV_FILETYPE_FREEFORM')
+        Files = []
+        for Index in range(Count):
+            Options = ()
+            if Index % 4 == 0:
+                Options += ('-s',)
+            if Index % 5 == 0:
+                Options += ('-a', '4K')
+            Name = 'module%d' % Index
+            self.WriteTmpFile(Name, self.GetPeImage(Size + Index * 0x40, Index + 3))
+            Files.append(self.GenFfs(Name, 'EFI_SECTION_PE32', Types[Index % len(Types)], Options))
+        return Files
+
+    def GenFv(self, Name, Files, *Options):
+        Args = ['-o', self.GetTmpFilePath(Name), '-a', self.GetTmpFilePath(Name + '.addr')]
+        Args += ['-b', '0x1000', '-n', '0x4000', '-r', '0xFF000000']
+        for File in Files:
+            Args += ['-f', File]
+        self.assertEqual(self.RunTool(*(Args + list(Options))), 0)
+        return tuple(self.ReadTmpFile(Name + Extension) for Extension in ('', '.map', '.txt'))
+
+    def testThreadCounts(self):
+        Files = self.GetFfsFiles(40, 0x2000)
+
+        #
+        # FV image file with a child FV
+        #
+        self.assertEqual(self.RunTool('-o', self.GetTmpFilePath('child'), '-b', '0x1000', '-n', '0x40', '-f', Files[0], '-f', Files[1]), 0)
+        Files.append(self.GenFfs('child', 'EFI_SECTION_FIRMWARE_VOLUME_IMAGE', 'EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE'))
+
+        Serial = self.GenFv('serial', Files)
+        ChildFvAddress = self.ReadTmpFile('serial.addr')
+        self.assertNotEqual(ChildFvAddress, b'')
+        for Threads in ThreadCounts:
+            self.assertEqual(self.GenFv('threads%d' % Threads, Files, '--threads', str(Threads)), Serial)
+            self.assertEqual(self.ReadTmpFile('threads%d.addr' % Threads), ChildFvAddress)
+
+    def testInvalidThreadCount(self):
+        Files = self.GetFfsFiles(1, 0x100)
+        for Threads in ('0', '65', 'x'):
+            self.assertNotEqual(self.RunTool('-o', self.GetTmpFilePath('fv'), '-b', '0x1000', '-n', '0x10', '--threads', Threads, '-f', Files[0]), 0)
+
+    def testPerformance(self):
+        Files = self.GetFfsFiles(200, 0x10000)
+        Times = []
+        for Threads in ThreadCounts:
+            Start = time.time()
+            self.GenFv('threads%d' % Threads, Files, '--threads', str(Threads))
+            Times.append('%d thread(s) %.3fs' % (Threads, time.time() - Start))
+        print('\n%d FFS files: %s' % (len(Files), ', '.join(Times)))
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
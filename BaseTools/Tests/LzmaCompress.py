@@ -0,0 +1,95 @@
+## @file
+# Unit tests and benchmark for LzmaCompress utility
+#
+# The benchmark compresses a DXE FV image with each number of threads. The
+# image is the one given by the LZMA_BENCHMARK_FV environment variable, such
+# as Build/OvmfX64/DEBUG_GCC5/FV/DXEFV.Fv, or else an image made of the
+# BaseTools binaries, which contain the same kind of x86 code.
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import time
+import unittest
+
+import TestTools
+
+ThreadCounts = (1, 2)
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'LzmaCompress'
+
+    def GetFvImage(self, Size):
+        FvImage = os.environ.get('LZMA_BENCHMARK_FV')
+        if FvImage:
+            with open(FvImage, 'rb') as File:
+                return File.read()
+        Data = bytearray()
+        BinDir = os.path.join(TestTools.CSourceDir, 'bin')
+        while len(Data) < Size:
+            for Name in sorted(os.listdir(BinDir)):
+                with open(os.path.join(BinDir, Name), 'rb') as File:
+                    Data += File.read()
+        return bytes(Data[:Size])
+
+    def Compress(self, Input, Output, *Options):
+        Result = self.RunTool('-e', '-q', *(Options + ('-o', self.GetTmpFilePath(Output), self.GetTmpFilePath(Input))))
+        self.assertEqual(Result, 0)
+        return self.ReadTmpFile(Output)
+
+    def Decompress(self, Input, Output, *Options):
+        Result = self.RunTool('-d', '-q', *(Options + ('-o', self.GetTmpFilePath(Output), self.GetTmpFilePath(Input))))
+        self.assertEqual(Result, 0)
+        return self.ReadTmpFile(Output)
+
+    def testHelp(self):
+        self.assertEqual(self.RunTool('--help', logFile='help'), 0)
+
+    def testThreadCounts(self):
+        Data = self.GetFvImage(0x100000)
+        self.WriteTmpFile('input', Data)
+        Compressed = None
+        for Threads in ThreadCounts:
+            for EncodeOptions, DecodeOptions in (((), ()), (('-a', '0'), ()), (('--f86',), ('--f86',))):
+                self.Compress('input', 'output', '--threads', str(Threads), *EncodeOptions)
+                self.assertEqual(self.Decompress('output', 'decompressed', *DecodeOptions), Data)
+            #
+            # The bitstream does not depend on the number of threads, so it is
+            # still decoded by LzmaCustomDecompressLib
+            #
+            Output = self.Compress('input', 'output%d' % Threads, '--threads', str(Threads))
+            if Compressed is None:
+                Compressed = Output
+            self.assertEqual(Output, Compressed)
+        self.assertEqual(self.Compress('input', 'default'), Compressed)
+
+    def testInvalidThreadCount(self):
+        self.WriteTmpFile('input', b'\0' * 0x100)
+        for Threads in ('0', '3'):
+            self.assertNotEqual(self.RunTool('-e', '--threads', Threads, '-o', self.GetTmpFilePath('output'), self.GetTmpFilePath('input')), 0)
+
+    def testPerformance(self):
+        Data = self.GetFvImage(0x800000)
+        self.WriteTmpFile('input', Data)
+        Times = []
+        for Threads in ThreadCounts:
+            Start = time.time()
+            self.Compress('input', 'output%d' % Threads, '--threads', str(Threads))
+            Times.append('%d thread(s) %.3fs' % (Threads, time.time() - Start))
+        print('\n%d KB FV image: %s' % (len(Data) // 1024, ', '.join(Times)))
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
@@ -0,0 +1,125 @@
+## @file
+# Unit tests for the persistent cache of the records parsed from the meta-files
+#
+#  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import time
+import unittest
+
+import TestTools
+
+from CommonDataClass.DataClass import MODEL_FILE_DEC, MODEL_FILE_INF
+from Common.Misc import PathClass
+from Workspace.MetaFileCache import MetaFileCache
+from Workspace.MetaFileParser import DecParser, InfParser, MetaFileParser
+from Workspace.MetaFileTable import MetaFileStorage
+from Workspace.WorkspaceDatabase import WorkspaceDatabase
+
+TopDir = os.path.dirname(TestTools.BaseToolsDir)
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.CacheDir = self.GetTmpFilePath('cache')
+        MetaFileCache.Enable(self.CacheDir)
+
+    def tearDown(self):
+        MetaFileCache.Enable(None)
+        TestTools.BaseToolsTest.tearDown(self)
+
+    def CopyMetaFile(self, Name, Source):
+        with open(os.path.join(TopDir, Source), 'rb') as File:
+            self.WriteTmpFile(Name, File.read())
+        #
+        # Not modified just before it is parsed
+        #
+        Time = time.time() - 60
+        os.utime(self.GetTmpFilePath(Name), (Time, Time))
+
+    def Parse(self, Name, OtherFiles=3):
+        #
+        # The IDs of the records depend on the other files in the database
+        #
+        Database = WorkspaceDatabase()
+        for Index in range(OtherFiles):
+            Database.TblFile.append(None)
+        MetaFile = PathClass(self.GetTmpFilePath(Name))
+        #
+        # New parser object, not the one of the previous parse of the file
+        #
+        MetaFileParser.MetaFiles.pop(MetaFile, None)
+        if Name.endswith('.dec'):
+            Parser = DecParser(MetaFile, MODEL_FILE_DEC, 'COMMON', MetaFileStorage(Database, MetaFile, MODEL_FILE_DEC, True))
+        else:
+            Parser = InfParser(MetaFile, MODEL_FILE_INF, 'COMMON', MetaFileStorage(Database, MetaFile, MODEL_FILE_INF, True))
+        Parser.StartParse()
+        self.assertTrue(Parser.Finished)
+        return Parser._RawTable
+
+    def testRecords(self):
+        self.CopyMetaFile('MdePkg.dec', 'MdePkg/MdePkg.dec')
+        self.CopyMetaFile('BaseLib.inf', 'MdePkg/Library/BaseLib/BaseLib.inf')
+        for Name in ('MdePkg.dec', 'BaseLib.inf'):
+            MetaFileCache.Enable(self.CacheDir)
+            self.Parse(Name)
+            self.assertEqual((MetaFileCache.Hits, MetaFileCache.Misses), (0, 1))
+            for OtherFiles in (0, 3):
+                MetaFileCache.Enable(None)
+                Table = self.Parse(Name, OtherFiles)
+                Records, Id = Table.CurrentContent, Table.ID
+                self.assertGreater(len(Records), 100)
+
+                MetaFileCache.Enable(self.CacheDir)
+                Table = self.Parse(Name, OtherFiles)
+                self.assertEqual((MetaFileCache.Hits, MetaFileCache.Misses), (1, 0))
+                self.assertEqual((Table.CurrentContent, Table.ID), (Records, Id))
+
+    def testModifiedFile(self):
+        self.CopyMetaFile('BaseLib.inf', 'MdePkg/Library/BaseLib/BaseLib.inf')
+        self.Parse('BaseLib.inf')
+
+        #
+        # Same content with another modification time
+        #
+        os.utime(self.GetTmpFilePath('BaseLib.inf'))
+        self.Parse('BaseLib.inf')
+        self.assertEqual((MetaFileCache.Hits, MetaFileCache.Misses), (1, 1))
+
+        #
+        # Other content with the same size and modification time
+        #
+        Stat = os.stat(self.GetTmpFilePath('BaseLib.inf'))
+        self.WriteTmpFile('BaseLib.inf', self.ReadTmpFile('BaseLib.inf').replace(b'BaseLib', b'BaseLiX'))
+        os.utime(self.GetTmpFilePath('BaseLib.inf'), ns=(Stat.st_atime_ns, Stat.st_mtime_ns))
+        Table = self.Parse('BaseLib.inf')
+        self.assertEqual((MetaFileCache.Hits, MetaFileCache.Misses), (1, 2))
+        self.assertIn('BaseLiX', [Row[4] for Row in Table.CurrentContent])
+
+    def testPerformance(self):
+        self.CopyMetaFile('MdePkg.dec', 'MdePkg/MdePkg.dec')
+
+        Start = time.time()
+        Records = self.Parse('MdePkg.dec').CurrentContent
+        ParseTime = time.time() - Start
+
+        Start = time.time()
+        self.assertEqual(self.Parse('MdePkg.dec').CurrentContent, Records)
+        CacheTime = time.time() - Start
+
+        print('\nMdePkg.dec: %.3fs to parse, %.3fs from the cache' % (ParseTime, CacheTime))
+        self.assertLess(CacheTime, ParseTime)
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
@@ -1,14 +1,80 @@
 /** @file
   SHA-256 Digest Wrapper Implementation over OpenSSL.
 
-Copyright (c) 2009 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
 #include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
 #include <openssl/sha.h>
 
+/**
+  Digests the input data into the OpenSSL SHA-256 context.
+
+  The whole blocks of the data are processed with the accelerated block
+  function when the processor supports one, and with SHA256_Update()
+  otherwise.
+
+  @param[in, out]  Context   Pointer to the OpenSSL SHA-256 context.
+  @param[in]       Data      Pointer to the buffer containing the data to be hashed.
+  @param[in]       DataSize  Size of Data buffer in bytes.
+
+  @retval TRUE   SHA-256 data digest succeeded.
+  @retval FALSE  SHA-256 data digest failed.
+
+**/
+STATIC
+BOOLEAN
+InternalSha256Update (
+  IN OUT  SHA256_CTX  *Context,
+  IN      CONST VOID  *Data,
+  IN      UINTN       DataSize
+  )
+{
+  CONST UINT8  *Buffer;
+  UINTN        Length;
+  UINTN        BlockCount;
+  UINT32       BitCountLow;
+
+  Buffer = Data;
+
+  //
+  // Complete the block left partially filled by the previous update first.
+  //
+  if ((Context->num != 0) && (DataSize != 0)) {
+    Length = MIN (DataSize, SHA256_BLOCK_SIZE - Context->num);
+    if (!SHA256_Update (Context, Buffer, Length)) {
+      return FALSE;
+    }
+
+    Buffer   += Length;
+    DataSize -= Length;
+  }
+
+  BlockCount = DataSize / SHA256_BLOCK_SIZE;
+  if ((BlockCount != 0) && Sha256ProcessBlocksAccel (Context->h, Buffer, BlockCount)) {
+    Length = BlockCount * SHA256_BLOCK_SIZE;
+
+    //
+    // Account for the blocks in the message bit count, as SHA256_Update() does.
+    //
+    BitCountLow = Context->Nl + (UINT32)(Length << 3);
+    if (BitCountLow < Context->Nl) {
+      Context->Nh++;
+    }
+
+    Context->Nh += (UINT32)(Length >> 29);
+    Context->Nl  = BitCountLow;
+
+    Buffer   += Length;
+    DataSize -= Length;
+  }
+
+  return (BOOLEAN)(SHA256_Update (Context, Buffer, DataSize));
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-256 hash operations.
 
@@ -133,7 +199,7 @@ Sha256Update (
   //
   // OpenSSL SHA-256 Hash Update
   //
-  return (BOOLEAN)(SHA256_Update ((SHA256_CTX *)Sha256Context, Data, DataSize));
+  return InternalSha256Update ((SHA256_CTX *)Sha256Context, Data, DataSize);
 }
 
 /**
@@ -222,7 +288,7 @@ Sha256HashAll (
     return FALSE;
   }
 
-  if (!SHA256_Update (&Context, Data, DataSize)) {
+  if (!InternalSha256Update (&Context, Data, DataSize)) {
     return FALSE;
   }
 
@@ -1,14 +1,81 @@
 /** @file
   SHA-384 and SHA-512 Digest Wrapper Implementations over OpenSSL.
 
-Copyright (c) 2014 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2014 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
 #include "InternalCryptLib.h"
+#include "CryptShaAccel.h"
 #include <openssl/sha.h>
 
+/**
+  Digests the input data into the OpenSSL SHA-512 context, also used for
+  SHA-384.
+
+  The whole blocks of the data are processed with the accelerated block
+  function when the processor supports one, and with SHA512_Update()
+  otherwise.
+
+  @param[in, out]  Context   Pointer to the OpenSSL SHA-512 context.
+  @param[in]       Data      Pointer to the buffer containing the data to be hashed.
+  @param[in]       DataSize  Size of Data buffer in bytes.
+
+  @retval TRUE   SHA-512 data digest succeeded.
+  @retval FALSE  SHA-512 data digest failed.
+
+**/
+STATIC
+BOOLEAN
+InternalSha512Update (
+  IN OUT  SHA512_CTX  *Context,
+  IN      CONST VOID  *Data,
+  IN      UINTN       DataSize
+  )
+{
+  CONST UINT8  *Buffer;
+  UINTN        Length;
+  UINTN        BlockCount;
+  UINT64       BitCountLow;
+
+  Buffer = Data;
+
+  //
+  // Complete the block left partially filled by the previous update first.
+  //
+  if ((Context->num != 0) && (DataSize != 0)) {
+    Length = MIN (DataSize, SHA512_BLOCK_SIZE - Context->num);
+    if (!SHA512_Update (Context, Buffer, Length)) {
+      return FALSE;
+    }
+
+    Buffer   += Length;
+    DataSize -= Length;
+  }
+
+  BlockCount = DataSize / SHA512_BLOCK_SIZE;
+  if ((BlockCount != 0) && Sha512ProcessBlocksAccel (Context->h, Buffer, BlockCount)) {
+    Length = BlockCount * SHA512_BLOCK_SIZE;
+
+    //
+    // Account for the blocks in the message bit count, as SHA512_Update() does.
+    //
+    BitCountLow = Context->Nl + LShiftU64 (Length, 3);
+    if (BitCountLow < Context->Nl) {
+      Context->Nh++;
+    }
+
+    Context->Nh += RShiftU64 (Length, 61);
+    Context->Nl  = BitCountLow;
+
+    Buffer   += Length;
+    DataSize -= Length;
+  }
+
+  return (BOOLEAN)(SHA512_Update (Context, Buffer, DataSize));
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
 
@@ -135,7 +202,7 @@ Sha384Update (
   //
   // OpenSSL SHA-384 Hash Update
   //
-  return (BOOLEAN)(SHA384_Update ((SHA512_CTX *)Sha384Context, Data, DataSize));
+  return InternalSha512Update ((SHA512_CTX *)Sha384Context, Data, DataSize);
 }
 
 /**
@@ -224,7 +291,7 @@ Sha384HashAll (
     return FALSE;
   }
 
-  if (!SHA384_Update (&Context, Data, DataSize)) {
+  if (!InternalSha512Update (&Context, Data, DataSize)) {
     return FALSE;
   }
 
@@ -361,7 +428,7 @@ Sha512Update (
   //
   // OpenSSL SHA-512 Hash Update
   //
-  return (BOOLEAN)(SHA512_Update ((SHA512_CTX *)Sha512Context, Data, DataSize));
+  return InternalSha512Update ((SHA512_CTX *)Sha512Context, Data, DataSize);
 }
 
 /**
@@ -450,7 +517,7 @@ Sha512HashAll (
     return FALSE;
   }
 
-  if (!SHA512_Update (&Context, Data, DataSize)) {
+  if (!InternalSha512Update (&Context, Data, DataSize)) {
     return FALSE;
   }
 
@@ -0,0 +1,61 @@
+/** @file
+  SHA-256 and SHA-512 block functions accelerated with processor extensions.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CRYPT_SHA_ACCEL_H__
+#define __CRYPT_SHA_ACCEL_H__
+
+#include "InternalCryptLib.h"
+
+#define SHA256_BLOCK_SIZE  64
+#define SHA512_BLOCK_SIZE  128
+
+/**
+  Processes whole SHA-256 blocks with the fastest block function supported
+  by the processor.
+
+  The State is updated in place, the message bit count is left to the caller.
+
+  @param[in, out]  State       Pointer to the eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+  @retval TRUE   The blocks were processed.
+  @retval FALSE  No accelerated block function is available. The State is
+                 not modified.
+
+**/
+BOOLEAN
+Sha256ProcessBlocksAccel (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  Processes whole SHA-512 (and SHA-384) blocks with the fastest block
+  function supported by the processor.
+
+  The State is updated in place, the message bit count is left to the caller.
+
+  @param[in, out]  State       Pointer to the eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 128-byte blocks in Data.
+
+  @retval TRUE   The blocks were processed.
+  @retval FALSE  No accelerated block function is available. The State is
+                 not modified.
+
+**/
+BOOLEAN
+Sha512ProcessBlocksAccel (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+#endif
@@ -0,0 +1,54 @@
+/** @file
+  SHA-256 and SHA-512 accelerated block functions NULL instance.
+
+  The portable OpenSSL block functions are used on the architectures and in
+  the library instances without an accelerated implementation.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "CryptShaAccel.h"
+
+/**
+  Processes whole SHA-256 blocks with the fastest block function supported
+  by the processor.
+
+  @param[in, out]  State       Pointer to the eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+  @retval FALSE  No accelerated block function is available.
+
+**/
+BOOLEAN
+Sha256ProcessBlocksAccel (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  return FALSE;
+}
+
+/**
+  Processes whole SHA-512 (and SHA-384) blocks with the fastest block
+  function supported by the processor.
+
+  @param[in, out]  State       Pointer to the eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 128-byte blocks in Data.
+
+  @retval FALSE  No accelerated block function is available.
+
+**/
+BOOLEAN
+Sha512ProcessBlocksAccel (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  return FALSE;
+}
@@ -0,0 +1,317 @@
+/** @file
+  SHA-256 and SHA-512 accelerated block functions for X64.
+
+  The SHA extensions are used for SHA-256 when present, and AVX2 with BMI2
+  otherwise. The SHA extensions have no SHA-512 instructions, so SHA-512 and
+  SHA-384 use AVX2 with BMI2 only.
+
+  When SHA_ACCEL_NO_AVX2 is defined, the AVX2 block functions are not used.
+  This is the case in SMM, where the SMI entry saves the XMM registers used
+  by the SHA extensions but not the upper halves of the YMM registers.
+
+  When SHA_ACCEL_HOST is defined, the processor is queried with the compiler
+  intrinsics instead of BaseLib. The BaseLib instance of the host based unit
+  tests reports fixed CPUID values and has no AsmXGetBv (), which would keep
+  the tests on the portable block functions.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../CryptShaAccel.h"
+#include <Register/Intel/Cpuid.h>
+
+#ifdef SHA_ACCEL_HOST
+  #if defined (_MSC_VER)
+    #include <intrin.h>
+  #else
+    #include <cpuid.h>
+  #endif
+#endif
+
+//
+// The block functions use the Microsoft x64 calling convention. EFIAPI only
+// selects it on GCC and clang through the tool chain flags, which a host
+// build is not required to use, so it is requested explicitly.
+//
+#if defined (__GNUC__) || defined (__clang__)
+#define SHA_ACCEL_API  __attribute__((ms_abi))
+#else
+#define SHA_ACCEL_API
+#endif
+
+#define SHA_ACCEL_DETECTED  BIT0
+#define SHA_ACCEL_SHA_NI    BIT1
+#define SHA_ACCEL_AVX2      BIT2
+
+//
+// Processor features used by the block functions. They are detected on the
+// first use and cached, as CPUID may trap to the hypervisor in a virtual
+// machine. The cache is simply not kept when the module runs from flash.
+//
+STATIC UINT32  mShaAccelFeatures = 0;
+
+/**
+  SHA-256 block function using the SHA extensions.
+
+  @param[in, out]  State       Pointer to the eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+VOID
+SHA_ACCEL_API
+Sha256ProcessBlocksShaNi (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+#ifndef SHA_ACCEL_NO_AVX2
+
+/**
+  SHA-256 block function using AVX2 and BMI2.
+
+  @param[in, out]  State       Pointer to the eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+VOID
+SHA_ACCEL_API
+Sha256ProcessBlocksAvx2 (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+/**
+  SHA-512 block function using AVX2 and BMI2.
+
+  @param[in, out]  State       Pointer to the eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 128-byte blocks in Data.
+
+**/
+VOID
+SHA_ACCEL_API
+Sha512ProcessBlocksAvx2 (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  );
+
+#endif
+
+/**
+  Reads a CPUID leaf.
+
+  @param[in]   Index     The CPUID leaf.
+  @param[in]   SubIndex  The CPUID sub-leaf.
+  @param[out]  Eax       The EAX value of the leaf. Optional.
+  @param[out]  Ebx       The EBX value of the leaf. Optional.
+  @param[out]  Ecx       The ECX value of the leaf. Optional.
+
+**/
+STATIC
+VOID
+ShaAccelCpuid (
+  IN  UINT32  Index,
+  IN  UINT32  SubIndex,
+  OUT UINT32  *Eax  OPTIONAL,
+  OUT UINT32  *Ebx  OPTIONAL,
+  OUT UINT32  *Ecx  OPTIONAL
+  )
+{
+ #ifdef SHA_ACCEL_HOST
+  UINT32  Registers[4];
+
+  #if defined (_MSC_VER)
+  __cpuidex ((int *)Registers, (int)Index, (int)SubIndex);
+  #else
+  __cpuid_count (Index, SubIndex, Registers[0], Registers[1], Registers[2], Registers[3]);
+  #endif
+
+  if (Eax != NULL) {
+    *Eax = Registers[0];
+  }
+
+  if (Ebx != NULL) {
+    *Ebx = Registers[1];
+  }
+
+  if (Ecx != NULL) {
+    *Ecx = Registers[2];
+  }
+
+ #else
+  AsmCpuidEx (Index, SubIndex, Eax, Ebx, Ecx, NULL);
+ #endif
+}
+
+#ifndef SHA_ACCEL_NO_AVX2
+
+/**
+  Reads an extended control register.
+
+  @param[in]  Index  The extended control register to read.
+
+  @return The value of the extended control register.
+
+**/
+STATIC
+UINT64
+ShaAccelXGetBv (
+  IN UINT32  Index
+  )
+{
+ #ifdef SHA_ACCEL_HOST
+  #if defined (_MSC_VER)
+  return _xgetbv (Index);
+  #else
+  UINT32  Low;
+  UINT32  High;
+
+  __asm__ __volatile__ ("xgetbv" : "=a" (Low), "=d" (High) : "c" (Index));
+  return LShiftU64 (High, 32) | Low;
+  #endif
+ #else
+  return AsmXGetBv (Index);
+ #endif
+}
+
+#endif
+
+/**
+  Detects the processor features used by the block functions.
+
+  @return The SHA_ACCEL_* flags of the supported block functions.
+
+**/
+STATIC
+UINT32
+ShaAccelGetFeatures (
+  VOID
+  )
+{
+  UINT32                                       MaxLeaf;
+  CPUID_VERSION_INFO_ECX                       VersionEcx;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EBX  ExtendedEbx;
+  UINT32                                       Features;
+
+  if (mShaAccelFeatures != 0) {
+    return mShaAccelFeatures;
+  }
+
+  Features = SHA_ACCEL_DETECTED;
+
+  ShaAccelCpuid (CPUID_SIGNATURE, 0, &MaxLeaf, NULL, NULL);
+  if (MaxLeaf >= CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+    ShaAccelCpuid (CPUID_VERSION_INFO, 0, NULL, NULL, &VersionEcx.Uint32);
+    ShaAccelCpuid (
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS,
+      CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_SUB_LEAF_INFO,
+      NULL,
+      &ExtendedEbx.Uint32,
+      NULL
+      );
+
+    if ((ExtendedEbx.Bits.SHA != 0) &&
+        (VersionEcx.Bits.SSSE3 != 0) &&
+        (VersionEcx.Bits.SSE4_1 != 0))
+    {
+      Features |= SHA_ACCEL_SHA_NI;
+    }
+
+ #ifndef SHA_ACCEL_NO_AVX2
+    //
+    // AVX2 also needs the OS to have enabled the SSE and AVX states in XCR0.
+    //
+    if ((ExtendedEbx.Bits.AVX2 != 0) &&
+        (ExtendedEbx.Bits.BMI2 != 0) &&
+        (VersionEcx.Bits.AVX != 0) &&
+        (VersionEcx.Bits.OSXSAVE != 0) &&
+        ((ShaAccelXGetBv (0) & (BIT1 | BIT2)) == (BIT1 | BIT2)))
+    {
+      Features |= SHA_ACCEL_AVX2;
+    }
+
+ #endif
+  }
+
+  mShaAccelFeatures = Features;
+  return Features;
+}
+
+/**
+  Processes whole SHA-256 blocks with the fastest block function supported
+  by the processor.
+
+  The State is updated in place, the message bit count is left to the caller.
+
+  @param[in, out]  State       Pointer to the eight SHA-256 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+  @retval TRUE   The blocks were processed.
+  @retval FALSE  No accelerated block function is available. The State is
+                 not modified.
+
+**/
+BOOLEAN
+Sha256ProcessBlocksAccel (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  UINT32  Features;
+
+  Features = ShaAccelGetFeatures ();
+  if ((Features & SHA_ACCEL_SHA_NI) != 0) {
+    Sha256ProcessBlocksShaNi (State, Data, BlockCount);
+    return TRUE;
+  }
+
+  if ((Features & SHA_ACCEL_AVX2) != 0) {
+ #ifndef SHA_ACCEL_NO_AVX2
+    Sha256ProcessBlocksAvx2 (State, Data, BlockCount);
+    return TRUE;
+ #endif
+  }
+
+  return FALSE;
+}
+
+/**
+  Processes whole SHA-512 (and SHA-384) blocks with the fastest block
+  function supported by the processor.
+
+  The State is updated in place, the message bit count is left to the caller.
+
+  @param[in, out]  State       Pointer to the eight SHA-512 state words.
+  @param[in]       Data        Pointer to the blocks to process.
+  @param[in]       BlockCount  Number of 128-byte blocks in Data.
+
+  @retval TRUE   The blocks were processed.
+  @retval FALSE  No accelerated block function is available. The State is
+                 not modified.
+
+**/
+BOOLEAN
+Sha512ProcessBlocksAccel (
+  IN OUT UINT64       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  if ((ShaAccelGetFeatures () & SHA_ACCEL_AVX2) != 0) {
+ #ifndef SHA_ACCEL_NO_AVX2
+    Sha512ProcessBlocksAvx2 (State, Data, BlockCount);
+    return TRUE;
+ #endif
+  }
+
+  return FALSE;
+}
@@ -0,0 +1,229 @@
+/** @file
+  Application for Hash Primitives Throughput Measurement.
+
+  The digests of a long message are checked, as computed in one call and in
+  updates of odd sizes, and the throughput of the digest computation is
+  reported when the platform has a timer.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TestBaseCryptLib.h"
+
+//
+// The long message of the NIST examples: one million repetitions of 'a'.
+//
+#define HASH_PERF_DATA_SIZE   1000000
+#define HASH_PERF_DATA_BYTE   'a'
+#define HASH_PERF_ITERATIONS  16
+
+#define HASH_PERF_MAX_DIGEST_SIZE  SHA512_DIGEST_SIZE
+
+//
+// Result for SHA-256 of the long message. (From "B.3 SHA-256 Example" of NIST FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  mSha256LongDigest[SHA256_DIGEST_SIZE] = {
+  0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+  0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+};
+
+//
+// Result for SHA-384 of the long message. (From "D.3 SHA-384 Example" of NIST FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  mSha384LongDigest[SHA384_DIGEST_SIZE] = {
+  0x9d, 0x0e, 0x18, 0x09, 0x71, 0x64, 0x74, 0xcb, 0x08, 0x6e, 0x83, 0x4e, 0x31, 0x0a, 0x4a, 0x1c,
+  0xed, 0x14, 0x9e, 0x9c, 0x00, 0xf2, 0x48, 0x52, 0x79, 0x72, 0xce, 0xc5, 0x70, 0x4c, 0x2a, 0x5b,
+  0x07, 0xb8, 0xb3, 0xdc, 0x38, 0xec, 0xc4, 0xeb, 0xae, 0x97, 0xdd, 0xd8, 0x7f, 0x3d, 0x89, 0x85
+};
+
+//
+// Result for SHA-512 of the long message. (From "C.3 SHA-512 Example" of NIST FIPS 180-2)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  mSha512LongDigest[SHA512_DIGEST_SIZE] = {
+  0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7, 0xbc, 0x15, 0xb4, 0x63,
+  0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28, 0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb,
+  0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
+  0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b
+};
+
+//
+// Sizes of the successive updates, chosen to split the message at every
+// offset within the blocks.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINTN  mHashPerfUpdateSizes[] = {
+  1, 63, 64, 65, 127, 128, 129, 255, 1000, 4093, 8192, 65537
+};
+
+typedef
+UINTN
+(EFIAPI *HASH_PERF_GET_CONTEXT_SIZE)(
+  VOID
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_PERF_INIT)(
+  OUT  VOID  *HashContext
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_PERF_UPDATE)(
+  IN OUT  VOID        *HashContext,
+  IN      CONST VOID  *Data,
+  IN      UINTN       DataSize
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_PERF_FINAL)(
+  IN OUT  VOID   *HashContext,
+  OUT     UINT8  *HashValue
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_PERF_ALL)(
+  IN   CONST VOID  *Data,
+  IN   UINTN       DataSize,
+  OUT  UINT8       *HashValue
+  );
+
+typedef struct {
+  CONST CHAR8                   *Name;
+  UINT32                        DigestSize;
+  HASH_PERF_GET_CONTEXT_SIZE    GetContextSize;
+  HASH_PERF_INIT                HashInit;
+  HASH_PERF_UPDATE              HashUpdate;
+  HASH_PERF_FINAL               HashFinal;
+  HASH_PERF_ALL                 HashAll;
+  CONST UINT8                   *Digest;
+  UINT8                         *Data;
+  VOID                          *HashCtx;
+} HASH_PERF_TEST_CONTEXT;
+
+HASH_PERF_TEST_CONTEXT  mSha256PerfTestCtx = { "SHA-256", SHA256_DIGEST_SIZE, Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll, mSha256LongDigest };
+HASH_PERF_TEST_CONTEXT  mSha384PerfTestCtx = { "SHA-384", SHA384_DIGEST_SIZE, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll, mSha384LongDigest };
+HASH_PERF_TEST_CONTEXT  mSha512PerfTestCtx = { "SHA-512", SHA512_DIGEST_SIZE, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll, mSha512LongDigest };
+
+UNIT_TEST_STATUS
+EFIAPI
+TestHashPerformancePreReq (
+  UNIT_TEST_CONTEXT  Context
+  )
+{
+  HASH_PERF_TEST_CONTEXT  *PerfTestContext;
+
+  PerfTestContext          = Context;
+  PerfTestContext->Data    = AllocatePool (HASH_PERF_DATA_SIZE);
+  PerfTestContext->HashCtx = AllocatePool (PerfTestContext->GetContextSize ());
+  if ((PerfTestContext->Data == NULL) || (PerfTestContext->HashCtx == NULL)) {
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  SetMem (PerfTestContext->Data, HASH_PERF_DATA_SIZE, HASH_PERF_DATA_BYTE);
+  return UNIT_TEST_PASSED;
+}
+
+VOID
+EFIAPI
+TestHashPerformanceCleanUp (
+  UNIT_TEST_CONTEXT  Context
+  )
+{
+  HASH_PERF_TEST_CONTEXT  *PerfTestContext;
+
+  PerfTestContext = Context;
+  if (PerfTestContext->Data != NULL) {
+    FreePool (PerfTestContext->Data);
+    PerfTestContext->Data = NULL;
+  }
+
+  if (PerfTestContext->HashCtx != NULL) {
+    FreePool (PerfTestContext->HashCtx);
+    PerfTestContext->HashCtx = NULL;
+  }
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+TestHashPerformance (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HASH_PERF_TEST_CONTEXT  *PerfTestContext;
+  UINT8                   Digest[HASH_PERF_MAX_DIGEST_SIZE];
+  UINTN                   Offset;
+  UINTN                   Length;
+  UINTN                   Index;
+  UINT64                  Start;
+  UINT64                  Nanoseconds;
+  BOOLEAN                 Status;
+
+  PerfTestContext = Context;
+
+  //
+  // The digest of the whole message in one call.
+  //
+  ZeroMem (Digest, sizeof (Digest));
+  Status = PerfTestContext->HashAll (PerfTestContext->Data, HASH_PERF_DATA_SIZE, Digest);
+  UT_ASSERT_TRUE (Status);
+  UT_ASSERT_MEM_EQUAL (Digest, PerfTestContext->Digest, PerfTestContext->DigestSize);
+
+  //
+  // The digest of the message in updates that start and end anywhere in
+  // the blocks.
+  //
+  Status = PerfTestContext->HashInit (PerfTestContext->HashCtx);
+  UT_ASSERT_TRUE (Status);
+
+  Offset = 0;
+  Index  = 0;
+  while (Offset < HASH_PERF_DATA_SIZE) {
+    Length = MIN (mHashPerfUpdateSizes[Index], HASH_PERF_DATA_SIZE - Offset);
+    Status = PerfTestContext->HashUpdate (PerfTestContext->HashCtx, PerfTestContext->Data + Offset, Length);
+    UT_ASSERT_TRUE (Status);
+    Offset += Length;
+    Index   = (Index + 1) % ARRAY_SIZE (mHashPerfUpdateSizes);
+  }
+
+  ZeroMem (Digest, sizeof (Digest));
+  Status = PerfTestContext->HashFinal (PerfTestContext->HashCtx, Digest);
+  UT_ASSERT_TRUE (Status);
+  UT_ASSERT_MEM_EQUAL (Digest, PerfTestContext->Digest, PerfTestContext->DigestSize);
+
+  //
+  // The throughput of the digest computation.
+  //
+  Start = GetHashPerformanceTime ();
+  for (Index = 0; Index < HASH_PERF_ITERATIONS; Index++) {
+    Status = PerfTestContext->HashAll (PerfTestContext->Data, HASH_PERF_DATA_SIZE, Digest);
+    UT_ASSERT_TRUE (Status);
+  }
+
+  Nanoseconds = GetHashPerformanceTime () - Start;
+  if (Nanoseconds == 0) {
+    UT_LOG_INFO ("%a: no timer, throughput not measured\n", PerfTestContext->Name);
+  } else {
+    UT_LOG_INFO (
+      "%a: %ld MB/s\n",
+      PerfTestContext->Name,
+      DivU64x64Remainder (MultU64x32 (HASH_PERF_DATA_SIZE * HASH_PERF_ITERATIONS, 1000), Nanoseconds, NULL)
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+TEST_DESC  mHashPerformanceTest[] = {
+  //
+  // -----Description-------------------------Class----------------------------------Function-------------Pre------------------------Post------------------------Context
+  //
+  { "TestHashPerformanceSha256()", "CryptoPkg.BaseCryptLib.HashPerformance", TestHashPerformance, TestHashPerformancePreReq, TestHashPerformanceCleanUp, &mSha256PerfTestCtx },
+  { "TestHashPerformanceSha384()", "CryptoPkg.BaseCryptLib.HashPerformance", TestHashPerformance, TestHashPerformancePreReq, TestHashPerformanceCleanUp, &mSha384PerfTestCtx },
+  { "TestHashPerformanceSha512()", "CryptoPkg.BaseCryptLib.HashPerformance", TestHashPerformance, TestHashPerformancePreReq, TestHashPerformanceCleanUp, &mSha512PerfTestCtx },
+};
+
+UINTN  mHashPerformanceTestNum = ARRAY_SIZE (mHashPerformanceTest);
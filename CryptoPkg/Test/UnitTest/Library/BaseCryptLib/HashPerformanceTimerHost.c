@@ -0,0 +1,34 @@
+/** @file
+  Timer of the hash throughput measurement for host based unit tests.
+
+  The TimerLib instance of the host builds is a null template, so the time
+  comes from the C library.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <time.h>
+#include "TestBaseCryptLib.h"
+
+/**
+  Get the current time of the timer used to measure the hash throughput.
+
+  @return The time in nanoseconds, or 0 if there is no timer.
+
+**/
+UINT64
+GetHashPerformanceTime (
+  VOID
+  )
+{
+  clock_t  Clock;
+
+  Clock = clock ();
+  if (Clock == (clock_t)-1) {
+    return 0;
+  }
+
+  return DivU64x32 (MultU64x32 ((UINT64)Clock, 1000000000), (UINT32)CLOCKS_PER_SEC);
+}
@@ -0,0 +1,30 @@
+/** @file
+  Timer of the hash throughput measurement for the UEFI Shell unit tests.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TestBaseCryptLib.h"
+#include <Library/TimerLib.h>
+
+/**
+  Get the current time of the timer used to measure the hash throughput.
+
+  @return The time in nanoseconds, or 0 if there is no timer.
+
+**/
+UINT64
+GetHashPerformanceTime (
+  VOID
+  )
+{
+  UINT64  Counter;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+
+  Counter = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  return GetTimeInNanoSecond ((CounterStart > CounterEnd) ? (CounterStart - Counter) : (Counter - CounterStart));
+}
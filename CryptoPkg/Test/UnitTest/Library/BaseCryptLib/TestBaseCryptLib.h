@@ -50,6 +50,9 @@ extern TEST_DESC  mPkcs7EkuTest[];
 extern UINTN      mHashTestNum;
 extern TEST_DESC  mHashTest[];
 
+extern UINTN      mHashPerformanceTestNum;
+extern TEST_DESC  mHashPerformanceTest[];
+
 extern UINTN      mHmacTestNum;
 extern TEST_DESC  mHmacTest[];
 
@@ -134,4 +137,15 @@ ValidateCryptPrng (
   VOID
   );
 
+/**
+  Get the current time of the timer used to measure the hash throughput.
+
+  @return The time in nanoseconds, or 0 if there is no timer.
+
+**/
+UINT64
+GetHashPerformanceTime (
+  VOID
+  );
+
 #endif
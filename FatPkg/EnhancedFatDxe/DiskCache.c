@@ -208,6 +208,91 @@ CacheFatDiskIo (
   return Status;
 }
 
+/**
+  Returns the address of the cache page held by a cache tag.
+
+  @param  DiskCache             - The disk cache.
+  @param  CacheTag              - A cache tag of DiskCache.
+
+  @return The address of the cache page.
+
+**/
+STATIC
+UINT8 *
+FatCachePageAddress (
+  IN DISK_CACHE  *DiskCache,
+  IN CACHE_TAG   *CacheTag
+  )
+{
+  return DiskCache->CacheBase + ((UINTN)(CacheTag - DiskCache->CacheTag) << DiskCache->PageAlignment);
+}
+
+/**
+  Looks up a page in the disk cache.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - The page to look up.
+
+  @return The cache tag holding PageNo, or NULL if the page is not cached.
+
+**/
+STATIC
+CACHE_TAG *
+FatFindCacheTag (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo
+  )
+{
+  CACHE_TAG  *CacheTag;
+  UINTN      Index;
+
+  CacheTag = &DiskCache->CacheTag[(PageNo & DiskCache->GroupMask) * DiskCache->GroupSize];
+  for (Index = 0; Index < DiskCache->GroupSize; Index++, CacheTag++) {
+    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) {
+      return CacheTag;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Selects the cache tag to replace when a page is loaded into the cache:
+  an unused tag of the group of the page if any, else the least recently
+  used tag of the group.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - The page to load.
+
+  @return The cache tag to replace.
+
+**/
+STATIC
+CACHE_TAG *
+FatGetVictimCacheTag (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo
+  )
+{
+  CACHE_TAG  *CacheTag;
+  CACHE_TAG  *Victim;
+  UINTN      Index;
+
+  CacheTag = &DiskCache->CacheTag[(PageNo & DiskCache->GroupMask) * DiskCache->GroupSize];
+  Victim   = CacheTag;
+  for (Index = 0; Index < DiskCache->GroupSize; Index++, CacheTag++) {
+    if (CacheTag->RealSize == 0) {
+      return CacheTag;
+    }
+
+    if (CacheTag->LastAccess < Victim->LastAccess) {
+      Victim = CacheTag;
+    }
+  }
+
+  return Victim;
+}
+
 /**
 
   This function is used by the Data Cache.
@@ -238,24 +323,18 @@ FatFlushDataCacheRange (
   )
 {
   UINTN       PageNo;
-  UINTN       GroupNo;
-  UINTN       GroupMask;
   UINTN       PageSize;
   UINT8       PageAlignment;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINT8       *BaseAddress;
 
   DiskCache     = &Volume->DiskCache[CacheData];
-  BaseAddress   = DiskCache->CacheBase;
-  GroupMask     = DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
   PageSize      = (UINTN)1 << PageAlignment;
 
   for (PageNo = StartPageNo; PageNo < EndPageNo; PageNo++) {
-    GroupNo  = PageNo & GroupMask;
-    CacheTag = &DiskCache->CacheTag[GroupNo];
-    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) {
+    CacheTag = FatFindCacheTag (DiskCache, PageNo);
+    if (CacheTag != NULL) {
       //
       // When reading data from disk directly, if some dirty data
       // in cache is in this range, this data in the Buffer needs to
@@ -265,7 +344,7 @@ FatFlushDataCacheRange (
         if (CacheTag->Dirty) {
           CopyMem (
             Buffer + ((PageNo - StartPageNo) << PageAlignment),
-            BaseAddress + (GroupNo << PageAlignment),
+            FatCachePageAddress (DiskCache, CacheTag),
             PageSize
             );
         }
@@ -304,7 +383,6 @@ FatExchangeCachePage (
   )
 {
   EFI_STATUS  Status;
-  UINTN       GroupNo;
   UINTN       PageNo;
   UINTN       WriteCount;
   UINTN       RealSize;
@@ -316,9 +394,8 @@ FatExchangeCachePage (
 
   DiskCache     = &Volume->DiskCache[DataType];
   PageNo        = CacheTag->PageNo;
-  GroupNo       = PageNo & DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
-  PageAddress   = DiskCache->CacheBase + (GroupNo << PageAlignment);
+  PageAddress   = FatCachePageAddress (DiskCache, CacheTag);
   EntryPos      = (DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment));
   RealSize      = CacheTag->RealSize;
   if (IoMode == ReadDisk) {
@@ -352,10 +429,100 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Load the page after a sequential miss and the pages that follow it into
+  the cache with a single disk read. The pages that are already cached are
+  kept as they are, since they may hold dirty data.
+
+  @param  Volume                - FAT file system volume.
+  @param  CacheDataType         - The cache type: CACHE_FAT or CACHE_DATA.
+  @param  PageNo                - The first page to load. It is not cached.
+  @param  PageCount             - The number of pages to load.
+  @param  CacheTag              - The Cache Tag of PageNo.
+
+  @retval EFI_SUCCESS           - The pages are loaded successfully.
+  @return other                 - An error occurred when accessing data.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadCachePages (
+  IN  FAT_VOLUME       *Volume,
+  IN  CACHE_DATA_TYPE  CacheDataType,
+  IN  UINTN            PageNo,
+  IN  UINTN            PageCount,
+  OUT CACHE_TAG        **CacheTag
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *Victim;
+  UINT64      EntryPos;
+  UINT64      MaxSize;
+  UINTN       ReadSize;
+  UINTN       Index;
+  UINTN       Offset;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheDataType];
+  PageAlignment = DiskCache->PageAlignment;
+  EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  ReadSize      = PageCount << PageAlignment;
+  MaxSize       = DiskCache->LimitAddress - EntryPos;
+  if (MaxSize < ReadSize) {
+    ReadSize = (UINTN)MaxSize;
+  }
+
+  Status = FatDiskIo (Volume, ReadDisk, EntryPos, ReadSize, DiskCache->ReadAheadBuffer, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // PageCount does not exceed the number of groups, so every page goes to a
+  // different group and none of them replaces another one.
+  //
+  *CacheTag = NULL;
+  for (Index = 0, Offset = 0; Offset < ReadSize; Index++, Offset += (UINTN)1 << PageAlignment) {
+    if ((Index > 0) && (FatFindCacheTag (DiskCache, PageNo + Index) != NULL)) {
+      continue;
+    }
+
+    Victim = FatGetVictimCacheTag (DiskCache, PageNo + Index);
+    if ((Victim->RealSize > 0) && Victim->Dirty) {
+      Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, Victim, NULL);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    Victim->PageNo   = PageNo + Index;
+    Victim->RealSize = MIN ((UINTN)1 << PageAlignment, ReadSize - Offset);
+    CopyMem (FatCachePageAddress (DiskCache, Victim), DiskCache->ReadAheadBuffer + Offset, Victim->RealSize);
+    ClearCacheTagDirtyState (Victim);
+    if (Index == 0) {
+      *CacheTag = Victim;
+    } else {
+      //
+      // Pages that were read ahead are replaced before the pages in use.
+      //
+      Victim->LastAccess = 0;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Get one cache page by specified PageNo.
 
+  On a miss, the least recently used page of the group of PageNo is replaced.
+  If the miss is the second one in a row on the page that follows the pages
+  of a recent miss, the access is sequential, and the pages that follow
+  PageNo are read ahead.
+
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The cache type: CACHE_FAT or CACHE_DATA.
   @param  PageNo                - PageNo to match with the cache.
@@ -368,40 +535,80 @@ FatExchangeCachePage (
 STATIC
 EFI_STATUS
 FatGetCachePage (
-  IN FAT_VOLUME       *Volume,
-  IN CACHE_DATA_TYPE  CacheDataType,
-  IN UINTN            PageNo,
-  IN CACHE_TAG        *CacheTag
+  IN  FAT_VOLUME       *Volume,
+  IN  CACHE_DATA_TYPE  CacheDataType,
+  IN  UINTN            PageNo,
+  OUT CACHE_TAG        **CacheTag
   )
 {
-  EFI_STATUS  Status;
-  UINTN       OldPageNo;
+  EFI_STATUS    Status;
+  DISK_CACHE    *DiskCache;
+  CACHE_TAG     *Tag;
+  UINTN         PageCount;
+  CACHE_STREAM  *Stream;
 
-  OldPageNo = CacheTag->PageNo;
-  if ((CacheTag->RealSize > 0) && (OldPageNo == PageNo)) {
+  DiskCache = &Volume->DiskCache[CacheDataType];
+  Tag       = FatFindCacheTag (DiskCache, PageNo);
+  if (Tag == NULL) {
     //
-    // Cache Hit occurred
+    // Track a few streams, so that other accesses between the accesses of a
+    // stream, such as to directory pages, do not hide that it is sequential.
     //
-    return EFI_SUCCESS;
-  }
+    // A single sequential miss, such as an access across a page boundary, is
+    // not enough to read ahead.
+    //
+    PageCount = 1;
+    for (Stream = DiskCache->Stream; Stream < DiskCache->Stream + FAT_CACHE_STREAM_COUNT; Stream++) {
+      if (Stream->NextMissPageNo == PageNo) {
+        Stream->SequentialMisses++;
+        if (Stream->SequentialMisses > 1) {
+          PageCount = DiskCache->ReadAheadPageCount;
+        }
 
-  //
-  // Write dirty cache page back to disk
-  //
-  if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
-    Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, NULL);
-    if (EFI_ERROR (Status)) {
-      return Status;
+        break;
+      }
     }
-  }
 
-  //
-  // Load new data from disk;
-  //
-  CacheTag->PageNo = PageNo;
-  Status           = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, CacheTag, NULL);
+    if (Stream == DiskCache->Stream + FAT_CACHE_STREAM_COUNT) {
+      Stream                   = &DiskCache->Stream[DiskCache->NextStream];
+      Stream->SequentialMisses = 0;
+      DiskCache->NextStream    = (DiskCache->NextStream + 1) % FAT_CACHE_STREAM_COUNT;
+    }
 
-  return Status;
+    Stream->NextMissPageNo = PageNo + PageCount;
+
+    if (PageCount > 1) {
+      Status = FatReadAheadCachePages (Volume, CacheDataType, PageNo, PageCount, &Tag);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    } else {
+      //
+      // Write dirty cache page back to disk
+      //
+      Tag = FatGetVictimCacheTag (DiskCache, PageNo);
+      if ((Tag->RealSize > 0) && Tag->Dirty) {
+        Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, Tag, NULL);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      }
+
+      //
+      // Load new data from disk;
+      //
+      Tag->PageNo = PageNo;
+      Status      = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, Tag, NULL);
+      if (EFI_ERROR (Status)) {
+        Tag->RealSize = 0;
+        return Status;
+      }
+    }
+  }
+
+  Tag->LastAccess = ++DiskCache->AccessCount;
+  *CacheTag       = Tag;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -438,14 +645,11 @@ FatAccessUnalignedCachePage (
   VOID        *Destination;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINTN       GroupNo;
 
   DiskCache = &Volume->DiskCache[CacheDataType];
-  GroupNo   = PageNo & DiskCache->GroupMask;
-  CacheTag  = &DiskCache->CacheTag[GroupNo];
-  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag);
+  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, &CacheTag);
   if (!EFI_ERROR (Status)) {
-    Source      = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + Offset;
+    Source      = FatCachePageAddress (DiskCache, CacheTag) + Offset;
     Destination = Buffer;
     if (IoMode != ReadDisk) {
       SetCacheTagDirty (DiskCache, CacheTag, Offset, Length);
@@ -599,8 +803,7 @@ FatVolumeFlushCache (
 {
   EFI_STATUS       Status;
   CACHE_DATA_TYPE  CacheDataType;
-  UINTN            GroupIndex;
-  UINTN            GroupMask;
+  UINTN            Index;
   DISK_CACHE       *DiskCache;
   CACHE_TAG        *CacheTag;
 
@@ -610,9 +813,8 @@ FatVolumeFlushCache (
       //
       // Data cache or fat cache is dirty, write the dirty data back
       //
-      GroupMask = DiskCache->GroupMask;
-      for (GroupIndex = 0; GroupIndex <= GroupMask; GroupIndex++) {
-        CacheTag = &DiskCache->CacheTag[GroupIndex];
+      for (Index = 0; Index < DiskCache->PageCount; Index++) {
+        CacheTag = &DiskCache->CacheTag[Index];
         if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
           //
           // Write back all Dirty Data Cache Page to disk
@@ -635,6 +837,45 @@ FatVolumeFlushCache (
   return Status;
 }
 
+/**
+
+  Set the geometry of a disk cache. The page count and the group size are
+  rounded down to powers of two, and the read ahead page count is limited to
+  the number of groups.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageCount             - The number of pages of the cache.
+  @param  GroupSize             - The number of pages of a group.
+  @param  ReadAheadPageCount    - The number of pages to read on a sequential miss.
+
+**/
+STATIC
+VOID
+FatSetDiskCacheGeometry (
+  OUT DISK_CACHE  *DiskCache,
+  IN  UINTN       PageCount,
+  IN  UINTN       GroupSize,
+  IN  UINTN       ReadAheadPageCount
+  )
+{
+  UINTN  GroupCount;
+  UINTN  Stream;
+
+  PageCount  = (UINTN)GetPowerOfTwo32 ((UINT32)MAX (PageCount, 1));
+  GroupSize  = (UINTN)GetPowerOfTwo32 ((UINT32)MIN (MAX (GroupSize, 1), PageCount));
+  GroupCount = PageCount / GroupSize;
+
+  DiskCache->PageCount          = PageCount;
+  DiskCache->GroupSize          = GroupSize;
+  DiskCache->GroupMask          = GroupCount - 1;
+  DiskCache->ReadAheadPageCount = MIN (MAX (ReadAheadPageCount, 1), GroupCount);
+  DiskCache->NextStream         = 0;
+  for (Stream = 0; Stream < FAT_CACHE_STREAM_COUNT; Stream++) {
+    DiskCache->Stream[Stream].NextMissPageNo   = MAX_UINTN;
+    DiskCache->Stream[Stream].SequentialMisses = 0;
+  }
+}
+
 /**
 
   Initialize the disk cache according to Volume's FatType.
@@ -654,6 +895,8 @@ FatInitializeDiskCache (
   UINTN       FatCacheGroupCount;
   UINTN       DataCacheSize;
   UINTN       FatCacheSize;
+  UINTN       ReadAheadSize;
+  UINTN       TagSize;
   UINT8       *CacheBuffer;
 
   DiskCache = Volume->DiskCache;
@@ -670,25 +913,45 @@ FatInitializeDiskCache (
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
   }
 
-  DiskCache[CacheData].GroupMask    = FAT_DATACACHE_GROUP_COUNT - 1;
+  FatSetDiskCacheGeometry (
+    &DiskCache[CacheData],
+    PcdGet32 (PcdFatDataCachePageCount),
+    PcdGet32 (PcdFatCacheGroupSize),
+    PcdGet32 (PcdFatCacheReadAheadPageCount)
+    );
+  FatSetDiskCacheGeometry (
+    &DiskCache[CacheFat],
+    FatCacheGroupCount,
+    PcdGet32 (PcdFatCacheGroupSize),
+    PcdGet32 (PcdFatCacheReadAheadPageCount)
+    );
+
   DiskCache[CacheData].BaseAddress  = Volume->RootPos;
   DiskCache[CacheData].LimitAddress = Volume->VolumeSize;
-  DiskCache[CacheFat].GroupMask     = FatCacheGroupCount - 1;
   DiskCache[CacheFat].BaseAddress   = Volume->FatPos;
   DiskCache[CacheFat].LimitAddress  = Volume->FatPos + Volume->FatSize;
-  FatCacheSize                      = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                     = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
+  FatCacheSize                      = DiskCache[CacheFat].PageCount << DiskCache[CacheFat].PageAlignment;
+  DataCacheSize                     = DiskCache[CacheData].PageCount << DiskCache[CacheData].PageAlignment;
+  ReadAheadSize                     = MAX (
+                                        DiskCache[CacheFat].ReadAheadPageCount << DiskCache[CacheFat].PageAlignment,
+                                        DiskCache[CacheData].ReadAheadPageCount << DiskCache[CacheData].PageAlignment
+                                        );
+  TagSize = (DiskCache[CacheFat].PageCount + DiskCache[CacheData].PageCount) * sizeof (CACHE_TAG);
   //
-  // Allocate the Fat Cache buffer
+  // Allocate the Fat Cache buffer, the read ahead buffer, and the cache tags
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
+  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize + ReadAheadSize + TagSize);
   if (CacheBuffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Volume->CacheBuffer            = CacheBuffer;
-  DiskCache[CacheFat].CacheBase  = CacheBuffer;
-  DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+  Volume->CacheBuffer                  = CacheBuffer;
+  DiskCache[CacheFat].CacheBase        = CacheBuffer;
+  DiskCache[CacheData].CacheBase       = CacheBuffer + FatCacheSize;
+  DiskCache[CacheFat].ReadAheadBuffer  = CacheBuffer + FatCacheSize + DataCacheSize;
+  DiskCache[CacheData].ReadAheadBuffer = DiskCache[CacheFat].ReadAheadBuffer;
+  DiskCache[CacheFat].CacheTag         = (CACHE_TAG *)(DiskCache[CacheFat].ReadAheadBuffer + ReadAheadSize);
+  DiskCache[CacheData].CacheTag        = DiskCache[CacheFat].CacheTag + DiskCache[CacheFat].PageCount;
 
   DiskCache[CacheFat].BlockSize  = Volume->BlockIo->Media->BlockSize;
   DiskCache[CacheData].BlockSize = Volume->BlockIo->Media->BlockSize;
@@ -75,14 +75,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Minimum fat page size is 8K, maximum fat page alignment is 32K
 // Minimum data page size is 8K, maximum fat page alignment is 64K
+// The number of data cache pages, the number of pages per cache group and
+// the number of pages read ahead are set by PCDs.
 //
 #define FAT_FATCACHE_PAGE_MIN_ALIGNMENT   13
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
+#define FAT_CACHE_STREAM_COUNT            4
 
 // For cache block bits, use a UINT64
 typedef UINT64 DIRTY_BLOCKS;
@@ -158,26 +160,49 @@ typedef enum {
 typedef struct {
   UINTN           PageNo;
   UINTN           RealSize;
+  UINT64          LastAccess;   // Value of DiskCache->AccessCount at the last access, for LRU
   BOOLEAN         Dirty;
   DIRTY_BLOCKS    DirtyBlocks[DIRTY_BLOCKS_SIZE];
 } CACHE_TAG;
 
+//
+// Sequential access stream of a disk cache
+//
+typedef struct {
+  UINTN    NextMissPageNo;   // Page of the next miss if the access is sequential
+  UINTN    SequentialMisses; // Number of sequential misses in a row
+} CACHE_STREAM;
+
+//
+// The disk cache is set associative: a page can only be cached in one of the
+// GroupSize tags of group (PageNo & GroupMask), and the least recently used
+// tag of the group is replaced on a miss. CacheTag[Index] holds the page at
+// CacheBase + (Index << PageAlignment).
+//
 typedef struct {
-  UINT64       BaseAddress;
-  UINT64       LimitAddress;
-  UINT8        *CacheBase;
-  UINT32       BlockSize;
-  BOOLEAN      Dirty;
-  UINT8        PageAlignment;
-  UINTN        GroupMask;
-  CACHE_TAG    CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  UINT64          BaseAddress;
+  UINT64          LimitAddress;
+  UINT8           *CacheBase;
+  UINT32          BlockSize;
+  BOOLEAN         Dirty;
+  UINT8           PageAlignment;
+  UINTN           GroupMask;
+  UINTN           GroupSize;          // Number of tags in a group
+  UINTN           PageCount;          // Number of tags in the cache
+  UINTN           ReadAheadPageCount; // Number of pages read on a sequential miss
+  UINTN           NextStream;         // Stream replaced by the next non sequential miss
+  CACHE_STREAM    Stream[FAT_CACHE_STREAM_COUNT];
+  UINT64          AccessCount;
+  UINT8           *ReadAheadBuffer;
+  CACHE_TAG       *CacheTag;
 } DISK_CACHE;
 
 //
-// Hash table size
+// Hash table size. The hash tables of a directory grow when the directory
+// has more entries than buckets, and shrink when it has less than an eighth.
 //
-#define HASH_TABLE_SIZE  0x400
-#define HASH_TABLE_MASK  (HASH_TABLE_SIZE - 1)
+#define HASH_TABLE_MIN_SIZE  0x10
+#define HASH_TABLE_MAX_SIZE  0x10000
 
 //
 // The directory entry for opened directory
@@ -197,6 +222,8 @@ struct _FAT_DIRENT {
   FAT_OFILE              *OFile;                // The OFile of the corresponding directory entry
   FAT_DIRENT             *ShortNameForwardLink; // Hash successor link for short filename
   FAT_DIRENT             *LongNameForwardLink;  // Hash successor link for long filename
+  UINT32                 ShortNameHash;         // Hash value of the short filename
+  UINT32                 LongNameHash;          // Hash value of the upper-cased long filename
   LIST_ENTRY             Link;                  // Connection of every directory entry
   FAT_DIRECTORY_ENTRY    Entry;                 // The physical directory entry stored in disk
 };
@@ -210,8 +237,10 @@ struct _FAT_ODIR {
   BOOLEAN       EndOfDir;                     // Indicate whether we have reached the end of the directory
   LIST_ENTRY    DirCacheLink;                 // Linked in Volume->DirCacheList when discarded
   UINTN         DirCacheTag;                  // The identification of the directory when in directory cache
-  FAT_DIRENT    *LongNameHashTable[HASH_TABLE_SIZE];
-  FAT_DIRENT    *ShortNameHashTable[HASH_TABLE_SIZE];
+  UINTN         HashTableSize;                // Number of buckets of each hash table
+  UINTN         HashEntryCount;               // Number of directory entries in the hash tables
+  FAT_DIRENT    **LongNameHashTable;
+  FAT_DIRENT    **ShortNameHashTable;
 };
 
 typedef struct {
@@ -1783,6 +1812,33 @@ FatSetVolumeEntry (
 // Hash.c
 //
 
+/**
+
+  Allocate the hash tables of a directory, with the minimum number of buckets.
+
+  @param  ODir                  - The directory.
+
+  @retval EFI_SUCCESS           - The hash tables are allocated.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory for the hash tables.
+
+**/
+EFI_STATUS
+FatInitializeHashTable (
+  IN FAT_ODIR  *ODir
+  );
+
+/**
+
+  Free the hash tables of a directory.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatFreeHashTable (
+  IN FAT_ODIR  *ODir
+  );
+
 /**
 
   Search the long name hash table for the directory entry.
@@ -1817,7 +1873,8 @@ FatShortNameHashSearch (
 
 /**
 
-  Insert directory entry to hash table.
+  Insert directory entry to hash table. The hash tables grow when the
+  directory has more entries than buckets.
 
   @param  ODir                  - The parent directory.
   @param  DirEnt                - The directory entry node.
@@ -1831,7 +1888,8 @@ FatInsertToHashTable (
 
 /**
 
-  Delete directory entry from hash table.
+  Delete directory entry from hash table. The hash tables shrink when the
+  directory has less entries than an eighth of the buckets.
 
   @param  ODir                  - The parent directory.
   @param  DirEnt                - The directory entry node.
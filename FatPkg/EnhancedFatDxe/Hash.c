@@ -8,6 +8,41 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Fat.h"
 
+/**
+
+  Get the hash value of a byte string. This is the FNV-1a hash followed by
+  the finalizer of MurmurHash3, so that the low bits used to select a bucket
+  depend on every byte of the string.
+
+  @param  Data                  - The bytes to be hashed.
+  @param  Length                - The number of bytes.
+
+  @return HashValue.
+
+**/
+STATIC
+UINT32
+FatHashBytes (
+  IN CONST VOID  *Data,
+  IN UINTN       Length
+  )
+{
+  CONST UINT8  *Byte;
+  UINT32       HashValue;
+
+  HashValue = 0x811C9DC5;
+  for (Byte = Data; Length > 0; Byte++, Length--) {
+    HashValue = (HashValue ^ *Byte) * 0x01000193;
+  }
+
+  HashValue ^= HashValue >> 16;
+  HashValue *= 0x85EBCA6B;
+  HashValue ^= HashValue >> 13;
+  HashValue *= 0xC2B2AE35;
+  HashValue ^= HashValue >> 16;
+  return HashValue;
+}
+
 /**
 
   Get hash value for long name.
@@ -23,7 +58,6 @@ FatHashLongName (
   IN CHAR16  *LongNameString
   )
 {
-  UINT32  HashValue;
   CHAR16  UpCasedLongFileName[EFI_PATH_STRING_LENGTH];
 
   StrnCpyS (
@@ -33,8 +67,7 @@ FatHashLongName (
     ARRAY_SIZE (UpCasedLongFileName) - 1
     );
   FatStrUpr (UpCasedLongFileName);
-  gBS->CalculateCrc32 (UpCasedLongFileName, StrSize (UpCasedLongFileName), &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return FatHashBytes (UpCasedLongFileName, StrLen (UpCasedLongFileName) * sizeof (CHAR16));
 }
 
 /**
@@ -52,10 +85,116 @@ FatHashShortName (
   IN CHAR8  *ShortNameString
   )
 {
-  UINT32  HashValue;
+  return FatHashBytes (ShortNameString, FAT_NAME_LEN);
+}
+
+/**
+
+  Move the directory entries of a directory to hash tables of a new size.
+  The current hash tables are kept if the new ones cannot be allocated.
+
+  Entries are appended to the new chains, so that entries which shared a
+  chain keep their order. A search returns the same entry before and after
+  the resize when several entries have the same name.
+
+  @param  ODir                  - The directory.
+  @param  NewSize               - The new number of buckets, a power of two.
+
+  @retval EFI_SUCCESS           - The hash tables are resized.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory for the new hash tables.
+
+**/
+STATIC
+EFI_STATUS
+FatResizeHashTable (
+  IN FAT_ODIR  *ODir,
+  IN UINTN     NewSize
+  )
+{
+  FAT_DIRENT  **LongNameHashTable;
+  FAT_DIRENT  **ShortNameHashTable;
+  FAT_DIRENT  *DirEnt;
+  FAT_DIRENT  *NextDirEnt;
+  FAT_DIRENT  **Tail;
+  UINTN       Index;
+
+  LongNameHashTable = AllocateZeroPool (2 * NewSize * sizeof (FAT_DIRENT *));
+  if (LongNameHashTable == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ShortNameHashTable = LongNameHashTable + NewSize;
+
+  if (ODir->LongNameHashTable != NULL) {
+    for (Index = 0; Index < ODir->HashTableSize; Index++) {
+      for (DirEnt = ODir->ShortNameHashTable[Index]; DirEnt != NULL; DirEnt = NextDirEnt) {
+        NextDirEnt = DirEnt->ShortNameForwardLink;
+        Tail       = &ShortNameHashTable[DirEnt->ShortNameHash & (NewSize - 1)];
+        while (*Tail != NULL) {
+          Tail = &(*Tail)->ShortNameForwardLink;
+        }
+
+        DirEnt->ShortNameForwardLink = NULL;
+        *Tail                        = DirEnt;
+      }
+
+      for (DirEnt = ODir->LongNameHashTable[Index]; DirEnt != NULL; DirEnt = NextDirEnt) {
+        NextDirEnt = DirEnt->LongNameForwardLink;
+        Tail       = &LongNameHashTable[DirEnt->LongNameHash & (NewSize - 1)];
+        while (*Tail != NULL) {
+          Tail = &(*Tail)->LongNameForwardLink;
+        }
+
+        DirEnt->LongNameForwardLink = NULL;
+        *Tail                       = DirEnt;
+      }
+    }
+
+    FreePool (ODir->LongNameHashTable);
+  }
+
+  ODir->LongNameHashTable  = LongNameHashTable;
+  ODir->ShortNameHashTable = ShortNameHashTable;
+  ODir->HashTableSize      = NewSize;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Allocate the hash tables of a directory, with the minimum number of buckets.
+
+  @param  ODir                  - The directory.
+
+  @retval EFI_SUCCESS           - The hash tables are allocated.
+  @retval EFI_OUT_OF_RESOURCES  - Not enough memory for the hash tables.
+
+**/
+EFI_STATUS
+FatInitializeHashTable (
+  IN FAT_ODIR  *ODir
+  )
+{
+  ODir->HashEntryCount = 0;
+  return FatResizeHashTable (ODir, HASH_TABLE_MIN_SIZE);
+}
+
+/**
+
+  Free the hash tables of a directory.
+
+  @param  ODir                  - The directory.
 
-  gBS->CalculateCrc32 (ShortNameString, FAT_NAME_LEN, &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+**/
+VOID
+FatFreeHashTable (
+  IN FAT_ODIR  *ODir
+  )
+{
+  if (ODir->LongNameHashTable != NULL) {
+    FreePool (ODir->LongNameHashTable);
+    ODir->LongNameHashTable  = NULL;
+    ODir->ShortNameHashTable = NULL;
+  }
 }
 
 /**
@@ -75,13 +214,17 @@ FatLongNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
+  UINT32      HashValue;
 
-  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString)];
+  HashValue = FatHashLongName (LongNameString);
+  for (PreviousHashNode   = &ODir->LongNameHashTable[HashValue & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
        )
   {
-    if (FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0) {
+    if (((*PreviousHashNode)->LongNameHash == HashValue) &&
+        (FatStriCmp (LongNameString, (*PreviousHashNode)->FileString) == 0))
+    {
       break;
     }
   }
@@ -106,13 +249,17 @@ FatShortNameHashSearch (
   )
 {
   FAT_DIRENT  **PreviousHashNode;
+  UINT32      HashValue;
 
-  for (PreviousHashNode   = &ODir->ShortNameHashTable[FatHashShortName (ShortNameString)];
+  HashValue = FatHashShortName (ShortNameString);
+  for (PreviousHashNode   = &ODir->ShortNameHashTable[HashValue & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->ShortNameForwardLink
        )
   {
-    if (CompareMem (ShortNameString, (*PreviousHashNode)->Entry.FileName, FAT_NAME_LEN) == 0) {
+    if (((*PreviousHashNode)->ShortNameHash == HashValue) &&
+        (CompareMem (ShortNameString, (*PreviousHashNode)->Entry.FileName, FAT_NAME_LEN) == 0))
+    {
       break;
     }
   }
@@ -122,7 +269,8 @@ FatShortNameHashSearch (
 
 /**
 
-  Insert directory entry to hash table.
+  Insert directory entry to hash table. The hash tables grow when the
+  directory has more entries than buckets.
 
   @param  ODir                  - The parent directory.
   @param  DirEnt                - The directory entry node.
@@ -137,17 +285,27 @@ FatInsertToHashTable (
   FAT_DIRENT  **HashTable;
   UINT32      HashTableIndex;
 
+  if ((ODir->HashEntryCount >= ODir->HashTableSize) && (ODir->HashTableSize < HASH_TABLE_MAX_SIZE)) {
+    //
+    // On failure, keep the current hash tables with longer chains
+    //
+    FatResizeHashTable (ODir, ODir->HashTableSize * 4);
+  }
+
+  ODir->HashEntryCount++;
   //
   // Insert hash table index for short name
   //
-  HashTableIndex               = FatHashShortName (DirEnt->Entry.FileName);
+  DirEnt->ShortNameHash        = FatHashShortName (DirEnt->Entry.FileName);
+  HashTableIndex               = DirEnt->ShortNameHash & (ODir->HashTableSize - 1);
   HashTable                    = ODir->ShortNameHashTable;
   DirEnt->ShortNameForwardLink = HashTable[HashTableIndex];
   HashTable[HashTableIndex]    = DirEnt;
   //
   // Insert hash table index for long name
   //
-  HashTableIndex              = FatHashLongName (DirEnt->FileString);
+  DirEnt->LongNameHash        = FatHashLongName (DirEnt->FileString);
+  HashTableIndex              = DirEnt->LongNameHash & (ODir->HashTableSize - 1);
   HashTable                   = ODir->LongNameHashTable;
   DirEnt->LongNameForwardLink = HashTable[HashTableIndex];
   HashTable[HashTableIndex]   = DirEnt;
@@ -155,7 +313,8 @@ FatInsertToHashTable (
 
 /**
 
-  Delete directory entry from hash table.
+  Delete directory entry from hash table. The hash tables shrink when the
+  directory has less entries than an eighth of the buckets.
 
   @param  ODir                  - The parent directory.
   @param  DirEnt                - The directory entry node.
@@ -167,6 +326,24 @@ FatDeleteFromHashTable (
   IN FAT_DIRENT  *DirEnt
   )
 {
-  *FatShortNameHashSearch (ODir, DirEnt->Entry.FileName) = DirEnt->ShortNameForwardLink;
-  *FatLongNameHashSearch (ODir, DirEnt->FileString)      = DirEnt->LongNameForwardLink;
+  FAT_DIRENT  **PreviousHashNode;
+
+  PreviousHashNode = &ODir->ShortNameHashTable[DirEnt->ShortNameHash & (ODir->HashTableSize - 1)];
+  while (*PreviousHashNode != DirEnt) {
+    PreviousHashNode = &(*PreviousHashNode)->ShortNameForwardLink;
+  }
+
+  *PreviousHashNode = DirEnt->ShortNameForwardLink;
+
+  PreviousHashNode = &ODir->LongNameHashTable[DirEnt->LongNameHash & (ODir->HashTableSize - 1)];
+  while (*PreviousHashNode != DirEnt) {
+    PreviousHashNode = &(*PreviousHashNode)->LongNameForwardLink;
+  }
+
+  *PreviousHashNode = DirEnt->LongNameForwardLink;
+
+  ODir->HashEntryCount--;
+  if ((ODir->HashEntryCount < ODir->HashTableSize / 8) && (ODir->HashTableSize > HASH_TABLE_MIN_SIZE)) {
+    FatResizeHashTable (ODir, ODir->HashTableSize / 4);
+  }
 }
@@ -0,0 +1,380 @@
+/** @file
+  Host based test and benchmark for the directory entry hash tables of the
+  FAT driver.
+
+  Directories of increasing size are filled with entries named like the
+  files of an ESP. The time to look up an entry by long name and by short
+  name, as FatSearchODir() does when a file is opened by name, is reported
+  with the number of buckets of the hash tables.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "../Fat.h"
+
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "FAT Directory Hash Test and Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_LOOKUP_COUNT  200000
+#define TEST_RESIZE_COUNT  30
+
+STATIC UINTN  mDirectorySizes[] = { 16, 1000, 10000, 50000 };
+
+/**
+  Uppercase a string. Replaces the Unicode Collation protocol based
+  implementation of the driver.
+
+  @param  String  The string which will be upper-cased.
+**/
+VOID
+FatStrUpr (
+  IN OUT CHAR16  *String
+  )
+{
+  for ( ; *String != 0; String++) {
+    if ((*String >= L'a') && (*String <= L'z')) {
+      *String = *String - L'a' + L'A';
+    }
+  }
+}
+
+/**
+  Performs a case-insensitive comparison of two strings. Replaces the
+  Unicode Collation protocol based implementation of the driver.
+
+  @param  S1  A pointer to a Null-terminated string.
+  @param  S2  A pointer to a Null-terminated string.
+
+  @retval 0     S1 is equivalent to S2.
+  @retval != 0  S1 is not equivalent to S2.
+**/
+INTN
+FatStriCmp (
+  IN CHAR16  *S1,
+  IN CHAR16  *S2
+  )
+{
+  CHAR16  C1;
+  CHAR16  C2;
+
+  do {
+    C1 = ((*S1 >= L'a') && (*S1 <= L'z')) ? *S1 - L'a' + L'A' : *S1;
+    C2 = ((*S2 >= L'a') && (*S2 <= L'z')) ? *S2 - L'a' + L'A' : *S2;
+    S1++;
+    S2++;
+  } while ((C1 == C2) && (C1 != 0));
+
+  return (INTN)C1 - (INTN)C2;
+}
+
+/**
+  Creates a directory entry with a long name and a short name derived from
+  its index, and adds it to a directory.
+
+  @param  ODir   The directory.
+  @param  Index  The index of the entry.
+
+  @return The directory entry, or NULL if out of resources.
+**/
+STATIC
+FAT_DIRENT *
+CreateTestDirEnt (
+  IN FAT_ODIR  *ODir,
+  IN UINTN     Index
+  )
+{
+  FAT_DIRENT  *DirEnt;
+  CHAR16      Name[EFI_FILE_STRING_LENGTH];
+  CHAR8       ShortName[FAT_NAME_LEN + 1];
+
+  DirEnt = AllocateZeroPool (sizeof (FAT_DIRENT));
+  if (DirEnt == NULL) {
+    return NULL;
+  }
+
+  UnicodeSPrintAsciiFormat (Name, sizeof (Name), "BootEntry-%04u-Vendor-Kernel.Efi", (UINT32)Index);
+  AsciiSPrint (ShortName, sizeof (ShortName), "BOOT%04XEFI", (UINT32)Index);
+
+  DirEnt->Signature  = FAT_DIRENT_SIGNATURE;
+  DirEnt->FileString = AllocateCopyPool (StrSize (Name), Name);
+  if (DirEnt->FileString == NULL) {
+    FreePool (DirEnt);
+    return NULL;
+  }
+
+  CopyMem (DirEnt->Entry.FileName, ShortName, FAT_NAME_LEN);
+  InsertTailList (&ODir->ChildList, &DirEnt->Link);
+  FatInsertToHashTable (ODir, DirEnt);
+  return DirEnt;
+}
+
+/**
+  Removes a directory entry from a directory and frees it.
+
+  @param  ODir    The directory.
+  @param  DirEnt  The directory entry.
+**/
+STATIC
+VOID
+DeleteTestDirEnt (
+  IN FAT_ODIR    *ODir,
+  IN FAT_DIRENT  *DirEnt
+  )
+{
+  RemoveEntryList (&DirEnt->Link);
+  FatDeleteFromHashTable (ODir, DirEnt);
+  FreePool (DirEnt->FileString);
+  FreePool (DirEnt);
+}
+
+/**
+  Fills directories of increasing size, looks up their entries by long name
+  with a different case and by short name, then empties them, and checks
+  that the hash tables grow and shrink with the number of entries.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DirectoryLookupTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FAT_ODIR    ODir;
+  FAT_DIRENT  **DirEnts;
+  FAT_DIRENT  *DirEnt;
+  UINTN       SizeIndex;
+  UINTN       EntryCount;
+  UINTN       Index;
+  UINTN       Lookup;
+  UINT32      Seed;
+  CHAR16      Name[EFI_FILE_STRING_LENGTH];
+  clock_t     Start;
+  UINT64      LongNameNs;
+  UINT64      ShortNameNs;
+
+  for (SizeIndex = 0; SizeIndex < ARRAY_SIZE (mDirectorySizes); SizeIndex++) {
+    EntryCount = mDirectorySizes[SizeIndex];
+    ZeroMem (&ODir, sizeof (ODir));
+    InitializeListHead (&ODir.ChildList);
+    UT_ASSERT_NOT_EFI_ERROR (FatInitializeHashTable (&ODir));
+    UT_ASSERT_EQUAL (ODir.HashTableSize, HASH_TABLE_MIN_SIZE);
+
+    DirEnts = AllocatePool (EntryCount * sizeof (FAT_DIRENT *));
+    UT_ASSERT_NOT_NULL (DirEnts);
+    for (Index = 0; Index < EntryCount; Index++) {
+      DirEnts[Index] = CreateTestDirEnt (&ODir, Index);
+      UT_ASSERT_NOT_NULL (DirEnts[Index]);
+    }
+
+    UT_ASSERT_EQUAL (ODir.HashEntryCount, EntryCount);
+    UT_ASSERT_TRUE (ODir.HashTableSize >= MIN (EntryCount, HASH_TABLE_MAX_SIZE) / 4);
+    UT_ASSERT_TRUE (ODir.HashTableSize <= MAX (EntryCount * 4, HASH_TABLE_MIN_SIZE));
+
+    //
+    // Look up by long name, lower-cased as a user would type it
+    //
+    Seed  = 1;
+    Start = clock ();
+    for (Lookup = 0; Lookup < TEST_LOOKUP_COUNT; Lookup++) {
+      Seed  = Seed * 1103515245 + 12345;
+      Index = (Seed >> 1) % EntryCount;
+      UnicodeSPrintAsciiFormat (Name, sizeof (Name), "bootentry-%04u-vendor-kernel.efi", (UINT32)Index);
+      DirEnt = *FatLongNameHashSearch (&ODir, Name);
+      UT_ASSERT_EQUAL ((UINTN)DirEnt, (UINTN)DirEnts[Index]);
+    }
+
+    LongNameNs = (UINT64)(clock () - Start) * 1000000000 / CLOCKS_PER_SEC / TEST_LOOKUP_COUNT;
+
+    Start = clock ();
+    for (Lookup = 0; Lookup < TEST_LOOKUP_COUNT; Lookup++) {
+      Seed   = Seed * 1103515245 + 12345;
+      Index  = (Seed >> 1) % EntryCount;
+      DirEnt = *FatShortNameHashSearch (&ODir, (CHAR8 *)DirEnts[Index]->Entry.FileName);
+      UT_ASSERT_EQUAL ((UINTN)DirEnt, (UINTN)DirEnts[Index]);
+    }
+
+    ShortNameNs = (UINT64)(clock () - Start) * 1000000000 / CLOCKS_PER_SEC / TEST_LOOKUP_COUNT;
+
+    UnicodeSPrintAsciiFormat (Name, sizeof (Name), "BootEntry-%04u-Vendor-Kernel.Efi", (UINT32)EntryCount);
+    UT_ASSERT_EQUAL ((UINTN)*FatLongNameHashSearch (&ODir, Name), (UINTN)NULL);
+
+    UT_LOG_INFO (
+      "%Lu entries, %Lu buckets: %Lu ns by long name, %Lu ns by short name\n",
+      (UINT64)EntryCount,
+      (UINT64)ODir.HashTableSize,
+      LongNameNs,
+      ShortNameNs
+      );
+
+    //
+    // Delete every entry but one, in a different order than the insertion
+    //
+    for (Index = 0; Index < EntryCount - 1; Index++) {
+      DeleteTestDirEnt (&ODir, DirEnts[(Index * 7919) % (EntryCount - 1) + 1]);
+    }
+
+    UT_ASSERT_EQUAL (ODir.HashEntryCount, 1);
+    UT_ASSERT_TRUE (ODir.HashTableSize <= HASH_TABLE_MIN_SIZE * 4);
+    UT_ASSERT_EQUAL ((UINTN)*FatShortNameHashSearch (&ODir, (CHAR8 *)DirEnts[0]->Entry.FileName), (UINTN)DirEnts[0]);
+    UT_ASSERT_EQUAL ((UINTN)*FatLongNameHashSearch (&ODir, DirEnts[0]->FileString), (UINTN)DirEnts[0]);
+
+    DeleteTestDirEnt (&ODir, DirEnts[0]);
+    FatFreeHashTable (&ODir);
+    FreePool (DirEnts);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Adds two entries with the same names to a directory, then grows and
+  shrinks the hash tables, and checks that a search by name returns the
+  same entry before and after each resize.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DuplicateNameOrderTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FAT_ODIR    ODir;
+  FAT_DIRENT  *DirEnts[TEST_RESIZE_COUNT + 2];
+  FAT_DIRENT  *Found;
+  UINTN       Index;
+
+  ZeroMem (&ODir, sizeof (ODir));
+  InitializeListHead (&ODir.ChildList);
+  UT_ASSERT_NOT_EFI_ERROR (FatInitializeHashTable (&ODir));
+
+  //
+  // The second entry is in front of the first one in both chains
+  //
+  DirEnts[0] = CreateTestDirEnt (&ODir, 0);
+  UT_ASSERT_NOT_NULL (DirEnts[0]);
+  DirEnts[1] = CreateTestDirEnt (&ODir, 0);
+  UT_ASSERT_NOT_NULL (DirEnts[1]);
+  Found = *FatLongNameHashSearch (&ODir, DirEnts[0]->FileString);
+  UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)DirEnts[1]);
+  Found = *FatShortNameHashSearch (&ODir, (CHAR8 *)DirEnts[0]->Entry.FileName);
+  UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)DirEnts[1]);
+
+  for (Index = 2; Index < ARRAY_SIZE (DirEnts); Index++) {
+    DirEnts[Index] = CreateTestDirEnt (&ODir, Index);
+    UT_ASSERT_NOT_NULL (DirEnts[Index]);
+  }
+
+  UT_ASSERT_TRUE (ODir.HashTableSize > HASH_TABLE_MIN_SIZE);
+  Found = *FatLongNameHashSearch (&ODir, DirEnts[0]->FileString);
+  UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)DirEnts[1]);
+  Found = *FatShortNameHashSearch (&ODir, (CHAR8 *)DirEnts[0]->Entry.FileName);
+  UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)DirEnts[1]);
+
+  for (Index = 2; Index < ARRAY_SIZE (DirEnts); Index++) {
+    DeleteTestDirEnt (&ODir, DirEnts[Index]);
+  }
+
+  UT_ASSERT_EQUAL (ODir.HashTableSize, HASH_TABLE_MIN_SIZE);
+  Found = *FatLongNameHashSearch (&ODir, DirEnts[0]->FileString);
+  UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)DirEnts[1]);
+  Found = *FatShortNameHashSearch (&ODir, (CHAR8 *)DirEnts[0]->Entry.FileName);
+  UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)DirEnts[1]);
+
+  DeleteTestDirEnt (&ODir, DirEnts[1]);
+  DeleteTestDirEnt (&ODir, DirEnts[0]);
+  FatFreeHashTable (&ODir);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the FAT
+  directory hash tables and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DirectoryHashTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&DirectoryHashTests, Framework, "FAT Directory Hash Tests", "Fat.DirectoryHash", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the FAT Directory Hash Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (DirectoryHashTests, "Lookup by name in directories of increasing size", "DirectoryLookup", DirectoryLookupTest, NULL, NULL, NULL);
+  AddTestCase (DirectoryHashTests, "Same names keep their order across resizes", "DuplicateNameOrder", DuplicateNameOrderTest, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define DirectoryHashBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+DirectoryHashBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
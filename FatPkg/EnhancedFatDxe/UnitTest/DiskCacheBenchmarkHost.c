@@ -0,0 +1,597 @@
+/** @file
+  Host based test and benchmark for the disk cache of the FAT driver.
+
+  The disk cache is run on a disk image held in memory. The disk charges a
+  fixed latency per request and a fixed transfer rate, as a USB or SATA disk
+  would, so that the reported MB/s reflect the number and the size of the
+  disk requests issued by the cache as well as its processing time. Each
+  workload runs with the direct mapped cache without read ahead that the
+  driver used before, and with the cache configured by the PCDs.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "../Fat.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "FAT Disk Cache Test and Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// Disk image geometry
+//
+#define TEST_BLOCK_SIZE   512
+#define TEST_VOLUME_SIZE  SIZE_64MB
+#define TEST_FAT_POS      0x4000
+#define TEST_FAT_SIZE     SIZE_1MB
+#define TEST_NUM_FATS     2
+#define TEST_ROOT_POS     (TEST_FAT_POS + TEST_NUM_FATS * TEST_FAT_SIZE)
+
+//
+// Simulated disk: 100us per request, 200MB/s
+//
+#define TEST_DISK_REQUEST_LATENCY_NS  100000
+#define TEST_DISK_BYTES_PER_US        200
+
+//
+// Workloads
+//
+#define TEST_READ_SIZE         SIZE_4KB
+#define TEST_TRANSFER_SIZE     SIZE_32MB
+#define TEST_HOT_PAGE_COUNT    8
+#define TEST_MIXED_OPERATIONS  20000
+
+///
+/// A cache configuration under test.
+///
+typedef struct {
+  CHAR8    *Name;
+  UINTN    GroupSize;
+  UINTN    ReadAheadPageCount;
+} TEST_CACHE_CONFIG;
+
+///
+/// The direct mapped cache without read ahead the driver used before, and
+/// the cache configured by the PCDs. 0 stands for the PCD value.
+///
+STATIC TEST_CACHE_CONFIG  mCacheConfigs[] = {
+  { "Direct mapped", 1, 1 },
+  { "PCD",           0, 0 }
+};
+
+typedef struct {
+  FAT_VOLUME                Volume;
+  EFI_BLOCK_IO_PROTOCOL     BlockIo;
+  EFI_BLOCK_IO_MEDIA        Media;
+  UINT8                     *Image;
+  UINT8                     *Reference;
+  UINT8                     *Buffer;
+  UINT64                    DiskReadCount;
+  UINT64                    DiskWriteCount;
+  UINT64                    DiskTimeNs;
+  UINT32                    Seed;
+} TEST_CONTEXT;
+
+STATIC TEST_CONTEXT  mTest;
+
+/**
+  Returns the next value of a deterministic pseudo random sequence.
+
+  @return A pseudo random 32-bit value.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mTest.Seed = mTest.Seed * 1103515245 + 12345;
+  return mTest.Seed >> 1;
+}
+
+/**
+  Returns a pseudo random value in [0, Limit).
+
+  @param  Limit  The upper bound, exclusive.
+
+  @return A pseudo random value.
+**/
+STATIC
+UINTN
+RandomBelow (
+  IN UINTN  Limit
+  )
+{
+  return (UINTN)(((UINT64)NextRandom () << 31 | NextRandom ()) % Limit);
+}
+
+/**
+  Flush blocks of the test block I/O. Nothing to do for a disk in memory.
+
+  @param  This  The block I/O protocol.
+
+  @retval EFI_SUCCESS  Always.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestFlushBlocks (
+  IN EFI_BLOCK_IO_PROTOCOL  *This
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  General disk access function, replacing the one of the driver. Cache
+  accesses go to the disk cache under test, and disk accesses go to the disk
+  image, charging the simulated disk time.
+
+  @param  Volume      FAT file system volume.
+  @param  IoMode      The access mode (disk read/write or cache access).
+  @param  Offset      The starting byte offset to read from.
+  @param  BufferSize  Size of Buffer.
+  @param  Buffer      Buffer containing read data.
+  @param  Task        Point to task instance.
+
+  @retval EFI_SUCCESS           The operation is performed successfully.
+  @retval EFI_VOLUME_CORRUPTED  The access is out of the volume.
+**/
+EFI_STATUS
+FatDiskIo (
+  IN     FAT_VOLUME  *Volume,
+  IN     IO_MODE     IoMode,
+  IN     UINT64      Offset,
+  IN     UINTN       BufferSize,
+  IN OUT VOID        *Buffer,
+  IN     FAT_TASK    *Task
+  )
+{
+  if (Offset + BufferSize > Volume->VolumeSize) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (CACHE_ENABLED (IoMode)) {
+    return FatAccessCache (Volume, CACHE_TYPE (IoMode), RAW_ACCESS (IoMode), Offset, BufferSize, Buffer, Task);
+  }
+
+  if (IoMode == ReadDisk) {
+    CopyMem (Buffer, mTest.Image + Offset, BufferSize);
+    mTest.DiskReadCount++;
+  } else {
+    CopyMem (mTest.Image + Offset, Buffer, BufferSize);
+    mTest.DiskWriteCount++;
+  }
+
+  mTest.DiskTimeNs += TEST_DISK_REQUEST_LATENCY_NS + (UINT64)BufferSize * 1000 / TEST_DISK_BYTES_PER_US;
+  return EFI_SUCCESS;
+}
+
+/**
+  Fills the disk image with a pattern and sets up the volume and its disk
+  cache with a cache configuration.
+
+  @param  Config  The cache configuration.
+
+  @retval EFI_SUCCESS  The volume is set up.
+  @return Others       FatInitializeDiskCache() failed.
+**/
+STATIC
+EFI_STATUS
+SetupVolume (
+  IN TEST_CACHE_CONFIG  *Config
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  UINTN       Index;
+
+  for (Index = 0; Index < TEST_VOLUME_SIZE / sizeof (UINT32); Index++) {
+    ((UINT32 *)mTest.Image)[Index] = (UINT32)(Index * 2654435761u);
+  }
+
+  for (Index = 1; Index < TEST_NUM_FATS; Index++) {
+    CopyMem (mTest.Image + TEST_FAT_POS + Index * TEST_FAT_SIZE, mTest.Image + TEST_FAT_POS, TEST_FAT_SIZE);
+  }
+
+  CopyMem (mTest.Reference, mTest.Image, TEST_VOLUME_SIZE);
+
+  if (mTest.Volume.CacheBuffer != NULL) {
+    FreePool (mTest.Volume.CacheBuffer);
+  }
+
+  ZeroMem (&mTest.Volume, sizeof (mTest.Volume));
+  ZeroMem (&mTest.Media, sizeof (mTest.Media));
+  mTest.Media.BlockSize        = TEST_BLOCK_SIZE;
+  mTest.Media.LastBlock        = TEST_VOLUME_SIZE / TEST_BLOCK_SIZE - 1;
+  mTest.BlockIo.Media          = &mTest.Media;
+  mTest.BlockIo.FlushBlocks    = TestFlushBlocks;
+  mTest.Volume.Signature       = FAT_VOLUME_SIGNATURE;
+  mTest.Volume.BlockIo         = &mTest.BlockIo;
+  mTest.Volume.FatType         = Fat32;
+  mTest.Volume.VolumeSize      = TEST_VOLUME_SIZE;
+  mTest.Volume.FatPos          = TEST_FAT_POS;
+  mTest.Volume.FatSize         = TEST_FAT_SIZE;
+  mTest.Volume.NumFats         = TEST_NUM_FATS;
+  mTest.Volume.RootPos         = TEST_ROOT_POS;
+  mTest.Volume.FirstClusterPos = TEST_ROOT_POS;
+
+  Status = FatInitializeDiskCache (&mTest.Volume);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Override the PCD geometry. A smaller group size or read ahead page count
+  // fits in the buffers allocated for the PCD geometry.
+  //
+  for (Index = 0; Index < CacheMaxType; Index++) {
+    DiskCache = &mTest.Volume.DiskCache[Index];
+    if (Config->GroupSize != 0) {
+      DiskCache->GroupSize = MIN (Config->GroupSize, DiskCache->GroupSize);
+      DiskCache->GroupMask = DiskCache->PageCount / DiskCache->GroupSize - 1;
+    }
+
+    if (Config->ReadAheadPageCount != 0) {
+      DiskCache->ReadAheadPageCount = MIN (Config->ReadAheadPageCount, DiskCache->ReadAheadPageCount);
+    }
+  }
+
+  mTest.DiskReadCount  = 0;
+  mTest.DiskWriteCount = 0;
+  mTest.DiskTimeNs     = 0;
+  mTest.Seed           = 0x5EED;
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the throughput of a workload in MB/s, counting the processor time
+  spent in the cache and the simulated disk time.
+
+  @param  Bytes   The number of bytes transferred.
+  @param  Start   The processor time when the workload started.
+
+  @return The throughput in MB/s.
+**/
+STATIC
+UINT64
+Throughput (
+  IN UINT64   Bytes,
+  IN clock_t  Start
+  )
+{
+  UINT64  ElapsedNs;
+
+  ElapsedNs = (UINT64)(clock () - Start) * 1000000000 / CLOCKS_PER_SEC + mTest.DiskTimeNs;
+  if (ElapsedNs == 0) {
+    ElapsedNs = 1;
+  }
+
+  return Bytes * 1000 / ElapsedNs;
+}
+
+/**
+  Reads TEST_TRANSFER_SIZE bytes sequentially and then at random offsets of
+  the data area in TEST_READ_SIZE reads, and reports the throughput of each
+  cache configuration.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SequentialAndRandomReadTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN    ConfigIndex;
+  UINT64   Offset;
+  UINTN    Index;
+  clock_t  Start;
+  UINT64   SequentialRate;
+  UINT64   SequentialReads;
+  UINT64   RandomRate;
+  UINT64   RandomReads;
+  UINT64   DirectMappedReads;
+
+  DirectMappedReads = 0;
+  for (ConfigIndex = 0; ConfigIndex < ARRAY_SIZE (mCacheConfigs); ConfigIndex++) {
+    UT_ASSERT_NOT_EFI_ERROR (SetupVolume (&mCacheConfigs[ConfigIndex]));
+
+    Start = clock ();
+    for (Offset = TEST_ROOT_POS; Offset < TEST_ROOT_POS + TEST_TRANSFER_SIZE; Offset += TEST_READ_SIZE) {
+      UT_ASSERT_NOT_EFI_ERROR (FatDiskIo (&mTest.Volume, ReadData, Offset, TEST_READ_SIZE, mTest.Buffer, NULL));
+      UT_ASSERT_MEM_EQUAL (mTest.Buffer, mTest.Image + Offset, TEST_READ_SIZE);
+    }
+
+    SequentialRate  = Throughput (TEST_TRANSFER_SIZE, Start);
+    SequentialReads = mTest.DiskReadCount;
+
+    mTest.DiskReadCount = 0;
+    mTest.DiskTimeNs    = 0;
+    Start               = clock ();
+    for (Index = 0; Index < TEST_TRANSFER_SIZE / TEST_READ_SIZE; Index++) {
+      Offset = TEST_ROOT_POS + RandomBelow ((TEST_VOLUME_SIZE - TEST_ROOT_POS - TEST_READ_SIZE) / TEST_BLOCK_SIZE) * TEST_BLOCK_SIZE;
+      UT_ASSERT_NOT_EFI_ERROR (FatDiskIo (&mTest.Volume, ReadData, Offset, TEST_READ_SIZE, mTest.Buffer, NULL));
+      UT_ASSERT_MEM_EQUAL (mTest.Buffer, mTest.Image + Offset, TEST_READ_SIZE);
+    }
+
+    RandomRate  = Throughput (TEST_TRANSFER_SIZE, Start);
+    RandomReads = mTest.DiskReadCount;
+
+    UT_LOG_INFO (
+      "%a: sequential %Lu MB/s in %Lu disk reads, random %Lu MB/s in %Lu disk reads\n",
+      mCacheConfigs[ConfigIndex].Name,
+      SequentialRate,
+      SequentialReads,
+      RandomRate,
+      RandomReads
+      );
+
+    if (ConfigIndex == 0) {
+      DirectMappedReads = SequentialReads;
+    } else if (mTest.Volume.DiskCache[CacheData].ReadAheadPageCount > 1) {
+      //
+      // Sequential misses read ahead
+      //
+      UT_ASSERT_TRUE (SequentialReads < DirectMappedReads);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Streams TEST_TRANSFER_SIZE bytes while a few hot pages, such as the pages
+  of a directory, are accessed between the reads, and checks that the hot
+  pages are not replaced by the stream when the cache is set associative.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+HotPagesSurviveStreamTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   ConfigIndex;
+  UINT64  HotPos;
+  UINT64  Offset;
+  UINTN   Index;
+  UINTN   PageSize;
+  UINT64  HotPageReads;
+
+  for (ConfigIndex = 0; ConfigIndex < ARRAY_SIZE (mCacheConfigs); ConfigIndex++) {
+    UT_ASSERT_NOT_EFI_ERROR (SetupVolume (&mCacheConfigs[ConfigIndex]));
+    PageSize = (UINTN)1 << mTest.Volume.DiskCache[CacheData].PageAlignment;
+
+    //
+    // Hot pages in the last quarter of the volume, streamed area in the first half
+    //
+    HotPos       = TEST_VOLUME_SIZE - TEST_VOLUME_SIZE / 4;
+    HotPageReads = 0;
+    Index        = 0;
+    for (Offset = TEST_ROOT_POS; Offset < TEST_ROOT_POS + TEST_TRANSFER_SIZE; Offset += TEST_READ_SIZE) {
+      UT_ASSERT_NOT_EFI_ERROR (FatDiskIo (&mTest.Volume, ReadData, Offset, TEST_READ_SIZE, mTest.Buffer, NULL));
+      if ((Offset / TEST_READ_SIZE) % (PageSize / TEST_READ_SIZE) == 0) {
+        mTest.DiskReadCount = 0;
+        UT_ASSERT_NOT_EFI_ERROR (
+          FatDiskIo (&mTest.Volume, ReadData, HotPos + (Index % TEST_HOT_PAGE_COUNT) * PageSize + 32, 32, mTest.Buffer, NULL)
+          );
+        UT_ASSERT_MEM_EQUAL (mTest.Buffer, mTest.Image + HotPos + (Index % TEST_HOT_PAGE_COUNT) * PageSize + 32, 32);
+        HotPageReads += mTest.DiskReadCount;
+        Index++;
+      }
+    }
+
+    UT_LOG_INFO ("%a: %Lu disk reads for %d hot pages\n", mCacheConfigs[ConfigIndex].Name, HotPageReads, TEST_HOT_PAGE_COUNT);
+    //
+    // The stream only replaces the least recently used pages if the groups are
+    // large enough to hold the hot pages and the pages of the stream.
+    //
+    if ((ConfigIndex > 0) &&
+        (mTest.Volume.DiskCache[CacheData].GroupSize > 1) &&
+        (mTest.Volume.DiskCache[CacheData].PageCount >= 4 * TEST_HOT_PAGE_COUNT))
+    {
+      UT_ASSERT_TRUE (HotPageReads <= TEST_HOT_PAGE_COUNT);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Runs random reads and writes of the data area and of the FAT through the
+  cache, checks every read against a reference copy of the volume, then
+  flushes the cache and checks the disk image against the reference.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReadWriteCoherencyTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   ConfigIndex;
+  UINTN   Operation;
+  UINTN   Size;
+  UINTN   Index;
+  UINT64  Offset;
+  UINT32  Random;
+
+  for (ConfigIndex = 0; ConfigIndex < ARRAY_SIZE (mCacheConfigs); ConfigIndex++) {
+    UT_ASSERT_NOT_EFI_ERROR (SetupVolume (&mCacheConfigs[ConfigIndex]));
+
+    for (Operation = 0; Operation < TEST_MIXED_OPERATIONS; Operation++) {
+      Random = NextRandom ();
+      if (Random % 4 == 0) {
+        //
+        // FAT entry access. Writes go to every FAT when the page is flushed.
+        //
+        Offset = TEST_FAT_POS + RandomBelow (TEST_FAT_SIZE / sizeof (UINT32)) * sizeof (UINT32);
+        if ((Random >> 8) % 2 == 0) {
+          UT_ASSERT_NOT_EFI_ERROR (FatDiskIo (&mTest.Volume, ReadFat, Offset, sizeof (UINT32), mTest.Buffer, NULL));
+          UT_ASSERT_MEM_EQUAL (mTest.Buffer, mTest.Reference + Offset, sizeof (UINT32));
+        } else {
+          *(UINT32 *)mTest.Buffer = NextRandom ();
+          UT_ASSERT_NOT_EFI_ERROR (FatDiskIo (&mTest.Volume, WriteFat, Offset, sizeof (UINT32), mTest.Buffer, NULL));
+          for (Index = 0; Index < TEST_NUM_FATS; Index++) {
+            CopyMem (mTest.Reference + Offset + Index * TEST_FAT_SIZE, mTest.Buffer, sizeof (UINT32));
+          }
+        }
+
+        continue;
+      }
+
+      //
+      // Data access from one byte to three pages, with runs of sequential accesses
+      //
+      Size = 1 + RandomBelow (3 * SIZE_64KB);
+      if ((Random >> 8) % 4 == 0) {
+        Offset = TEST_ROOT_POS + RandomBelow (TEST_VOLUME_SIZE - TEST_ROOT_POS - Size);
+      } else {
+        Offset = TEST_ROOT_POS + RandomBelow (SIZE_4MB);
+      }
+
+      if ((Random >> 12) % 2 == 0) {
+        UT_ASSERT_NOT_EFI_ERROR (FatDiskIo (&mTest.Volume, ReadData, Offset, Size, mTest.Buffer, NULL));
+        UT_ASSERT_MEM_EQUAL (mTest.Buffer, mTest.Reference + Offset, Size);
+      } else {
+        for (Index = 0; Index < Size; Index++) {
+          mTest.Buffer[Index] = (UINT8)NextRandom ();
+        }
+
+        UT_ASSERT_NOT_EFI_ERROR (FatDiskIo (&mTest.Volume, WriteData, Offset, Size, mTest.Buffer, NULL));
+        CopyMem (mTest.Reference + Offset, mTest.Buffer, Size);
+      }
+    }
+
+    UT_ASSERT_NOT_EFI_ERROR (FatVolumeFlushCache (&mTest.Volume, NULL));
+    UT_ASSERT_MEM_EQUAL (mTest.Image, mTest.Reference, TEST_VOLUME_SIZE);
+    UT_LOG_INFO (
+      "%a: %Lu disk reads, %Lu disk writes\n",
+      mCacheConfigs[ConfigIndex].Name,
+      mTest.DiskReadCount,
+      mTest.DiskWriteCount
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the FAT disk
+  cache and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DiskCacheTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  mTest.Image     = AllocatePool (TEST_VOLUME_SIZE);
+  mTest.Reference = AllocatePool (TEST_VOLUME_SIZE);
+  mTest.Buffer    = AllocatePool (3 * SIZE_64KB);
+  if ((mTest.Image == NULL) || (mTest.Reference == NULL) || (mTest.Buffer == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&DiskCacheTests, Framework, "FAT Disk Cache Tests", "Fat.DiskCache", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the FAT Disk Cache Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (DiskCacheTests, "Sequential and random read throughput", "SequentialAndRandomRead", SequentialAndRandomReadTest, NULL, NULL, NULL);
+  AddTestCase (DiskCacheTests, "Hot pages are not replaced by a stream", "HotPagesSurviveStream", HotPagesSurviveStreamTest, NULL, NULL, NULL);
+  AddTestCase (DiskCacheTests, "Reads and writes through the cache are coherent", "ReadWriteCoherency", ReadWriteCoherencyTest, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mTest.Volume.CacheBuffer != NULL) {
+    FreePool (mTest.Volume.CacheBuffer);
+  }
+
+  if (mTest.Image != NULL) {
+    FreePool (mTest.Image);
+  }
+
+  if (mTest.Reference != NULL) {
+    FreePool (mTest.Reference);
+  }
+
+  if (mTest.Buffer != NULL) {
+    FreePool (mTest.Buffer);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define DiskCacheBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+DiskCacheBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
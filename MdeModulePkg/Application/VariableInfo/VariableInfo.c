@@ -66,6 +66,70 @@ GetVariableStatisticsData (
   return Status;
 }
 
+/**
+  This function prints the statistics of the reclaims of the non-volatile variable store.
+
+  @param[in] ReclaimStatistics  The statistics of the reclaims.
+
+**/
+VOID
+PrintReclaimStatistics (
+  IN VARIABLE_RECLAIM_STATISTICS  *ReclaimStatistics
+  )
+{
+  Print (
+    L"Reclaims: %d (%d unchanged), blocks written: %d, blocks skipped: %d, bytes written: %ld\n",
+    ReclaimStatistics->ReclaimCount,
+    ReclaimStatistics->UnchangedCount,
+    ReclaimStatistics->BlocksWritten,
+    ReclaimStatistics->BlocksSkipped,
+    ReclaimStatistics->BytesWritten
+    );
+}
+
+/**
+  This function gets and prints the statistics of the reclaims of the non-volatile
+  variable store from SMM variable driver.
+
+  @param[in] CommBuffer    The SMM communication buffer.
+  @param[in] CommSize      The size of the SMM communication buffer.
+
+**/
+VOID
+PrintReclaimStatisticsFromSmm (
+  IN EFI_MM_COMMUNICATE_HEADER  *CommBuffer,
+  IN UINTN                      CommSize
+  )
+{
+  EFI_STATUS                       Status;
+  SMM_VARIABLE_COMMUNICATE_HEADER  *FunctionHeader;
+
+  if (CommSize < SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + sizeof (VARIABLE_RECLAIM_STATISTICS)) {
+    return;
+  }
+
+  ZeroMem (CommBuffer, CommSize);
+  CopyGuid (&CommBuffer->HeaderGuid, &gEfiSmmVariableProtocolGuid);
+  CommBuffer->MessageLength = SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + sizeof (VARIABLE_RECLAIM_STATISTICS);
+
+  FunctionHeader           = (SMM_VARIABLE_COMMUNICATE_HEADER *)&CommBuffer->Data[0];
+  FunctionHeader->Function = SMM_VARIABLE_FUNCTION_GET_RECLAIM_STATISTICS;
+
+  CommSize = SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + sizeof (VARIABLE_RECLAIM_STATISTICS);
+  Status   = mMmCommunication2->Communicate (
+                                  mMmCommunication2,
+                                  CommBuffer,
+                                  CommBuffer,
+                                  &CommSize
+                                  );
+  if (EFI_ERROR (Status) || EFI_ERROR (FunctionHeader->ReturnStatus)) {
+    return;
+  }
+
+  Print (L"SMM Driver Non-Volatile Variable Store:\n");
+  PrintReclaimStatistics ((VARIABLE_RECLAIM_STATISTICS *)FunctionHeader->Data);
+}
+
 /**
 
   This function get and print the variable statistics data from SMM variable driver.
@@ -193,6 +257,8 @@ PrintInfoFromSmm (
     }
   } while (TRUE);
 
+  PrintReclaimStatisticsFromSmm (CommBuffer, RealCommSize);
+
   return Status;
 }
 
@@ -215,10 +281,11 @@ UefiMain (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
-  EFI_STATUS           RuntimeDxeStatus;
-  EFI_STATUS           SmmStatus;
-  VARIABLE_INFO_ENTRY  *VariableInfo;
-  VARIABLE_INFO_ENTRY  *Entry;
+  EFI_STATUS                   RuntimeDxeStatus;
+  EFI_STATUS                   SmmStatus;
+  VARIABLE_INFO_ENTRY          *VariableInfo;
+  VARIABLE_INFO_ENTRY          *Entry;
+  VARIABLE_RECLAIM_STATISTICS  *ReclaimStatistics;
 
   RuntimeDxeStatus = EfiGetSystemConfigurationTable (&gEfiVariableGuid, (VOID **)&Entry);
   if (EFI_ERROR (RuntimeDxeStatus) || (Entry == NULL)) {
@@ -261,6 +328,11 @@ UefiMain (
 
       VariableInfo = VariableInfo->Next;
     } while (VariableInfo != NULL);
+
+    if (!EFI_ERROR (EfiGetSystemConfigurationTable (&gEdkiiVariableReclaimStatisticsGuid, (VOID **)&ReclaimStatistics))) {
+      Print (L"Runtime DXE Driver Non-Volatile Variable Store:\n");
+      PrintReclaimStatistics (ReclaimStatistics);
+    }
   }
 
   SmmStatus = PrintInfoFromSmm ();
@@ -19,6 +19,24 @@ BOOLEAN  *mDepexEvaluationStack        = NULL;
 BOOLEAN  *mDepexEvaluationStackEnd     = NULL;
 BOOLEAN  *mDepexEvaluationStackPointer = NULL;
 
+//
+// Reverse index from the protocol GUIDs pushed by dependency expressions to
+// the drivers that wait for them. Used to evaluate a dependency expression
+// again only when one of the protocols it references has changed.
+//
+#define DEPEX_WATCH_SIGNATURE   SIGNATURE_32 ('d', 'p', 'x', 'w')
+#define DEPEX_WATCH_TABLE_SIZE  64
+
+typedef struct {
+  UINTN                    Signature;
+  LIST_ENTRY               Link;
+  EFI_GUID                 ProtocolGuid;
+  EFI_CORE_DRIVER_ENTRY    *DriverEntry;
+} DEPEX_WATCH;
+
+LIST_ENTRY  mDepexWatchTable[DEPEX_WATCH_TABLE_SIZE];
+BOOLEAN     mDepexWatchTableReady = FALSE;
+
 //
 // Worker functions
 //
@@ -180,6 +198,221 @@ CorePreProcessDepex (
   return EFI_SUCCESS;
 }
 
+/**
+  Returns the bucket of mDepexWatchTable that holds a protocol GUID.
+
+  @param  ProtocolGuid          The protocol GUID.
+
+  @return The hash bucket list head.
+
+**/
+STATIC
+LIST_ENTRY *
+CoreGetDepexWatchBucket (
+  IN CONST EFI_GUID  *ProtocolGuid
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((UINT32 *)ProtocolGuid) ^ ReadUnaligned32 ((UINT32 *)ProtocolGuid + 3);
+  Hash = Hash ^ (Hash >> 16);
+  Hash = Hash ^ (Hash >> 8);
+
+  return &mDepexWatchTable[Hash & (DEPEX_WATCH_TABLE_SIZE - 1)];
+}
+
+/**
+  Records the protocols pushed by the dependency expression of a driver in
+  the reverse index, so that CoreDepexProtocolChanged() can tell the
+  dispatcher which drivers to evaluate again.
+
+  The driver is marked as indexed only if every protocol of its dependency
+  expression was recorded. Drivers that are not indexed are evaluated on
+  every pass of the dispatcher.
+
+  @param  DriverEntry           DriverEntry element to index.
+
+**/
+VOID
+CoreIndexDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8        *Iterator;
+  UINT8        *End;
+  LIST_ENTRY   *Bucket;
+  LIST_ENTRY   *Link;
+  DEPEX_WATCH  *Watch;
+  UINTN        Index;
+  BOOLEAN      Found;
+
+  if (DriverEntry->DepexIndexed || (DriverEntry->Depex == NULL) || DriverEntry->Before || DriverEntry->After) {
+    return;
+  }
+
+  if (!mDepexWatchTableReady) {
+    for (Index = 0; Index < DEPEX_WATCH_TABLE_SIZE; Index++) {
+      InitializeListHead (&mDepexWatchTable[Index]);
+    }
+
+    mDepexWatchTableReady = TRUE;
+  }
+
+  Iterator = DriverEntry->Depex;
+  End      = Iterator + DriverEntry->DepexSize;
+  while (Iterator < End) {
+    switch (*Iterator) {
+      case EFI_DEP_END:
+        DriverEntry->DepexIndexed = TRUE;
+        return;
+
+      case EFI_DEP_PUSH:
+      case EFI_DEP_REPLACE_TRUE:
+        if (Iterator + 1 + sizeof (EFI_GUID) > End) {
+          return;
+        }
+
+        //
+        // Each protocol is recorded once per driver
+        //
+        Bucket = CoreGetDepexWatchBucket ((EFI_GUID *)(Iterator + 1));
+        Found  = FALSE;
+        for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+          Watch = CR (Link, DEPEX_WATCH, Link, DEPEX_WATCH_SIGNATURE);
+          if ((Watch->DriverEntry == DriverEntry) && CompareGuid (&Watch->ProtocolGuid, (EFI_GUID *)(Iterator + 1))) {
+            Found = TRUE;
+            break;
+          }
+        }
+
+        if (!Found) {
+          Watch = AllocatePool (sizeof (DEPEX_WATCH));
+          if (Watch == NULL) {
+            return;
+          }
+
+          Watch->Signature   = DEPEX_WATCH_SIGNATURE;
+          Watch->DriverEntry = DriverEntry;
+          CopyMem (&Watch->ProtocolGuid, Iterator + 1, sizeof (EFI_GUID));
+          InsertTailList (Bucket, &Watch->Link);
+        }
+
+        Iterator += 1 + sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_BEFORE:
+      case EFI_DEP_AFTER:
+        //
+        // Not valid after the first opcode. CoreIsSchedulable() rejects them.
+        //
+        Iterator += 1 + sizeof (EFI_GUID);
+        break;
+
+      default:
+        Iterator++;
+        break;
+    }
+  }
+}
+
+/**
+  Removes and frees the protocol watches of a driver that has left the
+  Dependent state. The driver is no longer evaluated by the dispatcher, so
+  protocol notifications for its dependency expression are not needed.
+
+  @param  DriverEntry           The driver whose watches are removed.
+
+**/
+VOID
+CoreRemoveDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8        *Iterator;
+  UINT8        *End;
+  LIST_ENTRY   *Bucket;
+  LIST_ENTRY   *Link;
+  DEPEX_WATCH  *Watch;
+
+  DriverEntry->DepexIndexed     = FALSE;
+  DriverEntry->DepexUnsatisfied = FALSE;
+
+  if (!mDepexWatchTableReady || (DriverEntry->Depex == NULL)) {
+    return;
+  }
+
+  //
+  // Walk the same opcodes as CoreIndexDepexProtocols() so that a partially
+  // indexed expression is cleaned up too.
+  //
+  Iterator = DriverEntry->Depex;
+  End      = Iterator + DriverEntry->DepexSize;
+  while (Iterator < End) {
+    switch (*Iterator) {
+      case EFI_DEP_END:
+        return;
+
+      case EFI_DEP_PUSH:
+      case EFI_DEP_REPLACE_TRUE:
+        if (Iterator + 1 + sizeof (EFI_GUID) > End) {
+          return;
+        }
+
+        Bucket = CoreGetDepexWatchBucket ((EFI_GUID *)(Iterator + 1));
+        for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+          Watch = CR (Link, DEPEX_WATCH, Link, DEPEX_WATCH_SIGNATURE);
+          if ((Watch->DriverEntry == DriverEntry) && CompareGuid (&Watch->ProtocolGuid, (EFI_GUID *)(Iterator + 1))) {
+            RemoveEntryList (&Watch->Link);
+            FreePool (Watch);
+            break;
+          }
+        }
+
+        Iterator += 1 + sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_BEFORE:
+      case EFI_DEP_AFTER:
+        Iterator += 1 + sizeof (EFI_GUID);
+        break;
+
+      default:
+        Iterator++;
+        break;
+    }
+  }
+}
+
+/**
+  Tells the dispatcher that a protocol has been installed or uninstalled.
+  The drivers whose dependency expressions push the protocol are evaluated
+  again on the next pass of the dispatcher.
+
+  @param  Protocol              The protocol GUID.
+
+**/
+VOID
+CoreDepexProtocolChanged (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  LIST_ENTRY   *Bucket;
+  LIST_ENTRY   *Link;
+  DEPEX_WATCH  *Watch;
+
+  if (!mDepexWatchTableReady) {
+    return;
+  }
+
+  Bucket = CoreGetDepexWatchBucket (Protocol);
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    Watch = CR (Link, DEPEX_WATCH, Link, DEPEX_WATCH_SIGNATURE);
+    if (CompareGuid (&Watch->ProtocolGuid, Protocol)) {
+      Watch->DriverEntry->DepexUnsatisfied = FALSE;
+    }
+  }
+}
+
 /**
   This is the POSTFIX version of the dependency evaluator.  This code does
   not need to handle Before or After, as it is not valid to call this
@@ -60,6 +60,14 @@ EFI_LOCK  mDispatcherLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 //
 BOOLEAN  gDispatcherRunning = FALSE;
 
+//
+// Dispatcher statistics. The dependency expression of a driver is evaluated
+// again only if a protocol it references changed since its last evaluation.
+//
+UINTN  mDispatcherPasses        = 0;
+UINTN  mDepexEvaluations        = 0;
+UINTN  mDepexEvaluationsSkipped = 0;
+
 //
 // Module globals to manage the FwVol registration notification event
 //
@@ -276,6 +284,7 @@ CoreGetDepexSectionAndPreProccess (
     // Driver will be put in Dependent or Unrequested state
     //
     CorePreProcessDepex (DriverEntry);
+    CoreIndexDepexProtocols (DriverEntry);
     DriverEntry->DepexProtocolError = FALSE;
   }
 
@@ -433,6 +442,11 @@ CoreDispatcher (
 
   ReturnStatus = EFI_NOT_FOUND;
   do {
+    //
+    // Decode the sections of the scheduled drivers on the APs, if enabled
+    //
+    CorePrefetchScheduledSections (&mScheduledQueue);
+
     //
     // Drain the Scheduled Queue
     //
@@ -528,6 +542,8 @@ CoreDispatcher (
       ReturnStatus = EFI_SUCCESS;
     }
 
+    CoreFlushPrefetchedSections ();
+
     //
     // Now DXE Dispatcher finished one round of dispatch, signal an event group
     // so that SMM Dispatcher get chance to dispatch SMM Drivers which depend
@@ -541,6 +557,7 @@ CoreDispatcher (
     // Search DriverList for items to place on Scheduled Queue
     //
     ReadyToRun = FALSE;
+    mDispatcherPasses++;
     for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
       DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
 
@@ -552,7 +569,22 @@ CoreDispatcher (
       }
 
       if (DriverEntry->Dependent) {
+        if (DriverEntry->DepexUnsatisfied) {
+          //
+          // None of the protocols of the Depex changed since it evaluated to FALSE
+          //
+          mDepexEvaluationsSkipped++;
+          continue;
+        }
+
+        //
+        // Assume the Depex is still unsatisfied before evaluating it, so that a
+        // protocol installed by a notification during the evaluation is not missed.
+        //
+        DriverEntry->DepexUnsatisfied = DriverEntry->DepexIndexed;
+        mDepexEvaluations++;
         if (CoreIsSchedulable (DriverEntry)) {
+          DriverEntry->DepexUnsatisfied = FALSE;
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
         }
@@ -566,6 +598,14 @@ CoreDispatcher (
     }
   } while (ReadyToRun);
 
+  DEBUG ((
+    DEBUG_DISPATCH,
+    "DXE dispatcher: %Lu passes, %Lu DEPEX evaluations, %Lu skipped\n",
+    (UINT64)mDispatcherPasses,
+    (UINT64)mDepexEvaluations,
+    (UINT64)mDepexEvaluationsSkipped
+    ));
+
   //
   // Close DXE dispatch Event
   //
@@ -628,6 +668,11 @@ CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (
 
   CoreReleaseDispatcherLock ();
 
+  //
+  // The watches are freed outside the dispatcher lock, which is held at TPL_HIGH_LEVEL
+  //
+  CoreRemoveDepexProtocols (InsertedDriverEntry);
+
   //
   // Process After Dependency
   //
@@ -1421,6 +1466,7 @@ CoreFwVolEventProtocolNotify (
           DriverEntry->Scheduled = TRUE;
           InsertTailList (&mScheduledQueue, &DriverEntry->ScheduledLink);
           CoreReleaseDispatcherLock ();
+          CoreRemoveDepexProtocols (DriverEntry);
           DEBUG ((DEBUG_DISPATCH, "Evaluate DXE DEPEX for FFS(%g)\n", &DriverEntry->FileName));
           DEBUG ((DEBUG_DISPATCH, "  RESULT = TRUE (Apriori)\n"));
           break;
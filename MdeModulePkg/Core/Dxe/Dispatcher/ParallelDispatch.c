@@ -0,0 +1,570 @@
+/** @file
+  Use of the application processors by the DXE dispatcher.
+
+  Before the dispatcher drains the Scheduled Queue, the firmware files of the
+  scheduled drivers are read, and their compressed and GUIDed encapsulation
+  sections are decoded on the application processors. The section extraction
+  code picks up the decoded sections when the images are loaded instead of
+  decoding them again on the BSP.
+
+  All work that involves core services, such as reading files, allocating
+  buffers and publishing results, is done on the BSP. The application
+  processors only run the decoders on buffers the BSP has prepared. Only the
+  standard compression and the LZMA and Brotli GUIDed sections are decoded on
+  the application processors, as their decoders are known not to call boot
+  services. All other sections are decoded on the BSP when the images are
+  loaded. The feature is enabled with PcdDxeParallelDispatch.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+#define SECTION_PREFETCH_SIGNATURE  SIGNATURE_32 ('S', 'P', 'F', 'H')
+
+///
+/// The largest number of firmware files read ahead in one batch.
+///
+#define SECTION_PREFETCH_MAX_FILES  32
+
+typedef struct {
+  UINT32                       Signature;
+  LIST_ENTRY                   Link;
+  ///
+  /// The encapsulation section, in a file buffer owned by the prefetch.
+  ///
+  EFI_COMMON_SECTION_HEADER    *Section;
+  UINTN                        SectionSize;
+  BOOLEAN                      IsGuided;
+  ///
+  /// Buffers prepared by the BSP for the decoder.
+  ///
+  VOID                         *OutputBuffer;
+  UINT32                       OutputSize;
+  VOID                         *ScratchBuffer;
+  UINT32                       ScratchSize;
+  ///
+  /// Results of the decoder, written by an application processor.
+  ///
+  VOID                         *Result;
+  UINT32                       AuthenticationStatus;
+  EFI_STATUS                   Status;
+} SECTION_PREFETCH;
+
+typedef struct {
+  SECTION_PREFETCH    **Jobs;
+  UINTN               Count;
+  volatile UINT32     Next;
+} SECTION_PREFETCH_WORK;
+
+//
+// mPrefetchedSections - Decoded sections waiting to be used by CreateChildNode()
+// mPrefetchFileBuffer - File buffers holding the source of mPrefetchedSections
+//
+LIST_ENTRY                mPrefetchedSections = INITIALIZE_LIST_HEAD_VARIABLE (mPrefetchedSections);
+VOID                      *mPrefetchFileBuffer[SECTION_PREFETCH_MAX_FILES];
+UINTN                     mPrefetchFileCount = 0;
+EFI_MP_SERVICES_PROTOCOL  *mMpServices       = NULL;
+
+///
+/// The GUIDed sections whose decoders are safe to run on the application
+/// processors.
+///
+EFI_GUID  *mApSafeGuidedSections[] = {
+  &gLzmaCustomDecompressGuid,
+  &gLzmaF86CustomDecompressGuid,
+  &gBrotliCustomDecompressGuid
+};
+
+/**
+  Frees a section prefetch and its buffers.
+
+  @param  Prefetch               The section prefetch to free.
+
+**/
+STATIC
+VOID
+CoreFreeSectionPrefetch (
+  IN SECTION_PREFETCH  *Prefetch
+  )
+{
+  if (Prefetch->OutputBuffer != NULL) {
+    CoreFreePool (Prefetch->OutputBuffer);
+  }
+
+  if (Prefetch->ScratchBuffer != NULL) {
+    CoreFreePool (Prefetch->ScratchBuffer);
+  }
+
+  CoreFreePool (Prefetch);
+}
+
+/**
+  Creates a section prefetch for an encapsulation section if the section is
+  decoded by the DXE core itself with a decoder that is safe to run on the
+  application processors, and allocates the buffers of its decoder.
+
+  @param  Section                The section to prefetch.
+  @param  SectionSize            The size of the section.
+
+  @return The section prefetch, or NULL if the section is not prefetched.
+
+**/
+STATIC
+SECTION_PREFETCH *
+CoreCreateSectionPrefetch (
+  IN EFI_COMMON_SECTION_HEADER  *Section,
+  IN UINTN                      SectionSize
+  )
+{
+  EFI_STATUS        Status;
+  SECTION_PREFETCH  *Prefetch;
+  VOID              *Interface;
+  EFI_GUID          *SectionDefinitionGuid;
+  VOID              *CompressionSource;
+  UINT32            CompressionSourceSize;
+  UINT32            UncompressedLength;
+  UINT8             CompressionType;
+  UINT16            SectionAttribute;
+  UINT32            OutputSize;
+  UINT32            ScratchSize;
+  UINTN             Index;
+
+  if (Section->Type == EFI_SECTION_COMPRESSION) {
+    if (IS_SECTION2 (Section)) {
+      if (SectionSize < sizeof (EFI_COMPRESSION_SECTION2)) {
+        return NULL;
+      }
+
+      CompressionSource     = (UINT8 *)Section + sizeof (EFI_COMPRESSION_SECTION2);
+      CompressionSourceSize = (UINT32)(SectionSize - sizeof (EFI_COMPRESSION_SECTION2));
+      UncompressedLength    = ((EFI_COMPRESSION_SECTION2 *)Section)->UncompressedLength;
+      CompressionType       = ((EFI_COMPRESSION_SECTION2 *)Section)->CompressionType;
+    } else {
+      if (SectionSize < sizeof (EFI_COMPRESSION_SECTION)) {
+        return NULL;
+      }
+
+      CompressionSource     = (UINT8 *)Section + sizeof (EFI_COMPRESSION_SECTION);
+      CompressionSourceSize = (UINT32)(SectionSize - sizeof (EFI_COMPRESSION_SECTION));
+      UncompressedLength    = ((EFI_COMPRESSION_SECTION *)Section)->UncompressedLength;
+      CompressionType       = ((EFI_COMPRESSION_SECTION *)Section)->CompressionType;
+    }
+
+    //
+    // Only the decompress protocol of the DXE core is known to be safe to
+    // run on the application processors.
+    //
+    if ((CompressionType != EFI_STANDARD_COMPRESSION) || (UncompressedLength == 0)) {
+      return NULL;
+    }
+
+    Status = CoreLocateProtocol (&gEfiDecompressProtocolGuid, NULL, &Interface);
+    if (EFI_ERROR (Status) || (Interface != &gEfiDecompress)) {
+      return NULL;
+    }
+
+    Status = gEfiDecompress.GetInfo (
+                              &gEfiDecompress,
+                              CompressionSource,
+                              CompressionSourceSize,
+                              &OutputSize,
+                              &ScratchSize
+                              );
+    if (EFI_ERROR (Status) || (OutputSize != UncompressedLength)) {
+      return NULL;
+    }
+  } else if (Section->Type == EFI_SECTION_GUID_DEFINED) {
+    if (IS_SECTION2 (Section)) {
+      if (SectionSize < sizeof (EFI_GUID_DEFINED_SECTION2)) {
+        return NULL;
+      }
+
+      SectionDefinitionGuid = &((EFI_GUID_DEFINED_SECTION2 *)Section)->SectionDefinitionGuid;
+    } else {
+      if (SectionSize < sizeof (EFI_GUID_DEFINED_SECTION)) {
+        return NULL;
+      }
+
+      SectionDefinitionGuid = &((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid;
+    }
+
+    //
+    // Only the GUIDs known to have decoders free of calls to boot services,
+    // and registered with the extract guided section library of the DXE core,
+    // are decoded on the application processors. Other decoders, such as the
+    // CRC32 one, use boot services and are left to the BSP.
+    //
+    for (Index = 0; Index < ARRAY_SIZE (mApSafeGuidedSections); Index++) {
+      if (CompareGuid (SectionDefinitionGuid, mApSafeGuidedSections[Index])) {
+        break;
+      }
+    }
+
+    if (Index == ARRAY_SIZE (mApSafeGuidedSections)) {
+      return NULL;
+    }
+
+    Status = CoreLocateProtocol (SectionDefinitionGuid, NULL, &Interface);
+    if (EFI_ERROR (Status) || (Interface != &mCustomGuidedSectionExtractionProtocol)) {
+      return NULL;
+    }
+
+    Status = ExtractGuidedSectionGetInfo (Section, &OutputSize, &ScratchSize, &SectionAttribute);
+    if (EFI_ERROR (Status) || (OutputSize == 0)) {
+      return NULL;
+    }
+  } else {
+    return NULL;
+  }
+
+  Prefetch = AllocateZeroPool (sizeof (SECTION_PREFETCH));
+  if (Prefetch == NULL) {
+    return NULL;
+  }
+
+  Prefetch->Signature    = SECTION_PREFETCH_SIGNATURE;
+  Prefetch->Section      = Section;
+  Prefetch->SectionSize  = SectionSize;
+  Prefetch->IsGuided     = (BOOLEAN)(Section->Type == EFI_SECTION_GUID_DEFINED);
+  Prefetch->OutputSize   = OutputSize;
+  Prefetch->ScratchSize  = ScratchSize;
+  Prefetch->Status       = EFI_NOT_STARTED;
+  Prefetch->OutputBuffer = AllocatePool (OutputSize);
+  if (ScratchSize > 0) {
+    Prefetch->ScratchBuffer = AllocatePool (ScratchSize);
+  }
+
+  if ((Prefetch->OutputBuffer == NULL) || ((ScratchSize > 0) && (Prefetch->ScratchBuffer == NULL))) {
+    CoreFreeSectionPrefetch (Prefetch);
+    return NULL;
+  }
+
+  return Prefetch;
+}
+
+/**
+  Decodes one prefetched section. This function runs on the application
+  processors and must not use any core service.
+
+  @param  Prefetch               The section prefetch to decode.
+
+**/
+STATIC
+VOID
+CoreDecodeSectionPrefetch (
+  IN OUT SECTION_PREFETCH  *Prefetch
+  )
+{
+  EFI_COMMON_SECTION_HEADER  *Section;
+  UINTN                      HeaderSize;
+
+  Section = Prefetch->Section;
+  if (Prefetch->IsGuided) {
+    Prefetch->Result = Prefetch->OutputBuffer;
+    Prefetch->Status = ExtractGuidedSectionDecode (
+                         Section,
+                         &Prefetch->Result,
+                         Prefetch->ScratchBuffer,
+                         &Prefetch->AuthenticationStatus
+                         );
+    return;
+  }
+
+  HeaderSize       = IS_SECTION2 (Section) ? sizeof (EFI_COMPRESSION_SECTION2) : sizeof (EFI_COMPRESSION_SECTION);
+  Prefetch->Result = Prefetch->OutputBuffer;
+  Prefetch->Status = gEfiDecompress.Decompress (
+                                      &gEfiDecompress,
+                                      (UINT8 *)Section + HeaderSize,
+                                      (UINT32)(Prefetch->SectionSize - HeaderSize),
+                                      Prefetch->OutputBuffer,
+                                      Prefetch->OutputSize,
+                                      Prefetch->ScratchBuffer,
+                                      Prefetch->ScratchSize
+                                      );
+}
+
+/**
+  Application processor procedure. Takes section prefetches from the shared
+  work list until the list is exhausted.
+
+  @param  Buffer                 The SECTION_PREFETCH_WORK of the batch.
+
+**/
+STATIC
+VOID
+EFIAPI
+CoreSectionPrefetchProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  SECTION_PREFETCH_WORK  *Work;
+  UINTN                  Index;
+
+  Work = (SECTION_PREFETCH_WORK *)Buffer;
+  for ( ; ;) {
+    Index = (UINTN)InterlockedIncrement (&Work->Next) - 1;
+    if (Index >= Work->Count) {
+      break;
+    }
+
+    CoreDecodeSectionPrefetch (Work->Jobs[Index]);
+  }
+}
+
+/**
+  Reads the firmware files of the drivers in the Scheduled Queue, and decodes
+  their top level encapsulation sections on the application processors.
+
+  This function does nothing unless PcdDxeParallelDispatch is TRUE and the
+  MP Services Protocol has been installed.
+
+  @param  ScheduledQueue         The Scheduled Queue of the dispatcher.
+
+**/
+VOID
+CorePrefetchScheduledSections (
+  IN LIST_ENTRY  *ScheduledQueue
+  )
+{
+  EFI_STATUS                 Status;
+  LIST_ENTRY                 *Link;
+  EFI_CORE_DRIVER_ENTRY      *DriverEntry;
+  SECTION_PREFETCH           *Prefetch;
+  SECTION_PREFETCH_WORK      Work;
+  EFI_COMMON_SECTION_HEADER  *Section;
+  VOID                       *FileBuffer;
+  UINTN                      FileSize;
+  UINTN                      SectionSize;
+  UINTN                      Offset;
+  EFI_FV_FILETYPE            FileType;
+  EFI_FV_FILE_ATTRIBUTES     FileAttributes;
+  UINT32                     AuthenticationStatus;
+  UINTN                      NumberOfProcessors;
+  UINTN                      NumberOfEnabledProcessors;
+  UINTN                      Index;
+
+  if (!FeaturePcdGet (PcdDxeParallelDispatch)) {
+    return;
+  }
+
+  if (mMpServices == NULL) {
+    Status = CoreLocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&mMpServices);
+    if (EFI_ERROR (Status)) {
+      mMpServices = NULL;
+      return;
+    }
+  }
+
+  Status = mMpServices->GetNumberOfProcessors (mMpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return;
+  }
+
+  ASSERT (IsListEmpty (&mPrefetchedSections));
+
+  PERF_INMODULE_BEGIN ("DxeSectionPrefetch");
+
+  //
+  // Read the files of the scheduled drivers and collect the encapsulation
+  // sections at the top level of each file
+  //
+  Work.Count = 0;
+  for (Link = ScheduledQueue->ForwardLink;
+       (Link != ScheduledQueue) && (mPrefetchFileCount < SECTION_PREFETCH_MAX_FILES);
+       Link = Link->ForwardLink)
+  {
+    DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, ScheduledLink, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+    if ((DriverEntry->ImageHandle != NULL) || DriverEntry->IsFvImage || (DriverEntry->Fv == NULL)) {
+      continue;
+    }
+
+    FileBuffer = NULL;
+    Status     = DriverEntry->Fv->ReadFile (
+                                    DriverEntry->Fv,
+                                    &DriverEntry->FileName,
+                                    &FileBuffer,
+                                    &FileSize,
+                                    &FileType,
+                                    &FileAttributes,
+                                    &AuthenticationStatus
+                                    );
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    mPrefetchFileBuffer[mPrefetchFileCount++] = FileBuffer;
+
+    for (Offset = 0; Offset + sizeof (EFI_COMMON_SECTION_HEADER) <= FileSize; Offset += ALIGN_VALUE (SectionSize, 4)) {
+      Section = (EFI_COMMON_SECTION_HEADER *)((UINT8 *)FileBuffer + Offset);
+      if (IS_SECTION2 (Section)) {
+        if (Offset + sizeof (EFI_COMMON_SECTION_HEADER2) > FileSize) {
+          break;
+        }
+
+        SectionSize = SECTION2_SIZE (Section);
+      } else {
+        SectionSize = SECTION_SIZE (Section);
+      }
+
+      if ((SectionSize < sizeof (EFI_COMMON_SECTION_HEADER)) || (SectionSize > FileSize - Offset)) {
+        break;
+      }
+
+      Prefetch = CoreCreateSectionPrefetch (Section, SectionSize);
+      if (Prefetch != NULL) {
+        InsertTailList (&mPrefetchedSections, &Prefetch->Link);
+        Work.Count++;
+      }
+    }
+  }
+
+  if (Work.Count == 0) {
+    PERF_INMODULE_END ("DxeSectionPrefetch");
+    return;
+  }
+
+  Work.Jobs = AllocatePool (Work.Count * sizeof (SECTION_PREFETCH *));
+  if (Work.Jobs == NULL) {
+    PERF_INMODULE_END ("DxeSectionPrefetch");
+    CoreFlushPrefetchedSections ();
+    return;
+  }
+
+  Index = 0;
+  for (Link = mPrefetchedSections.ForwardLink; Link != &mPrefetchedSections; Link = Link->ForwardLink) {
+    Work.Jobs[Index++] = CR (Link, SECTION_PREFETCH, Link, SECTION_PREFETCH_SIGNATURE);
+  }
+
+  //
+  // Decode the sections on the application processors. If they cannot be
+  // started, the BSP decodes the sections itself.
+  //
+  Work.Next = 0;
+  Status    = mMpServices->StartupAllAPs (
+                             mMpServices,
+                             CoreSectionPrefetchProcedure,
+                             FALSE,
+                             NULL,
+                             0,
+                             &Work,
+                             NULL
+                             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "DXE section prefetch could not start the APs - %r\n", Status));
+  }
+
+  CoreSectionPrefetchProcedure (&Work);
+
+  CoreFreePool (Work.Jobs);
+
+  //
+  // Release the scratch buffers, and drop the sections that failed to decode
+  // so that they are decoded again, and the error reported, on the normal path
+  //
+  Link = mPrefetchedSections.ForwardLink;
+  while (Link != &mPrefetchedSections) {
+    Prefetch = CR (Link, SECTION_PREFETCH, Link, SECTION_PREFETCH_SIGNATURE);
+    Link     = Link->ForwardLink;
+
+    if (Prefetch->ScratchBuffer != NULL) {
+      CoreFreePool (Prefetch->ScratchBuffer);
+      Prefetch->ScratchBuffer = NULL;
+    }
+
+    if (EFI_ERROR (Prefetch->Status)) {
+      RemoveEntryList (&Prefetch->Link);
+      CoreFreeSectionPrefetch (Prefetch);
+      continue;
+    }
+
+    if (Prefetch->Result != Prefetch->OutputBuffer) {
+      //
+      // The decoder returned the section data in place
+      //
+      CopyMem (Prefetch->OutputBuffer, Prefetch->Result, Prefetch->OutputSize);
+      Prefetch->Result = Prefetch->OutputBuffer;
+    }
+  }
+
+  PERF_INMODULE_END ("DxeSectionPrefetch");
+}
+
+/**
+  Returns the decoded contents of an encapsulation section if the section
+  was decoded ahead of time by CorePrefetchScheduledSections().
+
+  The section is matched by its contents, so the caller may pass a section
+  from any copy of the firmware file. On success the caller owns the
+  returned buffer.
+
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of the section.
+  @param  Buffer                 Returns the decoded section contents.
+  @param  BufferSize             Returns the size of the decoded contents.
+  @param  AuthenticationStatus   Returns the authentication status reported
+                                 by the decoder of a GUIDed section. Optional.
+
+  @retval TRUE                   The decoded contents were returned.
+  @retval FALSE                  The section was not prefetched.
+
+**/
+BOOLEAN
+CoreTakePrefetchedSection (
+  IN  VOID    *Section,
+  IN  UINTN   SectionSize,
+  OUT VOID    **Buffer,
+  OUT UINTN   *BufferSize,
+  OUT UINT32  *AuthenticationStatus OPTIONAL
+  )
+{
+  LIST_ENTRY        *Link;
+  SECTION_PREFETCH  *Prefetch;
+
+  for (Link = mPrefetchedSections.ForwardLink; Link != &mPrefetchedSections; Link = Link->ForwardLink) {
+    Prefetch = CR (Link, SECTION_PREFETCH, Link, SECTION_PREFETCH_SIGNATURE);
+    if ((Prefetch->SectionSize != SectionSize) ||
+        ((Section != Prefetch->Section) && (CompareMem (Section, Prefetch->Section, SectionSize) != 0)))
+    {
+      continue;
+    }
+
+    RemoveEntryList (&Prefetch->Link);
+    *Buffer     = Prefetch->OutputBuffer;
+    *BufferSize = Prefetch->OutputSize;
+    if (AuthenticationStatus != NULL) {
+      *AuthenticationStatus = Prefetch->AuthenticationStatus;
+    }
+
+    Prefetch->OutputBuffer = NULL;
+    CoreFreeSectionPrefetch (Prefetch);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Frees the prefetched sections that were not used, and the file buffers
+  read by CorePrefetchScheduledSections().
+
+**/
+VOID
+CoreFlushPrefetchedSections (
+  VOID
+  )
+{
+  SECTION_PREFETCH  *Prefetch;
+
+  while (!IsListEmpty (&mPrefetchedSections)) {
+    Prefetch = CR (mPrefetchedSections.ForwardLink, SECTION_PREFETCH, Link, SECTION_PREFETCH_SIGNATURE);
+    RemoveEntryList (&Prefetch->Link);
+    CoreFreeSectionPrefetch (Prefetch);
+  }
+
+  while (mPrefetchFileCount > 0) {
+    CoreFreePool (mPrefetchFileBuffer[--mPrefetchFileCount]);
+  }
+}
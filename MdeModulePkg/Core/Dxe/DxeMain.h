@@ -28,6 +28,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/RealTimeClock.h>
 #include <Protocol/WatchdogTimer.h>
 #include <Protocol/FirmwareVolume2.h>
+#include <Protocol/FirmwareVolumeSectionInPlace.h>
 #include <Protocol/MonotonicCounter.h>
 #include <Protocol/StatusCode.h>
 #include <Protocol/Decompress.h>
@@ -45,6 +46,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/SmmBase2.h>
 #include <Protocol/PeCoffImageEmulator.h>
+#include <Protocol/MpService.h>
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
@@ -85,6 +87,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugAgentLib.h>
 #include <Library/CpuExceptionHandlerLib.h>
 #include <Library/OrderedCollectionLib.h>
+#include <Library/SynchronizationLib.h>
 
 //
 // attributes for reserved memory before it is promoted to system memory
@@ -158,6 +161,14 @@ typedef struct {
   BOOLEAN                          Untrusted;
   BOOLEAN                          Initialized;
   BOOLEAN                          DepexProtocolError;
+  ///
+  /// The protocols of the Depex are in the reverse index of the dispatcher.
+  ///
+  BOOLEAN                          DepexIndexed;
+  ///
+  /// The Depex evaluated to FALSE, and none of its protocols changed since.
+  ///
+  BOOLEAN                          DepexUnsatisfied;
 
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
@@ -241,6 +252,8 @@ extern BOOLEAN  gMemoryMapTerminated;
 
 extern EFI_DECOMPRESS_PROTOCOL  gEfiDecompress;
 
+extern EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL  mCustomGuidedSectionExtractionProtocol;
+
 extern EFI_RUNTIME_ARCH_PROTOCOL         *gRuntime;
 extern EFI_CPU_ARCH_PROTOCOL             *gCpu;
 extern EFI_WATCHDOG_TIMER_ARCH_PROTOCOL  *gWatchdogTimer;
@@ -484,6 +497,48 @@ CorePreProcessDepex (
   IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
   );
 
+/**
+  Records the protocols pushed by the dependency expression of a driver in
+  the reverse index, so that CoreDepexProtocolChanged() can tell the
+  dispatcher which drivers to evaluate again.
+
+  The driver is marked as indexed only if every protocol of its dependency
+  expression was recorded. Drivers that are not indexed are evaluated on
+  every pass of the dispatcher.
+
+  @param  DriverEntry           DriverEntry element to index.
+
+**/
+VOID
+CoreIndexDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
+/**
+  Removes and frees the protocol watches of a driver that has left the
+  Dependent state.
+
+  @param  DriverEntry           The driver whose watches are removed.
+
+**/
+VOID
+CoreRemoveDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
+/**
+  Tells the dispatcher that a protocol has been installed or uninstalled.
+  The drivers whose dependency expressions push the protocol are evaluated
+  again on the next pass of the dispatcher.
+
+  @param  Protocol              The protocol GUID.
+
+**/
+VOID
+CoreDepexProtocolChanged (
+  IN CONST EFI_GUID  *Protocol
+  );
+
 /**
   Terminates all boot services.
 
@@ -2322,6 +2377,52 @@ GetSection (
   IN BOOLEAN           IsFfs3Fv
   );
 
+/**
+  Retrieves requested section from section stream in place, without copying
+  its contents.
+
+  The section is returned in place only if it is not in an encapsulation
+  section. The returned buffer is in the buffer of the section stream, it
+  belongs to the creator of the section stream and is valid until the stream
+  is closed.
+
+  @param  SectionStreamHandle   The section stream from which to extract the
+                                requested section.
+  @param  SectionType           A pointer to the type of section to search for,
+                                or NULL for the whole section stream.
+  @param  SectionDefinitionGuid If the section type is EFI_SECTION_GUID_DEFINED,
+                                then SectionDefinitionGuid indicates which of
+                                these types of sections to search for.
+  @param  SectionInstance       Indicates which instance of the requested
+                                section to return.
+  @param  Buffer                Returns a pointer to the contents of the section.
+  @param  BufferSize            Returns the size of the contents of the section.
+  @param  AuthenticationStatus  A pointer to a caller-allocated UINT32 that
+                                indicates the authentication status of the
+                                section, as returned by GetSection().
+  @param  IsFfs3Fv              Indicates the FV format.
+
+  @retval EFI_SUCCESS           Section was retrieved successfully.
+  @retval EFI_UNSUPPORTED       The section is in an encapsulation section and
+                                must be retrieved with GetSection().
+  @retval EFI_NOT_FOUND         The requested section does not exist.
+  @retval EFI_INVALID_PARAMETER The SectionStreamHandle does not exist.
+  @retval others                The section stream could not be expanded.
+
+**/
+EFI_STATUS
+EFIAPI
+GetSectionInPlace (
+  IN  UINTN             SectionStreamHandle,
+  IN  EFI_SECTION_TYPE  *SectionType,
+  IN  EFI_GUID          *SectionDefinitionGuid,
+  IN  UINTN             SectionInstance,
+  OUT VOID              **Buffer,
+  OUT UINTN             *BufferSize,
+  OUT UINT32            *AuthenticationStatus,
+  IN  BOOLEAN           IsFfs3Fv
+  );
+
 /**
   SEP member function.  Deletes an existing section stream
 
@@ -2342,6 +2443,59 @@ CloseSectionStream (
   IN  BOOLEAN  FreeStreamBuffer
   );
 
+/**
+  Reads the firmware files of the drivers in the Scheduled Queue, and decodes
+  their top level encapsulation sections on the application processors.
+
+  This function does nothing unless PcdDxeParallelDispatch is TRUE and the
+  MP Services Protocol has been installed.
+
+  @param  ScheduledQueue         The Scheduled Queue of the dispatcher.
+
+**/
+VOID
+CorePrefetchScheduledSections (
+  IN LIST_ENTRY  *ScheduledQueue
+  );
+
+/**
+  Returns the decoded contents of an encapsulation section if the section
+  was decoded ahead of time by CorePrefetchScheduledSections().
+
+  The section is matched by its contents, so the caller may pass a section
+  from any copy of the firmware file. On success the caller owns the
+  returned buffer.
+
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of the section.
+  @param  Buffer                 Returns the decoded section contents.
+  @param  BufferSize             Returns the size of the decoded contents.
+  @param  AuthenticationStatus   Returns the authentication status reported
+                                 by the decoder of a GUIDed section. Optional.
+
+  @retval TRUE                   The decoded contents were returned.
+  @retval FALSE                  The section was not prefetched.
+
+**/
+BOOLEAN
+CoreTakePrefetchedSection (
+  IN  VOID    *Section,
+  IN  UINTN   SectionSize,
+  OUT VOID    **Buffer,
+  OUT UINTN   *BufferSize,
+  OUT UINT32  *AuthenticationStatus OPTIONAL
+  );
+
+/**
+  Frees the prefetched sections that were not used, and the file buffers
+  read by CorePrefetchScheduledSections().
+
+**/
+VOID
+CoreFlushPrefetchedSections (
+  VOID
+  );
+
 /**
   Creates and initializes the DebugImageInfo Table.  Also creates the configuration
   table and registers it into the system table.
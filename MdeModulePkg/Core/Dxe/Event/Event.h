@@ -10,6 +10,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef __EVENT_H__
 #define __EVENT_H__
 
+#include "TimerQueue.h"
+
 #define VALID_TPL(a)  ((a) <= TPL_HIGH_LEVEL)
 extern  UINTN  gEventPending;
 
@@ -30,9 +32,11 @@ extern  UINTN  gEventPending;
 /// Timer event information
 ///
 typedef struct {
-  LIST_ENTRY    Link;
-  UINT64        TriggerTime;
-  UINT64        Period;
+  ///
+  /// Entry in the timer queue. Node.TriggerTime holds the trigger time.
+  ///
+  TIMER_QUEUE_NODE    Node;
+  UINT64              Period;
 } TIMER_EVENT_INFO;
 
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
@@ -13,9 +13,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Internal data
 //
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
-EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
-EFI_EVENT   mEfiCheckTimerEvent = NULL;
+TIMER_QUEUE  mEfiTimerQueue      = INITIALIZE_TIMER_QUEUE_VARIABLE;
+EFI_LOCK     mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
+EFI_EVENT    mEfiCheckTimerEvent = NULL;
 
 EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64    mEfiSystemTime     = 0;
@@ -27,6 +27,9 @@ UINT64    mEfiSystemTime     = 0;
 /**
   Inserts the timer event.
 
+  The timer queue keeps events in ascending trigger time order, and events
+  with the same trigger time in the order they were inserted.
+
   @param  Event                  Points to the internal structure of timer event
                                  to be installed
 
@@ -36,29 +39,31 @@ CoreInsertEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
-  LIST_ENTRY  *Link;
-  IEVENT      *Event2;
-
   ASSERT_LOCKED (&mEfiTimerLock);
 
-  //
-  // Get the timer's trigger time
-  //
-  TriggerTime = Event->Timer.TriggerTime;
+  TimerQueueInsert (&mEfiTimerQueue, &Event->Timer.Node);
+}
 
-  //
-  // Insert the timer into the timer database in assending sorted order
-  //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+/**
+  Returns the timer event with the earliest trigger time.
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
-      break;
-    }
+  @return The first timer event in the timer queue, or NULL if it is empty.
+
+**/
+STATIC
+IEVENT *
+CoreFirstEventTimer (
+  VOID
+  )
+{
+  TIMER_QUEUE_NODE  *Node;
+
+  Node = TimerQueueFirst (&mEfiTimerQueue);
+  if (Node == NULL) {
+    return NULL;
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  return CR (Node, IEVENT, Timer.Node, EVENT_SIGNATURE);
 }
 
 /**
@@ -105,22 +110,18 @@ CoreCheckTimers (
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
+  for (Event = CoreFirstEventTimer (); Event != NULL; Event = CoreFirstEventTimer ()) {
     //
     // If this timer is not expired, then we're done
     //
-    if (Event->Timer.TriggerTime > SystemTime) {
+    if (Event->Timer.Node.TriggerTime > SystemTime) {
       break;
     }
 
     //
     // Remove this timer from the timer queue
     //
-
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    TimerQueueRemove (&mEfiTimerQueue, &Event->Timer.Node);
 
     //
     // Signal it
@@ -134,13 +135,13 @@ CoreCheckTimers (
       //
       // Compute the timers new trigger time
       //
-      Event->Timer.TriggerTime = Event->Timer.TriggerTime + Event->Timer.Period;
+      Event->Timer.Node.TriggerTime = Event->Timer.Node.TriggerTime + Event->Timer.Period;
 
       //
       // If that's before now, then reset the timer to start from now
       //
-      if (Event->Timer.TriggerTime <= SystemTime) {
-        Event->Timer.TriggerTime = SystemTime;
+      if (Event->Timer.Node.TriggerTime <= SystemTime) {
+        Event->Timer.Node.TriggerTime = SystemTime;
         CoreSignalEvent (mEfiCheckTimerEvent);
       }
 
@@ -202,13 +203,12 @@ CoreTimerTick (
   mEfiSystemTime += Duration;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the head of the queue is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
-    if (Event->Timer.TriggerTime <= mEfiSystemTime) {
+  Event = CoreFirstEventTimer ();
+  if (Event != NULL) {
+    if (Event->Timer.Node.TriggerTime <= mEfiSystemTime) {
       CoreSignalEvent (mEfiCheckTimerEvent);
     }
   }
@@ -260,13 +260,12 @@ CoreSetTimer (
   //
   // If the timer is queued to the timer database, remove it
   //
-  if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+  if (TimerQueueIsQueued (&Event->Timer.Node)) {
+    TimerQueueRemove (&mEfiTimerQueue, &Event->Timer.Node);
   }
 
-  Event->Timer.TriggerTime = 0;
-  Event->Timer.Period      = 0;
+  Event->Timer.Node.TriggerTime = 0;
+  Event->Timer.Period           = 0;
 
   if (Type != TimerCancel) {
     if (Type == TimerPeriodic) {
@@ -277,7 +276,7 @@ CoreSetTimer (
       Event->Timer.Period = TriggerTime;
     }
 
-    Event->Timer.TriggerTime = CoreCurrentSystemTime () + TriggerTime;
+    Event->Timer.Node.TriggerTime = CoreCurrentSystemTime () + TriggerTime;
     CoreInsertEventTimer (Event);
 
     if (TriggerTime == 0) {
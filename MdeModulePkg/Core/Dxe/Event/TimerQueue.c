@@ -0,0 +1,255 @@
+/** @file
+  Timer queue used by the DXE core to order timer events by trigger time.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Library/DebugLib.h>
+
+#include "TimerQueue.h"
+
+/**
+  Checks whether node A must be signaled before node B.
+
+  @param  A                      The first node.
+  @param  B                      The second node.
+
+  @retval TRUE                   A comes before B.
+  @retval FALSE                  B comes before A.
+
+**/
+STATIC
+BOOLEAN
+TimerQueueIsBefore (
+  IN TIMER_QUEUE_NODE  *A,
+  IN TIMER_QUEUE_NODE  *B
+  )
+{
+  if (A->TriggerTime != B->TriggerTime) {
+    return (BOOLEAN)(A->TriggerTime < B->TriggerTime);
+  }
+
+  return (BOOLEAN)(A->Sequence < B->Sequence);
+}
+
+/**
+  Links two heaps together.
+
+  Both nodes must be heap roots with no siblings.
+
+  @param  A                      The root of the first heap.
+  @param  B                      The root of the second heap.
+
+  @return The root of the combined heap.
+
+**/
+STATIC
+TIMER_QUEUE_NODE *
+TimerQueueMeld (
+  IN TIMER_QUEUE_NODE  *A,
+  IN TIMER_QUEUE_NODE  *B
+  )
+{
+  TIMER_QUEUE_NODE  *Temp;
+
+  if (TimerQueueIsBefore (B, A)) {
+    Temp = A;
+    A    = B;
+    B    = Temp;
+  }
+
+  //
+  // Make B the leftmost child of A
+  //
+  B->Prev    = A;
+  B->Sibling = A->Child;
+  if (A->Child != NULL) {
+    A->Child->Prev = B;
+  }
+
+  A->Child   = B;
+  A->Prev    = NULL;
+  A->Sibling = NULL;
+
+  return A;
+}
+
+/**
+  Combines a list of sibling heaps into a single heap using the two pass
+  pairing method.
+
+  @param  First                  The leftmost heap of the sibling list.
+
+  @return The root of the combined heap, or NULL if First is NULL.
+
+**/
+STATIC
+TIMER_QUEUE_NODE *
+TimerQueueMergePairs (
+  IN TIMER_QUEUE_NODE  *First
+  )
+{
+  TIMER_QUEUE_NODE  *Stack;
+  TIMER_QUEUE_NODE  *A;
+  TIMER_QUEUE_NODE  *B;
+  TIMER_QUEUE_NODE  *Next;
+
+  //
+  // First pass, left to right: meld the siblings in pairs and push each
+  // result onto a stack linked through Sibling.
+  //
+  Stack = NULL;
+  while (First != NULL) {
+    A    = First;
+    B    = A->Sibling;
+    Next = NULL;
+
+    A->Prev    = NULL;
+    A->Sibling = NULL;
+    if (B != NULL) {
+      Next       = B->Sibling;
+      B->Prev    = NULL;
+      B->Sibling = NULL;
+      A          = TimerQueueMeld (A, B);
+    }
+
+    A->Sibling = Stack;
+    Stack      = A;
+    First      = Next;
+  }
+
+  if (Stack == NULL) {
+    return NULL;
+  }
+
+  //
+  // Second pass, right to left: meld the stacked heaps into one.
+  //
+  A          = Stack;
+  Stack      = Stack->Sibling;
+  A->Sibling = NULL;
+  while (Stack != NULL) {
+    Next           = Stack->Sibling;
+    Stack->Sibling = NULL;
+    A              = TimerQueueMeld (A, Stack);
+    Stack          = Next;
+  }
+
+  return A;
+}
+
+/**
+  Inserts a node into the timer queue.
+
+  The caller must set Node->TriggerTime before calling this function.
+
+  @param  Queue                  The timer queue.
+  @param  Node                   The node to insert. It must not be queued.
+
+**/
+VOID
+TimerQueueInsert (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node
+  )
+{
+  ASSERT (!Node->Queued);
+
+  Node->Prev     = NULL;
+  Node->Child    = NULL;
+  Node->Sibling  = NULL;
+  Node->Sequence = Queue->NextSequence++;
+  Node->Queued   = TRUE;
+
+  if (Queue->Root == NULL) {
+    Queue->Root = Node;
+  } else {
+    Queue->Root = TimerQueueMeld (Queue->Root, Node);
+  }
+
+  Queue->Count++;
+}
+
+/**
+  Removes a node from the timer queue.
+
+  @param  Queue                  The timer queue.
+  @param  Node                   The node to remove. It must be queued.
+
+**/
+VOID
+TimerQueueRemove (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node
+  )
+{
+  TIMER_QUEUE_NODE  *SubHeap;
+
+  ASSERT (Node->Queued);
+  ASSERT (Queue->Count > 0);
+
+  if (Node == Queue->Root) {
+    Queue->Root = TimerQueueMergePairs (Node->Child);
+  } else {
+    //
+    // Unlink the node from its parent or previous sibling
+    //
+    ASSERT (Node->Prev != NULL);
+    if (Node->Prev->Child == Node) {
+      Node->Prev->Child = Node->Sibling;
+    } else {
+      Node->Prev->Sibling = Node->Sibling;
+    }
+
+    if (Node->Sibling != NULL) {
+      Node->Sibling->Prev = Node->Prev;
+    }
+
+    SubHeap = TimerQueueMergePairs (Node->Child);
+    if (SubHeap != NULL) {
+      Queue->Root = TimerQueueMeld (Queue->Root, SubHeap);
+    }
+  }
+
+  Node->Prev    = NULL;
+  Node->Child   = NULL;
+  Node->Sibling = NULL;
+  Node->Queued  = FALSE;
+  Queue->Count--;
+}
+
+/**
+  Returns the node with the earliest trigger time.
+
+  @param  Queue                  The timer queue.
+
+  @return The first node of the queue, or NULL if the queue is empty.
+
+**/
+TIMER_QUEUE_NODE *
+TimerQueueFirst (
+  IN TIMER_QUEUE  *Queue
+  )
+{
+  return Queue->Root;
+}
+
+/**
+  Checks whether a node is currently in a timer queue.
+
+  @param  Node                   The node to check.
+
+  @retval TRUE                   The node is queued.
+  @retval FALSE                  The node is not queued.
+
+**/
+BOOLEAN
+TimerQueueIsQueued (
+  IN TIMER_QUEUE_NODE  *Node
+  )
+{
+  return Node->Queued;
+}
@@ -0,0 +1,104 @@
+/** @file
+  Timer queue used by the DXE core to order timer events by trigger time.
+
+  The queue is an intrusive pairing heap. Insert is O(1), and removal of the
+  first or of an arbitrary node is O(log n) amortized. Nodes with the same
+  trigger time are returned in the order they were inserted, which matches
+  the behavior of the sorted list this queue replaces. The queue never
+  allocates memory, so it may be used at any TPL.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __TIMER_QUEUE_H__
+#define __TIMER_QUEUE_H__
+
+typedef struct _TIMER_QUEUE_NODE TIMER_QUEUE_NODE;
+
+///
+/// Timer queue node, embedded in the structure that is being queued.
+///
+struct _TIMER_QUEUE_NODE {
+  ///
+  /// Parent if this node is the leftmost child, otherwise previous sibling.
+  ///
+  TIMER_QUEUE_NODE    *Prev;
+  TIMER_QUEUE_NODE    *Child;
+  TIMER_QUEUE_NODE    *Sibling;
+  UINT64              TriggerTime;
+  ///
+  /// Insertion order, used to break ties between equal trigger times.
+  ///
+  UINT64              Sequence;
+  BOOLEAN             Queued;
+};
+
+///
+/// Timer queue head.
+///
+typedef struct {
+  TIMER_QUEUE_NODE    *Root;
+  UINT64              NextSequence;
+  UINTN               Count;
+} TIMER_QUEUE;
+
+#define INITIALIZE_TIMER_QUEUE_VARIABLE  { NULL, 0, 0 }
+
+/**
+  Inserts a node into the timer queue.
+
+  The caller must set Node->TriggerTime before calling this function.
+
+  @param  Queue                  The timer queue.
+  @param  Node                   The node to insert. It must not be queued.
+
+**/
+VOID
+TimerQueueInsert (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node
+  );
+
+/**
+  Removes a node from the timer queue.
+
+  @param  Queue                  The timer queue.
+  @param  Node                   The node to remove. It must be queued.
+
+**/
+VOID
+TimerQueueRemove (
+  IN OUT TIMER_QUEUE       *Queue,
+  IN OUT TIMER_QUEUE_NODE  *Node
+  );
+
+/**
+  Returns the node with the earliest trigger time.
+
+  @param  Queue                  The timer queue.
+
+  @return The first node of the queue, or NULL if the queue is empty.
+
+**/
+TIMER_QUEUE_NODE *
+TimerQueueFirst (
+  IN TIMER_QUEUE  *Queue
+  );
+
+/**
+  Checks whether a node is currently in a timer queue.
+
+  @param  Node                   The node to check.
+
+  @retval TRUE                   The node is queued.
+  @retval FALSE                  The node is not queued.
+
+**/
+BOOLEAN
+TimerQueueIsQueued (
+  IN TIMER_QUEUE_NODE  *Node
+  );
+
+#endif
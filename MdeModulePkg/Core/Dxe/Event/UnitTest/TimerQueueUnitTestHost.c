@@ -0,0 +1,378 @@
+/** @file
+  Unit tests the DXE core timer queue against the sorted timer list it
+  replaces.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../TimerQueue.h"
+
+#define UNIT_TEST_APP_NAME     "DXE Core Timer Queue Unit Test"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_TIMER_COUNT      256
+#define TEST_OPERATION_COUNT  200000
+
+///
+/// A timer as seen by the test, queued both in the timer queue under test
+/// and in the reference sorted list.
+///
+typedef struct {
+  TIMER_QUEUE_NODE    Node;
+  UINT64              Period;
+  LIST_ENTRY          Link;
+  BOOLEAN             InList;
+} TEST_TIMER;
+
+typedef struct {
+  TIMER_QUEUE    Queue;
+  LIST_ENTRY     List;
+  TEST_TIMER     Timers[TEST_TIMER_COUNT];
+  UINT64         SystemTime;
+  UINT32         Seed;
+} TEST_CONTEXT;
+
+STATIC TEST_CONTEXT  mTestContext;
+
+/**
+  Returns the next value of a deterministic pseudo random sequence.
+
+  @param  Context  The test context holding the seed.
+
+  @return A pseudo random 32-bit value.
+**/
+STATIC
+UINT32
+NextRandom (
+  IN OUT TEST_CONTEXT  *Context
+  )
+{
+  Context->Seed = Context->Seed * 1103515245 + 12345;
+  return Context->Seed >> 1;
+}
+
+/**
+  Inserts a timer into the reference list the same way the original DXE core
+  sorted list did: after every timer with a trigger time less than or equal
+  to its own.
+
+  @param  Context  The test context.
+  @param  Timer    The timer to insert.
+**/
+STATIC
+VOID
+ReferenceInsert (
+  IN OUT TEST_CONTEXT  *Context,
+  IN OUT TEST_TIMER    *Timer
+  )
+{
+  LIST_ENTRY  *Link;
+  TEST_TIMER  *Timer2;
+
+  for (Link = Context->List.ForwardLink; Link != &Context->List; Link = Link->ForwardLink) {
+    Timer2 = BASE_CR (Link, TEST_TIMER, Link);
+    if (Timer2->Node.TriggerTime > Timer->Node.TriggerTime) {
+      break;
+    }
+  }
+
+  InsertTailList (Link, &Timer->Link);
+  Timer->InList = TRUE;
+}
+
+/**
+  Arms a timer in both the queue under test and the reference list.
+
+  @param  Context      The test context.
+  @param  Timer        The timer to arm.
+  @param  TriggerTime  The relative trigger time.
+  @param  Period       The period, or 0 for a one-shot timer.
+**/
+STATIC
+VOID
+SetTestTimer (
+  IN OUT TEST_CONTEXT  *Context,
+  IN OUT TEST_TIMER    *Timer,
+  IN     UINT64        TriggerTime,
+  IN     UINT64        Period
+  )
+{
+  if (TimerQueueIsQueued (&Timer->Node)) {
+    TimerQueueRemove (&Context->Queue, &Timer->Node);
+  }
+
+  if (Timer->InList) {
+    RemoveEntryList (&Timer->Link);
+    Timer->InList = FALSE;
+  }
+
+  Timer->Period           = Period;
+  Timer->Node.TriggerTime = Context->SystemTime + TriggerTime;
+  TimerQueueInsert (&Context->Queue, &Timer->Node);
+  ReferenceInsert (Context, Timer);
+}
+
+/**
+  Cancels a timer in both the queue under test and the reference list.
+
+  @param  Context  The test context.
+  @param  Timer    The timer to cancel.
+**/
+STATIC
+VOID
+CancelTestTimer (
+  IN OUT TEST_CONTEXT  *Context,
+  IN OUT TEST_TIMER    *Timer
+  )
+{
+  if (TimerQueueIsQueued (&Timer->Node)) {
+    TimerQueueRemove (&Context->Queue, &Timer->Node);
+  }
+
+  if (Timer->InList) {
+    RemoveEntryList (&Timer->Link);
+    Timer->InList = FALSE;
+  }
+}
+
+/**
+  Resets the test context.
+
+  @param  Context  The test context to reset.
+  @param  Seed     The seed of the pseudo random sequence.
+**/
+STATIC
+VOID
+ResetTestContext (
+  OUT TEST_CONTEXT  *Context,
+  IN  UINT32        Seed
+  )
+{
+  ZeroMem (Context, sizeof (*Context));
+  InitializeListHead (&Context->List);
+  Context->Seed = Seed;
+}
+
+/**
+  Checks that an empty queue has no first node, and that nodes come out in
+  trigger time order with ties kept in insertion order.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TimerQueueOrderTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_CONTEXT  *Test;
+  UINTN         Index;
+  STATIC UINT8  TriggerTimes[] = { 5, 3, 5, 1, 3, 5, 0, 9 };
+  STATIC UINT8  Expected[]     = { 6, 3, 1, 4, 0, 2, 5, 7 };
+
+  Test = &mTestContext;
+  ResetTestContext (Test, 1);
+
+  UT_ASSERT_EQUAL ((UINTN)TimerQueueFirst (&Test->Queue), (UINTN)NULL);
+
+  for (Index = 0; Index < ARRAY_SIZE (TriggerTimes); Index++) {
+    SetTestTimer (Test, &Test->Timers[Index], TriggerTimes[Index], 0);
+  }
+
+  UT_ASSERT_EQUAL (Test->Queue.Count, ARRAY_SIZE (TriggerTimes));
+
+  for (Index = 0; Index < ARRAY_SIZE (Expected); Index++) {
+    UT_ASSERT_EQUAL ((UINTN)TimerQueueFirst (&Test->Queue), (UINTN)&Test->Timers[Expected[Index]].Node);
+    CancelTestTimer (Test, &Test->Timers[Expected[Index]]);
+  }
+
+  UT_ASSERT_EQUAL ((UINTN)TimerQueueFirst (&Test->Queue), (UINTN)NULL);
+  UT_ASSERT_EQUAL (Test->Queue.Count, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Runs a random workload of set, cancel and tick operations, mirroring the
+  way CoreSetTimer() and CoreCheckTimers() drive the queue, and checks that
+  every expired timer fires in the same order as with the sorted list.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TimerQueueRandomWorkloadTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_CONTEXT      *Test;
+  TEST_TIMER        *Timer;
+  TEST_TIMER        *Expected;
+  TIMER_QUEUE_NODE  *Node;
+  UINTN             Operation;
+  UINTN             Fired;
+  UINT32            Random;
+
+  Test = &mTestContext;
+  ResetTestContext (Test, 0x5EED);
+  Fired = 0;
+
+  for (Operation = 0; Operation < TEST_OPERATION_COUNT; Operation++) {
+    Random = NextRandom (Test);
+    Timer  = &Test->Timers[NextRandom (Test) % TEST_TIMER_COUNT];
+
+    switch (Random % 8) {
+      case 0:
+      case 1:
+      case 2:
+        //
+        // One-shot timer. The small range produces many equal trigger times.
+        //
+        SetTestTimer (Test, Timer, NextRandom (Test) % 64, 0);
+        break;
+
+      case 3:
+        //
+        // Periodic timer
+        //
+        SetTestTimer (Test, Timer, NextRandom (Test) % 64, 1 + NextRandom (Test) % 32);
+        break;
+
+      case 4:
+        CancelTestTimer (Test, Timer);
+        break;
+
+      default:
+        //
+        // Advance the system time and fire expired timers
+        //
+        Test->SystemTime += NextRandom (Test) % 16;
+        for (Node = TimerQueueFirst (&Test->Queue); Node != NULL; Node = TimerQueueFirst (&Test->Queue)) {
+          UT_ASSERT_FALSE (IsListEmpty (&Test->List));
+          Expected = BASE_CR (Test->List.ForwardLink, TEST_TIMER, Link);
+          UT_ASSERT_EQUAL ((UINTN)Node, (UINTN)&Expected->Node);
+
+          if (Node->TriggerTime > Test->SystemTime) {
+            break;
+          }
+
+          Fired++;
+          Timer = BASE_CR (Node, TEST_TIMER, Node);
+          TimerQueueRemove (&Test->Queue, Node);
+          RemoveEntryList (&Timer->Link);
+          Timer->InList = FALSE;
+
+          if (Timer->Period != 0) {
+            Node->TriggerTime += Timer->Period;
+            if (Node->TriggerTime <= Test->SystemTime) {
+              Node->TriggerTime = Test->SystemTime;
+            }
+
+            TimerQueueInsert (&Test->Queue, Node);
+            ReferenceInsert (Test, Timer);
+          }
+        }
+
+        UT_ASSERT_TRUE (Node != NULL || IsListEmpty (&Test->List));
+        break;
+    }
+  }
+
+  UT_ASSERT_TRUE (Fired > 0);
+  UT_LOG_INFO ("%Lu timers fired\n", (UINT64)Fired);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  timer queue and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TimerQueueTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&TimerQueueTests, Framework, "Timer Queue Tests", "DxeCore.TimerQueue", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the Timer Queue Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (TimerQueueTests, "Timers fire in trigger time order, ties in insertion order", "Order", TimerQueueOrderTest, NULL, NULL, NULL);
+  AddTestCase (TimerQueueTests, "Random workload matches the sorted timer list", "RandomWorkload", TimerQueueRandomWorkloadTest, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define TimerQueueUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+TimerQueueUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -3,7 +3,7 @@
   Layers on top of Firmware Block protocol to produce a file abstraction
   of FV based files.
 
-Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -41,9 +41,17 @@ FV_DEVICE  mFvDevice = {
   0,
   0,
   FALSE,
-  FALSE
+  FALSE,
+  FALSE,
+  NULL,
+  0,
+  {
+    FvReadFileSectionInPlace
+  }
 };
 
+#define FFS_FILE_HASH_MIN_SIZE  16
+
 //
 // FFS helper functions
 //
@@ -281,6 +289,11 @@ FreeFvDeviceResource (
     FfsFileEntry = (FFS_FILE_LIST_ENTRY *)NextEntry;
   }
 
+  if (FvDevice->FileHashTable != NULL) {
+    CoreFreePool (FvDevice->FileHashTable);
+    FvDevice->FileHashTable = NULL;
+  }
+
   if (!FvDevice->IsMemoryMapped) {
     //
     // Free the cached FV buffer.
@@ -296,6 +309,136 @@ FreeFvDeviceResource (
   return;
 }
 
+/**
+  Hash the name of a file into the file name hash table.
+
+  @param  NameGuid              The name of the file.
+
+  @return The hash of the name.
+
+**/
+STATIC
+UINTN
+FfsFileNameHash (
+  IN CONST EFI_GUID  *NameGuid
+  )
+{
+  UINT32  Hash;
+
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)NameGuid) ^ ReadUnaligned32 ((CONST UINT32 *)NameGuid + 1) ^
+          ReadUnaligned32 ((CONST UINT32 *)NameGuid + 2) ^ ReadUnaligned32 ((CONST UINT32 *)NameGuid + 3);
+  Hash *= 0x9E3779B1;
+  return (UINTN)(Hash ^ (Hash >> 16));
+}
+
+/**
+  Build the file name hash table of the files of an FV.
+
+  The hash table is only an accelerator. If it cannot be allocated, the files
+  are searched in the file list.
+
+  @param  FvDevice              The FvDevice with the file list built.
+
+**/
+STATIC
+VOID
+FvBuildFileHash (
+  IN OUT FV_DEVICE  *FvDevice
+  )
+{
+  LIST_ENTRY           *Link;
+  FFS_FILE_LIST_ENTRY  *FfsFileEntry;
+  FFS_FILE_LIST_ENTRY  **Bucket;
+  UINTN                FileCount;
+  UINTN                Size;
+
+  FileCount = 0;
+  for (Link = GetFirstNode (&FvDevice->FfsFileListHeader);
+       !IsNull (&FvDevice->FfsFileListHeader, Link);
+       Link = GetNextNode (&FvDevice->FfsFileListHeader, Link))
+  {
+    FileCount++;
+  }
+
+  Size = FFS_FILE_HASH_MIN_SIZE;
+  while (Size < FileCount) {
+    Size *= 2;
+  }
+
+  FvDevice->FileHashTable = AllocateZeroPool (Size * sizeof (FFS_FILE_LIST_ENTRY *));
+  if (FvDevice->FileHashTable == NULL) {
+    return;
+  }
+
+  FvDevice->FileHashMask = Size - 1;
+
+  //
+  // Insert the files from the last one, so that the files of a bucket are in the
+  // order of the FV and the first file of a name is the one found, as when the
+  // file list is searched.
+  //
+  for (Link = GetPreviousNode (&FvDevice->FfsFileListHeader, &FvDevice->FfsFileListHeader);
+       !IsNull (&FvDevice->FfsFileListHeader, Link);
+       Link = GetPreviousNode (&FvDevice->FfsFileListHeader, Link))
+  {
+    FfsFileEntry = (FFS_FILE_LIST_ENTRY *)Link;
+    if (FfsFileEntry->FfsHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+      continue;
+    }
+
+    Bucket                 = &FvDevice->FileHashTable[FfsFileNameHash (&FfsFileEntry->FfsHeader->Name) & FvDevice->FileHashMask];
+    FfsFileEntry->HashNext = *Bucket;
+    *Bucket                = FfsFileEntry;
+  }
+}
+
+/**
+  Find a file of the firmware volume by name. Pad files are skipped.
+
+  @param  FvDevice              The firmware volume to search.
+  @param  NameGuid              The name of the file.
+
+  @return The entry of the first file with the name in the firmware volume,
+          or NULL if there is no such file.
+
+**/
+FFS_FILE_LIST_ENTRY *
+FindFfsFileEntry (
+  IN FV_DEVICE       *FvDevice,
+  IN CONST EFI_GUID  *NameGuid
+  )
+{
+  LIST_ENTRY           *Link;
+  FFS_FILE_LIST_ENTRY  *FfsFileEntry;
+
+  if (FvDevice->FileHashTable != NULL) {
+    FfsFileEntry = FvDevice->FileHashTable[FfsFileNameHash (NameGuid) & FvDevice->FileHashMask];
+    while (FfsFileEntry != NULL) {
+      if (CompareGuid (&FfsFileEntry->FfsHeader->Name, NameGuid)) {
+        return FfsFileEntry;
+      }
+
+      FfsFileEntry = FfsFileEntry->HashNext;
+    }
+
+    return NULL;
+  }
+
+  for (Link = GetFirstNode (&FvDevice->FfsFileListHeader);
+       !IsNull (&FvDevice->FfsFileListHeader, Link);
+       Link = GetNextNode (&FvDevice->FfsFileListHeader, Link))
+  {
+    FfsFileEntry = (FFS_FILE_LIST_ENTRY *)Link;
+    if ((FfsFileEntry->FfsHeader->Type != EFI_FV_FILETYPE_FFS_PAD) &&
+        CompareGuid (&FfsFileEntry->FfsHeader->Name, NameGuid))
+    {
+      return FfsFileEntry;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Check if an FV is consistent and allocate cache for it.
 
@@ -330,6 +473,7 @@ FvCheck (
   BOOLEAN                             FileCached;
   UINTN                               WholeFileSize;
   EFI_FFS_FILE_HEADER                 *CacheFfsHeader;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR     Descriptor;
 
   FileCached     = FALSE;
   CacheFfsHeader = NULL;
@@ -355,6 +499,17 @@ FvCheck (
     // Don't cache memory mapped FV really.
     //
     FvDevice->CachedFv = (UINT8 *)(UINTN)PhysicalAddress;
+
+    //
+    // The files of a memory mapped FV in system memory are read in place, the
+    // files of a memory mapped FV in flash are cached when they are read.
+    //
+    Status = CoreGetMemorySpaceDescriptor (PhysicalAddress, &Descriptor);
+    if (!EFI_ERROR (Status) && (Descriptor.GcdMemoryType == EfiGcdMemoryTypeSystemMemory) &&
+        (Descriptor.BaseAddress + Descriptor.Length >= PhysicalAddress + Size))
+    {
+      FvDevice->IsInSystemMemory = TRUE;
+    }
   } else {
     FvDevice->IsMemoryMapped = FALSE;
     FvDevice->CachedFv       = AllocatePool (Size);
@@ -480,7 +635,7 @@ FvCheck (
 
     CacheFfsHeader = FfsHeader;
     if ((CacheFfsHeader->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
-      if (FvDevice->IsMemoryMapped) {
+      if (FvDevice->IsMemoryMapped && !FvDevice->IsInSystemMemory) {
         //
         // Memory mapped FV has not been cached.
         // Here is to cache FFS file to memory buffer for following checksum calculating.
@@ -559,6 +714,8 @@ Done:
     }
 
     FreeFvDeviceResource (FvDevice);
+  } else {
+    FvBuildFileHash (FvDevice);
   }
 
   return Status;
@@ -684,6 +841,17 @@ NotifyFwVolBlock (
                    &FvDevice->Fv
                    );
         ASSERT_EFI_ERROR (Status);
+
+        //
+        // Install the protocol to read the sections of the files in place
+        //
+        Status = CoreInstallProtocolInterface (
+                   &Handle,
+                   &gEdkiiFirmwareVolumeSectionInPlaceProtocolGuid,
+                   EFI_NATIVE_INTERFACE,
+                   &FvDevice->SectionInPlace
+                   );
+        ASSERT_EFI_ERROR (Status);
       } else {
         //
         // Free FvDevice Buffer for the corrupt FV image.
@@ -2,7 +2,7 @@
   Firmware File System protocol. Layers on top of Firmware
   Block protocol to produce a file abstraction of FV based files.
 
-Copyright (c) 2006 - 2014, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -15,12 +15,17 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Used to track all non-deleted files
 //
-typedef struct {
+typedef struct _FFS_FILE_LIST_ENTRY FFS_FILE_LIST_ENTRY;
+struct _FFS_FILE_LIST_ENTRY {
   LIST_ENTRY             Link;
   EFI_FFS_FILE_HEADER    *FfsHeader;
   UINTN                  StreamHandle;
   BOOLEAN                FileCached;
-} FFS_FILE_LIST_ENTRY;
+  //
+  // Next file in the same bucket of the file name hash table
+  //
+  FFS_FILE_LIST_ENTRY    *HashNext;
+};
 
 typedef struct {
   UINTN                                 Signature;
@@ -40,9 +45,24 @@ typedef struct {
   UINT8                                 ErasePolarity;
   BOOLEAN                               IsFfs3Fv;
   BOOLEAN                               IsMemoryMapped;
+  //
+  // TRUE if the memory mapped FV is in system memory, then its files are read
+  // in place instead of being cached.
+  //
+  BOOLEAN                               IsInSystemMemory;
+
+  //
+  // Hash table of the non-pad files by name, with FileHashMask + 1 buckets.
+  // NULL if it could not be allocated, then the file list is searched.
+  //
+  FFS_FILE_LIST_ENTRY                   **FileHashTable;
+  UINTN                                 FileHashMask;
+
+  EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL    SectionInPlace;
 } FV_DEVICE;
 
-#define FV_DEVICE_FROM_THIS(a)  CR(a, FV_DEVICE, Fv, FV2_DEVICE_SIGNATURE)
+#define FV_DEVICE_FROM_THIS(a)               CR(a, FV_DEVICE, Fv, FV2_DEVICE_SIGNATURE)
+#define FV_DEVICE_FROM_SECTION_IN_PLACE(a)  CR(a, FV_DEVICE, SectionInPlace, FV2_DEVICE_SIGNATURE)
 
 /**
   Retrieves attributes, insures positive polarity of attribute bits, returns
@@ -227,6 +247,42 @@ FvReadFileSection (
   OUT       UINT32                         *AuthenticationStatus
   );
 
+/**
+  Locates a section in a given FFS File and returns a pointer to its contents
+  (not including section header) in place, without copying them.
+
+  @param  This                       Indicates the calling context.
+  @param  NameGuid                   Pointer to an EFI_GUID, which is the
+                                     filename.
+  @param  SectionType                Indicates the section type to return.
+  @param  SectionInstance            Indicates which instance of sections with a
+                                     type of SectionType to return.
+  @param  Buffer                     Returns a pointer to the contents of the
+                                     section. The buffer belongs to the FV.
+  @param  BufferSize                 Returns the size of the contents of the
+                                     section.
+  @param  AuthenticationStatus       AuthenticationStatus is a pointer to a
+                                     caller allocated UINT32 in which the
+                                     authentication status is returned.
+
+  @retval EFI_SUCCESS                Successfully found the file section.
+  @retval EFI_UNSUPPORTED            The section is in an encapsulation section.
+  @retval EFI_NOT_FOUND              Section not found.
+  @retval EFI_INVALID_PARAMETER      Invalid parameter.
+
+**/
+EFI_STATUS
+EFIAPI
+FvReadFileSectionInPlace (
+  IN CONST  EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL  *This,
+  IN CONST  EFI_GUID                                         *NameGuid,
+  IN        EFI_SECTION_TYPE                                 SectionType,
+  IN        UINTN                                            SectionInstance,
+  OUT CONST VOID                                             **Buffer,
+  OUT       UINTN                                            *BufferSize,
+  OUT       UINT32                                           *AuthenticationStatus
+  );
+
 /**
   Writes one or more files to the firmware volume.
 
@@ -384,4 +440,20 @@ IsValidFfsFile (
   IN EFI_FFS_FILE_HEADER  *FfsHeader
   );
 
+/**
+  Find a file of the firmware volume by name. Pad files are skipped.
+
+  @param  FvDevice       The firmware volume to search.
+  @param  NameGuid       The name of the file.
+
+  @return The entry of the first file with the name in the firmware volume,
+          or NULL if there is no such file.
+
+**/
+FFS_FILE_LIST_ENTRY *
+FindFfsFileEntry (
+  IN FV_DEVICE       *FvDevice,
+  IN CONST EFI_GUID  *NameGuid
+  );
+
 #endif
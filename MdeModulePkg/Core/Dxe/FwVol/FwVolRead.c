@@ -1,7 +1,7 @@
 /** @file
   Implements functions to read firmware file
 
-Copyright (c) 2006 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -277,9 +277,7 @@ FvReadFile (
 {
   EFI_STATUS              Status;
   FV_DEVICE               *FvDevice;
-  EFI_GUID                SearchNameGuid;
-  EFI_FV_FILETYPE         LocalFoundType;
-  EFI_FV_FILE_ATTRIBUTES  LocalAttributes;
+  EFI_FV_ATTRIBUTES       FvAttributes;
   UINTN                   FileSize;
   UINT8                   *SrcPtr;
   EFI_FFS_FILE_HEADER     *FfsHeader;
@@ -293,32 +291,39 @@ FvReadFile (
   FvDevice = FV_DEVICE_FROM_THIS (This);
 
   //
-  // Keep looking until we find the matching NameGuid.
-  // The Key is really a FfsFileEntry
-  //
-  FvDevice->LastKey = 0;
-  do {
-    LocalFoundType = 0;
-    Status         = FvGetNextFile (
-                       This,
-                       &FvDevice->LastKey,
-                       &LocalFoundType,
-                       &SearchNameGuid,
-                       &LocalAttributes,
-                       &FileSize
-                       );
-    if (EFI_ERROR (Status)) {
+  // Check if read operation is enabled
+  //
+  Status = FvGetVolumeAttributes (This, &FvAttributes);
+  if (EFI_ERROR (Status) || ((FvAttributes & EFI_FV2_READ_STATUS) == 0)) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // LastKey is the FfsFileEntry of the last file read. The same file is often
+  // read several times in a row, e.g. by FvReadFileSection() for each section
+  // instance, so only look the name up if it is another file.
+  //
+  if ((FvDevice->LastKey == NULL) || !CompareGuid (&FvDevice->LastKey->FfsHeader->Name, NameGuid)) {
+    FvDevice->LastKey = FindFfsFileEntry (FvDevice, NameGuid);
+    if (FvDevice->LastKey == NULL) {
       return EFI_NOT_FOUND;
     }
-  } while (!CompareGuid (&SearchNameGuid, NameGuid));
+  }
 
   //
   // Get a pointer to the header
   //
   FfsHeader = FvDevice->LastKey->FfsHeader;
-  if (FvDevice->IsMemoryMapped) {
+  if (IS_FFS_FILE2 (FfsHeader)) {
+    FileSize = FFS_FILE2_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER2);
+  } else {
+    FileSize = FFS_FILE_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER);
+  }
+
+  if (FvDevice->IsMemoryMapped && !FvDevice->IsInSystemMemory) {
     //
     // Memory mapped FV has not been cached, so here is to cache by file.
+    // A memory mapped FV in system memory is read in place.
     //
     if (!FvDevice->LastKey->FileCached) {
       //
@@ -399,6 +404,86 @@ FvReadFile (
   return Status;
 }
 
+/**
+  Opens the section stream of a file, or returns the section stream opened by
+  a previous read of the file. The section stream is closed with the FV.
+
+  @param  FvDevice                   The FV of the file.
+  @param  NameGuid                   Pointer to an EFI_GUID, which is the
+                                     filename.
+  @param  FfsEntry                   Returns the FfsFileEntry of the file, with
+                                     the section stream in StreamHandle.
+  @param  AuthenticationStatus       A pointer to a caller allocated UINT32,
+                                     used as scratch buffer.
+
+  @retval EFI_SUCCESS                The section stream of the file is open.
+  @retval EFI_NOT_FOUND              The file was not found or has no sections.
+  @retval others                     The section stream could not be opened.
+
+**/
+STATIC
+EFI_STATUS
+OpenFileSectionStream (
+  IN  FV_DEVICE            *FvDevice,
+  IN  CONST EFI_GUID       *NameGuid,
+  OUT FFS_FILE_LIST_ENTRY  **FfsEntry,
+  OUT UINT32               *AuthenticationStatus
+  )
+{
+  EFI_STATUS              Status;
+  EFI_FV_FILETYPE         FileType;
+  EFI_FV_FILE_ATTRIBUTES  FileAttributes;
+  UINTN                   FileSize;
+  UINT8                   *FileBuffer;
+
+  //
+  // Read the file
+  //
+  Status = FvReadFile (
+             &FvDevice->Fv,
+             NameGuid,
+             NULL,
+             &FileSize,
+             &FileType,
+             &FileAttributes,
+             AuthenticationStatus
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Get the last key used by our call to FvReadFile as it is the FfsEntry for this file.
+  //
+  *FfsEntry = FvDevice->LastKey;
+
+  if (IS_FFS_FILE2 ((*FfsEntry)->FfsHeader)) {
+    FileBuffer = ((UINT8 *)(*FfsEntry)->FfsHeader) + sizeof (EFI_FFS_FILE_HEADER2);
+  } else {
+    FileBuffer = ((UINT8 *)(*FfsEntry)->FfsHeader) + sizeof (EFI_FFS_FILE_HEADER);
+  }
+
+  //
+  // Check to see that the file actually HAS sections before we go any further.
+  //
+  if (FileType == EFI_FV_FILETYPE_RAW) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Use FfsEntry to cache Section Extraction Protocol Information
+  //
+  if ((*FfsEntry)->StreamHandle == 0) {
+    Status = OpenSectionStream (
+               FileSize,
+               FileBuffer,
+               &(*FfsEntry)->StreamHandle
+               );
+  }
+
+  return Status;
+}
+
 /**
   Locates a section in a given FFS File and
   copies it to the supplied buffer (not including section header).
@@ -439,13 +524,9 @@ FvReadFileSection (
   OUT       UINT32                         *AuthenticationStatus
   )
 {
-  EFI_STATUS              Status;
-  FV_DEVICE               *FvDevice;
-  EFI_FV_FILETYPE         FileType;
-  EFI_FV_FILE_ATTRIBUTES  FileAttributes;
-  UINTN                   FileSize;
-  UINT8                   *FileBuffer;
-  FFS_FILE_LIST_ENTRY     *FfsEntry;
+  EFI_STATUS           Status;
+  FV_DEVICE            *FvDevice;
+  FFS_FILE_LIST_ENTRY  *FfsEntry;
 
   if ((NameGuid == NULL) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -453,64 +534,107 @@ FvReadFileSection (
 
   FvDevice = FV_DEVICE_FROM_THIS (This);
 
+  Status = OpenFileSectionStream (FvDevice, NameGuid, &FfsEntry, AuthenticationStatus);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
   //
-  // Read the file
+  // If SectionType == 0 We need the whole section stream
   //
-  Status = FvReadFile (
-             This,
-             NameGuid,
+  Status = GetSection (
+             FfsEntry->StreamHandle,
+             (SectionType == 0) ? NULL : &SectionType,
              NULL,
-             &FileSize,
-             &FileType,
-             &FileAttributes,
-             AuthenticationStatus
+             (SectionType == 0) ? 0 : SectionInstance,
+             Buffer,
+             BufferSize,
+             AuthenticationStatus,
+             FvDevice->IsFfs3Fv
              );
-  //
-  // Get the last key used by our call to FvReadFile as it is the FfsEntry for this file.
-  //
-  FfsEntry = (FFS_FILE_LIST_ENTRY *)FvDevice->LastKey;
 
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
-  if (IS_FFS_FILE2 (FfsEntry->FfsHeader)) {
-    FileBuffer = ((UINT8 *)FfsEntry->FfsHeader) + sizeof (EFI_FFS_FILE_HEADER2);
-  } else {
-    FileBuffer = ((UINT8 *)FfsEntry->FfsHeader) + sizeof (EFI_FFS_FILE_HEADER);
+  if (!EFI_ERROR (Status)) {
+    //
+    // Inherit the authentication status.
+    //
+    *AuthenticationStatus |= FvDevice->AuthenticationStatus;
   }
 
   //
-  // Check to see that the file actually HAS sections before we go any further.
+  // Close of stream defered to close of FfsHeader list to allow SEP to cache data
   //
-  if (FileType == EFI_FV_FILETYPE_RAW) {
-    Status = EFI_NOT_FOUND;
-    goto Done;
+
+Done:
+  return Status;
+}
+
+/**
+  Locates a section in a given FFS File and returns a pointer to its contents
+  (not including section header) in place, without copying them.
+
+  Only the sections that are not in an encapsulation section are returned.
+  The returned buffer is in the section stream of the file, which is in the
+  FV itself if the FV is memory mapped in system memory, or else in the copy
+  of the file or of the FV cached by this driver. The section stream is only
+  closed with the FV, so the buffer stays valid as long as the FV protocols
+  are installed.
+
+  @param  This                       Indicates the calling context.
+  @param  NameGuid                   Pointer to an EFI_GUID, which is the
+                                     filename.
+  @param  SectionType                Indicates the section type to return.
+  @param  SectionInstance            Indicates which instance of sections with a
+                                     type of SectionType to return.
+  @param  Buffer                     Returns a pointer to the contents of the
+                                     section. The buffer belongs to the FV.
+  @param  BufferSize                 Returns the size of the contents of the
+                                     section.
+  @param  AuthenticationStatus       AuthenticationStatus is a pointer to a
+                                     caller allocated UINT32 in which the
+                                     authentication status is returned.
+
+  @retval EFI_SUCCESS                Successfully found the file section.
+  @retval EFI_UNSUPPORTED            The section is in an encapsulation section.
+  @retval EFI_NOT_FOUND              Section not found.
+  @retval EFI_INVALID_PARAMETER      Invalid parameter.
+
+**/
+EFI_STATUS
+EFIAPI
+FvReadFileSectionInPlace (
+  IN CONST  EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL  *This,
+  IN CONST  EFI_GUID                                         *NameGuid,
+  IN        EFI_SECTION_TYPE                                 SectionType,
+  IN        UINTN                                            SectionInstance,
+  OUT CONST VOID                                             **Buffer,
+  OUT       UINTN                                            *BufferSize,
+  OUT       UINT32                                           *AuthenticationStatus
+  )
+{
+  EFI_STATUS           Status;
+  FV_DEVICE            *FvDevice;
+  FFS_FILE_LIST_ENTRY  *FfsEntry;
+
+  if ((NameGuid == NULL) || (Buffer == NULL) || (BufferSize == NULL) || (AuthenticationStatus == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Use FfsEntry to cache Section Extraction Protocol Information
-  //
-  if (FfsEntry->StreamHandle == 0) {
-    Status = OpenSectionStream (
-               FileSize,
-               FileBuffer,
-               &FfsEntry->StreamHandle
-               );
-    if (EFI_ERROR (Status)) {
-      goto Done;
-    }
+  FvDevice = FV_DEVICE_FROM_SECTION_IN_PLACE (This);
+
+  Status = OpenFileSectionStream (FvDevice, NameGuid, &FfsEntry, AuthenticationStatus);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
   //
   // If SectionType == 0 We need the whole section stream
   //
-  Status = GetSection (
+  Status = GetSectionInPlace (
              FfsEntry->StreamHandle,
              (SectionType == 0) ? NULL : &SectionType,
              NULL,
              (SectionType == 0) ? 0 : SectionInstance,
-             Buffer,
+             (VOID **)Buffer,
              BufferSize,
              AuthenticationStatus,
              FvDevice->IsFfs3Fv
@@ -523,10 +647,5 @@ FvReadFileSection (
     *AuthenticationStatus |= FvDevice->AuthenticationStatus;
   }
 
-  //
-  // Close of stream defered to close of FfsHeader list to allow SEP to cache data
-  //
-
-Done:
   return Status;
 }
@@ -0,0 +1,615 @@
+/** @file
+  Host based test and benchmark for the file name hash table of the DXE core
+  firmware volume driver.
+
+  The real FwVol.c, FwVolRead.c, FwVolAttrib.c, FwVolWrite.c and Ffs.c are
+  linked with stubs for the protocol, event and section extraction services of
+  the DXE core. A memory mapped FV with 1000 files is checked by FvCheck(), the
+  files are read by name with FvReadFile() with and without the hash table, the
+  results are compared and the time of the lookups is reported.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "DxeMain.h"
+#include "FwVolDriver.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE Core FV File Hash Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_FILE_COUNT         1000
+#define TEST_PAD_FILE_COUNT     16
+#define TEST_ABSENT_FILE_COUNT  24
+#define TEST_MAX_DATA_SIZE      256
+#define TEST_LOOKUP_COUNT       20000
+
+//
+// Names of the files of the test FV. The first pad file is named as the first
+// absent file, and the last file is a second file named as the first file.
+//
+#define TEST_NAME_COUNT  (TEST_FILE_COUNT + TEST_ABSENT_FILE_COUNT)
+
+extern FV_DEVICE  mFvDevice;
+
+EFI_STATUS
+FvCheck (
+  IN OUT FV_DEVICE  *FvDevice
+  );
+
+STATIC EFI_GUID   mFileName[TEST_NAME_COUNT];
+STATIC UINTN      mFileDataSize[TEST_FILE_COUNT];
+STATIC UINT8      *mFv           = NULL;
+STATIC UINTN      mFvLength      = 0;
+STATIC FV_DEVICE  *mTestFvDevice = NULL;
+STATIC UINT32     mSeed;
+
+//
+// Stubs for the DXE core services used by the firmware volume driver
+//
+EFI_STATUS
+EFIAPI
+CoreFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+CoreLocateHandle (
+  IN     EFI_LOCATE_SEARCH_TYPE  SearchType,
+  IN     EFI_GUID                *Protocol   OPTIONAL,
+  IN     VOID                    *SearchKey  OPTIONAL,
+  IN OUT UINTN                   *BufferSize,
+  OUT    EFI_HANDLE              *Buffer
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+EFI_STATUS
+EFIAPI
+CoreHandleProtocol (
+  IN   EFI_HANDLE  UserHandle,
+  IN   EFI_GUID    *Protocol,
+  OUT  VOID        **Interface
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+CoreInstallProtocolInterface (
+  IN OUT EFI_HANDLE      *UserHandle,
+  IN EFI_GUID            *Protocol,
+  IN EFI_INTERFACE_TYPE  InterfaceType,
+  IN VOID                *Interface
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_EVENT
+EFIAPI
+EfiCreateProtocolNotifyEvent (
+  IN  EFI_GUID          *ProtocolGuid,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction,
+  IN  VOID              *NotifyContext   OPTIONAL,
+  OUT VOID              **Registration
+  )
+{
+  return NULL;
+}
+
+UINT32
+GetFvbAuthenticationStatus (
+  IN EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *FvbProtocol
+  )
+{
+  return 0;
+}
+
+EFI_STATUS
+EFIAPI
+OpenSectionStream (
+  IN     UINTN  SectionStreamLength,
+  IN     VOID   *SectionStream,
+  OUT    UINTN  *SectionStreamHandle
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+GetSection (
+  IN UINTN               SectionStreamHandle,
+  IN EFI_SECTION_TYPE    *SectionType,
+  IN EFI_GUID            *SectionDefinitionGuid,
+  IN UINTN               SectionInstance,
+  IN VOID                **Buffer,
+  IN OUT UINTN           *BufferSize,
+  OUT UINT32             *AuthenticationStatus,
+  IN BOOLEAN             IsFfs3Fv
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+GetSectionInPlace (
+  IN  UINTN             SectionStreamHandle,
+  IN  EFI_SECTION_TYPE  *SectionType,
+  IN  EFI_GUID          *SectionDefinitionGuid,
+  IN  UINTN             SectionInstance,
+  OUT VOID              **Buffer,
+  OUT UINTN             *BufferSize,
+  OUT UINT32            *AuthenticationStatus,
+  IN  BOOLEAN           IsFfs3Fv
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+CoreGetMemorySpaceDescriptor (
+  IN  EFI_PHYSICAL_ADDRESS             BaseAddress,
+  OUT EFI_GCD_MEMORY_SPACE_DESCRIPTOR  *Descriptor
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+EFI_STATUS
+EFIAPI
+CloseSectionStream (
+  IN  UINTN    StreamHandleToClose,
+  IN  BOOLEAN  FreeStreamBuffer
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the attributes of the test FV.
+
+  @param  This        The test FVB.
+  @param  Attributes  Returns the attributes of the test FV.
+
+  @retval EFI_SUCCESS  Always.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestFvbGetAttributes (
+  IN CONST EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *This,
+  OUT      EFI_FVB_ATTRIBUTES_2                *Attributes
+  )
+{
+  *Attributes = EFI_FVB2_READ_ENABLED_CAP | EFI_FVB2_READ_STATUS | EFI_FVB2_MEMORY_MAPPED;
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the address of the test FV.
+
+  @param  This     The test FVB.
+  @param  Address  Returns the address of the test FV.
+
+  @retval EFI_SUCCESS  Always.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestFvbGetPhysicalAddress (
+  IN CONST EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *This,
+  OUT      EFI_PHYSICAL_ADDRESS                *Address
+  )
+{
+  *Address = (EFI_PHYSICAL_ADDRESS)(UINTN)mFv;
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  mTestFvb = {
+  TestFvbGetAttributes,
+  NULL,
+  TestFvbGetPhysicalAddress,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+/**
+  Returns the next value of a deterministic pseudo random sequence.
+
+  @return A pseudo random 15-bit value.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mSeed = mSeed * 1103515245 + 12345;
+  return (mSeed >> 16) & 0x7FFF;
+}
+
+/**
+  Appends an FFS file to the test FV.
+
+  @param  Offset    The offset of the file, updated to the offset of the next file.
+  @param  Name      The name of the file.
+  @param  Type      The type of the file.
+  @param  DataSize  The size of the data of the file.
+**/
+STATIC
+VOID
+AppendFile (
+  IN OUT UINTN            *Offset,
+  IN     CONST EFI_GUID   *Name,
+  IN     EFI_FV_FILETYPE  Type,
+  IN     UINTN            DataSize
+  )
+{
+  EFI_FFS_FILE_HEADER  *FfsHeader;
+  UINTN                FileSize;
+
+  FileSize  = sizeof (EFI_FFS_FILE_HEADER) + DataSize;
+  FfsHeader = (EFI_FFS_FILE_HEADER *)(mFv + *Offset);
+  CopyGuid (&FfsHeader->Name, Name);
+  FfsHeader->Type       = Type;
+  FfsHeader->Attributes = 0;
+  FfsHeader->Size[0]    = (UINT8)FileSize;
+  FfsHeader->Size[1]    = (UINT8)(FileSize >> 8);
+  FfsHeader->Size[2]    = (UINT8)(FileSize >> 16);
+  FfsHeader->State      = 0;
+
+  FfsHeader->IntegrityCheck.Checksum16      = 0;
+  FfsHeader->IntegrityCheck.Checksum.Header = CalculateCheckSum8 ((UINT8 *)FfsHeader, sizeof (EFI_FFS_FILE_HEADER));
+  FfsHeader->IntegrityCheck.Checksum.File   = FFS_FIXED_CHECKSUM;
+  FfsHeader->State                          = EFI_FILE_HEADER_CONSTRUCTION | EFI_FILE_HEADER_VALID | EFI_FILE_DATA_VALID;
+  SetMem ((UINT8 *)(FfsHeader + 1), DataSize, (UINT8)Type);
+
+  *Offset = ALIGN_VALUE (*Offset + FileSize, 8);
+}
+
+/**
+  Builds a memory mapped FV with TEST_FILE_COUNT driver files and
+  TEST_PAD_FILE_COUNT pad files, and the FV_DEVICE of the FV.
+
+  @param  Context  Unused.
+
+  @retval UNIT_TEST_PASSED                      The FV was built.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The FV could not be built.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PrepareFv (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader;
+  UINTN                       HeaderLength;
+  UINTN                       Offset;
+  UINTN                       Index;
+
+  mSeed = 1;
+  for (Index = 0; Index < TEST_NAME_COUNT; Index++) {
+    mFileName[Index].Data1 = (NextRandom () << 16) | NextRandom ();
+    mFileName[Index].Data2 = (UINT16)NextRandom ();
+    mFileName[Index].Data3 = (UINT16)NextRandom ();
+    WriteUnaligned32 ((UINT32 *)&mFileName[Index].Data4[0], (NextRandom () << 16) | NextRandom ());
+    WriteUnaligned32 ((UINT32 *)&mFileName[Index].Data4[4], (UINT32)Index);
+  }
+
+  HeaderLength = sizeof (EFI_FIRMWARE_VOLUME_HEADER) + sizeof (EFI_FV_BLOCK_MAP_ENTRY);
+  mFvLength    = ALIGN_VALUE (HeaderLength, 8) +
+                 (TEST_FILE_COUNT + TEST_PAD_FILE_COUNT + 1) * (sizeof (EFI_FFS_FILE_HEADER) + TEST_MAX_DATA_SIZE + 8) +
+                 SIZE_4KB;
+  mFv = AllocateZeroPool (mFvLength);
+  if (mFv == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  FwVolHeader = (EFI_FIRMWARE_VOLUME_HEADER *)mFv;
+  CopyGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem2Guid);
+  FwVolHeader->FvLength              = mFvLength;
+  FwVolHeader->Signature             = EFI_FVH_SIGNATURE;
+  FwVolHeader->Attributes            = EFI_FVB2_READ_ENABLED_CAP | EFI_FVB2_READ_STATUS | EFI_FVB2_MEMORY_MAPPED;
+  FwVolHeader->HeaderLength          = (UINT16)HeaderLength;
+  FwVolHeader->Revision              = EFI_FVH_REVISION;
+  FwVolHeader->BlockMap[0].NumBlocks = 1;
+  FwVolHeader->BlockMap[0].Length    = (UINT32)mFvLength;
+  FwVolHeader->Checksum              = CalculateCheckSum16 ((UINT16 *)FwVolHeader, HeaderLength);
+
+  Offset = ALIGN_VALUE (HeaderLength, 8);
+  for (Index = 0; Index < TEST_FILE_COUNT; Index++) {
+    if ((Index % (TEST_FILE_COUNT / TEST_PAD_FILE_COUNT)) == 0) {
+      AppendFile (&Offset, &mFileName[TEST_FILE_COUNT], EFI_FV_FILETYPE_FFS_PAD, 8 * (NextRandom () % 8));
+    }
+
+    mFileDataSize[Index] = 8 * (NextRandom () % (TEST_MAX_DATA_SIZE / 8));
+    AppendFile (&Offset, &mFileName[Index], EFI_FV_FILETYPE_DRIVER, mFileDataSize[Index]);
+  }
+
+  AppendFile (&Offset, &mFileName[0], EFI_FV_FILETYPE_APPLICATION, 8);
+  ASSERT (Offset <= mFvLength);
+
+  mTestFvDevice = AllocateCopyPool (sizeof (FV_DEVICE), &mFvDevice);
+  if (mTestFvDevice == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mTestFvDevice->Fvb         = &mTestFvb;
+  mTestFvDevice->FwVolHeader = AllocateCopyPool (HeaderLength, FwVolHeader);
+  if ((mTestFvDevice->FwVolHeader == NULL) || EFI_ERROR (FvCheck (mTestFvDevice))) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Looks a file up by name with FvReadFile().
+
+  @param  Name  The name of the file.
+  @param  Size  Returns the size of the file.
+  @param  Type  Returns the type of the file.
+
+  @return The status returned by FvReadFile().
+**/
+STATIC
+EFI_STATUS
+ReadFileInfo (
+  IN  CONST EFI_GUID   *Name,
+  OUT UINTN            *Size,
+  OUT EFI_FV_FILETYPE  *Type
+  )
+{
+  EFI_FV_FILE_ATTRIBUTES  Attributes;
+  UINT32                  AuthenticationStatus;
+
+  return FvReadFile (&mTestFvDevice->Fv, Name, NULL, Size, Type, &Attributes, &AuthenticationStatus);
+}
+
+/**
+  Checks the files found by name with and without the hash table.
+
+  @param  UseHashTable  TRUE to look the files up with the hash table.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckFileLookups (
+  IN BOOLEAN  UseHashTable
+  )
+{
+  FFS_FILE_LIST_ENTRY     **FileHashTable;
+  EFI_STATUS              Status;
+  UINTN                   Index;
+  UINTN                   Size;
+  EFI_FV_FILETYPE         Type;
+  EFI_FV_FILE_ATTRIBUTES  Attributes;
+  UINT32                  AuthenticationStatus;
+  UINT8                   *Buffer;
+
+  FileHashTable = mTestFvDevice->FileHashTable;
+  UT_ASSERT_NOT_NULL (FileHashTable);
+  if (!UseHashTable) {
+    mTestFvDevice->FileHashTable = NULL;
+  }
+
+  mTestFvDevice->LastKey = NULL;
+  for (Index = 0; Index < TEST_FILE_COUNT; Index++) {
+    Status = ReadFileInfo (&mFileName[Index], &Size, &Type);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Size, mFileDataSize[Index]);
+    UT_ASSERT_EQUAL (Type, EFI_FV_FILETYPE_DRIVER);
+    UT_ASSERT_TRUE (CompareGuid (&mTestFvDevice->LastKey->FfsHeader->Name, &mFileName[Index]));
+  }
+
+  //
+  // The names of the pad files are not file names.
+  //
+  for (Index = TEST_FILE_COUNT; Index < TEST_NAME_COUNT; Index++) {
+    Status = ReadFileInfo (&mFileName[Index], &Size, &Type);
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  }
+
+  //
+  // Read the file contents, twice in a row through LastKey.
+  //
+  for (Index = 0; Index < 2; Index++) {
+    Buffer = NULL;
+    Status = FvReadFile (&mTestFvDevice->Fv, &mFileName[1], (VOID **)&Buffer, &Size, &Type, &Attributes, &AuthenticationStatus);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_NOT_NULL (Buffer);
+    UT_ASSERT_EQUAL (Size, mFileDataSize[1]);
+    UT_ASSERT_TRUE ((Size == 0) || (Buffer[Size - 1] == EFI_FV_FILETYPE_DRIVER));
+    FreePool (Buffer);
+  }
+
+  mTestFvDevice->FileHashTable = FileHashTable;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that FvReadFile() finds the same files with and without the hash
+  table.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FileLookupTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+
+  Status = CheckFileLookups (FALSE);
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  return CheckFileLookups (TRUE);
+}
+
+/**
+  Times TEST_LOOKUP_COUNT lookups of random file names with FvReadFile().
+
+  @return The average time of a lookup, in nanoseconds.
+**/
+STATIC
+UINT64
+TimeFileLookups (
+  VOID
+  )
+{
+  UINTN            Lookup;
+  UINTN            Size;
+  EFI_FV_FILETYPE  Type;
+  clock_t          Start;
+
+  mSeed = 7;
+  Start = clock ();
+  for (Lookup = 0; Lookup < TEST_LOOKUP_COUNT; Lookup++) {
+    ReadFileInfo (&mFileName[NextRandom () % TEST_NAME_COUNT], &Size, &Type);
+  }
+
+  return (UINT64)(clock () - Start) * 1000000000 / CLOCKS_PER_SEC / TEST_LOOKUP_COUNT;
+}
+
+/**
+  Times the lookups of files by name with and without the hash table.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The benchmark ran.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The hash table was not built.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FileLookupBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FFS_FILE_LIST_ENTRY  **FileHashTable;
+  UINT64               ListNs;
+  UINT64               HashNs;
+
+  FileHashTable = mTestFvDevice->FileHashTable;
+  UT_ASSERT_NOT_NULL (FileHashTable);
+
+  mTestFvDevice->FileHashTable = NULL;
+  ListNs                       = TimeFileLookups ();
+  mTestFvDevice->FileHashTable = FileHashTable;
+  HashNs                       = TimeFileLookups ();
+
+  UT_LOG_INFO (
+    "%Lu files: FvReadFile() %Lu ns searching the file list, %Lu ns with the hash table\n",
+    (UINT64)TEST_FILE_COUNT,
+    ListNs,
+    HashNs
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the file name
+  hash table and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      FileHashTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&FileHashTests, Framework, "FV File Hash Tests", "DxeCore.FwVol", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the FV File Hash Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (FileHashTests, "File lookups with and without the hash table", "Lookup", FileLookupTest, PrepareFv, NULL, NULL);
+  AddTestCase (FileHashTests, "File lookup time", "Benchmark", FileLookupBenchmark, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define FfsFileHashBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+FfsFileHashBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,902 @@
+/** @file
+  Host based unit test of the section in place protocol of the DXE core
+  firmware volume driver.
+
+  The real FwVol.c, FwVolRead.c, FwVolAttrib.c, FwVolWrite.c, Ffs.c and
+  CoreSectionExtraction.c are linked with stubs for the protocol, event and
+  GCD services of the DXE core. A memory mapped FV is checked by FvCheck()
+  twice, once reported by the GCD as system memory and once as memory mapped
+  I/O, and the sections of its files are read with ReadSectionInPlace() and
+  with ReadSection().
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "DxeMain.h"
+#include "FwVolDriver.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE Core FV Section In Place Unit Test"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_MAX_FILE_SIZE  SIZE_1KB
+
+//
+// GUID of the GUIDed section of the test file. No extraction protocol is
+// installed for it, so its sections are read from an encapsulated stream.
+//
+#define TEST_SECTION_DEFINITION_GUID \
+  { 0x3b2d4f71, 0x8c0e, 0x4a6d, { 0x95, 0x1f, 0x62, 0xd8, 0x0a, 0x7c, 0x43, 0xe9 } }
+
+#define TEST_SECTION_FILE_GUID \
+  { 0x6f1c8a24, 0x5d37, 0x4e90, { 0xb2, 0x6a, 0x19, 0xf4, 0x8e, 0x03, 0xc7, 0x5d } }
+
+#define TEST_RAW_FILE_GUID \
+  { 0x0e97b3d5, 0x2a48, 0x4c1f, { 0x8d, 0x73, 0xa5, 0x6c, 0x31, 0xfb, 0x92, 0x08 } }
+
+typedef struct {
+  EFI_SECTION_TYPE    Type;
+  UINTN               Instance;
+  ///
+  /// Status returned by ReadSectionInPlace(). ReadSection() returns
+  /// EFI_NOT_FOUND for the sections not found, and EFI_SUCCESS otherwise.
+  ///
+  EFI_STATUS          InPlaceStatus;
+  UINT8               Fill;
+  UINT32              DataSize;
+} TEST_SECTION;
+
+//
+// Sections of the test file, in the order they are searched:
+//   RAW 0x10, GUID_DEFINED { RAW 0x11, PE32 0x20 }, RAW 0x12, DXE_DEPEX 0x30
+//
+STATIC CONST TEST_SECTION  mTestSections[] = {
+  { EFI_SECTION_RAW,       0, EFI_SUCCESS,     0x10, 12 },
+  { EFI_SECTION_RAW,       1, EFI_UNSUPPORTED, 0x11, 8  },
+  { EFI_SECTION_RAW,       2, EFI_SUCCESS,     0x12, 21 },
+  { EFI_SECTION_RAW,       3, EFI_NOT_FOUND,   0,    0  },
+  { EFI_SECTION_PE32,      0, EFI_UNSUPPORTED, 0x20, 32 },
+  { EFI_SECTION_PE32,      1, EFI_NOT_FOUND,   0,    0  },
+  { EFI_SECTION_DXE_DEPEX, 0, EFI_SUCCESS,     0x30, 4  },
+  { EFI_SECTION_TE,        0, EFI_NOT_FOUND,   0,    0  }
+};
+
+extern FV_DEVICE  mFvDevice;
+
+EFI_STATUS
+FvCheck (
+  IN OUT FV_DEVICE  *FvDevice
+  );
+
+EFI_BOOT_SERVICES  *gBS;
+
+STATIC EFI_GUID   mSectionDefinitionGuid = TEST_SECTION_DEFINITION_GUID;
+STATIC EFI_GUID   mSectionFileName       = TEST_SECTION_FILE_GUID;
+STATIC EFI_GUID   mRawFileName           = TEST_RAW_FILE_GUID;
+STATIC UINT8      *mFv                   = NULL;
+STATIC UINTN      mFvLength              = 0;
+STATIC BOOLEAN    mFvInSystemMemory      = FALSE;
+STATIC FV_DEVICE  *mSystemMemoryFvDevice = NULL;
+STATIC FV_DEVICE  *mFlashFvDevice        = NULL;
+
+//
+// Stubs for the DXE core services used by the firmware volume driver and the
+// section extraction
+//
+EFI_STATUS
+EFIAPI
+CoreFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+EFI_TPL
+EFIAPI
+CoreRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+VOID
+EFIAPI
+CoreRestoreTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+}
+
+EFI_STATUS
+EFIAPI
+CoreLocateHandle (
+  IN     EFI_LOCATE_SEARCH_TYPE  SearchType,
+  IN     EFI_GUID                *Protocol   OPTIONAL,
+  IN     VOID                    *SearchKey  OPTIONAL,
+  IN OUT UINTN                   *BufferSize,
+  OUT    EFI_HANDLE              *Buffer
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+EFI_STATUS
+EFIAPI
+CoreHandleProtocol (
+  IN   EFI_HANDLE  UserHandle,
+  IN   EFI_GUID    *Protocol,
+  OUT  VOID        **Interface
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+CoreLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+EFI_STATUS
+EFIAPI
+CoreInstallProtocolInterface (
+  IN OUT EFI_HANDLE      *UserHandle,
+  IN EFI_GUID            *Protocol,
+  IN EFI_INTERFACE_TYPE  InterfaceType,
+  IN VOID                *Interface
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_EVENT
+EFIAPI
+EfiCreateProtocolNotifyEvent (
+  IN  EFI_GUID          *ProtocolGuid,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction,
+  IN  VOID              *NotifyContext   OPTIONAL,
+  OUT VOID              **Registration
+  )
+{
+  return NULL;
+}
+
+EFI_STATUS
+EFIAPI
+EfiGetSystemConfigurationTable (
+  IN  EFI_GUID  *TableGuid,
+  OUT VOID      **Table
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+BOOLEAN
+CoreTakePrefetchedSection (
+  IN  VOID    *Section,
+  IN  UINTN   SectionSize,
+  OUT VOID    **Buffer,
+  OUT UINTN   *BufferSize,
+  OUT UINT32  *AuthenticationStatus
+  )
+{
+  return FALSE;
+}
+
+UINTN
+EFIAPI
+ExtractGuidedSectionGetGuidList (
+  OUT  GUID  **ExtractHandlerGuidTable
+  )
+{
+  return 0;
+}
+
+RETURN_STATUS
+EFIAPI
+ExtractGuidedSectionGetInfo (
+  IN  CONST VOID    *InputSection,
+  OUT       UINT32  *OutputBufferSize,
+  OUT       UINT32  *ScratchBufferSize,
+  OUT       UINT16  *SectionAttribute
+  )
+{
+  return RETURN_UNSUPPORTED;
+}
+
+RETURN_STATUS
+EFIAPI
+ExtractGuidedSectionDecode (
+  IN  CONST VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  IN        VOID    *ScratchBuffer         OPTIONAL,
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  return RETURN_UNSUPPORTED;
+}
+
+UINT32
+GetFvbAuthenticationStatus (
+  IN EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *FvbProtocol
+  )
+{
+  return 0;
+}
+
+/**
+  Returns the GCD memory space descriptor of the test FV, reported as system
+  memory or memory mapped I/O according to mFvInSystemMemory.
+
+  @param  BaseAddress  The address to look up.
+  @param  Descriptor   Returns the descriptor of the test FV.
+
+  @retval EFI_SUCCESS    The address is in the test FV.
+  @retval EFI_NOT_FOUND  The address is not in the test FV.
+**/
+EFI_STATUS
+EFIAPI
+CoreGetMemorySpaceDescriptor (
+  IN  EFI_PHYSICAL_ADDRESS             BaseAddress,
+  OUT EFI_GCD_MEMORY_SPACE_DESCRIPTOR  *Descriptor
+  )
+{
+  if ((BaseAddress < (UINTN)mFv) || (BaseAddress >= (UINTN)mFv + mFvLength)) {
+    return EFI_NOT_FOUND;
+  }
+
+  ZeroMem (Descriptor, sizeof (EFI_GCD_MEMORY_SPACE_DESCRIPTOR));
+  Descriptor->BaseAddress   = (UINTN)mFv;
+  Descriptor->Length        = mFvLength;
+  Descriptor->GcdMemoryType = mFvInSystemMemory ? EfiGcdMemoryTypeSystemMemory : EfiGcdMemoryTypeMemoryMappedIo;
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the attributes of the test FV.
+
+  @param  This        The test FVB.
+  @param  Attributes  Returns the attributes of the test FV.
+
+  @retval EFI_SUCCESS  Always.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestFvbGetAttributes (
+  IN CONST EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *This,
+  OUT      EFI_FVB_ATTRIBUTES_2                *Attributes
+  )
+{
+  *Attributes = EFI_FVB2_READ_ENABLED_CAP | EFI_FVB2_READ_STATUS | EFI_FVB2_MEMORY_MAPPED;
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the address of the test FV.
+
+  @param  This     The test FVB.
+  @param  Address  Returns the address of the test FV.
+
+  @retval EFI_SUCCESS  Always.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestFvbGetPhysicalAddress (
+  IN CONST EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *This,
+  OUT      EFI_PHYSICAL_ADDRESS                *Address
+  )
+{
+  *Address = (EFI_PHYSICAL_ADDRESS)(UINTN)mFv;
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  mTestFvb = {
+  TestFvbGetAttributes,
+  NULL,
+  TestFvbGetPhysicalAddress,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+/**
+  Sets the type and the size of a section header.
+
+  @param  Section  The section header.
+  @param  Type     The type of the section.
+  @param  Size     The size of the section, including its header.
+**/
+STATIC
+VOID
+SetSectionHeader (
+  OUT EFI_COMMON_SECTION_HEADER  *Section,
+  IN  EFI_SECTION_TYPE           Type,
+  IN  UINTN                      Size
+  )
+{
+  Section->Type    = Type;
+  Section->Size[0] = (UINT8)Size;
+  Section->Size[1] = (UINT8)(Size >> 8);
+  Section->Size[2] = (UINT8)(Size >> 16);
+}
+
+/**
+  Appends a leaf section filled with a byte value to a section stream.
+
+  @param  Stream  The section stream.
+  @param  Offset  The end of the section stream, updated to the end of the
+                  section.
+  @param  Entry   The test section to append.
+**/
+STATIC
+VOID
+AppendSection (
+  IN OUT UINT8               *Stream,
+  IN OUT UINTN               *Offset,
+  IN     CONST TEST_SECTION  *Entry
+  )
+{
+  EFI_COMMON_SECTION_HEADER  *Section;
+
+  *Offset = ALIGN_VALUE (*Offset, 4);
+  Section = (EFI_COMMON_SECTION_HEADER *)(Stream + *Offset);
+  SetSectionHeader (Section, Entry->Type, sizeof (EFI_COMMON_SECTION_HEADER) + Entry->DataSize);
+  SetMem (Section + 1, Entry->DataSize, Entry->Fill);
+  *Offset += sizeof (EFI_COMMON_SECTION_HEADER) + Entry->DataSize;
+}
+
+/**
+  Appends an FFS file to the test FV.
+
+  @param  Offset    The offset of the file, updated to the offset of the next file.
+  @param  Name      The name of the file.
+  @param  Type      The type of the file.
+  @param  Data      The data of the file.
+  @param  DataSize  The size of the data of the file.
+**/
+STATIC
+VOID
+AppendFile (
+  IN OUT UINTN            *Offset,
+  IN     CONST EFI_GUID   *Name,
+  IN     EFI_FV_FILETYPE  Type,
+  IN     CONST UINT8      *Data,
+  IN     UINTN            DataSize
+  )
+{
+  EFI_FFS_FILE_HEADER  *FfsHeader;
+  UINTN                FileSize;
+
+  FileSize  = sizeof (EFI_FFS_FILE_HEADER) + DataSize;
+  FfsHeader = (EFI_FFS_FILE_HEADER *)(mFv + *Offset);
+  CopyGuid (&FfsHeader->Name, Name);
+  FfsHeader->Type       = Type;
+  FfsHeader->Attributes = 0;
+  FfsHeader->Size[0]    = (UINT8)FileSize;
+  FfsHeader->Size[1]    = (UINT8)(FileSize >> 8);
+  FfsHeader->Size[2]    = (UINT8)(FileSize >> 16);
+  FfsHeader->State      = 0;
+
+  FfsHeader->IntegrityCheck.Checksum16      = 0;
+  FfsHeader->IntegrityCheck.Checksum.Header = CalculateCheckSum8 ((UINT8 *)FfsHeader, sizeof (EFI_FFS_FILE_HEADER));
+  FfsHeader->IntegrityCheck.Checksum.File   = FFS_FIXED_CHECKSUM;
+  FfsHeader->State                          = EFI_FILE_HEADER_CONSTRUCTION | EFI_FILE_HEADER_VALID | EFI_FILE_DATA_VALID;
+  CopyMem (FfsHeader + 1, Data, DataSize);
+
+  *Offset = ALIGN_VALUE (*Offset + FileSize, 8);
+}
+
+/**
+  Creates the FV_DEVICE of the test FV and checks the FV with FvCheck().
+
+  @param  InSystemMemory  TRUE if the GCD reports the FV as system memory.
+
+  @return The FV_DEVICE, or NULL if the FV could not be checked.
+**/
+STATIC
+FV_DEVICE *
+CreateFvDevice (
+  IN BOOLEAN  InSystemMemory
+  )
+{
+  FV_DEVICE  *FvDevice;
+
+  FvDevice = AllocateCopyPool (sizeof (FV_DEVICE), &mFvDevice);
+  if (FvDevice == NULL) {
+    return NULL;
+  }
+
+  mFvInSystemMemory     = InSystemMemory;
+  FvDevice->Fvb         = &mTestFvb;
+  FvDevice->FwVolHeader = AllocateCopyPool (((EFI_FIRMWARE_VOLUME_HEADER *)mFv)->HeaderLength, mFv);
+  if ((FvDevice->FwVolHeader == NULL) || EFI_ERROR (FvCheck (FvDevice))) {
+    return NULL;
+  }
+
+  return FvDevice;
+}
+
+/**
+  Builds a memory mapped FV with a file of the sections of mTestSections and
+  a RAW file, and the FV_DEVICEs of the FV in system memory and in flash.
+
+  @param  Context  Unused.
+
+  @retval UNIT_TEST_PASSED                      The FV was built.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The FV could not be built.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PrepareFv (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader;
+  EFI_GUID_DEFINED_SECTION    *GuidedSection;
+  UINT8                       *Data;
+  UINTN                       DataSize;
+  UINTN                       GuidedOffset;
+  UINTN                       HeaderLength;
+  UINTN                       Offset;
+
+  Data         = AllocateZeroPool (TEST_MAX_FILE_SIZE);
+  HeaderLength = sizeof (EFI_FIRMWARE_VOLUME_HEADER) + sizeof (EFI_FV_BLOCK_MAP_ENTRY);
+  mFvLength    = ALIGN_VALUE (HeaderLength, 8) + 2 * (sizeof (EFI_FFS_FILE_HEADER) + TEST_MAX_FILE_SIZE) + SIZE_4KB;
+  mFv          = AllocateZeroPool (mFvLength);
+  if ((Data == NULL) || (mFv == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  FwVolHeader = (EFI_FIRMWARE_VOLUME_HEADER *)mFv;
+  CopyGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem2Guid);
+  FwVolHeader->FvLength              = mFvLength;
+  FwVolHeader->Signature             = EFI_FVH_SIGNATURE;
+  FwVolHeader->Attributes            = EFI_FVB2_READ_ENABLED_CAP | EFI_FVB2_READ_STATUS | EFI_FVB2_MEMORY_MAPPED;
+  FwVolHeader->HeaderLength          = (UINT16)HeaderLength;
+  FwVolHeader->Revision              = EFI_FVH_REVISION;
+  FwVolHeader->BlockMap[0].NumBlocks = 1;
+  FwVolHeader->BlockMap[0].Length    = (UINT32)mFvLength;
+  FwVolHeader->Checksum              = CalculateCheckSum16 ((UINT16 *)FwVolHeader, HeaderLength);
+
+  //
+  // RAW 0x10, GUID_DEFINED { RAW 0x11, PE32 0x20 }, RAW 0x12, DXE_DEPEX 0x30
+  //
+  DataSize = 0;
+  AppendSection (Data, &DataSize, &mTestSections[0]);
+
+  DataSize      = ALIGN_VALUE (DataSize, 4);
+  GuidedOffset  = DataSize;
+  GuidedSection = (EFI_GUID_DEFINED_SECTION *)(Data + GuidedOffset);
+  CopyGuid (&GuidedSection->SectionDefinitionGuid, &mSectionDefinitionGuid);
+  GuidedSection->DataOffset = sizeof (EFI_GUID_DEFINED_SECTION);
+  GuidedSection->Attributes = 0;
+  DataSize                 += sizeof (EFI_GUID_DEFINED_SECTION);
+  AppendSection (Data, &DataSize, &mTestSections[1]);
+  AppendSection (Data, &DataSize, &mTestSections[4]);
+  SetSectionHeader (&GuidedSection->CommonHeader, EFI_SECTION_GUID_DEFINED, DataSize - GuidedOffset);
+
+  AppendSection (Data, &DataSize, &mTestSections[2]);
+  AppendSection (Data, &DataSize, &mTestSections[6]);
+  ASSERT (DataSize <= TEST_MAX_FILE_SIZE);
+
+  Offset = ALIGN_VALUE (HeaderLength, 8);
+  AppendFile (&Offset, &mSectionFileName, EFI_FV_FILETYPE_FREEFORM, Data, DataSize);
+  AppendFile (&Offset, &mRawFileName, EFI_FV_FILETYPE_RAW, Data, DataSize);
+  ASSERT (Offset <= mFvLength);
+  FreePool (Data);
+
+  mSystemMemoryFvDevice = CreateFvDevice (TRUE);
+  mFlashFvDevice        = CreateFvDevice (FALSE);
+  if ((mSystemMemoryFvDevice == NULL) || (mFlashFvDevice == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that the GCD type of the test FV selects whether its files are read
+  in place or copied to pool.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SystemMemoryFileTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST VOID  *Buffer;
+  UINTN       BufferSize;
+  UINT32      AuthenticationStatus;
+  EFI_STATUS  Status;
+
+  UT_ASSERT_TRUE (mSystemMemoryFvDevice->IsMemoryMapped);
+  UT_ASSERT_TRUE (mSystemMemoryFvDevice->IsInSystemMemory);
+  UT_ASSERT_TRUE (mFlashFvDevice->IsMemoryMapped);
+  UT_ASSERT_FALSE (mFlashFvDevice->IsInSystemMemory);
+
+  //
+  // The files of the FV in system memory are not copied to pool.
+  //
+  Status = mSystemMemoryFvDevice->SectionInPlace.ReadSectionInPlace (
+                                                   &mSystemMemoryFvDevice->SectionInPlace,
+                                                   &mSectionFileName,
+                                                   EFI_SECTION_RAW,
+                                                   0,
+                                                   &Buffer,
+                                                   &BufferSize,
+                                                   &AuthenticationStatus
+                                                   );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (mSystemMemoryFvDevice->LastKey->FileCached);
+  UT_ASSERT_TRUE ((UINT8 *)mSystemMemoryFvDevice->LastKey->FfsHeader > mFv);
+  UT_ASSERT_TRUE ((UINT8 *)mSystemMemoryFvDevice->LastKey->FfsHeader < mFv + mFvLength);
+
+  //
+  // The files of the FV in flash are copied to pool when they are read.
+  //
+  Status = mFlashFvDevice->SectionInPlace.ReadSectionInPlace (
+                                            &mFlashFvDevice->SectionInPlace,
+                                            &mSectionFileName,
+                                            EFI_SECTION_RAW,
+                                            0,
+                                            &Buffer,
+                                            &BufferSize,
+                                            &AuthenticationStatus
+                                            );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (mFlashFvDevice->LastKey->FileCached);
+  UT_ASSERT_TRUE (((UINT8 *)Buffer < mFv) || ((UINT8 *)Buffer >= mFv + mFvLength));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that the sections not in an encapsulation section are returned in
+  place, inside the FV in system memory.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InPlaceSectionTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST TEST_SECTION  *Entry;
+  CONST UINT8         *Buffer;
+  UINTN               BufferSize;
+  UINT32              AuthenticationStatus;
+  EFI_STATUS          Status;
+  UINTN               Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mTestSections); Index++) {
+    Entry = &mTestSections[Index];
+    if (Entry->InPlaceStatus != EFI_SUCCESS) {
+      continue;
+    }
+
+    Status = mSystemMemoryFvDevice->SectionInPlace.ReadSectionInPlace (
+                                                     &mSystemMemoryFvDevice->SectionInPlace,
+                                                     &mSectionFileName,
+                                                     Entry->Type,
+                                                     Entry->Instance,
+                                                     (CONST VOID **)&Buffer,
+                                                     &BufferSize,
+                                                     &AuthenticationStatus
+                                                     );
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (BufferSize, Entry->DataSize);
+    UT_ASSERT_TRUE (Buffer >= mFv);
+    UT_ASSERT_TRUE (Buffer + BufferSize <= mFv + mFvLength);
+    UT_ASSERT_EQUAL (Buffer[0], Entry->Fill);
+    UT_ASSERT_EQUAL (Buffer[BufferSize - 1], Entry->Fill);
+  }
+
+  //
+  // The whole section stream of the file is in place too.
+  //
+  Status = mSystemMemoryFvDevice->SectionInPlace.ReadSectionInPlace (
+                                                   &mSystemMemoryFvDevice->SectionInPlace,
+                                                   &mSectionFileName,
+                                                   0,
+                                                   0,
+                                                   (CONST VOID **)&Buffer,
+                                                   &BufferSize,
+                                                   &AuthenticationStatus
+                                                   );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (Buffer == (UINT8 *)(mSystemMemoryFvDevice->LastKey->FfsHeader + 1));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks the sections of the test file of an FV_DEVICE read with
+  ReadSectionInPlace() against the sections read with ReadSection().
+
+  @param  FvDevice  The FV_DEVICE of the test FV.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckSectionInstances (
+  IN FV_DEVICE  *FvDevice
+  )
+{
+  CONST TEST_SECTION  *Entry;
+  CONST VOID          *InPlaceBuffer;
+  UINTN               InPlaceSize;
+  UINT32              InPlaceAuthenticationStatus;
+  UINT8               *Buffer;
+  UINTN               BufferSize;
+  UINT32              AuthenticationStatus;
+  EFI_STATUS          Status;
+  UINTN               Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mTestSections); Index++) {
+    Entry  = &mTestSections[Index];
+    Buffer = NULL;
+    Status = FvDevice->Fv.ReadSection (
+                            &FvDevice->Fv,
+                            &mSectionFileName,
+                            Entry->Type,
+                            Entry->Instance,
+                            (VOID **)&Buffer,
+                            &BufferSize,
+                            &AuthenticationStatus
+                            );
+    if (Entry->InPlaceStatus == EFI_NOT_FOUND) {
+      UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+    } else {
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_EQUAL (BufferSize, Entry->DataSize);
+      UT_ASSERT_EQUAL (Buffer[0], Entry->Fill);
+      UT_ASSERT_EQUAL (Buffer[BufferSize - 1], Entry->Fill);
+    }
+
+    Status = FvDevice->SectionInPlace.ReadSectionInPlace (
+                                        &FvDevice->SectionInPlace,
+                                        &mSectionFileName,
+                                        Entry->Type,
+                                        Entry->Instance,
+                                        &InPlaceBuffer,
+                                        &InPlaceSize,
+                                        &InPlaceAuthenticationStatus
+                                        );
+    UT_ASSERT_STATUS_EQUAL (Status, Entry->InPlaceStatus);
+    if (!EFI_ERROR (Status)) {
+      UT_ASSERT_EQUAL (InPlaceSize, BufferSize);
+      UT_ASSERT_EQUAL (InPlaceAuthenticationStatus, AuthenticationStatus);
+      UT_ASSERT_MEM_EQUAL (InPlaceBuffer, Buffer, BufferSize);
+    }
+
+    if (Buffer != NULL) {
+      FreePool (Buffer);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that ReadSectionInPlace() numbers the section instances as
+  ReadSection() does, in system memory and in flash.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SectionInstanceTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+
+  Status = CheckSectionInstances (mSystemMemoryFvDevice);
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  return CheckSectionInstances (mFlashFvDevice);
+}
+
+/**
+  Checks that the sections of an encapsulation section are not returned in
+  place.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+EncapsulatedSectionTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST VOID  *Buffer;
+  UINTN       BufferSize;
+  UINT32      AuthenticationStatus;
+  EFI_STATUS  Status;
+
+  Status = mSystemMemoryFvDevice->SectionInPlace.ReadSectionInPlace (
+                                                   &mSystemMemoryFvDevice->SectionInPlace,
+                                                   &mSectionFileName,
+                                                   EFI_SECTION_PE32,
+                                                   0,
+                                                   &Buffer,
+                                                   &BufferSize,
+                                                   &AuthenticationStatus
+                                                   );
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Status = mSystemMemoryFvDevice->SectionInPlace.ReadSectionInPlace (
+                                                   &mSystemMemoryFvDevice->SectionInPlace,
+                                                   &mSectionFileName,
+                                                   EFI_SECTION_RAW,
+                                                   1,
+                                                   &Buffer,
+                                                   &BufferSize,
+                                                   &AuthenticationStatus
+                                                   );
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that no section is found in a RAW file.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RawFileTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST VOID  *Buffer;
+  UINTN       BufferSize;
+  UINT32      AuthenticationStatus;
+  EFI_STATUS  Status;
+
+  Status = mSystemMemoryFvDevice->SectionInPlace.ReadSectionInPlace (
+                                                   &mSystemMemoryFvDevice->SectionInPlace,
+                                                   &mRawFileName,
+                                                   EFI_SECTION_RAW,
+                                                   0,
+                                                   &Buffer,
+                                                   &BufferSize,
+                                                   &AuthenticationStatus
+                                                   );
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = mSystemMemoryFvDevice->SectionInPlace.ReadSectionInPlace (
+                                                   &mSystemMemoryFvDevice->SectionInPlace,
+                                                   &mRawFileName,
+                                                   0,
+                                                   0,
+                                                   &Buffer,
+                                                   &BufferSize,
+                                                   &AuthenticationStatus
+                                                   );
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the section
+  in place protocol and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SectionInPlaceTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&SectionInPlaceTests, Framework, "FV Section In Place Tests", "DxeCore.FwVol", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the FV Section In Place Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (SectionInPlaceTests, "Files of an FV in system memory are not copied", "SystemMemory", SystemMemoryFileTest, PrepareFv, NULL, NULL);
+  AddTestCase (SectionInPlaceTests, "Sections are returned inside the FV", "InPlace", InPlaceSectionTest, NULL, NULL, NULL);
+  AddTestCase (SectionInPlaceTests, "Section instances match ReadSection", "Instance", SectionInstanceTest, NULL, NULL, NULL);
+  AddTestCase (SectionInPlaceTests, "Encapsulated sections are not returned in place", "Encapsulated", EncapsulatedSectionTest, NULL, NULL, NULL);
+  AddTestCase (SectionInPlaceTests, "RAW files have no sections", "RawFile", RawFileTest, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define SectionInPlaceUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+SectionInPlaceUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -10,12 +10,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Handle.h"
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// mProtocolDatabase     - A list of all protocols in the system.
+// mProtocolHashTable    - The protocols of mProtocolDatabase hashed by GUID
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
+#define PROTOCOL_HASH_TABLE_SIZE  0x100
+
 LIST_ENTRY          mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
+LIST_ENTRY          mProtocolHashTable[PROTOCOL_HASH_TABLE_SIZE];
 LIST_ENTRY          gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK            gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64              gHandleDatabaseKey    = 0;
@@ -90,12 +94,18 @@ CoreInitializeHandleServices (
   VOID
   )
 {
+  UINTN  Index;
+
   gOrderedHandleList = OrderedCollectionInit (PointerCompare, PointerCompare);
 
   if (gOrderedHandleList == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
+  for (Index = 0; Index < PROTOCOL_HASH_TABLE_SIZE; Index++) {
+    InitializeListHead (&mProtocolHashTable[Index]);
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -130,6 +140,34 @@ CoreValidateHandle (
   return EFI_INVALID_PARAMETER;
 }
 
+/**
+  Returns the bucket of mProtocolHashTable that holds a protocol GUID.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The hash bucket list head
+
+**/
+STATIC
+LIST_ENTRY *
+CoreGetProtocolHashBucket (
+  IN EFI_GUID  *Protocol
+  )
+{
+  UINT32  *Data;
+  UINT32  Hash;
+
+  //
+  // GUIDs are mostly random, so folding the four 32-bit words is enough
+  //
+  Data = (UINT32 *)Protocol;
+  Hash = Data[0] ^ Data[1] ^ Data[2] ^ Data[3];
+  Hash = Hash ^ (Hash >> 16);
+  Hash = Hash ^ (Hash >> 8);
+
+  return &mProtocolHashTable[Hash & (PROTOCOL_HASH_TABLE_SIZE - 1)];
+}
+
 /**
   Finds the protocol entry for the requested protocol.
   The gProtocolDatabaseLock must be owned
@@ -146,6 +184,7 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   )
 {
+  LIST_ENTRY      *Bucket;
   LIST_ENTRY      *Link;
   PROTOCOL_ENTRY  *Item;
   PROTOCOL_ENTRY  *ProtEntry;
@@ -153,15 +192,12 @@ CoreFindProtocolEntry (
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket of the GUID for the matching entry
   //
-
+  Bucket    = CoreGetProtocolHashBucket (Protocol);
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
-       Link = Link->ForwardLink)
-  {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    Item = CR (Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
       //
       // This is the protocol entry
@@ -192,6 +228,7 @@ CoreFindProtocolEntry (
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertTailList (Bucket, &ProtEntry->HashLink);
     }
   }
 
@@ -1006,13 +1043,21 @@ CoreGetProtocolInterface (
 
   Handle = (IHANDLE *)UserHandle;
 
+  //
+  // Resolve the GUID once through the protocol hash table. A protocol that
+  // is not in the database cannot be on the handle.
+  //
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  if (ProtEntry == NULL) {
+    return NULL;
+  }
+
   //
   // Look at each protocol interface for a match
   //
   for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
-    Prot      = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
-    ProtEntry = Prot->Protocol;
-    if (CompareGuid (&ProtEntry->ProtocolID, Protocol)) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    if (Prot->Protocol == ProtEntry) {
       return Prot;
     }
   }
@@ -31,6 +31,8 @@ CoreNotifyProtocolEntry (
     ProtNotify = CR (Link, PROTOCOL_NOTIFY, Link, PROTOCOL_NOTIFY_SIGNATURE);
     CoreSignalEvent (ProtNotify->Event);
   }
+
+  CoreDepexProtocolChanged (&ProtEntry->ProtocolID);
 }
 
 /**
@@ -76,6 +78,7 @@ CoreRemoveInterfaceFromProtocol (
     // Remove the protocol interface entry
     //
     RemoveEntryList (&Prot->ByProtocol);
+    CoreDepexProtocolChanged (&ProtEntry->ProtocolID);
   }
 
   return Prot;
@@ -0,0 +1,675 @@
+/** @file
+  Host based test and benchmark for the DXE core handle database.
+
+  The real Handle.c, Locate.c, Notify.c and DriverSupport.c are linked with
+  stubs for the locks, TPL and event services of the DXE core. A synthetic
+  platform with a large protocol database and a configurable number of
+  controller handles is built, and a connect-all pass is timed along with
+  the HandleProtocol(), LocateProtocol() and LocateHandleBuffer() calls that
+  dominate it.
+
+  Usage: HandleDatabaseBenchmarkHost [HandleCount]
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "DxeMain.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE Core Handle Database Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_PROTOCOL_COUNT           512
+#define TEST_DRIVER_COUNT             64
+#define TEST_PROTOCOLS_PER_HANDLE     6
+#define TEST_DEFAULT_HANDLE_COUNT     2000
+#define TEST_LOOKUP_ROUNDS            20
+#define TEST_INTERFACE_SIGNATURE      SIGNATURE_32 ('t', 'h', 'd', 'b')
+
+typedef struct {
+  UINT32        Signature;
+  EFI_HANDLE    Handle;
+  UINTN         ProtocolIndex;
+} TEST_INTERFACE;
+
+typedef struct {
+  EFI_HANDLE        Handle;
+  UINTN             ProtocolIndex[TEST_PROTOCOLS_PER_HANDLE];
+  TEST_INTERFACE    Interface[TEST_PROTOCOLS_PER_HANDLE];
+} TEST_CONTROLLER;
+
+typedef struct {
+  EFI_DRIVER_BINDING_PROTOCOL    DriverBinding;
+  UINTN                          ProtocolIndex;
+  UINTN                          StartCount;
+} TEST_DRIVER;
+
+STATIC UINTN            mHandleCount = TEST_DEFAULT_HANDLE_COUNT;
+STATIC EFI_GUID         mProtocolGuid[TEST_PROTOCOL_COUNT];
+STATIC TEST_INTERFACE   mPlatformInterface[TEST_PROTOCOL_COUNT];
+STATIC EFI_HANDLE       mPlatformHandle = NULL;
+STATIC TEST_CONTROLLER  *mControllers   = NULL;
+STATIC TEST_DRIVER      mDrivers[TEST_DRIVER_COUNT];
+STATIC UINT32           mSeed;
+STATIC EFI_TPL          mTestTpl = TPL_APPLICATION;
+
+//
+// Stubs for the DXE core services used by the handle database
+//
+EFI_HANDLE                   gDxeCoreImageHandle = NULL;
+EFI_SECURITY2_ARCH_PROTOCOL  *gSecurity2         = NULL;
+
+VOID
+CoreAcquireLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockReleased);
+  Lock->Lock = EfiLockAcquired;
+}
+
+EFI_STATUS
+CoreAcquireLockOrFail (
+  IN EFI_LOCK  *Lock
+  )
+{
+  if (Lock->Lock == EfiLockAcquired) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  Lock->Lock = EfiLockAcquired;
+  return EFI_SUCCESS;
+}
+
+VOID
+CoreReleaseLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockAcquired);
+  Lock->Lock = EfiLockReleased;
+}
+
+EFI_TPL
+EFIAPI
+CoreRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl   = mTestTpl;
+  mTestTpl = NewTpl;
+  return OldTpl;
+}
+
+VOID
+EFIAPI
+CoreRestoreTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  mTestTpl = NewTpl;
+}
+
+EFI_STATUS
+EFIAPI
+CoreSignalEvent (
+  IN EFI_EVENT  UserEvent
+  )
+{
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+CoreFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the next value of a deterministic pseudo random sequence.
+
+  @return A pseudo random 32-bit value.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mSeed = mSeed * 1103515245 + 12345;
+  return mSeed >> 1;
+}
+
+/**
+  Tests whether a controller carries the protocol of a test driver.
+
+  @param  This                 The driver binding protocol of the test driver.
+  @param  ControllerHandle     The controller to test.
+  @param  RemainingDevicePath  Unused.
+
+  @retval EFI_SUCCESS          The driver supports the controller.
+  @retval other                The driver does not support the controller.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestDriverSupported (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   ControllerHandle,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath OPTIONAL
+  )
+{
+  TEST_DRIVER  *Driver;
+  EFI_STATUS   Status;
+  VOID         *Interface;
+
+  Driver = BASE_CR (This, TEST_DRIVER, DriverBinding);
+  Status = CoreOpenProtocol (
+             ControllerHandle,
+             &mProtocolGuid[Driver->ProtocolIndex],
+             &Interface,
+             This->DriverBindingHandle,
+             ControllerHandle,
+             EFI_OPEN_PROTOCOL_BY_DRIVER
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  CoreCloseProtocol (
+    ControllerHandle,
+    &mProtocolGuid[Driver->ProtocolIndex],
+    This->DriverBindingHandle,
+    ControllerHandle
+    );
+  return EFI_SUCCESS;
+}
+
+/**
+  Starts a test driver on a controller by opening its protocol by driver.
+
+  @param  This                 The driver binding protocol of the test driver.
+  @param  ControllerHandle     The controller to start on.
+  @param  RemainingDevicePath  Unused.
+
+  @retval EFI_SUCCESS          The driver was started.
+  @retval other                The driver could not be started.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestDriverStart (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   ControllerHandle,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath OPTIONAL
+  )
+{
+  TEST_DRIVER  *Driver;
+  EFI_STATUS   Status;
+  VOID         *Interface;
+
+  Driver = BASE_CR (This, TEST_DRIVER, DriverBinding);
+  Status = CoreOpenProtocol (
+             ControllerHandle,
+             &mProtocolGuid[Driver->ProtocolIndex],
+             &Interface,
+             This->DriverBindingHandle,
+             ControllerHandle,
+             EFI_OPEN_PROTOCOL_BY_DRIVER
+             );
+  if (!EFI_ERROR (Status)) {
+    Driver->StartCount++;
+  }
+
+  return Status;
+}
+
+/**
+  Stops a test driver on a controller.
+
+  @param  This               The driver binding protocol of the test driver.
+  @param  ControllerHandle   The controller to stop.
+  @param  NumberOfChildren   Unused.
+  @param  ChildHandleBuffer  Unused.
+
+  @retval EFI_SUCCESS        The driver was stopped.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestDriverStop (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   ControllerHandle,
+  IN UINTN                        NumberOfChildren,
+  IN EFI_HANDLE                   *ChildHandleBuffer OPTIONAL
+  )
+{
+  TEST_DRIVER  *Driver;
+
+  Driver = BASE_CR (This, TEST_DRIVER, DriverBinding);
+  return CoreCloseProtocol (
+           ControllerHandle,
+           &mProtocolGuid[Driver->ProtocolIndex],
+           This->DriverBindingHandle,
+           ControllerHandle
+           );
+}
+
+/**
+  Builds the synthetic platform: one handle carrying every test protocol,
+  so that the protocol database is large, and one handle per test driver.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED                      The platform was built.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The platform could not be built.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PreparePlatform (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       Byte;
+
+  if (mPlatformHandle != NULL) {
+    return UNIT_TEST_PASSED;
+  }
+
+  Status = CoreInitializeHandleServices ();
+  if (EFI_ERROR (Status)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mSeed = 0x48444221;
+  for (Index = 0; Index < TEST_PROTOCOL_COUNT; Index++) {
+    mProtocolGuid[Index].Data1 = NextRandom ();
+    mProtocolGuid[Index].Data2 = (UINT16)NextRandom ();
+    mProtocolGuid[Index].Data3 = (UINT16)Index;
+    for (Byte = 0; Byte < sizeof (mProtocolGuid[Index].Data4); Byte++) {
+      mProtocolGuid[Index].Data4[Byte] = (UINT8)NextRandom ();
+    }
+
+    mPlatformInterface[Index].Signature     = TEST_INTERFACE_SIGNATURE;
+    mPlatformInterface[Index].ProtocolIndex = Index;
+    Status                                  = CoreInstallProtocolInterface (
+                                                &mPlatformHandle,
+                                                &mProtocolGuid[Index],
+                                                EFI_NATIVE_INTERFACE,
+                                                &mPlatformInterface[Index]
+                                                );
+    if (EFI_ERROR (Status)) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+  }
+
+  for (Index = 0; Index < TEST_DRIVER_COUNT; Index++) {
+    mDrivers[Index].DriverBinding.Supported           = TestDriverSupported;
+    mDrivers[Index].DriverBinding.Start               = TestDriverStart;
+    mDrivers[Index].DriverBinding.Stop                = TestDriverStop;
+    mDrivers[Index].DriverBinding.Version             = 0x10;
+    mDrivers[Index].DriverBinding.ImageHandle         = NULL;
+    mDrivers[Index].DriverBinding.DriverBindingHandle = NULL;
+    mDrivers[Index].ProtocolIndex                     = Index;
+    Status                                            = CoreInstallProtocolInterface (
+                                                          &mDrivers[Index].DriverBinding.DriverBindingHandle,
+                                                          &gEfiDriverBindingProtocolGuid,
+                                                          EFI_NATIVE_INTERFACE,
+                                                          &mDrivers[Index].DriverBinding
+                                                          );
+    if (EFI_ERROR (Status)) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    mDrivers[Index].DriverBinding.ImageHandle = mDrivers[Index].DriverBinding.DriverBindingHandle;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks protocol lookups by handle and by GUID, and that the handle
+  database key changes when a handle is created and on every uninstall.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+HandleDatabaseLookupTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS      Status;
+  EFI_HANDLE      Handle;
+  EFI_GUID        UnknownGuid;
+  TEST_INTERFACE  Interface[2];
+  VOID            *Found;
+  UINT64          Key;
+  UINTN           Index;
+  UINTN           Count;
+  EFI_HANDLE      *Buffer;
+
+  for (Index = 0; Index < TEST_PROTOCOL_COUNT; Index++) {
+    Status = CoreHandleProtocol (mPlatformHandle, &mProtocolGuid[Index], &Found);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)&mPlatformInterface[Index]);
+
+    Status = CoreLocateProtocol (&mProtocolGuid[Index], NULL, &Found);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)&mPlatformInterface[Index]);
+  }
+
+  //
+  // A GUID that differs from a known one in a single byte is not found
+  //
+  CopyGuid (&UnknownGuid, &mProtocolGuid[0]);
+  UnknownGuid.Data4[7] ^= 1;
+  Status                = CoreLocateProtocol (&UnknownGuid, NULL, &Found);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  Status = CoreHandleProtocol (mPlatformHandle, &UnknownGuid, &Found);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  //
+  // Install two protocols on a new handle. The key changes when the handle
+  // is created.
+  //
+  Handle = NULL;
+  Key    = CoreGetHandleDatabaseKey ();
+  for (Index = 0; Index < 2; Index++) {
+    Interface[Index].Signature = TEST_INTERFACE_SIGNATURE;
+    Status                     = CoreInstallProtocolInterface (&Handle, &mProtocolGuid[Index], EFI_NATIVE_INTERFACE, &Interface[Index]);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  UT_ASSERT_TRUE (CoreGetHandleDatabaseKey () > Key);
+  Key = CoreGetHandleDatabaseKey ();
+
+  Status = CoreHandleProtocol (Handle, &mProtocolGuid[1], &Found);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)&Interface[1]);
+  Status = CoreHandleProtocol (Handle, &mProtocolGuid[2], &Found);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Status = CoreLocateHandleBuffer (ByProtocol, &mProtocolGuid[0], NULL, &Count, &Buffer);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Count, 2);
+  CoreFreePool (Buffer);
+
+  for (Index = 0; Index < 2; Index++) {
+    Status = CoreUninstallProtocolInterface (Handle, &mProtocolGuid[Index], &Interface[Index]);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_TRUE (CoreGetHandleDatabaseKey () > Key);
+    Key = CoreGetHandleDatabaseKey ();
+  }
+
+  Status = CoreLocateHandleBuffer (ByProtocol, &mProtocolGuid[0], NULL, &Count, &Buffer);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Count, 1);
+  UT_ASSERT_EQUAL ((UINTN)Buffer[0], (UINTN)mPlatformHandle);
+  CoreFreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Creates the controller handles, connects every handle, times the connect
+  pass and the protocol lookups, and destroys the controllers again.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConnectAllBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS       Status;
+  TEST_CONTROLLER  *Controller;
+  EFI_HANDLE       *Buffer;
+  VOID             *Found;
+  UINTN            Count;
+  UINTN            Index;
+  UINTN            Slot;
+  UINTN            Round;
+  UINTN            Started;
+  UINTN            Expected;
+  clock_t          Start;
+  clock_t          ConnectTime;
+  clock_t          LookupTime;
+
+  mControllers = AllocateZeroPool (mHandleCount * sizeof (TEST_CONTROLLER));
+  UT_ASSERT_NOT_NULL (mControllers);
+
+  mSeed    = (UINT32)mHandleCount;
+  Expected = 0;
+  for (Index = 0; Index < mHandleCount; Index++) {
+    Controller = &mControllers[Index];
+    for (Slot = 0; Slot < TEST_PROTOCOLS_PER_HANDLE; Slot++) {
+      //
+      // The first protocol selects a driver, the others are noise drawn
+      // from the whole database. Duplicates on a handle are skipped.
+      //
+      if (Slot == 0) {
+        Controller->ProtocolIndex[Slot] = Index % TEST_DRIVER_COUNT;
+      } else {
+        Controller->ProtocolIndex[Slot] = TEST_DRIVER_COUNT + NextRandom () % (TEST_PROTOCOL_COUNT - TEST_DRIVER_COUNT);
+      }
+
+      Controller->Interface[Slot].Signature     = TEST_INTERFACE_SIGNATURE;
+      Controller->Interface[Slot].ProtocolIndex = Controller->ProtocolIndex[Slot];
+      Status                                    = CoreInstallProtocolInterface (
+                                                    &Controller->Handle,
+                                                    &mProtocolGuid[Controller->ProtocolIndex[Slot]],
+                                                    EFI_NATIVE_INTERFACE,
+                                                    &Controller->Interface[Slot]
+                                                    );
+      if (Status == EFI_INVALID_PARAMETER) {
+        Controller->Interface[Slot].Signature = 0;
+        continue;
+      }
+
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      Controller->Interface[Slot].Handle = Controller->Handle;
+    }
+
+    Expected++;
+  }
+
+  for (Index = 0; Index < TEST_DRIVER_COUNT; Index++) {
+    mDrivers[Index].StartCount = 0;
+  }
+
+  //
+  // Connect all, the way BDS does it
+  //
+  Start  = clock ();
+  Status = CoreLocateHandleBuffer (AllHandles, NULL, NULL, &Count, &Buffer);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  for (Index = 0; Index < Count; Index++) {
+    CoreConnectController (Buffer[Index], NULL, NULL, TRUE);
+  }
+
+  CoreFreePool (Buffer);
+  ConnectTime = clock () - Start;
+
+  Started = 0;
+  for (Index = 0; Index < TEST_DRIVER_COUNT; Index++) {
+    Started += mDrivers[Index].StartCount;
+  }
+
+  //
+  // Every controller is started by exactly one driver. The platform handle
+  // carries every protocol and is started by every driver.
+  //
+  UT_ASSERT_EQUAL (Started, Expected + TEST_DRIVER_COUNT);
+
+  //
+  // Protocol lookups by handle and by GUID
+  //
+  Start = clock ();
+  for (Round = 0; Round < TEST_LOOKUP_ROUNDS; Round++) {
+    for (Index = 0; Index < mHandleCount; Index++) {
+      Controller = &mControllers[Index];
+      for (Slot = 0; Slot < TEST_PROTOCOLS_PER_HANDLE; Slot++) {
+        if (Controller->Interface[Slot].Signature != TEST_INTERFACE_SIGNATURE) {
+          continue;
+        }
+
+        Status = CoreHandleProtocol (Controller->Handle, &mProtocolGuid[Controller->ProtocolIndex[Slot]], &Found);
+        UT_ASSERT_NOT_EFI_ERROR (Status);
+        UT_ASSERT_EQUAL ((UINTN)Found, (UINTN)&Controller->Interface[Slot]);
+      }
+    }
+
+    for (Index = 0; Index < TEST_PROTOCOL_COUNT; Index++) {
+      Status = CoreLocateProtocol (&mProtocolGuid[Index], NULL, &Found);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+
+    Status = CoreLocateHandleBuffer (ByProtocol, &gEfiDriverBindingProtocolGuid, NULL, &Count, &Buffer);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Count, TEST_DRIVER_COUNT);
+    CoreFreePool (Buffer);
+  }
+
+  LookupTime = clock () - Start;
+
+  UT_LOG_INFO (
+    "%Lu handles, %Lu protocols: connect all %Lu ms, %Lu lookup rounds %Lu ms\n",
+    (UINT64)mHandleCount,
+    (UINT64)TEST_PROTOCOL_COUNT,
+    (UINT64)(ConnectTime * 1000 / CLOCKS_PER_SEC),
+    (UINT64)TEST_LOOKUP_ROUNDS,
+    (UINT64)(LookupTime * 1000 / CLOCKS_PER_SEC)
+    );
+
+  //
+  // Disconnect and destroy the controllers
+  //
+  for (Index = 0; Index < mHandleCount; Index++) {
+    Controller = &mControllers[Index];
+    Status     = CoreDisconnectController (Controller->Handle, NULL, NULL);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    for (Slot = 0; Slot < TEST_PROTOCOLS_PER_HANDLE; Slot++) {
+      if (Controller->Interface[Slot].Signature != TEST_INTERFACE_SIGNATURE) {
+        continue;
+      }
+
+      Status = CoreUninstallProtocolInterface (
+                 Controller->Handle,
+                 &mProtocolGuid[Controller->ProtocolIndex[Slot]],
+                 &Controller->Interface[Slot]
+                 );
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+  }
+
+  Status = CoreDisconnectController (mPlatformHandle, NULL, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  FreePool (mControllers);
+  mControllers = NULL;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the handle
+  database and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      HandleTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&HandleTests, Framework, "Handle Database Tests", "DxeCore.Handle", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the Handle Database Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (HandleTests, "Protocol lookups and handle database key", "Lookup", HandleDatabaseLookupTest, PreparePlatform, NULL, NULL);
+  AddTestCase (HandleTests, "Connect all controllers", "ConnectAll", ConnectAllBenchmark, PreparePlatform, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define HandleDatabaseBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+HandleDatabaseBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  if (Argc > 1) {
+    mHandleCount = (UINTN)strtoul (Argv[1], NULL, 0);
+  }
+
+  return UnitTestingEntry ();
+}
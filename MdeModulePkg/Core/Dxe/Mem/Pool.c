@@ -59,6 +59,30 @@ STATIC CONST UINT16  mPoolSizeTable[] = {
 
 #define MAX_POOL_SIZE  (MAX_ADDRESS - POOL_OVERHEAD)
 
+//
+// For each bit position N, the index of the first mPoolSizeTable entry that
+// is larger than 2^N. Since each element is less than twice the previous
+// one, a power-of-two range never holds more than two bins, so a bit scan
+// followed by at most two compares finds the bin of any size.
+//
+STATIC UINT8  mPoolIndexFromBit[32];
+
+//
+// Empty pool pages of the boot services memory types are kept in a small
+// per-type cache instead of being returned to the page allocator right away.
+// Pages are taken from the page allocator POOL_PAGE_BATCH_COUNT at a time,
+// and handed back in one batch when the cache grows past POOL_EMPTY_PAGE_MAX.
+//
+#define POOL_PAGE_BATCH_COUNT  4
+#define POOL_EMPTY_PAGE_MAX    16
+
+#define POOL_EMPTY_PAGE_SIGNATURE  SIGNATURE_32('p','e','p','0')
+typedef struct {
+  UINT32        Signature;
+  UINT32        Reserved;
+  LIST_ENTRY    Link;
+} POOL_EMPTY_PAGE;
+
 //
 // Globals
 //
@@ -70,6 +94,8 @@ typedef struct {
   EFI_MEMORY_TYPE    MemoryType;
   LIST_ENTRY         FreeList[MAX_POOL_LIST];
   LIST_ENTRY         Link;
+  LIST_ENTRY         EmptyPageList;
+  UINTN              EmptyPageCount;
 } POOL;
 
 //
@@ -98,13 +124,24 @@ GetPoolIndexFromSize (
 {
   UINTN  Index;
 
-  for (Index = 0; Index < MAX_POOL_LIST; Index++) {
-    if (mPoolSizeTable[Index] >= Size) {
-      return Index;
-    }
+  if (Size > mPoolSizeTable[MAX_POOL_LIST - 1]) {
+    return MAX_POOL_LIST;
+  }
+
+  if (Size <= mPoolSizeTable[0]) {
+    return 0;
+  }
+
+  //
+  // Size is in the range (2^N, 2^(N+1)], start at the first bin above 2^N
+  //
+  Index = mPoolIndexFromBit[HighBitSet32 ((UINT32)(Size - 1))];
+  while (mPoolSizeTable[Index] < Size) {
+    Index++;
   }
 
-  return MAX_POOL_LIST;
+  ASSERT (Index < MAX_POOL_LIST);
+  return Index;
 }
 
 /**
@@ -118,6 +155,7 @@ CoreInitializePool (
 {
   UINTN  Type;
   UINTN  Index;
+  UINTN  Bit;
 
   for (Type = 0; Type < EfiMaxMemoryType; Type++) {
     mPoolHead[Type].Signature  = 0;
@@ -126,6 +164,18 @@ CoreInitializePool (
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
+
+    InitializeListHead (&mPoolHead[Type].EmptyPageList);
+    mPoolHead[Type].EmptyPageCount = 0;
+  }
+
+  Index = 0;
+  for (Bit = 0; Bit < ARRAY_SIZE (mPoolIndexFromBit); Bit++) {
+    while ((Index < MAX_POOL_LIST - 1) && (mPoolSizeTable[Index] <= LShiftU64 (1, Bit))) {
+      Index++;
+    }
+
+    mPoolIndexFromBit[Bit] = (UINT8)Index;
   }
 }
 
@@ -175,6 +225,9 @@ LookupPoolHead (
       InitializeListHead (&Pool->FreeList[Index]);
     }
 
+    InitializeListHead (&Pool->EmptyPageList);
+    Pool->EmptyPageCount = 0;
+
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
     return Pool;
@@ -336,6 +389,122 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Checks whether the empty pool pages of a pool are kept in its empty page
+  cache.
+
+  Only the boot services memory types are cached, so pool pages that are
+  still cached at ExitBootServices() never show up as runtime memory.
+
+  @param  Pool                   The pool head.
+  @param  Granularity            The page allocation granularity of the pool.
+
+  @retval TRUE                   Empty pool pages are cached.
+  @retval FALSE                  Empty pool pages go back to the page allocator.
+
+**/
+STATIC
+BOOLEAN
+IsPoolPageCacheable (
+  IN POOL   *Pool,
+  IN UINTN  Granularity
+  )
+{
+  return (BOOLEAN)((Granularity == DEFAULT_PAGE_ALLOCATION_GRANULARITY) &&
+                   ((Pool->MemoryType == EfiBootServicesCode) ||
+                    (Pool->MemoryType == EfiBootServicesData)));
+}
+
+/**
+  Internal function.  Adds an empty pool page to the empty page cache of a pool.
+
+  @param  Pool                   The pool head.
+  @param  Page                   The empty pool page.
+
+**/
+STATIC
+VOID
+CoreInsertEmptyPoolPage (
+  IN POOL  *Pool,
+  IN VOID  *Page
+  )
+{
+  POOL_EMPTY_PAGE  *EmptyPage;
+
+  EmptyPage            = (POOL_EMPTY_PAGE *)Page;
+  EmptyPage->Signature = POOL_EMPTY_PAGE_SIGNATURE;
+  InsertHeadList (&Pool->EmptyPageList, &EmptyPage->Link);
+  Pool->EmptyPageCount++;
+}
+
+/**
+  Internal function.  Gets an empty page to carve into pool blocks.
+
+  For pools with an empty page cache, the page is taken from the cache,
+  and the cache is refilled with a batch of pages when it runs empty.
+
+  @param  Pool                   The pool head.
+  @param  PoolType               The type of memory for the new pool page.
+  @param  Granularity            The page allocation granularity of the pool.
+
+  @return The empty pool page, or NULL
+
+**/
+STATIC
+VOID *
+CoreAllocateEmptyPoolPage (
+  IN POOL             *Pool,
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            Granularity
+  )
+{
+  POOL_EMPTY_PAGE  *EmptyPage;
+  CHAR8            *Pages;
+  UINTN            Index;
+
+  if (!IsPoolPageCacheable (Pool, Granularity)) {
+    return CoreAllocatePoolPagesI (
+             PoolType,
+             EFI_SIZE_TO_PAGES (Granularity),
+             Granularity,
+             FALSE
+             );
+  }
+
+  if (!IsListEmpty (&Pool->EmptyPageList)) {
+    EmptyPage = CR (Pool->EmptyPageList.ForwardLink, POOL_EMPTY_PAGE, Link, POOL_EMPTY_PAGE_SIGNATURE);
+    RemoveEntryList (&EmptyPage->Link);
+    EmptyPage->Signature = 0;
+    Pool->EmptyPageCount--;
+    return EmptyPage;
+  }
+
+  //
+  // Refill the cache with a batch of pages. If that fails, fall back to a
+  // single page.
+  //
+  Pages = CoreAllocatePoolPagesI (
+            PoolType,
+            EFI_SIZE_TO_PAGES (Granularity) * POOL_PAGE_BATCH_COUNT,
+            Granularity,
+            FALSE
+            );
+  if (Pages == NULL) {
+    return CoreAllocatePoolPagesI (
+             PoolType,
+             EFI_SIZE_TO_PAGES (Granularity),
+             Granularity,
+             FALSE
+             );
+  }
+
+  for (Index = POOL_PAGE_BATCH_COUNT - 1; Index > 0; Index--) {
+    CoreInsertEmptyPoolPage (Pool, &Pages[Index * Granularity]);
+  }
+
+  return Pages;
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -457,12 +626,7 @@ CoreAllocatePoolI (
     //
     // Get another page
     //
-    NewPage = CoreAllocatePoolPagesI (
-                PoolType,
-                EFI_SIZE_TO_PAGES (Granularity),
-                Granularity,
-                NeedGuard
-                );
+    NewPage = CoreAllocateEmptyPoolPage (Pool, PoolType, Granularity);
     if (NewPage == NULL) {
       goto Done;
     }
@@ -676,6 +840,72 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function.  Frees a pool page whose pool entries are all free.
+
+  For pools with an empty page cache, the page is kept in the cache. Once the
+  cache grows past POOL_EMPTY_PAGE_MAX, the least recently cached pages are
+  returned to the page allocator in one batch.
+
+  @param  Pool                   The pool head.
+  @param  Page                   The empty pool page.
+  @param  Granularity            The page allocation granularity of the pool.
+
+**/
+STATIC
+VOID
+CoreFreeEmptyPoolPage (
+  IN POOL   *Pool,
+  IN VOID   *Page,
+  IN UINTN  Granularity
+  )
+{
+  POOL_EMPTY_PAGE       *EmptyPage;
+  EFI_PHYSICAL_ADDRESS  Batch[POOL_EMPTY_PAGE_MAX];
+  UINTN                 Count;
+  UINTN                 Index;
+
+  if (!IsPoolPageCacheable (Pool, Granularity)) {
+    CoreFreePoolPagesI (
+      Pool->MemoryType,
+      (EFI_PHYSICAL_ADDRESS)(UINTN)Page,
+      EFI_SIZE_TO_PAGES (Granularity)
+      );
+    return;
+  }
+
+  CoreInsertEmptyPoolPage (Pool, Page);
+  if (Pool->EmptyPageCount <= POOL_EMPTY_PAGE_MAX) {
+    return;
+  }
+
+  Count = 0;
+  while (Pool->EmptyPageCount > POOL_EMPTY_PAGE_MAX / 2) {
+    EmptyPage = CR (Pool->EmptyPageList.BackLink, POOL_EMPTY_PAGE, Link, POOL_EMPTY_PAGE_SIGNATURE);
+    RemoveEntryList (&EmptyPage->Link);
+    EmptyPage->Signature = 0;
+    Pool->EmptyPageCount--;
+    Batch[Count++] = (EFI_PHYSICAL_ADDRESS)(UINTN)EmptyPage;
+  }
+
+  CoreAcquireMemoryLock ();
+  for (Index = 0; Index < Count; Index++) {
+    CoreFreePoolPages (Batch[Index], EFI_SIZE_TO_PAGES (Granularity));
+  }
+
+  CoreReleaseMemoryLock ();
+
+  for (Index = 0; Index < Count; Index++) {
+    GuardFreedPagesChecked (Batch[Index], EFI_SIZE_TO_PAGES (Granularity));
+    ApplyMemoryProtectionPolicy (
+      Pool->MemoryType,
+      EfiConventionalMemory,
+      Batch[Index],
+      Granularity
+      );
+  }
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -859,11 +1089,7 @@ CoreFreePoolI (
         //
         // Free the page
         //
-        CoreFreePoolPagesI (
-          Pool->MemoryType,
-          (EFI_PHYSICAL_ADDRESS)(UINTN)NewPage,
-          EFI_SIZE_TO_PAGES (Granularity)
-          );
+        CoreFreeEmptyPoolPage (Pool, NewPage, Granularity);
       }
     }
   }
@@ -0,0 +1,648 @@
+/** @file
+  Host based benchmark for the DXE core pool allocator.
+
+  The benchmark replays the pool allocations of a memory profile, as returned
+  by EDKII_MEMORY_PROFILE_PROTOCOL.GetData() and recorded by
+  MemoryProfileRecord.c, against the real Pool.c. The page allocator, heap
+  guard and memory profile services of the DXE core are replaced by stubs
+  that count calls into the page allocator.
+
+  Usage: PoolTraceReplayHost [MemoryProfileData.bin]
+
+  Without an argument, a synthetic trace shaped like the small allocation
+  storm of BDS and HII parsing is used.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "DxeMain.h"
+#include "Imem.h"
+#include "HeapGuard.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE Core Pool Trace Replay"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define SYNTHETIC_TRACE_LENGTH  20000
+#define REPLAY_ROUNDS           20
+#define REPLAY_LIVE_WINDOW      256
+#define MAX_TEST_POOL_SIZE      40000
+#define PAGE_ARENA_PAGES        16384
+
+typedef struct {
+  UINT32             SequenceId;
+  EFI_MEMORY_TYPE    MemoryType;
+  UINT32             Size;
+} POOL_TRACE_RECORD;
+
+STATIC CHAR8              *mProfileFileName = NULL;
+STATIC POOL_TRACE_RECORD  *mTrace           = NULL;
+STATIC UINTN              mTraceLength      = 0;
+STATIC UINTN              mPageAllocations  = 0;
+STATIC UINTN              mPageFrees        = 0;
+
+//
+// Pool pages may be freed one page at a time even when they were allocated
+// in a batch, so the page allocator stub hands out pages from an arena.
+//
+STATIC UINT8  *mPageArena = NULL;
+STATIC UINT8  mPageArenaMap[PAGE_ARENA_PAGES];
+
+//
+// Stubs for the DXE core services used by Pool.c
+//
+EFI_LOCK  gMemoryLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
+BOOLEAN   mOnGuarding = FALSE;
+
+VOID
+CoreAcquireLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockReleased);
+  Lock->Lock = EfiLockAcquired;
+}
+
+EFI_STATUS
+CoreAcquireLockOrFail (
+  IN EFI_LOCK  *Lock
+  )
+{
+  if (Lock->Lock == EfiLockAcquired) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  Lock->Lock = EfiLockAcquired;
+  return EFI_SUCCESS;
+}
+
+VOID
+CoreReleaseLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockAcquired);
+  Lock->Lock = EfiLockReleased;
+}
+
+VOID
+CoreAcquireMemoryLock (
+  VOID
+  )
+{
+  CoreAcquireLock (&gMemoryLock);
+}
+
+VOID
+CoreReleaseMemoryLock (
+  VOID
+  )
+{
+  CoreReleaseLock (&gMemoryLock);
+}
+
+VOID *
+CoreAllocatePoolPages (
+  IN EFI_MEMORY_TYPE  PoolType,
+  IN UINTN            NumberOfPages,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard
+  )
+{
+  UINTN  Step;
+  UINTN  Start;
+  UINTN  Index;
+
+  mPageAllocations++;
+
+  if (mPageArena == NULL) {
+    mPageArena = AllocateAlignedPages (PAGE_ARENA_PAGES, SIZE_64KB);
+    if (mPageArena == NULL) {
+      return NULL;
+    }
+  }
+
+  Step = MAX (EFI_SIZE_TO_PAGES (Alignment), 1);
+  for (Start = 0; Start + NumberOfPages <= PAGE_ARENA_PAGES; Start += Step) {
+    for (Index = 0; Index < NumberOfPages; Index++) {
+      if (mPageArenaMap[Start + Index] != 0) {
+        break;
+      }
+    }
+
+    if (Index == NumberOfPages) {
+      SetMem (&mPageArenaMap[Start], NumberOfPages, 1);
+      return mPageArena + EFI_PAGES_TO_SIZE (Start);
+    }
+  }
+
+  return NULL;
+}
+
+VOID
+CoreFreePoolPages (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NumberOfPages
+  )
+{
+  UINTN  Start;
+
+  mPageFrees++;
+
+  Start = EFI_SIZE_TO_PAGES ((UINTN)Memory - (UINTN)mPageArena);
+  ASSERT (Start + NumberOfPages <= PAGE_ARENA_PAGES);
+  SetMem (&mPageArenaMap[Start], NumberOfPages, 0);
+}
+
+VOID
+SetGuardForMemory (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NumberOfPages
+  )
+{
+}
+
+VOID
+UnsetGuardForMemory (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NumberOfPages
+  )
+{
+}
+
+VOID
+AdjustMemoryF (
+  IN OUT EFI_PHYSICAL_ADDRESS  *Memory,
+  IN OUT UINTN                 *NumberOfPages
+  )
+{
+}
+
+BOOLEAN
+IsPoolTypeToGuard (
+  IN EFI_MEMORY_TYPE  MemoryType
+  )
+{
+  return FALSE;
+}
+
+BOOLEAN
+IsHeapGuardEnabled (
+  UINT8  GuardType
+  )
+{
+  return FALSE;
+}
+
+BOOLEAN
+EFIAPI
+IsMemoryGuarded (
+  IN EFI_PHYSICAL_ADDRESS  Address
+  )
+{
+  return FALSE;
+}
+
+VOID *
+AdjustPoolHeadA (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NoPages,
+  IN UINTN                 Size
+  )
+{
+  return (VOID *)(UINTN)Memory;
+}
+
+VOID *
+AdjustPoolHeadF (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NoPages,
+  IN UINTN                 Size
+  )
+{
+  return (VOID *)(UINTN)Memory;
+}
+
+VOID
+EFIAPI
+GuardFreedPagesChecked (
+  IN  EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN  UINTN                 Pages
+  )
+{
+}
+
+EFI_STATUS
+EFIAPI
+ApplyMemoryProtectionPolicy (
+  IN  EFI_MEMORY_TYPE       OldType,
+  IN  EFI_MEMORY_TYPE       NewType,
+  IN  EFI_PHYSICAL_ADDRESS  Memory,
+  IN  UINT64                Length
+  )
+{
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+CoreUpdateProfile (
+  IN EFI_PHYSICAL_ADDRESS   CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer,
+  IN CHAR8                  *ActionString OPTIONAL
+  )
+{
+  return EFI_SUCCESS;
+}
+
+VOID
+InstallMemoryAttributesTableOnMemoryAllocation (
+  IN EFI_MEMORY_TYPE  MemoryType
+  )
+{
+}
+
+/**
+  qsort() callback ordering trace records by sequence ID.
+
+  @param  A  The first record.
+  @param  B  The second record.
+
+  @return Negative, zero or positive as for strcmp().
+**/
+STATIC
+int
+CompareTraceRecord (
+  IN CONST VOID  *A,
+  IN CONST VOID  *B
+  )
+{
+  UINT32  SequenceA;
+  UINT32  SequenceB;
+
+  SequenceA = ((CONST POOL_TRACE_RECORD *)A)->SequenceId;
+  SequenceB = ((CONST POOL_TRACE_RECORD *)B)->SequenceId;
+  return (SequenceA > SequenceB) - (SequenceA < SequenceB);
+}
+
+/**
+  Extracts the pool allocations of a memory profile into the trace.
+
+  @param  Data  The memory profile data.
+  @param  Size  The size of the memory profile data.
+
+  @retval EFI_SUCCESS            The trace was built.
+  @retval EFI_INVALID_PARAMETER  The memory profile is malformed or empty.
+**/
+STATIC
+EFI_STATUS
+LoadProfileTrace (
+  IN UINT8  *Data,
+  IN UINTN  Size
+  )
+{
+  MEMORY_PROFILE_COMMON_HEADER  *Header;
+  MEMORY_PROFILE_ALLOC_INFO     *AllocInfo;
+  UINTN                         Offset;
+
+  mTrace       = AllocatePool ((Size / sizeof (MEMORY_PROFILE_ALLOC_INFO) + 1) * sizeof (POOL_TRACE_RECORD));
+  mTraceLength = 0;
+  if (mTrace == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The profile is a context record followed by driver info records, each
+  // followed by its allocation records. Only the allocation records matter.
+  //
+  for (Offset = 0; Offset + sizeof (MEMORY_PROFILE_COMMON_HEADER) <= Size; Offset += Header->Length) {
+    Header = (MEMORY_PROFILE_COMMON_HEADER *)(Data + Offset);
+    if ((Header->Length < sizeof (MEMORY_PROFILE_COMMON_HEADER)) || (Header->Length > Size - Offset)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if ((Header->Signature != MEMORY_PROFILE_ALLOC_INFO_SIGNATURE) ||
+        (Header->Length < sizeof (MEMORY_PROFILE_ALLOC_INFO)))
+    {
+      continue;
+    }
+
+    AllocInfo = (MEMORY_PROFILE_ALLOC_INFO *)Header;
+    if (((AllocInfo->Action & MEMORY_PROFILE_ACTION_BASIC_MASK) != MemoryProfileActionAllocatePool) ||
+        (AllocInfo->Size == 0) || (AllocInfo->Size > MAX_TEST_POOL_SIZE))
+    {
+      continue;
+    }
+
+    mTrace[mTraceLength].SequenceId = AllocInfo->SequenceId;
+    mTrace[mTraceLength].MemoryType = AllocInfo->MemoryType;
+    mTrace[mTraceLength].Size       = (UINT32)AllocInfo->Size;
+    mTraceLength++;
+  }
+
+  if (mTraceLength == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  qsort (mTrace, mTraceLength, sizeof (POOL_TRACE_RECORD), CompareTraceRecord);
+  return EFI_SUCCESS;
+}
+
+/**
+  Builds a deterministic synthetic trace dominated by small allocations.
+**/
+STATIC
+VOID
+BuildSyntheticTrace (
+  VOID
+  )
+{
+  UINT32  Seed;
+  UINT32  Random;
+  UINTN   Index;
+
+  mTrace       = AllocatePool (SYNTHETIC_TRACE_LENGTH * sizeof (POOL_TRACE_RECORD));
+  mTraceLength = 0;
+  if (mTrace == NULL) {
+    return;
+  }
+
+  Seed = 0x1234;
+  for (Index = 0; Index < SYNTHETIC_TRACE_LENGTH; Index++) {
+    Seed   = Seed * 1103515245 + 12345;
+    Random = Seed >> 8;
+
+    mTrace[Index].SequenceId = (UINT32)Index;
+    mTrace[Index].MemoryType = ((Random & 0xF) == 0) ? EfiRuntimeServicesData : EfiBootServicesData;
+    switch ((Random >> 4) % 50) {
+      case 0:
+        mTrace[Index].Size = 4096 + (Random >> 10) % 12288;
+        break;
+      case 1:
+      case 2:
+      case 3:
+      case 4:
+        mTrace[Index].Size = 1024 + (Random >> 10) % 3072;
+        break;
+      case 5:
+      case 6:
+      case 7:
+      case 8:
+      case 9:
+      case 10:
+      case 11:
+      case 12:
+      case 13:
+      case 14:
+        mTrace[Index].Size = 128 + (Random >> 10) % 896;
+        break;
+      default:
+        mTrace[Index].Size = 8 + (Random >> 10) % 120;
+        break;
+    }
+  }
+
+  mTraceLength = SYNTHETIC_TRACE_LENGTH;
+}
+
+/**
+  Loads the trace from the memory profile file given on the command line, or
+  builds the synthetic trace.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED                The trace is ready.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  No trace could be built.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PrepareTrace (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FILE        *File;
+  UINT8       *Data;
+  long        Size;
+  EFI_STATUS  Status;
+
+  if (mTrace != NULL) {
+    return UNIT_TEST_PASSED;
+  }
+
+  CoreInitializePool ();
+
+  if (mProfileFileName != NULL) {
+    File = fopen (mProfileFileName, "rb");
+    if (File == NULL) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    fseek (File, 0, SEEK_END);
+    Size = ftell (File);
+    fseek (File, 0, SEEK_SET);
+    Data = AllocatePool ((UINTN)Size);
+    if ((Data == NULL) || (fread (Data, 1, (size_t)Size, File) != (size_t)Size)) {
+      fclose (File);
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    fclose (File);
+    Status = LoadProfileTrace (Data, (UINTN)Size);
+    FreePool (Data);
+    if (EFI_ERROR (Status)) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    UT_LOG_INFO ("Replaying %Lu pool allocations from %a\n", (UINT64)mTraceLength, mProfileFileName);
+  } else {
+    BuildSyntheticTrace ();
+    UT_LOG_INFO ("Replaying %Lu synthetic pool allocations\n", (UINT64)mTraceLength);
+  }
+
+  return (mTraceLength != 0) ? UNIT_TEST_PASSED : UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+}
+
+/**
+  Allocates and frees every pool size up to and beyond the largest pool bin,
+  and checks the alignment and usable size of each buffer.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PoolSizeClassTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Buffer;
+  UINTN       Size;
+
+  for (Size = 1; Size <= MAX_TEST_POOL_SIZE; Size++) {
+    Status = CoreInternalAllocatePool (EfiBootServicesData, Size, &Buffer);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL ((UINTN)Buffer & (sizeof (UINT64) - 1), 0);
+    SetMem (Buffer, Size, 0xA5);
+    Status = CoreInternalFreePool (Buffer, NULL);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Replays the trace with a sliding window of live allocations and reports
+  the throughput and the number of calls into the page allocator.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PoolTraceReplayBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Live[REPLAY_LIVE_WINDOW];
+  UINTN       Round;
+  UINTN       Index;
+  UINTN       Slot;
+  UINTN       Operations;
+  clock_t     Start;
+  clock_t     Elapsed;
+
+  ZeroMem (Live, sizeof (Live));
+  mPageAllocations = 0;
+  mPageFrees       = 0;
+  Operations       = 0;
+
+  Start = clock ();
+  for (Round = 0; Round < REPLAY_ROUNDS; Round++) {
+    for (Index = 0; Index < mTraceLength; Index++) {
+      Slot = Operations % REPLAY_LIVE_WINDOW;
+      if (Live[Slot] != NULL) {
+        Status = CoreInternalFreePool (Live[Slot], NULL);
+        UT_ASSERT_NOT_EFI_ERROR (Status);
+      }
+
+      Status = CoreInternalAllocatePool (mTrace[Index].MemoryType, mTrace[Index].Size, &Live[Slot]);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      Operations++;
+    }
+  }
+
+  for (Slot = 0; Slot < REPLAY_LIVE_WINDOW; Slot++) {
+    if (Live[Slot] != NULL) {
+      Status = CoreInternalFreePool (Live[Slot], NULL);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+  }
+
+  Elapsed = clock () - Start;
+
+  UT_LOG_INFO (
+    "%Lu allocate/free pairs in %Lu ms, %Lu page allocations, %Lu page frees\n",
+    (UINT64)Operations,
+    (UINT64)(Elapsed * 1000 / CLOCKS_PER_SEC),
+    (UINT64)mPageAllocations,
+    (UINT64)mPageFrees
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the pool
+  allocator and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PoolTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&PoolTests, Framework, "Pool Allocator Tests", "DxeCore.Pool", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the Pool Allocator Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (PoolTests, "Every pool size maps to a usable bin", "SizeClass", PoolSizeClassTest, PrepareTrace, NULL, NULL);
+  AddTestCase (PoolTests, "Replay an allocation trace", "TraceReplay", PoolTraceReplayBenchmark, PrepareTrace, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define PoolTraceReplayMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+PoolTraceReplayMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  if (Argc > 1) {
+    mProfileFileName = Argv[1];
+  }
+
+  return UnitTestingEntry ();
+}
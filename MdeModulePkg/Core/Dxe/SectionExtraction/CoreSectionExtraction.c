@@ -27,7 +27,7 @@
   3) A support protocol is not found, and the data is not available to be read
      without it.  This results in EFI_PROTOCOL_ERROR.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -741,9 +741,14 @@ CreateChildNode (
       }
 
       //
-      // Allocate space for the new stream
+      // Allocate space for the new stream, unless the dispatcher has already
+      // decompressed the section on an application processor.
       //
-      if (UncompressedLength > 0) {
+      if ((CompressionType == EFI_STANDARD_COMPRESSION) &&
+          CoreTakePrefetchedSection (SectionHeader, Node->Size, &NewStreamBuffer, &NewStreamBufferSize, NULL))
+      {
+        ASSERT (NewStreamBufferSize == UncompressedLength);
+      } else if (UncompressedLength > 0) {
         NewStreamBufferSize = UncompressedLength;
         NewStreamBuffer     = AllocatePool (NewStreamBufferSize);
         if (NewStreamBuffer == NULL) {
@@ -841,15 +846,23 @@ CreateChildNode (
       if (VerifyGuidedSectionGuid (Node->EncapsulationGuid, &GuidedExtraction)) {
         //
         // NewStreamBuffer is always allocated by ExtractSection... No caller
-        // allocation here.
+        // allocation here. Sections decoded by the DXE core itself may have
+        // been decoded already by the dispatcher on an application processor.
         //
-        Status = GuidedExtraction->ExtractSection (
-                                     GuidedExtraction,
-                                     GuidedHeader,
-                                     &NewStreamBuffer,
-                                     &NewStreamBufferSize,
-                                     &AuthenticationStatus
-                                     );
+        if ((GuidedExtraction == &mCustomGuidedSectionExtractionProtocol) &&
+            CoreTakePrefetchedSection (GuidedHeader, Node->Size, &NewStreamBuffer, &NewStreamBufferSize, &AuthenticationStatus))
+        {
+          Status = EFI_SUCCESS;
+        } else {
+          Status = GuidedExtraction->ExtractSection (
+                                       GuidedExtraction,
+                                       GuidedHeader,
+                                       &NewStreamBuffer,
+                                       &NewStreamBufferSize,
+                                       &AuthenticationStatus
+                                       );
+        }
+
         if (EFI_ERROR (Status)) {
           CoreFreePool (*ChildNode);
           return EFI_PROTOCOL_ERROR;
@@ -1180,90 +1193,56 @@ FindStreamNode (
 }
 
 /**
-  SEP member function.  Retrieves requested section from section stream.
+  Worker function.  Locates the requested section in a section stream.
+
+  The caller must be at TPL_NOTIFY.
 
   @param  SectionStreamHandle   The section stream from which to extract the
                                 requested section.
-  @param  SectionType           A pointer to the type of section to search for.
+  @param  SectionType           A pointer to the type of section to search for,
+                                or NULL for the whole section stream.
   @param  SectionDefinitionGuid If the section type is EFI_SECTION_GUID_DEFINED,
                                 then SectionDefinitionGuid indicates which of
                                 these types of sections to search for.
   @param  SectionInstance       Indicates which instance of the requested
                                 section to return.
-  @param  Buffer                Double indirection to buffer.  If *Buffer is
-                                non-null on input, then the buffer is caller
-                                allocated.  If Buffer is NULL, then the buffer
-                                is callee allocated.  In either case, the
-                                required buffer size is returned in *BufferSize.
-  @param  BufferSize            On input, indicates the size of *Buffer if
-                                *Buffer is non-null on input.  On output,
-                                indicates the required size (allocated size if
-                                callee allocated) of *Buffer.
-  @param  AuthenticationStatus  A pointer to a caller-allocated UINT32 that
-                                indicates the authentication status of the
-                                output buffer. If the input section's
-                                GuidedSectionHeader.Attributes field
-                                has the EFI_GUIDED_SECTION_AUTH_STATUS_VALID
-                                bit as clear, AuthenticationStatus must return
-                                zero. Both local bits (19:16) and aggregate
-                                bits (3:0) in AuthenticationStatus are returned
-                                by ExtractSection(). These bits reflect the
-                                status of the extraction operation. The bit
-                                pattern in both regions must be the same, as
-                                the local and aggregate authentication statuses
-                                have equivalent meaning at this level. If the
-                                function returns anything other than
-                                EFI_SUCCESS, the value of *AuthenticationStatus
-                                is undefined.
   @param  IsFfs3Fv              Indicates the FV format.
-
-  @retval EFI_SUCCESS           Section was retrieved successfully
-  @retval EFI_PROTOCOL_ERROR    A GUID defined section was encountered in the
-                                section stream with its
-                                EFI_GUIDED_SECTION_PROCESSING_REQUIRED bit set,
-                                but there was no corresponding GUIDed Section
-                                Extraction Protocol in the handle database.
-                                *Buffer is unmodified.
-  @retval EFI_NOT_FOUND         An error was encountered when parsing the
-                                SectionStream.  This indicates the SectionStream
-                                is not correctly formatted.
+  @param  SectionData           Returns a pointer to the contents of the section
+                                in the buffer of its section stream.
+  @param  SectionSize           Returns the size of the contents of the section.
+  @param  AuthenticationStatus  Returns the authentication status of the section.
+  @param  Encapsulated          Returns TRUE if the section is in an encapsulation
+                                section of the section stream. Optional.
+
+  @retval EFI_SUCCESS           The section was found.
   @retval EFI_NOT_FOUND         The requested section does not exist.
-  @retval EFI_OUT_OF_RESOURCES  The system has insufficient resources to process
-                                the request.
   @retval EFI_INVALID_PARAMETER The SectionStreamHandle does not exist.
-  @retval EFI_WARN_TOO_SMALL    The size of the caller allocated input buffer is
-                                insufficient to contain the requested section.
-                                The input buffer is filled and section contents
-                                are truncated.
+  @retval others                The section stream could not be expanded.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-GetSection (
-  IN UINTN             SectionStreamHandle,
-  IN EFI_SECTION_TYPE  *SectionType,
-  IN EFI_GUID          *SectionDefinitionGuid,
-  IN UINTN             SectionInstance,
-  IN VOID              **Buffer,
-  IN OUT UINTN         *BufferSize,
-  OUT UINT32           *AuthenticationStatus,
-  IN BOOLEAN           IsFfs3Fv
+LocateSection (
+  IN  UINTN             SectionStreamHandle,
+  IN  EFI_SECTION_TYPE  *SectionType,
+  IN  EFI_GUID          *SectionDefinitionGuid,
+  IN  UINTN             SectionInstance,
+  IN  BOOLEAN           IsFfs3Fv,
+  OUT UINT8             **SectionData,
+  OUT UINTN             *SectionSize,
+  OUT UINT32            *AuthenticationStatus,
+  OUT BOOLEAN           *Encapsulated OPTIONAL
   )
 {
   CORE_SECTION_STREAM_NODE   *StreamNode;
-  EFI_TPL                    OldTpl;
   EFI_STATUS                 Status;
   CORE_SECTION_CHILD_NODE    *ChildNode;
   CORE_SECTION_STREAM_NODE   *ChildStreamNode;
-  UINTN                      CopySize;
   UINT32                     ExtractedAuthenticationStatus;
   UINTN                      Instance;
-  UINT8                      *CopyBuffer;
-  UINTN                      SectionSize;
   EFI_COMMON_SECTION_HEADER  *Section;
 
   ChildStreamNode = NULL;
-  OldTpl          = CoreRaiseTpl (TPL_NOTIFY);
   Instance        = SectionInstance + 1;
 
   //
@@ -1271,8 +1250,7 @@ GetSection (
   //
   Status = FindStreamNode (SectionStreamHandle, &StreamNode);
   if (EFI_ERROR (Status)) {
-    Status = EFI_INVALID_PARAMETER;
-    goto GetSection_Done;
+    return EFI_INVALID_PARAMETER;
   }
 
   //
@@ -1282,9 +1260,10 @@ GetSection (
     //
     // SectionType == NULL means return the WHOLE section stream...
     //
-    CopySize              = StreamNode->StreamLength;
-    CopyBuffer            = StreamNode->StreamBuffer;
+    *SectionSize          = StreamNode->StreamLength;
+    *SectionData          = StreamNode->StreamBuffer;
     *AuthenticationStatus = StreamNode->AuthenticationStatus;
+    ChildStreamNode       = StreamNode;
   } else {
     //
     // There's a requested section type, so go find it and return it...
@@ -1312,7 +1291,7 @@ GetSection (
         Status = EFI_NOT_FOUND;
       }
 
-      goto GetSection_Done;
+      return Status;
     }
 
     Section = (EFI_COMMON_SECTION_HEADER *)(ChildStreamNode->StreamBuffer + ChildNode->OffsetInStream);
@@ -1321,20 +1300,120 @@ GetSection (
       ASSERT (SECTION2_SIZE (Section) > 0x00FFFFFF);
       if (!IsFfs3Fv) {
         DEBUG ((DEBUG_ERROR, "It is a FFS3 formatted section in a non-FFS3 formatted FV.\n"));
-        Status = EFI_NOT_FOUND;
-        goto GetSection_Done;
+        return EFI_NOT_FOUND;
       }
 
-      CopySize   = SECTION2_SIZE (Section) - sizeof (EFI_COMMON_SECTION_HEADER2);
-      CopyBuffer = (UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER2);
+      *SectionSize = SECTION2_SIZE (Section) - sizeof (EFI_COMMON_SECTION_HEADER2);
+      *SectionData = (UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER2);
     } else {
-      CopySize   = SECTION_SIZE (Section) - sizeof (EFI_COMMON_SECTION_HEADER);
-      CopyBuffer = (UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER);
+      *SectionSize = SECTION_SIZE (Section) - sizeof (EFI_COMMON_SECTION_HEADER);
+      *SectionData = (UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER);
     }
 
     *AuthenticationStatus = ExtractedAuthenticationStatus;
   }
 
+  if (Encapsulated != NULL) {
+    *Encapsulated = (BOOLEAN)(ChildStreamNode != StreamNode);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  SEP member function.  Retrieves requested section from section stream.
+
+  @param  SectionStreamHandle   The section stream from which to extract the
+                                requested section.
+  @param  SectionType           A pointer to the type of section to search for.
+  @param  SectionDefinitionGuid If the section type is EFI_SECTION_GUID_DEFINED,
+                                then SectionDefinitionGuid indicates which of
+                                these types of sections to search for.
+  @param  SectionInstance       Indicates which instance of the requested
+                                section to return.
+  @param  Buffer                Double indirection to buffer.  If *Buffer is
+                                non-null on input, then the buffer is caller
+                                allocated.  If Buffer is NULL, then the buffer
+                                is callee allocated.  In either case, the
+                                required buffer size is returned in *BufferSize.
+  @param  BufferSize            On input, indicates the size of *Buffer if
+                                *Buffer is non-null on input.  On output,
+                                indicates the required size (allocated size if
+                                callee allocated) of *Buffer.
+  @param  AuthenticationStatus  A pointer to a caller-allocated UINT32 that
+                                indicates the authentication status of the
+                                output buffer. If the input section's
+                                GuidedSectionHeader.Attributes field
+                                has the EFI_GUIDED_SECTION_AUTH_STATUS_VALID
+                                bit as clear, AuthenticationStatus must return
+                                zero. Both local bits (19:16) and aggregate
+                                bits (3:0) in AuthenticationStatus are returned
+                                by ExtractSection(). These bits reflect the
+                                status of the extraction operation. The bit
+                                pattern in both regions must be the same, as
+                                the local and aggregate authentication statuses
+                                have equivalent meaning at this level. If the
+                                function returns anything other than
+                                EFI_SUCCESS, the value of *AuthenticationStatus
+                                is undefined.
+  @param  IsFfs3Fv              Indicates the FV format.
+
+  @retval EFI_SUCCESS           Section was retrieved successfully
+  @retval EFI_PROTOCOL_ERROR    A GUID defined section was encountered in the
+                                section stream with its
+                                EFI_GUIDED_SECTION_PROCESSING_REQUIRED bit set,
+                                but there was no corresponding GUIDed Section
+                                Extraction Protocol in the handle database.
+                                *Buffer is unmodified.
+  @retval EFI_NOT_FOUND         An error was encountered when parsing the
+                                SectionStream.  This indicates the SectionStream
+                                is not correctly formatted.
+  @retval EFI_NOT_FOUND         The requested section does not exist.
+  @retval EFI_OUT_OF_RESOURCES  The system has insufficient resources to process
+                                the request.
+  @retval EFI_INVALID_PARAMETER The SectionStreamHandle does not exist.
+  @retval EFI_WARN_TOO_SMALL    The size of the caller allocated input buffer is
+                                insufficient to contain the requested section.
+                                The input buffer is filled and section contents
+                                are truncated.
+
+**/
+EFI_STATUS
+EFIAPI
+GetSection (
+  IN UINTN             SectionStreamHandle,
+  IN EFI_SECTION_TYPE  *SectionType,
+  IN EFI_GUID          *SectionDefinitionGuid,
+  IN UINTN             SectionInstance,
+  IN VOID              **Buffer,
+  IN OUT UINTN         *BufferSize,
+  OUT UINT32           *AuthenticationStatus,
+  IN BOOLEAN           IsFfs3Fv
+  )
+{
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  UINTN       CopySize;
+  UINT8       *CopyBuffer;
+  UINTN       SectionSize;
+
+  OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+
+  Status = LocateSection (
+             SectionStreamHandle,
+             SectionType,
+             SectionDefinitionGuid,
+             SectionInstance,
+             IsFfs3Fv,
+             &CopyBuffer,
+             &CopySize,
+             AuthenticationStatus,
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    goto GetSection_Done;
+  }
+
   SectionSize = CopySize;
   if (*Buffer != NULL) {
     //
@@ -1364,6 +1443,92 @@ GetSection_Done:
   return Status;
 }
 
+/**
+  Retrieves requested section from section stream in place, without copying
+  its contents.
+
+  The section is returned in place only if it is not in an encapsulation
+  section. The returned buffer is in the buffer of the section stream, it
+  belongs to the creator of the section stream and is valid until the stream
+  is closed.
+
+  @param  SectionStreamHandle   The section stream from which to extract the
+                                requested section.
+  @param  SectionType           A pointer to the type of section to search for,
+                                or NULL for the whole section stream.
+  @param  SectionDefinitionGuid If the section type is EFI_SECTION_GUID_DEFINED,
+                                then SectionDefinitionGuid indicates which of
+                                these types of sections to search for.
+  @param  SectionInstance       Indicates which instance of the requested
+                                section to return.
+  @param  Buffer                Returns a pointer to the contents of the section.
+  @param  BufferSize            Returns the size of the contents of the section.
+  @param  AuthenticationStatus  A pointer to a caller-allocated UINT32 that
+                                indicates the authentication status of the
+                                section, as returned by GetSection().
+  @param  IsFfs3Fv              Indicates the FV format.
+
+  @retval EFI_SUCCESS           Section was retrieved successfully.
+  @retval EFI_UNSUPPORTED       The section is in an encapsulation section and
+                                must be retrieved with GetSection().
+  @retval EFI_NOT_FOUND         The requested section does not exist.
+  @retval EFI_INVALID_PARAMETER The SectionStreamHandle does not exist.
+  @retval others                The section stream could not be expanded.
+
+**/
+EFI_STATUS
+EFIAPI
+GetSectionInPlace (
+  IN  UINTN             SectionStreamHandle,
+  IN  EFI_SECTION_TYPE  *SectionType,
+  IN  EFI_GUID          *SectionDefinitionGuid,
+  IN  UINTN             SectionInstance,
+  OUT VOID              **Buffer,
+  OUT UINTN             *BufferSize,
+  OUT UINT32            *AuthenticationStatus,
+  IN  BOOLEAN           IsFfs3Fv
+  )
+{
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  UINT8       *SectionData;
+  UINTN       SectionSize;
+  UINT32      SectionAuthenticationStatus;
+  BOOLEAN     Encapsulated;
+
+  OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+  Status = LocateSection (
+             SectionStreamHandle,
+             SectionType,
+             SectionDefinitionGuid,
+             SectionInstance,
+             IsFfs3Fv,
+             &SectionData,
+             &SectionSize,
+             &SectionAuthenticationStatus,
+             &Encapsulated
+             );
+  CoreRestoreTpl (OldTpl);
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The streams of the encapsulation sections are freed when the parent stream
+  // is closed, and are replaced when a GUIDed section extraction protocol is
+  // installed, so their contents are not returned in place.
+  //
+  if (Encapsulated) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *Buffer               = SectionData;
+  *BufferSize           = SectionSize;
+  *AuthenticationStatus = SectionAuthenticationStatus;
+  return EFI_SUCCESS;
+}
+
 /**
   Worker function.  Destructor for child nodes.
 
@@ -2,7 +2,7 @@
   Pei Core Firmware File System service routines.
 
 Copyright (c) 2015 HP Development Company, L.P.
-Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -243,6 +243,351 @@ FileHandleToVolume (
   return NULL;
 }
 
+/**
+  Walk the FFS files of a FV as FindFileEx() does, and count the files which
+  FindFileEx() could return, or record them into a file index.
+
+  @param FwVolHeader  Pointer to the FV header.
+  @param FileIndex    The file index to record the files into, or NULL to only count them.
+  @param FileCount    Returns the number of the files.
+
+  @retval EFI_SUCCESS           The files are counted or recorded.
+  @retval EFI_VOLUME_CORRUPTED  A file has a bad checksum.
+  @retval EFI_OUT_OF_RESOURCES  The FV has too many files for a file index.
+**/
+STATIC
+EFI_STATUS
+WalkFvFiles (
+  IN  EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader,
+  IN  PEI_CORE_FV_FILE_INDEX      *FileIndex  OPTIONAL,
+  OUT UINT32                      *FileCount
+  )
+{
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *FwVolExtHeader;
+  EFI_FFS_FILE_HEADER             *FfsFileHeader;
+  UINT32                          FileLength;
+  UINT32                          FileOccupiedSize;
+  UINT32                          FileOffset;
+  UINT64                          FvLength;
+  UINT8                           ErasePolarity;
+  UINT8                           FileState;
+  UINT8                           DataCheckSum;
+  BOOLEAN                         IsFfs3Fv;
+
+  *FileCount = 0;
+
+  IsFfs3Fv = CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid);
+
+  FvLength = FwVolHeader->FvLength;
+  if ((FwVolHeader->Attributes & EFI_FVB2_ERASE_POLARITY) != 0) {
+    ErasePolarity = 1;
+  } else {
+    ErasePolarity = 0;
+  }
+
+  if (FwVolHeader->ExtHeaderOffset != 0) {
+    FwVolExtHeader = (EFI_FIRMWARE_VOLUME_EXT_HEADER *)((UINT8 *)FwVolHeader + FwVolHeader->ExtHeaderOffset);
+    FfsFileHeader  = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolExtHeader + FwVolExtHeader->ExtHeaderSize);
+  } else {
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolHeader + FwVolHeader->HeaderLength);
+  }
+
+  FfsFileHeader = (EFI_FFS_FILE_HEADER *)ALIGN_POINTER (FfsFileHeader, 8);
+  FileOffset    = (UINT32)((UINT8 *)FfsFileHeader - (UINT8 *)FwVolHeader);
+
+  while (FileOffset < (FvLength - sizeof (EFI_FFS_FILE_HEADER))) {
+    FileState = GetFileState (ErasePolarity, FfsFileHeader);
+    switch (FileState) {
+      case EFI_FILE_HEADER_CONSTRUCTION:
+      case EFI_FILE_HEADER_INVALID:
+        if (IS_FFS_FILE2 (FfsFileHeader)) {
+          FileOccupiedSize = sizeof (EFI_FFS_FILE_HEADER2);
+        } else {
+          FileOccupiedSize = sizeof (EFI_FFS_FILE_HEADER);
+        }
+
+        break;
+
+      case EFI_FILE_DATA_VALID:
+      case EFI_FILE_MARKED_FOR_UPDATE:
+        if (CalculateHeaderChecksum (FfsFileHeader) != 0) {
+          return EFI_VOLUME_CORRUPTED;
+        }
+
+        if (IS_FFS_FILE2 (FfsFileHeader)) {
+          FileLength       = FFS_FILE2_SIZE (FfsFileHeader);
+          FileOccupiedSize = GET_OCCUPIED_SIZE (FileLength, 8);
+          if (!IsFfs3Fv) {
+            DEBUG ((DEBUG_ERROR, "Found a FFS3 formatted file: %g in a non-FFS3 formatted FV.\n", &FfsFileHeader->Name));
+            break;
+          }
+
+          DataCheckSum = FFS_FIXED_CHECKSUM;
+          if ((FfsFileHeader->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
+            DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *)FfsFileHeader + sizeof (EFI_FFS_FILE_HEADER2), FileLength - sizeof (EFI_FFS_FILE_HEADER2));
+          }
+        } else {
+          FileLength       = FFS_FILE_SIZE (FfsFileHeader);
+          FileOccupiedSize = GET_OCCUPIED_SIZE (FileLength, 8);
+          DataCheckSum     = FFS_FIXED_CHECKSUM;
+          if ((FfsFileHeader->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
+            DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *)FfsFileHeader + sizeof (EFI_FFS_FILE_HEADER), FileLength - sizeof (EFI_FFS_FILE_HEADER));
+          }
+        }
+
+        if (FfsFileHeader->IntegrityCheck.Checksum.File != DataCheckSum) {
+          return EFI_VOLUME_CORRUPTED;
+        }
+
+        //
+        // The entries are numbered with UINT16 in the name order of the file index.
+        //
+        if (*FileCount >= MAX_UINT16) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+
+        if (FileIndex != NULL) {
+          CopyGuid (&FileIndex->Entry[*FileCount].Name, &FfsFileHeader->Name);
+          FileIndex->Entry[*FileCount].Offset = FileOffset;
+          FileIndex->Entry[*FileCount].Type   = FfsFileHeader->Type;
+        }
+
+        (*FileCount)++;
+        break;
+
+      case EFI_FILE_DELETED:
+        if (IS_FFS_FILE2 (FfsFileHeader)) {
+          FileLength = FFS_FILE2_SIZE (FfsFileHeader);
+        } else {
+          FileLength = FFS_FILE_SIZE (FfsFileHeader);
+        }
+
+        FileOccupiedSize = GET_OCCUPIED_SIZE (FileLength, 8);
+        break;
+
+      default:
+        return EFI_SUCCESS;
+    }
+
+    FileOffset   += FileOccupiedSize;
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FfsFileHeader + FileOccupiedSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Binary search the name order of a file index.
+
+  @param FileIndex  Pointer to the file index.
+  @param Count      The number of the entries in the name order to search.
+  @param FileName   The file name to search for.
+  @param After      TRUE to return the position after the entries named FileName,
+                    FALSE to return the position of the first entry named FileName.
+
+  @return The position in the name order.
+**/
+STATIC
+UINT32
+FileIndexNamePosition (
+  IN PEI_CORE_FV_FILE_INDEX  *FileIndex,
+  IN UINT32                  Count,
+  IN CONST EFI_GUID          *FileName,
+  IN BOOLEAN                 After
+  )
+{
+  UINT16  *NameOrder;
+  UINT32  Low;
+  UINT32  High;
+  UINT32  Middle;
+  INTN    Result;
+
+  NameOrder = PEI_CORE_FV_FILE_NAME_ORDER (FileIndex);
+  Low       = 0;
+  High      = Count;
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    Result = CompareMem (&FileIndex->Entry[NameOrder[Middle]].Name, FileName, sizeof (EFI_GUID));
+    if ((Result < 0) || (After && (Result == 0))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return Low;
+}
+
+/**
+  Search for a file with the file index of a FV, with the same result as the
+  search of FindFileEx() in the FV itself.
+
+  @param FileIndex       Pointer to the file index of the FV.
+  @param FwVolHeader     Pointer to the FV header.
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+  @param FileHeader      The file to start the search after, and returns the file found.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @retval EFI_SUCCESS      The file is found.
+  @retval EFI_NOT_FOUND    No files matching the search criteria were found.
+  @retval EFI_UNSUPPORTED  The file to start the search after is not in the FV.
+**/
+STATIC
+EFI_STATUS
+FindFileInIndex (
+  IN     PEI_CORE_FV_FILE_INDEX      *FileIndex,
+  IN     EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader,
+  IN     CONST EFI_GUID              *FileName    OPTIONAL,
+  IN     EFI_FV_FILETYPE             SearchType,
+  IN OUT EFI_FFS_FILE_HEADER         **FileHeader,
+  IN OUT EFI_PEI_FILE_HANDLE         *AprioriFile  OPTIONAL
+  )
+{
+  PEI_CORE_FV_FILE_ENTRY  *Entry;
+  UINT32                  Position;
+  UINT32                  Offset;
+  UINT32                  Low;
+  UINT32                  High;
+
+  if (FileName != NULL) {
+    Position = FileIndexNamePosition (FileIndex, FileIndex->FileCount, FileName, FALSE);
+    if (Position < FileIndex->FileCount) {
+      Entry = &FileIndex->Entry[PEI_CORE_FV_FILE_NAME_ORDER (FileIndex)[Position]];
+      if (CompareGuid (&Entry->Name, FileName)) {
+        *FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolHeader + Entry->Offset);
+        return EFI_SUCCESS;
+      }
+    }
+
+    *FileHeader = NULL;
+    return EFI_NOT_FOUND;
+  }
+
+  Position = 0;
+  if (*FileHeader != NULL) {
+    if (((UINTN)*FileHeader <= (UINTN)FwVolHeader) ||
+        ((UINT64)((UINTN)*FileHeader - (UINTN)FwVolHeader) >= FwVolHeader->FvLength))
+    {
+      return EFI_UNSUPPORTED;
+    }
+
+    //
+    // Start with the first file after the given one.
+    //
+    Offset = (UINT32)((UINTN)*FileHeader - (UINTN)FwVolHeader);
+    Low    = 0;
+    High   = FileIndex->FileCount;
+    while (Low < High) {
+      Position = (Low + High) / 2;
+      if (FileIndex->Entry[Position].Offset <= Offset) {
+        Low = Position + 1;
+      } else {
+        High = Position;
+      }
+    }
+
+    Position = Low;
+  }
+
+  for ( ; Position < FileIndex->FileCount; Position++) {
+    Entry = &FileIndex->Entry[Position];
+    if (SearchType == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE) {
+      if ((Entry->Type == EFI_FV_FILETYPE_PEIM) ||
+          (Entry->Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
+          (Entry->Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE))
+      {
+        *FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolHeader + Entry->Offset);
+        return EFI_SUCCESS;
+      } else if (AprioriFile != NULL) {
+        if ((Entry->Type == EFI_FV_FILETYPE_FREEFORM) && CompareGuid (&Entry->Name, &gPeiAprioriFileNameGuid)) {
+          *AprioriFile = (EFI_PEI_FILE_HANDLE)((UINT8 *)FwVolHeader + Entry->Offset);
+        }
+      }
+    } else if (((SearchType == Entry->Type) || (SearchType == EFI_FV_FILETYPE_ALL)) &&
+               (Entry->Type != EFI_FV_FILETYPE_FFS_PAD))
+    {
+      *FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolHeader + Entry->Offset);
+      return EFI_SUCCESS;
+    }
+  }
+
+  *FileHeader = NULL;
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Build the file index of a FV which is handled by the FV PPI of the PeiCore,
+  so that FindFileEx() does not walk the FV for each file search.
+
+  The file index records the offsets of the files from the FV header, so it stays
+  valid when the FV is migrated from the temporary RAM to the permanent memory.
+  No file index is built if PcdPeiCoreFvFileIndex is FALSE, or if a file of the FV
+  has a bad checksum, and the FV itself is searched instead.
+
+  @param CoreFvHandle   Pointer to the PEI_CORE_FV_HANDLE of the FV.
+**/
+VOID
+PeiBuildFvFileIndex (
+  IN PEI_CORE_FV_HANDLE  *CoreFvHandle
+  )
+{
+  EFI_STATUS                  Status;
+  EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader;
+  PEI_CORE_FV_FILE_INDEX      *FileIndex;
+  UINT16                      *NameOrder;
+  UINT32                      FileCount;
+  UINT32                      Index;
+  UINT32                      Position;
+
+  if (!PcdGetBool (PcdPeiCoreFvFileIndex)) {
+    return;
+  }
+
+  if ((CoreFvHandle->FvPpi != &mPeiFfs2FwVol.Fv) && (CoreFvHandle->FvPpi != &mPeiFfs3FwVol.Fv)) {
+    return;
+  }
+
+  PERF_INMODULE_BEGIN ("PeiFvFileIndex");
+
+  FwVolHeader = (EFI_FIRMWARE_VOLUME_HEADER *)CoreFvHandle->FvHandle;
+  FileIndex   = NULL;
+  Status      = WalkFvFiles (FwVolHeader, NULL, &FileCount);
+  if (!EFI_ERROR (Status) && (FileCount != 0)) {
+    FileIndex = AllocatePool (
+                  OFFSET_OF (PEI_CORE_FV_FILE_INDEX, Entry) +
+                  FileCount * (sizeof (PEI_CORE_FV_FILE_ENTRY) + sizeof (UINT16))
+                  );
+    if (FileIndex == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      WalkFvFiles (FwVolHeader, FileIndex, &FileCount);
+      FileIndex->FileCount = FileCount;
+
+      //
+      // Insert the entries into the name order. An entry is inserted after the
+      // entries with the same name, so the first file of a name is found first.
+      //
+      NameOrder = PEI_CORE_FV_FILE_NAME_ORDER (FileIndex);
+      for (Index = 0; Index < FileCount; Index++) {
+        Position = FileIndexNamePosition (FileIndex, Index, &FileIndex->Entry[Index].Name, TRUE);
+        CopyMem (&NameOrder[Position + 1], &NameOrder[Position], (Index - Position) * sizeof (UINT16));
+        NameOrder[Position] = (UINT16)Index;
+      }
+    }
+  }
+
+  PERF_INMODULE_END ("PeiFvFileIndex");
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "No file index of FV %p - %r\n", FwVolHeader, Status));
+    return;
+  }
+
+  CoreFvHandle->FileIndex = FileIndex;
+  DEBUG ((DEBUG_VERBOSE, "File index of FV %p has %d files\n", FwVolHeader, FileCount));
+}
+
 /**
   Given the input file pointer, search for the first matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
@@ -250,6 +595,7 @@ FileHandleToVolume (
   If SearchType is EFI_FV_FILETYPE_ALL, the first FFS file will return without check its file type.
   If SearchType is PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE,
   the first PEIM, or COMBINED PEIM or FV file type FFS file will return.
+  The file index of the FV is used for the search when it has one.
 
   @param FvHandle        Pointer to the FV header of the volume to search
   @param FileName        File name
@@ -283,6 +629,9 @@ FindFileEx (
   UINT8                           FileState;
   UINT8                           DataCheckSum;
   BOOLEAN                         IsFfs3Fv;
+  PEI_CORE_INSTANCE               *PrivateData;
+  PEI_CORE_FV_HANDLE              *CoreFvHandle;
+  EFI_STATUS                      Status;
 
   //
   // Convert the handle of FV to FV header for memory-mapped firmware volume
@@ -290,6 +639,18 @@ FindFileEx (
   FwVolHeader = (EFI_FIRMWARE_VOLUME_HEADER *)FvHandle;
   FileHeader  = (EFI_FFS_FILE_HEADER **)FileHandle;
 
+  PrivateData  = PEI_CORE_INSTANCE_FROM_PS_THIS (GetPeiServicesTablePointer ());
+  CoreFvHandle = FvHandleToCoreHandle (FvHandle);
+  if ((CoreFvHandle != NULL) && (CoreFvHandle->FileIndex != NULL)) {
+    Status = FindFileInIndex (CoreFvHandle->FileIndex, FwVolHeader, FileName, SearchType, FileHeader, AprioriFile);
+    if (Status != EFI_UNSUPPORTED) {
+      PrivateData->IndexedFindFileCount++;
+      return Status;
+    }
+  }
+
+  PrivateData->LinearFindFileCount++;
+
   IsFfs3Fv = CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid);
 
   FvLength = FwVolHeader->FvLength;
@@ -517,6 +878,7 @@ PeiInitializeFv (
   PrivateData->Fv[PrivateData->FvCount].FvPpi                = FvPpi;
   PrivateData->Fv[PrivateData->FvCount].FvHandle             = FvHandle;
   PrivateData->Fv[PrivateData->FvCount].AuthenticationStatus = 0;
+  PeiBuildFvFileIndex (&PrivateData->Fv[PrivateData->FvCount]);
   DEBUG ((
     DEBUG_INFO,
     "The %dth FV start address is 0x%11p, size is 0x%08x, handle is 0x%p\n",
@@ -658,6 +1020,7 @@ FirmwareVolumeInfoPpiNotifyCallback (
     PrivateData->Fv[PrivateData->FvCount].FvPpi                = FvPpi;
     PrivateData->Fv[PrivateData->FvCount].FvHandle             = FvHandle;
     PrivateData->Fv[PrivateData->FvCount].AuthenticationStatus = FvInfo2Ppi.AuthenticationStatus;
+    PeiBuildFvFileIndex (&PrivateData->Fv[PrivateData->FvCount]);
     CurFvCount                                                 = PrivateData->FvCount;
     DEBUG ((
       DEBUG_INFO,
@@ -759,6 +1122,118 @@ VerifyGuidedSectionGuid (
   return FALSE;
 }
 
+/**
+  Look up an encapsulation section in the cache of the extracted sections,
+  and make it the most recently used entry.
+
+  @param PrivateData  Pointer to PEI_CORE_INSTANCE.
+  @param Section      The encapsulation section.
+
+  @return The cache entry of the section, or NULL if the section is not cached.
+**/
+STATIC
+CACHE_SECTION_ENTRY *
+FindCachedSection (
+  IN PEI_CORE_INSTANCE          *PrivateData,
+  IN EFI_COMMON_SECTION_HEADER  *Section
+  )
+{
+  CACHE_SECTION_DATA  *Cache;
+  UINTN               Index;
+
+  Cache = &PrivateData->CacheSection;
+  for (Index = 0; Index < Cache->AllSectionCount; Index++) {
+    if (Cache->Entry[Index].Section == Section) {
+      Cache->HitCount++;
+      Cache->Entry[Index].LastUse = ++Cache->UseCount;
+      return &Cache->Entry[Index];
+    }
+  }
+
+  Cache->MissCount++;
+  return NULL;
+}
+
+/**
+  Add an extracted encapsulation section to the cache of the extracted sections.
+  If the cache is full, the least recently used entry is replaced.
+
+  @param PrivateData           Pointer to PEI_CORE_INSTANCE.
+  @param Section               The encapsulation section.
+  @param SectionData           The extracted data of the section.
+  @param SectionSize           The size of the extracted data.
+  @param AuthenticationStatus  The authentication status of the extraction.
+**/
+STATIC
+VOID
+CacheExtractedSection (
+  IN PEI_CORE_INSTANCE          *PrivateData,
+  IN EFI_COMMON_SECTION_HEADER  *Section,
+  IN VOID                       *SectionData,
+  IN UINTN                      SectionSize,
+  IN UINT32                     AuthenticationStatus
+  )
+{
+  CACHE_SECTION_DATA   *Cache;
+  CACHE_SECTION_ENTRY  *Entry;
+  UINTN                Index;
+
+  Cache = &PrivateData->CacheSection;
+  if (Cache->AllSectionCount < CACHE_SECTION_MAX_NUMBER) {
+    Entry = &Cache->Entry[Cache->AllSectionCount];
+    Cache->AllSectionCount++;
+  } else {
+    Entry = &Cache->Entry[0];
+    for (Index = 1; Index < Cache->AllSectionCount; Index++) {
+      if (Cache->Entry[Index].LastUse < Entry->LastUse) {
+        Entry = &Cache->Entry[Index];
+      }
+    }
+
+    Cache->EvictionCount++;
+  }
+
+  Entry->Section              = Section;
+  Entry->SectionData          = SectionData;
+  Entry->SectionSize          = SectionSize;
+  Entry->AuthenticationStatus = AuthenticationStatus;
+  Entry->LastUse              = ++Cache->UseCount;
+}
+
+/**
+  Build the HOB with the statistics of the cache of the extracted sections,
+  if the performance measurement is enabled.
+
+  @param PrivateData   Pointer to PEI_CORE_INSTANCE.
+**/
+VOID
+PeiReportSectionCacheStatistics (
+  IN  PEI_CORE_INSTANCE  *PrivateData
+  )
+{
+  PEI_SECTION_CACHE_STATISTICS  Statistics;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "PeiCore: section cache of %d entries, %ld hits, %ld misses, %ld evictions\n",
+    (UINT32)CACHE_SECTION_MAX_NUMBER,
+    PrivateData->CacheSection.HitCount,
+    PrivateData->CacheSection.MissCount,
+    PrivateData->CacheSection.EvictionCount
+    ));
+
+  if (!PerformanceMeasurementEnabled ()) {
+    return;
+  }
+
+  Statistics.Capacity      = CACHE_SECTION_MAX_NUMBER;
+  Statistics.Count         = (UINT32)PrivateData->CacheSection.AllSectionCount;
+  Statistics.HitCount      = PrivateData->CacheSection.HitCount;
+  Statistics.MissCount     = PrivateData->CacheSection.MissCount;
+  Statistics.EvictionCount = PrivateData->CacheSection.EvictionCount;
+  BuildGuidDataHob (&gEdkiiPeiSectionCacheStatisticsGuid, &Statistics, sizeof (Statistics));
+}
+
 /**
   Go through the file to search SectionType section.
   Search within encapsulation sections (compression and GUIDed) recursively,
@@ -797,11 +1272,10 @@ ProcessSection (
   EFI_PEI_DECOMPRESS_PPI                 *DecompressPpi;
   VOID                                   *PpiOutput;
   UINTN                                  PpiOutputSize;
-  UINTN                                  Index;
   UINT32                                 Authentication;
   PEI_CORE_INSTANCE                      *PrivateData;
   EFI_GUID                               *SectionDefinitionGuid;
-  BOOLEAN                                SectionCached;
+  CACHE_SECTION_ENTRY                    *CachedSection;
   VOID                                   *TempOutputBuffer;
   UINT32                                 TempAuthenticationStatus;
   UINT16                                 GuidedSectionAttributes;
@@ -809,7 +1283,6 @@ ProcessSection (
   PrivateData   = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
   *OutputBuffer = NULL;
   ParsedLength  = 0;
-  Index         = 0;
   Status        = EFI_NOT_FOUND;
   PpiOutput     = NULL;
   PpiOutputSize = 0;
@@ -876,39 +1349,34 @@ ProcessSection (
       //
       // Check the encapsulated section is extracted into the cache data.
       //
-      SectionCached = FALSE;
-      for (Index = 0; Index < PrivateData->CacheSection.AllSectionCount; Index++) {
-        if (Section == PrivateData->CacheSection.Section[Index]) {
-          SectionCached  = TRUE;
-          PpiOutput      = PrivateData->CacheSection.SectionData[Index];
-          PpiOutputSize  = PrivateData->CacheSection.SectionSize[Index];
-          Authentication = PrivateData->CacheSection.AuthenticationStatus[Index];
-          //
-          // Search section directly from the cache data.
-          //
-          TempAuthenticationStatus = 0;
-          Status                   = ProcessSection (
-                                       PeiServices,
-                                       SectionType,
-                                       SectionInstance,
-                                       PpiOutput,
-                                       PpiOutputSize,
-                                       &TempOutputBuffer,
-                                       &TempAuthenticationStatus,
-                                       IsFfs3Fv
-                                       );
-          if (!EFI_ERROR (Status)) {
-            *OutputBuffer         = TempOutputBuffer;
-            *AuthenticationStatus = TempAuthenticationStatus | Authentication;
-            return EFI_SUCCESS;
-          }
+      CachedSection = FindCachedSection (PrivateData, Section);
+      if (CachedSection != NULL) {
+        PpiOutput      = CachedSection->SectionData;
+        PpiOutputSize  = CachedSection->SectionSize;
+        Authentication = CachedSection->AuthenticationStatus;
+        //
+        // Search section directly from the cache data.
+        //
+        TempAuthenticationStatus = 0;
+        Status                   = ProcessSection (
+                                     PeiServices,
+                                     SectionType,
+                                     SectionInstance,
+                                     PpiOutput,
+                                     PpiOutputSize,
+                                     &TempOutputBuffer,
+                                     &TempAuthenticationStatus,
+                                     IsFfs3Fv
+                                     );
+        if (!EFI_ERROR (Status)) {
+          *OutputBuffer         = TempOutputBuffer;
+          *AuthenticationStatus = TempAuthenticationStatus | Authentication;
+          return EFI_SUCCESS;
         }
-      }
-
-      //
-      // If SectionCached is TRUE, the section data has been cached and scanned.
-      //
-      if (!SectionCached) {
+      } else {
+        //
+        // The section data is not cached, extract it.
+        //
         Status         = EFI_NOT_FOUND;
         Authentication = 0;
         if (Section->Type == EFI_SECTION_GUID_DEFINED) {
@@ -962,15 +1430,7 @@ ProcessSection (
             //
             // Update cache section data.
             //
-            if (PrivateData->CacheSection.AllSectionCount < CACHE_SETION_MAX_NUMBER) {
-              PrivateData->CacheSection.AllSectionCount++;
-            }
-
-            PrivateData->CacheSection.Section[PrivateData->CacheSection.SectionIndex]              = Section;
-            PrivateData->CacheSection.SectionData[PrivateData->CacheSection.SectionIndex]          = PpiOutput;
-            PrivateData->CacheSection.SectionSize[PrivateData->CacheSection.SectionIndex]          = PpiOutputSize;
-            PrivateData->CacheSection.AuthenticationStatus[PrivateData->CacheSection.SectionIndex] = Authentication;
-            PrivateData->CacheSection.SectionIndex                                                 = (PrivateData->CacheSection.SectionIndex + 1)%CACHE_SETION_MAX_NUMBER;
+            CacheExtractedSection (PrivateData, Section, PpiOutput, PpiOutputSize, Authentication);
           }
 
           TempAuthenticationStatus = 0;
@@ -1,7 +1,7 @@
 /** @file
   The internal header file for firmware volume related definitions.
 
-Copyright (c) 2009 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -274,6 +274,17 @@ FvHandleToCoreHandle (
   IN EFI_PEI_FV_HANDLE  FvHandle
   );
 
+/**
+  Build the file index of a FV which is handled by the FV PPI of the PeiCore,
+  so that FindFileEx() does not walk the FV for each file search.
+
+  @param CoreFvHandle   Pointer to the PEI_CORE_FV_HANDLE of the FV.
+**/
+VOID
+PeiBuildFvFileIndex (
+  IN PEI_CORE_FV_HANDLE  *CoreFvHandle
+  );
+
 /**
   Given the input file pointer, search for the next matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
@@ -1,7 +1,7 @@
 /** @file
   Definition of Pei Core Structures and Services
 
-Copyright (c) 2006 - 2024, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -46,6 +46,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/AprioriFileName.h>
 #include <Guid/MigratedFvInfo.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
 
 ///
 /// It is an FFS type extension used for PeiFindFileEx. It indicates current
@@ -132,6 +133,30 @@ typedef struct {
 //
 #define FV_GROWTH_STEP  8
 
+///
+/// Entry of the file index of a FV. The entries are in the order of the files in the FV.
+///
+typedef struct {
+  EFI_GUID    Name;
+  ///
+  /// Offset of the FFS file header from the FV header.
+  ///
+  UINT32      Offset;
+  UINT8       Type;
+} PEI_CORE_FV_FILE_ENTRY;
+
+///
+/// Index of the valid FFS files of a FV which is handled by the FV PPI of the PeiCore.
+/// The FileCount entries are followed by FileCount UINT16 entry numbers in the order
+/// of the file names, see PEI_CORE_FV_FILE_NAME_ORDER().
+///
+typedef struct {
+  UINT32                    FileCount;
+  PEI_CORE_FV_FILE_ENTRY    Entry[1];
+} PEI_CORE_FV_FILE_INDEX;
+
+#define PEI_CORE_FV_FILE_NAME_ORDER(Index)  ((UINT16 *)&(Index)->Entry[(Index)->FileCount])
+
 typedef struct {
   EFI_FIRMWARE_VOLUME_HEADER     *FvHeader;
   EFI_PEI_FIRMWARE_VOLUME_PPI    *FvPpi;
@@ -147,6 +172,10 @@ typedef struct {
   EFI_PEI_FILE_HANDLE            *FvFileHandles;
   BOOLEAN                        ScanFv;
   UINT32                         AuthenticationStatus;
+  //
+  // Pointer to the file index of the FV, NULL if the files are searched in the FV itself.
+  //
+  PEI_CORE_FV_FILE_INDEX         *FileIndex;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
@@ -157,14 +186,33 @@ typedef struct {
   EFI_PEI_NOTIFY_DESCRIPTOR    NotifyDescriptor;
 } PEI_CORE_UNKNOW_FORMAT_FV_INFO;
 
-#define CACHE_SETION_MAX_NUMBER  0x10
+//
+// Number of the extracted encapsulation sections cached by the PeiCore
+//
+#define CACHE_SECTION_MAX_NUMBER  FixedPcdGet32 (PcdPeiCoreSectionCacheEntries)
+
+typedef struct {
+  EFI_COMMON_SECTION_HEADER    *Section;
+  VOID                         *SectionData;
+  UINTN                        SectionSize;
+  UINT32                       AuthenticationStatus;
+  //
+  // Value of CACHE_SECTION_DATA.UseCount when the entry was last used.
+  //
+  UINTN                        LastUse;
+} CACHE_SECTION_ENTRY;
+
+//
+// Cache of the extracted encapsulation sections. When it is full, the least
+// recently used entry is replaced.
+//
 typedef struct {
-  EFI_COMMON_SECTION_HEADER    *Section[CACHE_SETION_MAX_NUMBER];
-  VOID                         *SectionData[CACHE_SETION_MAX_NUMBER];
-  UINTN                        SectionSize[CACHE_SETION_MAX_NUMBER];
-  UINT32                       AuthenticationStatus[CACHE_SETION_MAX_NUMBER];
-  UINTN                        AllSectionCount;
-  UINTN                        SectionIndex;
+  CACHE_SECTION_ENTRY    Entry[CACHE_SECTION_MAX_NUMBER];
+  UINTN                  AllSectionCount;
+  UINTN                  UseCount;
+  UINT64                 HitCount;
+  UINT64                 MissCount;
+  UINT64                 EvictionCount;
 } CACHE_SECTION_DATA;
 
 #define HOLE_MAX_NUMBER  0x3
@@ -308,6 +356,13 @@ struct _PEI_CORE_INSTANCE {
   // Those Memory Range will be migrated into physical memory.
   //
   HOLE_MEMORY_DATA                  HoleData[HOLE_MAX_NUMBER];
+
+  //
+  // The number of the file searches done with the file index of the FV,
+  // and in the FV itself.
+  //
+  UINTN                             IndexedFindFileCount;
+  UINTN                             LinearFindFileCount;
 };
 
 ///
@@ -2028,4 +2083,15 @@ PeiReinitializeFv (
   IN  PEI_CORE_INSTANCE  *PrivateData
   );
 
+/**
+  Build the HOB with the statistics of the cache of the extracted sections,
+  if the performance measurement is enabled.
+
+  @param PrivateData   Pointer to PEI_CORE_INSTANCE.
+**/
+VOID
+PeiReportSectionCacheStatistics (
+  IN  PEI_CORE_INSTANCE  *PrivateData
+  );
+
 #endif
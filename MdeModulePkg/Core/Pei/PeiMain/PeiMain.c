@@ -241,6 +241,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (PEI_CORE_FV_FILE_INDEX *)((UINT8 *)OldCoreData->Fv[Index].FileIndex + OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
@@ -276,6 +280,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (PEI_CORE_FV_FILE_INDEX *)((UINT8 *)OldCoreData->Fv[Index].FileIndex - OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
@@ -524,6 +532,14 @@ PeiCore (
   //
   PERF_INMODULE_END ("PostMem");
 
+  DEBUG ((
+    DEBUG_INFO,
+    "PeiCore: %d file searches with the FV file index, %d in the FV\n",
+    (UINT32)PrivateData.IndexedFindFileCount,
+    (UINT32)PrivateData.LinearFindFileCount
+    ));
+  PeiReportSectionCacheStatistics (&PrivateData);
+
   //
   // Lookup DXE IPL PPI
   //
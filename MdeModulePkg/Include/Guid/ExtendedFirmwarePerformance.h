@@ -2,7 +2,7 @@
   This file defines edk2 extended firmware performance records.
   These records will be added into ACPI FPDT Firmware Basic Boot Performance Table.
 
-Copyright (c) 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2018 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -251,4 +251,23 @@ typedef struct {
 
 extern EFI_GUID  gEdkiiFpdtExtendedFirmwarePerformanceGuid;
 
+///
+/// Hob:
+///   GUID - gEdkiiPeiSectionCacheStatisticsGuid;
+///   Data - PEI_SECTION_CACHE_STATISTICS
+///
+/// The PEI Core builds this HOB at the end of PEI when the performance measurement
+/// is enabled, with the statistics of its cache of the extracted compression and
+/// GUIDed sections.
+///
+typedef struct {
+  UINT32    Capacity;       ///< The number of entries of the cache.
+  UINT32    Count;          ///< The number of entries in use.
+  UINT64    HitCount;       ///< The number of sections found in the cache.
+  UINT64    MissCount;      ///< The number of sections not found in the cache.
+  UINT64    EvictionCount;  ///< The number of entries replaced.
+} PEI_SECTION_CACHE_STATISTICS;
+
+extern EFI_GUID  gEdkiiPeiSectionCacheStatisticsGuid;
+
 #endif
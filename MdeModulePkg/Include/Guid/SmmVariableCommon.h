@@ -77,6 +77,11 @@ typedef struct {
 // The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO
 //
 #define SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO  14
+//
+// The payload for this function is VARIABLE_RECLAIM_STATISTICS. The GUID in EFI_MM_COMMUNICATE_HEADER
+// is gEfiSmmVariableProtocolGuid.
+//
+#define SMM_VARIABLE_FUNCTION_GET_RECLAIM_STATISTICS  15
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -16,8 +16,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define EFI_AUTHENTICATED_VARIABLE_GUID \
   { 0xaaf32c78, 0x947b, 0x439a, { 0xa1, 0x80, 0x2e, 0x14, 0x4e, 0xc3, 0x77, 0x92 } }
 
+#define EDKII_VARIABLE_RECLAIM_STATISTICS_GUID \
+  { 0x3c2f8a6e, 0x1b4d, 0x4e97, { 0x8d, 0x52, 0x6a, 0x0e, 0x9f, 0x31, 0xc7, 0x4b } }
+
 extern EFI_GUID  gEfiVariableGuid;
 extern EFI_GUID  gEfiAuthenticatedVariableGuid;
+extern EFI_GUID  gEdkiiVariableReclaimStatisticsGuid;
 
 ///
 /// Alignment of variable name and data, according to the architecture:
@@ -218,4 +222,17 @@ struct _VARIABLE_INFO_ENTRY {
   BOOLEAN                Volatile;    ///< TRUE if volatile, FALSE if non-volatile.
 };
 
+///
+/// This structure contains the statistics of the reclaims of the non-volatile variable store.
+/// The variable driver collects them with the variable list, and the runtime DXE variable driver
+/// puts them in EFI system table with gEdkiiVariableReclaimStatisticsGuid.
+///
+typedef struct {
+  UINT32    ReclaimCount;   ///< Number of reclaims of the non-volatile variable store.
+  UINT32    UnchangedCount; ///< Number of reclaims that did not change the variable store.
+  UINT32    BlocksWritten;  ///< Number of blocks of the variable store erased and written by reclaims.
+  UINT32    BlocksSkipped;  ///< Number of blocks of the variable store left unchanged by reclaims.
+  UINT64    BytesWritten;   ///< Number of bytes of the variable store written by reclaims.
+} VARIABLE_RECLAIM_STATISTICS;
+
 #endif // _EFI_VARIABLE_H_
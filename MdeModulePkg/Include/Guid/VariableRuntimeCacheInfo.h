@@ -35,6 +35,17 @@ typedef struct {
   /// TRUE indicates all HOB variables have been flushed in flash.
   ///
   BOOLEAN    HobFlushComplete;
+  ///
+  /// Incremented each time pending updates are flushed to the runtime caches.
+  ///
+  UINT32     UpdateCount;
+  ///
+  /// Set to TRUE by the MM variable driver when it increments UpdateCount.
+  /// The runtime DXE driver clears it before it sends the runtime cache
+  /// context to MM. A runtime cache that is not known to change with
+  /// UpdateCount cannot be indexed, so it is searched variable by variable.
+  ///
+  BOOLEAN    UpdateCountSupported;
 } CACHE_INFO_FLAG;
 
 typedef struct {
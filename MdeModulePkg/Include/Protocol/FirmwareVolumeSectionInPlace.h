@@ -0,0 +1,87 @@
+/** @file
+  EDKII Firmware Volume Section In Place Protocol.
+
+  This protocol is installed by the DXE Core on the handles of the firmware
+  volumes it produces the Firmware Volume2 Protocol on. It returns a section
+  of a file in place, without allocating and copying the section contents as
+  EFI_FIRMWARE_VOLUME2_PROTOCOL.ReadSection() does.
+
+  Only the sections that are not in an encapsulation section are returned in
+  place. The contents of the sections in compression and GUIDed sections are
+  only available through EFI_FIRMWARE_VOLUME2_PROTOCOL.ReadSection().
+
+  Ownership and lifetime of the returned buffer:
+  - The buffer belongs to the firmware volume. The caller must not free it and
+    must not write to it.
+  - The buffer is valid as long as this protocol is installed on the handle of
+    the firmware volume. A caller that keeps the buffer beyond the current boot
+    phase, or across the removal of the firmware volume, must copy it.
+  - The buffer is in the firmware volume itself if the firmware volume is
+    memory mapped in system memory, or else in the copy of the file or of the
+    firmware volume cached by the DXE Core.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __FIRMWARE_VOLUME_SECTION_IN_PLACE_H__
+#define __FIRMWARE_VOLUME_SECTION_IN_PLACE_H__
+
+#include <Pi/PiFirmwareFile.h>
+
+#define EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL_GUID \
+  { 0x5c3a1e07, 0x9b4d, 0x4f62, { 0xa8, 0x1c, 0x3e, 0x7d, 0x90, 0x2b, 0x64, 0xf5 } }
+
+typedef struct _EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL;
+
+/**
+  Locates a section in a file of the firmware volume and returns a pointer to
+  its contents, without the section header, in place.
+
+  @param  This                  Indicates the calling context.
+  @param  NameGuid              Pointer to an EFI_GUID, which indicates the file
+                                name from which the requested section will be
+                                read.
+  @param  SectionType           Indicates the section type to return.
+  @param  SectionInstance       Indicates which instance of sections with a type
+                                of SectionType to return.
+  @param  Buffer                On output, points to the contents of the section.
+                                The buffer belongs to the firmware volume.
+  @param  BufferSize            On output, the size in bytes of the contents of
+                                the section.
+  @param  AuthenticationStatus  Pointer to a caller-allocated UINT32 in which the
+                                authentication status is returned, as by
+                                EFI_FIRMWARE_VOLUME2_PROTOCOL.ReadSection().
+
+  @retval EFI_SUCCESS           The section was found, *Buffer points to its
+                                contents.
+  @retval EFI_NOT_FOUND         The file or the section was not found.
+  @retval EFI_UNSUPPORTED       The section is in an encapsulation section, it
+                                must be read with
+                                EFI_FIRMWARE_VOLUME2_PROTOCOL.ReadSection().
+  @retval EFI_ACCESS_DENIED     The firmware volume is configured to disallow
+                                reads.
+  @retval EFI_INVALID_PARAMETER NameGuid, Buffer, BufferSize or
+                                AuthenticationStatus is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_FIRMWARE_VOLUME_READ_SECTION_IN_PLACE)(
+  IN CONST  EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL  *This,
+  IN CONST  EFI_GUID                                         *NameGuid,
+  IN        EFI_SECTION_TYPE                                 SectionType,
+  IN        UINTN                                            SectionInstance,
+  OUT CONST VOID                                             **Buffer,
+  OUT       UINTN                                            *BufferSize,
+  OUT       UINT32                                           *AuthenticationStatus
+  );
+
+struct _EDKII_FIRMWARE_VOLUME_SECTION_IN_PLACE_PROTOCOL {
+  EDKII_FIRMWARE_VOLUME_READ_SECTION_IN_PLACE    ReadSectionInPlace;
+};
+
+extern EFI_GUID  gEdkiiFirmwareVolumeSectionInPlaceProtocolGuid;
+
+#endif
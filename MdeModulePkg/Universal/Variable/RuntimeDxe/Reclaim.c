@@ -9,6 +9,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Variable.h"
 
+///
+/// Statistics of the reclaims of the non-volatile variable store.
+///
+VARIABLE_RECLAIM_STATISTICS  mVariableReclaimStatistics;
+
 /**
   Gets LBA of block and offset by given address.
 
@@ -92,12 +97,20 @@ GetLbaAndOffsetByAddress (
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
+  Only the blocks of the variable storage space whose content changes are
+  erased and written, with a single fault tolerant write so that the update
+  of the variable storage space is still atomic. A reclaim keeps the location
+  of the variables before the first deleted one, so the blocks holding them
+  are neither erased nor written.
+
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
   @retval EFI_ABORTED    The function could not complete successfully.
+  @retval EFI_BAD_BUFFER_SIZE  The blocks to write are beyond the blocks of the
+                               firmware volume block device.
 
 **/
 EFI_STATUS
@@ -106,12 +119,21 @@ FtwVariableSpace (
   IN VARIABLE_STORE_HEADER  *VariableBuffer
   )
 {
-  EFI_STATUS                         Status;
-  EFI_HANDLE                         FvbHandle;
-  EFI_LBA                            VarLba;
-  UINTN                              VarOffset;
-  UINTN                              FtwBufferSize;
-  EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
+  EFI_STATUS                          Status;
+  EFI_HANDLE                          FvbHandle;
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *Fvb;
+  EFI_LBA                             VarLba;
+  UINTN                               VarOffset;
+  UINTN                               FtwBufferSize;
+  UINTN                               BlockSize;
+  UINTN                               NumberOfBlocks;
+  UINTN                               BlockCount;
+  UINTN                               Block;
+  UINTN                               FirstChangedBlock;
+  UINTN                               LastChangedBlock;
+  UINTN                               WriteOffset;
+  UINTN                               WriteSize;
+  EFI_FAULT_TOLERANT_WRITE_PROTOCOL   *FtwProtocol;
 
   //
   // Locate fault tolerant write protocol.
@@ -124,7 +146,7 @@ FtwVariableSpace (
   //
   // Locate Fvb handle by address.
   //
-  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, NULL);
+  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, &Fvb);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -137,21 +159,75 @@ FtwVariableSpace (
     return EFI_ABORTED;
   }
 
+  Status = Fvb->GetBlockSize (Fvb, VarLba, &BlockSize, &NumberOfBlocks);
+  if (EFI_ERROR (Status) || (BlockSize <= VarOffset)) {
+    return EFI_ABORTED;
+  }
+
   FtwBufferSize = ((VARIABLE_STORE_HEADER *)((UINTN)VariableBase))->Size;
   ASSERT (FtwBufferSize == VariableBuffer->Size);
 
+  if (FeaturePcdGet (PcdVariableCollectStatistics)) {
+    mVariableReclaimStatistics.ReclaimCount++;
+  }
+
+  //
+  // Find the first and the last blocks whose content changes. The variable
+  // storage space starts at VarOffset in the first block.
+  //
+  BlockCount        = (VarOffset + FtwBufferSize + BlockSize - 1) / BlockSize;
+  FirstChangedBlock = BlockCount;
+  LastChangedBlock  = 0;
+  for (Block = 0; Block < BlockCount; Block++) {
+    WriteOffset = (Block == 0) ? 0 : Block * BlockSize - VarOffset;
+    WriteSize   = MIN ((Block + 1) * BlockSize - VarOffset, FtwBufferSize) - WriteOffset;
+    if (CompareMem ((UINT8 *)VariableBuffer + WriteOffset, (UINT8 *)(UINTN)VariableBase + WriteOffset, WriteSize) != 0) {
+      if (FirstChangedBlock == BlockCount) {
+        FirstChangedBlock = Block;
+      }
+
+      LastChangedBlock = Block;
+    }
+  }
+
+  if (FirstChangedBlock == BlockCount) {
+    if (FeaturePcdGet (PcdVariableCollectStatistics)) {
+      mVariableReclaimStatistics.UnchangedCount++;
+      mVariableReclaimStatistics.BlocksSkipped += (UINT32)BlockCount;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The blocks written must be within the consecutive blocks of the same
+  // size that start at VarLba.
+  //
+  if (LastChangedBlock >= NumberOfBlocks) {
+    ASSERT (LastChangedBlock < NumberOfBlocks);
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  WriteOffset = (FirstChangedBlock == 0) ? 0 : FirstChangedBlock * BlockSize - VarOffset;
+  WriteSize   = MIN ((LastChangedBlock + 1) * BlockSize - VarOffset, FtwBufferSize) - WriteOffset;
+
   //
   // FTW write record.
   //
   Status = FtwProtocol->Write (
                           FtwProtocol,
-                          VarLba,                // LBA
-                          VarOffset,             // Offset
-                          FtwBufferSize,         // NumBytes
-                          NULL,                  // PrivateData NULL
-                          FvbHandle,             // Fvb Handle
-                          (VOID *)VariableBuffer // write buffer
+                          VarLba + FirstChangedBlock,                     // LBA
+                          (FirstChangedBlock == 0) ? VarOffset : 0,       // Offset
+                          WriteSize,                                      // NumBytes
+                          NULL,                                           // PrivateData NULL
+                          FvbHandle,                                      // Fvb Handle
+                          (VOID *)((UINT8 *)VariableBuffer + WriteOffset) // write buffer
                           );
+  if (!EFI_ERROR (Status) && FeaturePcdGet (PcdVariableCollectStatistics)) {
+    mVariableReclaimStatistics.BlocksWritten += (UINT32)(LastChangedBlock - FirstChangedBlock + 1);
+    mVariableReclaimStatistics.BlocksSkipped += (UINT32)(BlockCount - (LastChangedBlock - FirstChangedBlock + 1));
+    mVariableReclaimStatistics.BytesWritten  += WriteSize;
+  }
 
   return Status;
 }
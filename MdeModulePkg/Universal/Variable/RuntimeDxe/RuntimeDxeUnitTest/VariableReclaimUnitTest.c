@@ -0,0 +1,676 @@
+/** @file
+  This is a host-based unit test for the write of the non-volatile variable
+  store by a reclaim.
+
+  The variable store is in a simulated SPI flash, written through a simulated
+  Fault Tolerant Write protocol that counts the erases of each block and the
+  time the flash would take to erase and program them.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "../Variable.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "Variable Reclaim Unit Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+/// === TEST DATA ==================================================================================
+
+#define TEST_BLOCK_SIZE        SIZE_4KB
+#define TEST_BLOCK_COUNT       16
+#define TEST_FV_HEADER_LENGTH  (sizeof (EFI_FIRMWARE_VOLUME_HEADER) + sizeof (EFI_FV_BLOCK_MAP_ENTRY))
+#define TEST_STORE_SIZE        (TEST_BLOCK_SIZE * TEST_BLOCK_COUNT - TEST_FV_HEADER_LENGTH)
+#define TEST_DATA_SIZE         1000
+#define TEST_VARIABLE_COUNT    32
+#define TEST_UPDATE_COUNT      2000
+
+///
+/// Typical SPI flash timings, in microseconds. A fault tolerant write of a
+/// block erases and programs the spare block, then the target block.
+///
+#define TEST_BLOCK_ERASE_TIME    45000
+#define TEST_BLOCK_PROGRAM_TIME  11000
+
+//
+// Test GUID {7D2E6B1F-2C66-4F0B-9A3F-3B0D1C5E8A41}
+//
+EFI_GUID  mTestGuid = {
+  0x7d2e6b1f, 0x2c66, 0x4f0b, { 0x9a, 0x3f, 0x3b, 0x0d, 0x1c, 0x5e, 0x8a, 0x41 }
+};
+
+UINT8                               *mFlash;
+UINT32                              mBlockEraseCount[TEST_BLOCK_COUNT];
+UINT64                              mFlashTime;
+VARIABLE_STORE_HEADER               *mFlashStore;
+UINTN                               mFlashStoreOffset;
+VARIABLE_STORE_HEADER               *mReclaimBuffer;
+EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  mTestFvb;
+EFI_FAULT_TOLERANT_WRITE_PROTOCOL   mTestFtw;
+
+/// === CODE UNDER TEST ===========================================================================
+
+/**
+  Retrieves the physical address of the simulated flash.
+
+  @param[in]   This     Indicates the EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL instance.
+  @param[out]  Address  Pointer to a caller-allocated EFI_PHYSICAL_ADDRESS.
+
+  @retval EFI_SUCCESS  The firmware volume base address was returned.
+**/
+EFI_STATUS
+EFIAPI
+TestFvbGetPhysicalAddress (
+  IN CONST EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *This,
+  OUT EFI_PHYSICAL_ADDRESS                     *Address
+  )
+{
+  *Address = (EFI_PHYSICAL_ADDRESS)(UINTN)mFlash;
+  return EFI_SUCCESS;
+}
+
+/**
+  Retrieves the size of the blocks of the simulated flash.
+
+  @param[in]   This            Indicates the EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL instance.
+  @param[in]   Lba             Indicates the block whose size to return.
+  @param[out]  BlockSize       The size of the block.
+  @param[out]  NumberOfBlocks  The number of consecutive blocks of the same size.
+
+  @retval EFI_SUCCESS            The block size was returned.
+  @retval EFI_INVALID_PARAMETER  The requested LBA is out of range.
+**/
+EFI_STATUS
+EFIAPI
+TestFvbGetBlockSize (
+  IN CONST EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *This,
+  IN EFI_LBA                                   Lba,
+  OUT UINTN                                    *BlockSize,
+  OUT UINTN                                    *NumberOfBlocks
+  )
+{
+  if (Lba >= TEST_BLOCK_COUNT) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *BlockSize      = TEST_BLOCK_SIZE;
+  *NumberOfBlocks = TEST_BLOCK_COUNT - (UINTN)Lba;
+  return EFI_SUCCESS;
+}
+
+/**
+  Writes the simulated flash as a fault tolerant write would, erasing and
+  programming each block the write touches twice.
+
+  @param[in]  This        The pointer to this protocol instance.
+  @param[in]  Lba         The logical block address of the target block.
+  @param[in]  Offset      The offset within the target block to place the data.
+  @param[in]  Length      The number of bytes to write to the target block.
+  @param[in]  PrivateData A pointer to private data that the caller requires to
+                          complete any pending writes in the event of a fault.
+  @param[in]  FvBlockHandle  The handle of FVB protocol that provides services.
+  @param[in]  Buffer      The data to write.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_BAD_BUFFER_SIZE    The write would span past the simulated flash.
+**/
+EFI_STATUS
+EFIAPI
+TestFtwWrite (
+  IN EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *This,
+  IN EFI_LBA                            Lba,
+  IN UINTN                              Offset,
+  IN UINTN                              Length,
+  IN VOID                               *PrivateData,
+  IN EFI_HANDLE                         FvBlockHandle,
+  IN VOID                               *Buffer
+  )
+{
+  UINTN  Block;
+
+  if ((Length == 0) || ((UINTN)Lba * TEST_BLOCK_SIZE + Offset + Length > TEST_BLOCK_SIZE * TEST_BLOCK_COUNT)) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  for (Block = (UINTN)Lba; Block <= ((UINTN)Lba * TEST_BLOCK_SIZE + Offset + Length - 1) / TEST_BLOCK_SIZE; Block++) {
+    mBlockEraseCount[Block]++;
+    mFlashTime += 2 * (TEST_BLOCK_ERASE_TIME + TEST_BLOCK_PROGRAM_TIME);
+  }
+
+  CopyMem (mFlash + (UINTN)Lba * TEST_BLOCK_SIZE + Offset, Buffer, Length);
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the simulated Fault Tolerant Write protocol.
+
+  @param[out] FtwProtocol       The simulated FTW protocol.
+
+  @retval EFI_SUCCESS           The protocol is returned.
+**/
+EFI_STATUS
+GetFtwProtocol (
+  OUT VOID  **FtwProtocol
+  )
+{
+  *FtwProtocol = &mTestFtw;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the simulated Firmware Volume Block protocol of the simulated flash.
+
+  @param[in]  Address        The address of the simulated flash.
+  @param[out] FvbHandle      Handle of the simulated FVB protocol.
+  @param[out] FvbProtocol    The simulated FVB protocol.
+
+  @retval EFI_SUCCESS        The simulated FVB protocol is returned.
+  @retval EFI_NOT_FOUND      The address is not in the simulated flash.
+**/
+EFI_STATUS
+GetFvbInfoByAddress (
+  IN  EFI_PHYSICAL_ADDRESS                Address,
+  OUT EFI_HANDLE                          *FvbHandle OPTIONAL,
+  OUT EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  **FvbProtocol OPTIONAL
+  )
+{
+  if ((Address < (UINTN)mFlash) || (Address >= (UINTN)mFlash + TEST_BLOCK_SIZE * TEST_BLOCK_COUNT)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (FvbHandle != NULL) {
+    *FvbHandle = (EFI_HANDLE)&mTestFvb;
+  }
+
+  if (FvbProtocol != NULL) {
+    *FvbProtocol = &mTestFvb;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/// === HELPER FUNCTIONS ===========================================================================
+
+/**
+  Get the size of a test variable, with its header and alignment.
+
+  @param[in]  Variable  The variable.
+
+  @return The size of the variable.
+**/
+STATIC
+UINTN
+GetTestVariableSize (
+  IN AUTHENTICATED_VARIABLE_HEADER  *Variable
+  )
+{
+  return HEADER_ALIGN (sizeof (*Variable) + Variable->NameSize + Variable->DataSize);
+}
+
+/**
+  Append a test variable to the variable store in the simulated flash.
+
+  @param[in]  Index  Index of the test variable, used for its name and data.
+  @param[in]  Value  Value of the data of the test variable.
+
+  @retval TRUE   The variable is appended.
+  @retval FALSE  The variable store is full.
+**/
+STATIC
+BOOLEAN
+AppendTestVariable (
+  IN UINTN  Index,
+  IN UINT8  Value
+  )
+{
+  AUTHENTICATED_VARIABLE_HEADER  *Variable;
+  CHAR16                         Name[] = L"Var00";
+
+  Name[3]  = (CHAR16)(L'0' + (Index / 10) % 10);
+  Name[4]  = (CHAR16)(L'0' + Index % 10);
+  Variable = (AUTHENTICATED_VARIABLE_HEADER *)((UINTN)mFlashStore + mFlashStoreOffset);
+  if (mFlashStoreOffset + HEADER_ALIGN (sizeof (*Variable) + sizeof (Name) + TEST_DATA_SIZE) > TEST_STORE_SIZE) {
+    return FALSE;
+  }
+
+  ZeroMem (Variable, sizeof (*Variable));
+  Variable->StartId    = VARIABLE_DATA;
+  Variable->State      = VAR_ADDED;
+  Variable->Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS;
+  Variable->NameSize   = sizeof (Name);
+  Variable->DataSize   = TEST_DATA_SIZE;
+  CopyGuid (&Variable->VendorGuid, &mTestGuid);
+  CopyMem (Variable + 1, Name, sizeof (Name));
+  SetMem ((UINT8 *)(Variable + 1) + sizeof (Name), TEST_DATA_SIZE, Value);
+
+  mFlashStoreOffset += GetTestVariableSize (Variable);
+  return TRUE;
+}
+
+/**
+  Get a test variable of the variable store in the simulated flash.
+
+  @param[in]  Index  Index of the test variable in the store, deleted or not.
+
+  @return The variable.
+**/
+STATIC
+AUTHENTICATED_VARIABLE_HEADER *
+GetTestVariable (
+  IN UINTN  Index
+  )
+{
+  AUTHENTICATED_VARIABLE_HEADER  *Variable;
+
+  Variable = (AUTHENTICATED_VARIABLE_HEADER *)(mFlashStore + 1);
+  while (Index-- > 0) {
+    Variable = (AUTHENTICATED_VARIABLE_HEADER *)((UINTN)Variable + GetTestVariableSize (Variable));
+  }
+
+  return Variable;
+}
+
+/**
+  Build the variable store a reclaim writes, with the added variables of the
+  store in the simulated flash, and write it.
+
+  @return The status of FtwVariableSpace ().
+**/
+STATIC
+EFI_STATUS
+ReclaimTestStore (
+  VOID
+  )
+{
+  AUTHENTICATED_VARIABLE_HEADER  *Variable;
+  UINTN                          Offset;
+  UINTN                          ReclaimOffset;
+  EFI_STATUS                     Status;
+
+  SetMem (mReclaimBuffer, TEST_STORE_SIZE, 0xFF);
+  CopyMem (mReclaimBuffer, mFlashStore, sizeof (VARIABLE_STORE_HEADER));
+  ReclaimOffset = sizeof (VARIABLE_STORE_HEADER);
+  for (Offset = sizeof (VARIABLE_STORE_HEADER); Offset < mFlashStoreOffset; Offset += GetTestVariableSize (Variable)) {
+    Variable = (AUTHENTICATED_VARIABLE_HEADER *)((UINTN)mFlashStore + Offset);
+    if (Variable->State == VAR_ADDED) {
+      CopyMem ((UINT8 *)mReclaimBuffer + ReclaimOffset, Variable, GetTestVariableSize (Variable));
+      ReclaimOffset += GetTestVariableSize (Variable);
+    }
+  }
+
+  Status = FtwVariableSpace ((EFI_PHYSICAL_ADDRESS)(UINTN)mFlashStore, mReclaimBuffer);
+  if (!EFI_ERROR (Status)) {
+    mFlashStoreOffset = ReclaimOffset;
+  }
+
+  return Status;
+}
+
+/**
+  Create the simulated flash, with a variable store of TEST_VARIABLE_COUNT
+  variables.
+
+  @param[in]  Context  Unit test case context
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CreateTestFlash (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  *FvHeader;
+  UINTN                       Index;
+
+  mFlash         = AllocatePool (TEST_BLOCK_SIZE * TEST_BLOCK_COUNT);
+  mReclaimBuffer = AllocatePool (TEST_STORE_SIZE);
+  if ((mFlash == NULL) || (mReclaimBuffer == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  SetMem (mFlash, TEST_BLOCK_SIZE * TEST_BLOCK_COUNT, 0xFF);
+  FvHeader                       = (EFI_FIRMWARE_VOLUME_HEADER *)mFlash;
+  FvHeader->FvLength             = TEST_BLOCK_SIZE * TEST_BLOCK_COUNT;
+  FvHeader->HeaderLength         = (UINT16)TEST_FV_HEADER_LENGTH;
+  FvHeader->BlockMap[0].NumBlocks = TEST_BLOCK_COUNT;
+  FvHeader->BlockMap[0].Length    = TEST_BLOCK_SIZE;
+  FvHeader->BlockMap[1].NumBlocks = 0;
+  FvHeader->BlockMap[1].Length    = 0;
+
+  mFlashStore = (VARIABLE_STORE_HEADER *)(mFlash + TEST_FV_HEADER_LENGTH);
+  ZeroMem (mFlashStore, sizeof (VARIABLE_STORE_HEADER));
+  CopyGuid (&mFlashStore->Signature, &gEfiAuthenticatedVariableGuid);
+  mFlashStore->Size   = TEST_STORE_SIZE;
+  mFlashStore->Format = VARIABLE_STORE_FORMATTED;
+  mFlashStore->State  = VARIABLE_STORE_HEALTHY;
+  mFlashStoreOffset   = sizeof (VARIABLE_STORE_HEADER);
+
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    AppendTestVariable (Index, 0);
+  }
+
+  mTestFvb.GetPhysicalAddress = TestFvbGetPhysicalAddress;
+  mTestFvb.GetBlockSize       = TestFvbGetBlockSize;
+  mTestFtw.Write              = TestFtwWrite;
+
+  ZeroMem (mBlockEraseCount, sizeof (mBlockEraseCount));
+  ZeroMem (&mVariableReclaimStatistics, sizeof (mVariableReclaimStatistics));
+  mFlashTime = 0;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the simulated flash.
+
+  @param[in]  Context  Unit test case context
+**/
+STATIC
+VOID
+EFIAPI
+FreeTestFlash (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreePool (mFlash);
+  FreePool (mReclaimBuffer);
+  mFlash         = NULL;
+  mReclaimBuffer = NULL;
+}
+
+/// === TEST CASES =================================================================================
+
+/**
+  A reclaim that removes variables near the end of the store only writes the
+  blocks from the first variable removed to the end of the variables.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReclaimShouldWriteChangedBlocksOnly (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  FirstBlock;
+  UINTN  LastBlock;
+  UINTN  Block;
+
+  GetTestVariable (TEST_VARIABLE_COUNT - 4)->State &= VAR_DELETED;
+  GetTestVariable (TEST_VARIABLE_COUNT - 2)->State &= VAR_DELETED;
+  FirstBlock = ((UINTN)GetTestVariable (TEST_VARIABLE_COUNT - 4) - (UINTN)mFlash) / TEST_BLOCK_SIZE;
+  LastBlock  = ((UINTN)mFlashStore + mFlashStoreOffset - 1 - (UINTN)mFlash) / TEST_BLOCK_SIZE;
+
+  UT_ASSERT_NOT_EFI_ERROR (ReclaimTestStore ());
+  UT_ASSERT_MEM_EQUAL (mFlashStore, mReclaimBuffer, TEST_STORE_SIZE);
+
+  for (Block = 0; Block < TEST_BLOCK_COUNT; Block++) {
+    UT_ASSERT_EQUAL (mBlockEraseCount[Block], ((Block >= FirstBlock) && (Block <= LastBlock)) ? 1 : 0);
+  }
+
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.ReclaimCount, 1);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.UnchangedCount, 0);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.BlocksWritten, LastBlock - FirstBlock + 1);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.BlocksSkipped, TEST_BLOCK_COUNT - (LastBlock - FirstBlock + 1));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A reclaim of a store without deleted variables does not write the flash.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReclaimShouldSkipUnchangedStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_NOT_EFI_ERROR (ReclaimTestStore ());
+  UT_ASSERT_MEM_EQUAL (mFlashStore, mReclaimBuffer, TEST_STORE_SIZE);
+
+  UT_ASSERT_EQUAL (mFlashTime, 0);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.ReclaimCount, 1);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.UnchangedCount, 1);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.BlocksWritten, 0);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.BytesWritten, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A reclaim that removes the first variable writes the store up to the end of
+  the variables, including the block shared with the firmware volume header,
+  and keeps the firmware volume header.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReclaimShouldKeepFvHeader (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  FvHeader;
+  UINTN                       LastBlock;
+
+  CopyMem (&FvHeader, mFlash, sizeof (FvHeader));
+  GetTestVariable (0)->State &= VAR_DELETED;
+  LastBlock = ((UINTN)mFlashStore + mFlashStoreOffset - 1 - (UINTN)mFlash) / TEST_BLOCK_SIZE;
+
+  UT_ASSERT_NOT_EFI_ERROR (ReclaimTestStore ());
+  UT_ASSERT_MEM_EQUAL (mFlashStore, mReclaimBuffer, TEST_STORE_SIZE);
+  UT_ASSERT_MEM_EQUAL (mFlash, &FvHeader, sizeof (FvHeader));
+
+  UT_ASSERT_EQUAL (mBlockEraseCount[0], 1);
+  UT_ASSERT_EQUAL (mBlockEraseCount[LastBlock + 1], 0);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.BlocksWritten, LastBlock + 1);
+  UT_ASSERT_EQUAL (mVariableReclaimStatistics.BytesWritten, (LastBlock + 1) * TEST_BLOCK_SIZE - TEST_FV_HEADER_LENGTH);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Updates of random variables, each appending the new value and deleting the
+  old one, with a reclaim whenever the store is full. The wear of the flash
+  and the time spent writing it are compared with a rewrite of the whole store
+  by each reclaim.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReclaimShouldReduceWear (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  AUTHENTICATED_VARIABLE_HEADER  *Variable;
+  UINTN                          Update;
+  UINTN                          Index;
+  UINTN                          Block;
+  UINT32                         Seed;
+  UINT32                         MaxEraseCount;
+  UINT64                         FullRewriteTime;
+
+  Seed = 1;
+  for (Update = 0; Update < TEST_UPDATE_COUNT; Update++) {
+    //
+    // Most updates are for a few variables, as with boot next, counters and
+    // logs, and the other variables are seldom updated.
+    //
+    Seed  = Seed * 1103515245 + 12345;
+    Index = ((Seed >> 16) % 256 == 0) ? (Seed >> 8) % TEST_VARIABLE_COUNT : (Seed >> 8) % 4;
+
+    if (!AppendTestVariable (Index, (UINT8)Update)) {
+      UT_ASSERT_NOT_EFI_ERROR (ReclaimTestStore ());
+      UT_ASSERT_MEM_EQUAL (mFlashStore, mReclaimBuffer, TEST_STORE_SIZE);
+      UT_ASSERT_TRUE (AppendTestVariable (Index, (UINT8)Update));
+    }
+
+    //
+    // Delete the previous copy of the variable
+    //
+    for (Variable = GetTestVariable (0); Variable->StartId == VARIABLE_DATA; Variable = (AUTHENTICATED_VARIABLE_HEADER *)((UINTN)Variable + GetTestVariableSize (Variable))) {
+      if ((Variable->State == VAR_ADDED) && (((CHAR16 *)(Variable + 1))[3] == (CHAR16)(L'0' + (Index / 10) % 10)) &&
+          (((CHAR16 *)(Variable + 1))[4] == (CHAR16)(L'0' + Index % 10)))
+      {
+        Variable->State &= VAR_DELETED;
+        break;
+      }
+    }
+  }
+
+  MaxEraseCount = 0;
+  for (Block = 0; Block < TEST_BLOCK_COUNT; Block++) {
+    MaxEraseCount = MAX (MaxEraseCount, mBlockEraseCount[Block]);
+  }
+
+  FullRewriteTime = (UINT64)mVariableReclaimStatistics.ReclaimCount * TEST_BLOCK_COUNT * 2 * (TEST_BLOCK_ERASE_TIME + TEST_BLOCK_PROGRAM_TIME);
+
+  UT_LOG_INFO (
+    "%d reclaims: %d blocks written, %d blocks skipped, %d erases of the most worn block\n",
+    mVariableReclaimStatistics.ReclaimCount,
+    mVariableReclaimStatistics.BlocksWritten,
+    mVariableReclaimStatistics.BlocksSkipped,
+    MaxEraseCount
+    );
+  UT_LOG_INFO (
+    "%Lu ms writing the flash, %Lu ms when rewriting the whole store\n",
+    mFlashTime / 1000,
+    FullRewriteTime / 1000
+    );
+
+  UT_ASSERT_TRUE (mVariableReclaimStatistics.ReclaimCount > 0);
+  UT_ASSERT_EQUAL (
+    mVariableReclaimStatistics.BlocksWritten + mVariableReclaimStatistics.BlocksSkipped,
+    mVariableReclaimStatistics.ReclaimCount * TEST_BLOCK_COUNT
+    );
+  UT_ASSERT_TRUE (mVariableReclaimStatistics.BlocksSkipped > 0);
+  UT_ASSERT_TRUE (mFlashTime < FullRewriteTime);
+
+  return UNIT_TEST_PASSED;
+}
+
+/// === TEST ENGINE ================================================================================
+
+/**
+  Main entry point to this unit test application.
+
+  Sets up and runs the test suites.
+**/
+VOID
+EFIAPI
+UnitTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ReclaimTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Add all test suites and tests.
+  //
+  Status = CreateUnitTestSuite (&ReclaimTests, Framework, "Variable Reclaim Tests", "VarReclaim", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for VarReclaim\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (
+    ReclaimTests,
+    "A reclaim should only write the blocks that change",
+    "ChangedBlocks",
+    ReclaimShouldWriteChangedBlocksOnly,
+    CreateTestFlash,
+    FreeTestFlash,
+    NULL
+    );
+  AddTestCase (
+    ReclaimTests,
+    "A reclaim should not write an unchanged store",
+    "Unchanged",
+    ReclaimShouldSkipUnchangedStore,
+    CreateTestFlash,
+    FreeTestFlash,
+    NULL
+    );
+  AddTestCase (
+    ReclaimTests,
+    "A reclaim should keep the firmware volume header",
+    "FvHeader",
+    ReclaimShouldKeepFvHeader,
+    CreateTestFlash,
+    FreeTestFlash,
+    NULL
+    );
+  AddTestCase (
+    ReclaimTests,
+    "Reclaims should wear the flash less than rewrites of the whole store",
+    "Wear",
+    ReclaimShouldReduceWear,
+    CreateTestFlash,
+    FreeTestFlash,
+    NULL
+    );
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestMain ();
+  return 0;
+}
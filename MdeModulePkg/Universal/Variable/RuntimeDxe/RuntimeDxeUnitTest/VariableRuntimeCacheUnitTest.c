@@ -0,0 +1,442 @@
+/** @file
+  This is a host-based unit test for the dirty extents used to synchronize
+  the runtime variable caches with the variable stores.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "../VariableRuntimeCache.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "Variable Runtime Cache Unit Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+/// === TEST DATA ==================================================================================
+
+#define TEST_STORE_SIZE  SIZE_64KB
+
+VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
+VARIABLE_STORE_HEADER   *mNvVariableCache;
+VARIABLE_STORE_HEADER   *mTestVolatileStore;
+BOOLEAN                 mTestPendingUpdate;
+BOOLEAN                 mTestReadLock;
+BOOLEAN                 mTestHobFlushComplete;
+UINT32                  mTestUpdateCount;
+
+/// === HELPER FUNCTIONS ===========================================================================
+
+/**
+  Allocate a test buffer filled with a pattern.
+
+  @param[in]  Seed  Seed of the pattern.
+
+  @return Pointer to the buffer, or NULL if out of resources.
+**/
+STATIC
+VARIABLE_STORE_HEADER *
+AllocateTestStore (
+  IN UINT8  Seed
+  )
+{
+  UINT8  *Buffer;
+  UINTN  Index;
+
+  Buffer = AllocatePool (TEST_STORE_SIZE);
+  if (Buffer != NULL) {
+    for (Index = 0; Index < TEST_STORE_SIZE; Index++) {
+      Buffer[Index] = (UINT8)(Index * 7 + Seed);
+    }
+  }
+
+  return (VARIABLE_STORE_HEADER *)Buffer;
+}
+
+/**
+  Change bytes of a variable store as an update of a variable would.
+
+  @param[in]  Store   The variable store.
+  @param[in]  Offset  Offset of the bytes to change.
+  @param[in]  Length  Number of bytes to change.
+**/
+STATIC
+VOID
+ChangeTestStore (
+  IN VARIABLE_STORE_HEADER  *Store,
+  IN UINTN                  Offset,
+  IN UINTN                  Length
+  )
+{
+  UINT8  *Buffer;
+
+  Buffer = (UINT8 *)Store + Offset;
+  while (Length-- > 0) {
+    *Buffer = (UINT8)~*Buffer;
+    Buffer++;
+  }
+}
+
+/**
+  Create variable stores and runtime caches holding the same data, as after
+  the runtime caches have been initialized.
+
+  @param[in]  Context  Unit test case context
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CreateTestCaches (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_RUNTIME_CACHE_CONTEXT  *CacheContext;
+
+  mVariableModuleGlobal = AllocateZeroPool (sizeof (VARIABLE_MODULE_GLOBAL));
+  mNvVariableCache      = AllocateTestStore (1);
+  mTestVolatileStore    = AllocateTestStore (2);
+  if ((mVariableModuleGlobal == NULL) || (mNvVariableCache == NULL) || (mTestVolatileStore == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mVariableModuleGlobal->VariableGlobal.VolatileVariableBase = (EFI_PHYSICAL_ADDRESS)(UINTN)mTestVolatileStore;
+
+  CacheContext                                     = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
+  CacheContext->VariableRuntimeNvCache.Store       = AllocateCopyPool (TEST_STORE_SIZE, mNvVariableCache);
+  CacheContext->VariableRuntimeVolatileCache.Store = AllocateCopyPool (TEST_STORE_SIZE, mTestVolatileStore);
+  CacheContext->PendingUpdate                      = &mTestPendingUpdate;
+  CacheContext->ReadLock                           = &mTestReadLock;
+  CacheContext->HobFlushComplete                   = &mTestHobFlushComplete;
+  CacheContext->UpdateCount                        = &mTestUpdateCount;
+  if ((CacheContext->VariableRuntimeNvCache.Store == NULL) || (CacheContext->VariableRuntimeVolatileCache.Store == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mTestPendingUpdate    = FALSE;
+  mTestReadLock         = FALSE;
+  mTestHobFlushComplete = FALSE;
+  mTestUpdateCount      = 0;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the variable stores and the runtime caches.
+
+  @param[in]  Context  Unit test case context
+**/
+STATIC
+VOID
+EFIAPI
+FreeTestCaches (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreePool (mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache.Store);
+  FreePool (mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache.Store);
+  FreePool (mTestVolatileStore);
+  FreePool (mNvVariableCache);
+  FreePool (mVariableModuleGlobal);
+  mVariableModuleGlobal = NULL;
+  mNvVariableCache      = NULL;
+  mTestVolatileStore    = NULL;
+}
+
+/// === TEST CASES =================================================================================
+
+/**
+  Updating a variable copies the State of the old variable and the new
+  variable to the runtime cache, and nothing else.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UpdateShouldSynchronizeOnlyDirtyBytes (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_RUNTIME_CACHE_CONTEXT  *CacheContext;
+
+  CacheContext = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
+
+  ChangeTestStore (mNvVariableCache, 0x102, 1);
+  ChangeTestStore (mNvVariableCache, 0x8000, 0x64);
+  UT_ASSERT_NOT_EFI_ERROR (AddPendingRuntimeVariableCacheUpdate (&CacheContext->VariableRuntimeNvCache, 0x102, 1));
+  UT_ASSERT_TRUE (mTestPendingUpdate);
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, 0);
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeNvCache, 0x8000, 0x64));
+
+  UT_ASSERT_FALSE (mTestPendingUpdate);
+  UT_ASSERT_EQUAL (mTestUpdateCount, 1);
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, 1 + 0x64);
+  UT_ASSERT_MEM_EQUAL (CacheContext->VariableRuntimeNvCache.Store, mNvVariableCache, TEST_STORE_SIZE);
+  UT_ASSERT_MEM_EQUAL (CacheContext->VariableRuntimeVolatileCache.Store, mTestVolatileStore, TEST_STORE_SIZE);
+
+  //
+  // An update with nothing changed copies nothing.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeNvCache, 0, 0));
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, 1 + 0x64);
+
+  //
+  // A reclaim synchronizes the whole store.
+  //
+  ChangeTestStore (mTestVolatileStore, 0, TEST_STORE_SIZE);
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeVolatileCache, 0, TEST_STORE_SIZE));
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, 1 + 0x64 + TEST_STORE_SIZE);
+  UT_ASSERT_MEM_EQUAL (CacheContext->VariableRuntimeVolatileCache.Store, mTestVolatileStore, TEST_STORE_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Updates made while the runtime DXE driver holds the ReadLock are kept as
+  dirty extents, merged when they overlap or touch, and copied once when the
+  pending updates are flushed.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReadLockShouldDeferUpdates (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_RUNTIME_CACHE_CONTEXT  *CacheContext;
+  VARIABLE_RUNTIME_CACHE          *NvCache;
+
+  CacheContext  = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
+  NvCache       = &CacheContext->VariableRuntimeNvCache;
+  mTestReadLock = TRUE;
+
+  ChangeTestStore (mNvVariableCache, 100, 100);
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (NvCache, 100, 100));
+  ChangeTestStore (mNvVariableCache, 300, 10);
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (NvCache, 300, 10));
+  UT_ASSERT_EQUAL (NvCache->DirtyExtentCount, 2);
+
+  //
+  // [150, 300) overlaps [100, 200) and touches [300, 310).
+  //
+  ChangeTestStore (mNvVariableCache, 250, 50);
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (NvCache, 150, 150));
+  UT_ASSERT_EQUAL (NvCache->DirtyExtentCount, 1);
+  UT_ASSERT_EQUAL (NvCache->DirtyExtent[0].Offset, 100);
+  UT_ASSERT_EQUAL (NvCache->DirtyExtent[0].Length, 210);
+
+  ChangeTestStore (mTestVolatileStore, 0x4000, 8);
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeVolatileCache, 0x4000, 8));
+
+  UT_ASSERT_TRUE (mTestPendingUpdate);
+  UT_ASSERT_EQUAL (mTestUpdateCount, 0);
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, 0);
+
+  mTestReadLock = FALSE;
+  UT_ASSERT_NOT_EFI_ERROR (FlushPendingRuntimeVariableCacheUpdates ());
+
+  UT_ASSERT_FALSE (mTestPendingUpdate);
+  UT_ASSERT_EQUAL (mTestUpdateCount, 1);
+  UT_ASSERT_EQUAL (NvCache->DirtyExtentCount, 0);
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, 210 + 8);
+  UT_ASSERT_MEM_EQUAL (NvCache->Store, mNvVariableCache, TEST_STORE_SIZE);
+  UT_ASSERT_MEM_EQUAL (CacheContext->VariableRuntimeVolatileCache.Store, mTestVolatileStore, TEST_STORE_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  When more disjoint updates are pending than there are dirty extents, the
+  closest extents are merged and every update still reaches the runtime
+  cache.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TooManyExtentsShouldMergeClosest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_RUNTIME_CACHE_CONTEXT  *CacheContext;
+  VARIABLE_RUNTIME_CACHE          *NvCache;
+  UINTN                           Index;
+  UINTN                           Offset;
+
+  CacheContext  = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
+  NvCache       = &CacheContext->VariableRuntimeNvCache;
+  mTestReadLock = TRUE;
+
+  //
+  // Updates of 16 bytes every 0x1000 bytes, and a last one 0x100 bytes after
+  // the fourth one.
+  //
+  for (Index = 0; Index < VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS + 1; Index++) {
+    Offset = (Index < VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS) ? Index * 0x1000 : 0x3100;
+    ChangeTestStore (mNvVariableCache, Offset, 16);
+    UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (NvCache, Offset, 16));
+    UT_ASSERT_TRUE (NvCache->DirtyExtentCount <= VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS);
+  }
+
+  UT_ASSERT_EQUAL (NvCache->DirtyExtentCount, VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS);
+
+  mTestReadLock = FALSE;
+  UT_ASSERT_NOT_EFI_ERROR (FlushPendingRuntimeVariableCacheUpdates ());
+
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, (VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS - 1) * 16 + 0x100 + 16);
+  UT_ASSERT_MEM_EQUAL (NvCache->Store, mNvVariableCache, TEST_STORE_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Invalid updates and uninitialized runtime caches are reported.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InvalidUpdateShouldFail (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_RUNTIME_CACHE_CONTEXT  *CacheContext;
+  VARIABLE_RUNTIME_CACHE          NoCache;
+
+  CacheContext = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
+  ZeroMem (&NoCache, sizeof (NoCache));
+
+  UT_ASSERT_STATUS_EQUAL (SynchronizeRuntimeVariableCache (NULL, 0, 1), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeNvCache, MAX_UINT32, 2), EFI_INVALID_PARAMETER);
+  UT_ASSERT_NOT_EFI_ERROR (SynchronizeRuntimeVariableCache (&NoCache, 0, 1));
+  UT_ASSERT_EQUAL (NoCache.DirtyExtentCount, 0);
+  UT_ASSERT_FALSE (mTestPendingUpdate);
+
+  CacheContext->PendingUpdate = NULL;
+  UT_ASSERT_STATUS_EQUAL (SynchronizeRuntimeVariableCache (&CacheContext->VariableRuntimeNvCache, 0, 1), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (FlushPendingRuntimeVariableCacheUpdates (), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (CacheContext->SynchronizedBytes, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/// === TEST ENGINE ================================================================================
+
+/**
+  Main entry point to this unit test application.
+
+  Sets up and runs the test suites.
+**/
+VOID
+EFIAPI
+UnitTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Add all test suites and tests.
+  //
+  Status = CreateUnitTestSuite (&CacheTests, Framework, "Variable Runtime Cache Tests", "VarRuntimeCache", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for VarRuntimeCache\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (
+    CacheTests,
+    "An update should synchronize only the dirty bytes",
+    "DirtyBytes",
+    UpdateShouldSynchronizeOnlyDirtyBytes,
+    CreateTestCaches,
+    FreeTestCaches,
+    NULL
+    );
+  AddTestCase (
+    CacheTests,
+    "Updates should be deferred while the ReadLock is held",
+    "ReadLock",
+    ReadLockShouldDeferUpdates,
+    CreateTestCaches,
+    FreeTestCaches,
+    NULL
+    );
+  AddTestCase (
+    CacheTests,
+    "Too many dirty extents should merge the closest ones",
+    "ExtentOverflow",
+    TooManyExtentsShouldMergeClosest,
+    CreateTestCaches,
+    FreeTestCaches,
+    NULL
+    );
+  AddTestCase (
+    CacheTests,
+    "An invalid update should fail",
+    "InvalidUpdate",
+    InvalidUpdateShouldFail,
+    CreateTestCaches,
+    FreeTestCaches,
+    NULL
+    );
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestMain ();
+  return 0;
+}
@@ -0,0 +1,559 @@
+/** @file
+  This is a host-based unit test for the hash index used by FindVariableEx ()
+  to search a variable store.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "../VariableParsing.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "Variable Store Index Unit Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+/// === TEST DATA ==================================================================================
+
+#define TEST_STORE_SIZE      SIZE_128KB
+#define TEST_VARIABLE_COUNT  600
+#define TEST_NAME_LENGTH     16
+
+//
+// Test GUID 1 {7D2E6B1F-2C66-4F0B-9A3F-3B0D1C5E8A41}
+//
+EFI_GUID  mTestGuid1 = {
+  0x7d2e6b1f, 0x2c66, 0x4f0b, { 0x9a, 0x3f, 0x3b, 0x0d, 0x1c, 0x5e, 0x8a, 0x41 }
+};
+
+//
+// Test GUID 2 {E4A6C2B0-55D1-4C8E-8F0A-6C1B2D3E4F50}
+//
+EFI_GUID  mTestGuid2 = {
+  0xe4a6c2b0, 0x55d1, 0x4c8e, { 0x8f, 0x0a, 0x6c, 0x1b, 0x2d, 0x3e, 0x4f, 0x50 }
+};
+
+BOOLEAN                mAtRuntime;
+VARIABLE_STORE_HEADER  *mTestStore;
+UINTN                  mTestStoreOffset;
+
+/// === CODE UNDER TEST ===========================================================================
+
+/**
+  This function allows the caller to determine if UEFI ExitBootServices() has been called.
+
+  @retval TRUE   The test simulates a call at runtime.
+  @retval FALSE  The test simulates a call at boot time.
+
+**/
+BOOLEAN
+AtRuntime (
+  VOID
+  )
+{
+  return mAtRuntime;
+}
+
+/// === HELPER FUNCTIONS ===========================================================================
+
+/**
+  Append an authenticated variable to the test variable store.
+
+  @param[in]  Name        Name of the variable.
+  @param[in]  Guid        Vendor GUID of the variable.
+  @param[in]  Attributes  Attributes of the variable.
+  @param[in]  State       State of the variable.
+
+  @return Pointer to the header of the variable.
+**/
+STATIC
+VARIABLE_HEADER *
+AppendTestVariable (
+  IN CHAR16    *Name,
+  IN EFI_GUID  *Guid,
+  IN UINT32    Attributes,
+  IN UINT8     State
+  )
+{
+  AUTHENTICATED_VARIABLE_HEADER  *Variable;
+  UINTN                          NameSize;
+
+  NameSize = StrSize (Name);
+  Variable = (AUTHENTICATED_VARIABLE_HEADER *)((UINTN)mTestStore + mTestStoreOffset);
+  ZeroMem (Variable, sizeof (*Variable) + NameSize + sizeof (UINT32));
+  Variable->StartId    = VARIABLE_DATA;
+  Variable->State      = State;
+  Variable->Attributes = Attributes;
+  Variable->NameSize   = (UINT32)NameSize;
+  Variable->DataSize   = sizeof (UINT32);
+  CopyGuid (&Variable->VendorGuid, Guid);
+  CopyMem (Variable + 1, Name, NameSize);
+
+  mTestStoreOffset += HEADER_ALIGN (sizeof (*Variable) + NameSize + sizeof (UINT32));
+  return (VARIABLE_HEADER *)Variable;
+}
+
+/**
+  Get the name of a test variable.
+
+  @param[out]  Name   Buffer of TEST_NAME_LENGTH characters for the name.
+  @param[in]   Index  Index of the test variable.
+**/
+STATIC
+VOID
+GetTestVariableName (
+  OUT CHAR16  *Name,
+  IN  UINTN   Index
+  )
+{
+  CONST CHAR16  *Digits = L"0123456789ABCDEF";
+
+  StrCpyS (Name, TEST_NAME_LENGTH, L"Boot");
+  Name[4] = Digits[(Index >> 12) & 0xF];
+  Name[5] = Digits[(Index >> 8) & 0xF];
+  Name[6] = Digits[(Index >> 4) & 0xF];
+  Name[7] = Digits[Index & 0xF];
+  Name[8] = 0;
+}
+
+/**
+  Search the test variable store for a variable.
+
+  @param[in]   Name      Name of the variable.
+  @param[in]   Guid      Vendor GUID of the variable.
+  @param[out]  PtrTrack  The result of the search.
+
+  @retval EFI_SUCCESS    The variable is found.
+  @retval EFI_NOT_FOUND  The variable is not found.
+**/
+STATIC
+EFI_STATUS
+FindTestVariable (
+  IN  CHAR16                  *Name,
+  IN  EFI_GUID                *Guid,
+  OUT VARIABLE_POINTER_TRACK  *PtrTrack
+  )
+{
+  ZeroMem (PtrTrack, sizeof (*PtrTrack));
+  PtrTrack->StartPtr = GetStartPointer (mTestStore);
+  PtrTrack->EndPtr   = GetEndPointer (mTestStore);
+  return FindVariableEx (Name, Guid, FALSE, PtrTrack, TRUE);
+}
+
+/**
+  Create an empty authenticated variable store and reset the statistics.
+
+  @param[in]  Context  Unit test case context
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CreateTestStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mTestStore = AllocatePool (TEST_STORE_SIZE);
+  if (mTestStore == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  SetMem (mTestStore, TEST_STORE_SIZE, 0xFF);
+  CopyGuid (&mTestStore->Signature, &gEfiAuthenticatedVariableGuid);
+  mTestStore->Size   = TEST_STORE_SIZE;
+  mTestStore->Format = VARIABLE_STORE_FORMATTED;
+  mTestStore->State  = VARIABLE_STORE_HEALTHY;
+  mTestStoreOffset   = sizeof (VARIABLE_STORE_HEADER);
+  mAtRuntime         = FALSE;
+
+  mVariableStoreIndexEnabled = TRUE;
+  ZeroMem (&mVariableSearchStatistics, sizeof (mVariableSearchStatistics));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the test variable store and its index.
+
+  @param[in]  Context  Unit test case context
+**/
+STATIC
+VOID
+EFIAPI
+FreeTestStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  InvalidateVariableStoreIndex (mTestStore);
+  FreePool (mTestStore);
+  mTestStore = NULL;
+}
+
+/// === TEST CASES =================================================================================
+
+/**
+  Every variable of a large store is found through the index, comparing a
+  few variables per search where a walk of the store compares half of them
+  on average, and all of them when the variable is not found.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexedSearchShouldCompareFewVariables (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_HEADER         *Variables[TEST_VARIABLE_COUNT];
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  CHAR16                  Name[TEST_NAME_LENGTH];
+  UINTN                   Index;
+
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    GetTestVariableName (Name, Index);
+    Variables[Index] = AppendTestVariable (Name, (Index % 2 == 0) ? &mTestGuid1 : &mTestGuid2, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  }
+
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    GetTestVariableName (Name, Index);
+    UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (Name, (Index % 2 == 0) ? &mTestGuid1 : &mTestGuid2, &PtrTrack));
+    UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Variables[Index]);
+    UT_ASSERT_EQUAL ((UINTN)PtrTrack.InDeletedTransitionPtr, (UINTN)NULL);
+  }
+
+  //
+  // Same names with the other GUID, and unknown names
+  //
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    GetTestVariableName (Name, Index);
+    UT_ASSERT_STATUS_EQUAL (FindTestVariable (Name, (Index % 2 == 0) ? &mTestGuid2 : &mTestGuid1, &PtrTrack), EFI_NOT_FOUND);
+    GetTestVariableName (Name, Index + TEST_VARIABLE_COUNT);
+    UT_ASSERT_STATUS_EQUAL (FindTestVariable (Name, &mTestGuid1, &PtrTrack), EFI_NOT_FOUND);
+  }
+
+  UT_LOG_INFO (
+    "%Lu searches, %Lu through the index, %Lu variables compared\n",
+    mVariableSearchStatistics.Searches,
+    mVariableSearchStatistics.IndexedSearches,
+    mVariableSearchStatistics.VariablesCompared
+    );
+
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.Searches, 3 * TEST_VARIABLE_COUNT);
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.IndexedSearches, 3 * TEST_VARIABLE_COUNT);
+  UT_ASSERT_TRUE (mVariableSearchStatistics.VariablesCompared < 4 * mVariableSearchStatistics.Searches);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A variable being updated is found in the same state as with a walk of the
+  store: the ADDED copy and the IN_DELETED_TRANSITION copy that precedes it,
+  or the IN_DELETED_TRANSITION copy alone, and never a DELETED copy.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexedSearchShouldFollowVariableStates (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_HEADER         *Deleted;
+  VARIABLE_HEADER         *InDeleted;
+  VARIABLE_HEADER         *Added;
+  VARIABLE_POINTER_TRACK  PtrTrack;
+
+  Deleted   = AppendTestVariable (L"Timeout", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED & VAR_DELETED);
+  InDeleted = AppendTestVariable (L"Timeout", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED & VAR_IN_DELETED_TRANSITION);
+
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"Timeout", &mTestGuid1, &PtrTrack));
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)InDeleted);
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.InDeletedTransitionPtr, (UINTN)NULL);
+
+  //
+  // Variables appended after the index is built are found
+  //
+  Added = AppendTestVariable (L"Timeout", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"Timeout", &mTestGuid1, &PtrTrack));
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Added);
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.InDeletedTransitionPtr, (UINTN)InDeleted);
+
+  InDeleted->State &= VAR_DELETED;
+  Added->State     &= VAR_DELETED;
+  UT_ASSERT_STATUS_EQUAL (FindTestVariable (L"Timeout", &mTestGuid1, &PtrTrack), EFI_NOT_FOUND);
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)NULL);
+  UT_ASSERT_TRUE (Deleted->State != VAR_ADDED);
+
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.IndexedSearches, mVariableSearchStatistics.Searches);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Variables without EFI_VARIABLE_RUNTIME_ACCESS are not found at runtime,
+  unless the runtime check is ignored.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexedSearchShouldCheckRuntimeAccess (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_POINTER_TRACK  PtrTrack;
+
+  Variable = AppendTestVariable (L"SetupMode", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"SetupMode", &mTestGuid1, &PtrTrack));
+
+  mAtRuntime = TRUE;
+  UT_ASSERT_STATUS_EQUAL (FindTestVariable (L"SetupMode", &mTestGuid1, &PtrTrack), EFI_NOT_FOUND);
+
+  PtrTrack.StartPtr = GetStartPointer (mTestStore);
+  PtrTrack.EndPtr   = GetEndPointer (mTestStore);
+  UT_ASSERT_NOT_EFI_ERROR (FindVariableEx (L"SetupMode", &mTestGuid1, TRUE, &PtrTrack, TRUE));
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Variable);
+
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.IndexedSearches, 3);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Once a store is rewritten, as a reclaim does, its variables are found at
+  their new location after the index is invalidated.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InvalidatedIndexShouldBeRebuilt (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_POINTER_TRACK  PtrTrack;
+
+  AppendTestVariable (L"Lang", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED & VAR_DELETED);
+  AppendTestVariable (L"Boot0000", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"Boot0000", &mTestGuid1, &PtrTrack));
+
+  //
+  // Reclaim the deleted variable
+  //
+  SetMem (GetStartPointer (mTestStore), TEST_STORE_SIZE - sizeof (VARIABLE_STORE_HEADER), 0xFF);
+  mTestStoreOffset = sizeof (VARIABLE_STORE_HEADER);
+  Variable         = AppendTestVariable (L"Boot0000", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  InvalidateVariableStoreIndex (mTestStore);
+
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"Boot0000", &mTestGuid1, &PtrTrack));
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Variable);
+  UT_ASSERT_STATUS_EQUAL (FindTestVariable (L"Lang", &mTestGuid1, &PtrTrack), EFI_NOT_FOUND);
+
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.IndexedSearches, 3);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A store with a variable name that is not terminated by its only null
+  character is walked, so the search gives the same result as without index.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MalformedNameShouldDisableIndex (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  AUTHENTICATED_VARIABLE_HEADER  *Malformed;
+  VARIABLE_HEADER                *Variable;
+  VARIABLE_POINTER_TRACK         PtrTrack;
+
+  Variable  = AppendTestVariable (L"PK", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  Malformed = (AUTHENTICATED_VARIABLE_HEADER *)AppendTestVariable (L"KEK", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  Malformed->NameSize -= sizeof (CHAR16);
+
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"PK", &mTestGuid1, &PtrTrack));
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Variable);
+
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.Searches, 1);
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.IndexedSearches, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  When the index is disabled, as for runtime caches that the MM variable
+  driver updates without reporting it, a store rewritten without invalidating
+  its index is walked and its variables are found at their new location.
+
+  @param[in]  Context  Unit test case context
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DisabledIndexShouldWalkStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_POINTER_TRACK  PtrTrack;
+
+  mVariableStoreIndexEnabled = FALSE;
+
+  AppendTestVariable (L"Lang", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED & VAR_DELETED);
+  AppendTestVariable (L"Boot0000", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"Boot0000", &mTestGuid1, &PtrTrack));
+
+  SetMem (GetStartPointer (mTestStore), TEST_STORE_SIZE - sizeof (VARIABLE_STORE_HEADER), 0xFF);
+  mTestStoreOffset = sizeof (VARIABLE_STORE_HEADER);
+  Variable         = AppendTestVariable (L"Boot0000", &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+
+  UT_ASSERT_NOT_EFI_ERROR (FindTestVariable (L"Boot0000", &mTestGuid1, &PtrTrack));
+  UT_ASSERT_EQUAL ((UINTN)PtrTrack.CurrPtr, (UINTN)Variable);
+
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.Searches, 2);
+  UT_ASSERT_EQUAL (mVariableSearchStatistics.IndexedSearches, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/// === TEST ENGINE ================================================================================
+
+/**
+  Main entry point to this unit test application.
+
+  Sets up and runs the test suites.
+**/
+VOID
+EFIAPI
+UnitTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Add all test suites and tests.
+  //
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "Variable Store Index Tests", "VarIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for VarIndex\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (
+    IndexTests,
+    "Searching a large store through the index should compare few variables",
+    "LookupCount",
+    IndexedSearchShouldCompareFewVariables,
+    CreateTestStore,
+    FreeTestStore,
+    NULL
+    );
+  AddTestCase (
+    IndexTests,
+    "Searching through the index should follow the variable states",
+    "States",
+    IndexedSearchShouldFollowVariableStates,
+    CreateTestStore,
+    FreeTestStore,
+    NULL
+    );
+  AddTestCase (
+    IndexTests,
+    "Searching through the index should check the runtime access",
+    "RuntimeAccess",
+    IndexedSearchShouldCheckRuntimeAccess,
+    CreateTestStore,
+    FreeTestStore,
+    NULL
+    );
+  AddTestCase (
+    IndexTests,
+    "An invalidated index should be rebuilt",
+    "Invalidate",
+    InvalidatedIndexShouldBeRebuilt,
+    CreateTestStore,
+    FreeTestStore,
+    NULL
+    );
+  AddTestCase (
+    IndexTests,
+    "A malformed variable name should disable the index",
+    "MalformedName",
+    MalformedNameShouldDisableIndex,
+    CreateTestStore,
+    FreeTestStore,
+    NULL
+    );
+  AddTestCase (
+    IndexTests,
+    "A disabled index should walk the store",
+    "Disabled",
+    DisabledIndexShouldWalkStore,
+    CreateTestStore,
+    FreeTestStore,
+    NULL
+    );
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestMain ();
+  return 0;
+}
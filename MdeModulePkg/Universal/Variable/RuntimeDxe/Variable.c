@@ -341,8 +341,8 @@ RecordVarErrorFlag (
       *VarErrFlag = TempFlag;
       Status      =  SynchronizeRuntimeVariableCache (
                        &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
-                       0,
-                       mNvVariableCache->Size
+                       (UINTN)VarErrFlag - (UINTN)mNvVariableCache,
+                       sizeof (TempFlag)
                        );
       ASSERT_EFI_ERROR (Status);
     }
@@ -792,6 +792,15 @@ Reclaim (
   }
 
 Done:
+  //
+  // The variables of the store, and of the NV variable cache used as buffer,
+  // have been rewritten, so their hash indexes are stale.
+  //
+  InvalidateVariableStoreIndex (VariableStoreHeader);
+  if (!IsVolatile) {
+    InvalidateVariableStoreIndex (mNvVariableCache);
+  }
+
   DoneStatus = EFI_SUCCESS;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     DoneStatus = SynchronizeRuntimeVariableCache (
@@ -1656,6 +1665,40 @@ AutoUpdateLangVariable (
   }
 }
 
+/**
+  Adds the State field of a variable to the pending updates of a runtime variable cache.
+
+  @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache of the variable store.
+  @param[in] VariableStore        The variable store the runtime cache is a copy of.
+  @param[in] Variable             The variable whose State changed. Nothing is added if it is NULL
+                                  or not in the variable store.
+
+**/
+STATIC
+VOID
+AddRuntimeVariableCacheStateUpdate (
+  IN VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN VARIABLE_STORE_HEADER   *VariableStore,
+  IN VARIABLE_HEADER         *Variable
+  )
+{
+  EFI_STATUS  Status;
+
+  if ((Variable == NULL) ||
+      ((UINTN)Variable < (UINTN)VariableStore) ||
+      ((UINTN)Variable >= (UINTN)VariableStore + VariableStore->Size))
+  {
+    return;
+  }
+
+  Status = AddPendingRuntimeVariableCacheUpdate (
+             VariableRuntimeCache,
+             (UINTN)&Variable->State - (UINTN)VariableStore,
+             sizeof (Variable->State)
+             );
+  ASSERT_EFI_ERROR (Status);
+}
+
 /**
   Update the variable region with Variable information. If EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS is set,
   index of associated public key is needed.
@@ -1702,6 +1745,9 @@ UpdateVariable (
   VARIABLE_POINTER_TRACK              NvVariable;
   VARIABLE_STORE_HEADER               *VariableStoreHeader;
   VARIABLE_RUNTIME_CACHE              *VolatileCacheInstance;
+  VARIABLE_STORE_HEADER               *CacheStore;
+  UINTN                               NewVariableOffset;
+  UINTN                               NewVariableSize;
   UINT8                               *BufferForMerge;
   UINTN                               MergedBufSize;
   BOOLEAN                             DataReady;
@@ -1795,7 +1841,9 @@ UpdateVariable (
   NextVariable = GetEndPointer ((VARIABLE_STORE_HEADER *)((UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase));
   ScratchSize  = mVariableModuleGlobal->ScratchBufferSize;
   SetMem (NextVariable, ScratchSize, 0xff);
-  DataReady = FALSE;
+  DataReady         = FALSE;
+  NewVariableOffset = 0;
+  NewVariableSize   = 0;
 
   if (Variable->CurrPtr != NULL) {
     //
@@ -2231,6 +2279,8 @@ UpdateVariable (
       }
     }
 
+    NewVariableOffset                                     = mVariableModuleGlobal->NonVolatileLastVariableOffset;
+    NewVariableSize                                       = VarSize;
     mVariableModuleGlobal->NonVolatileLastVariableOffset += HEADER_ALIGN (VarSize);
 
     if ((Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) != 0) {
@@ -2291,6 +2341,8 @@ UpdateVariable (
       goto Done;
     }
 
+    NewVariableOffset                                  = mVariableModuleGlobal->VolatileLastVariableOffset;
+    NewVariableSize                                    = VarSize;
     mVariableModuleGlobal->VolatileLastVariableOffset += HEADER_ALIGN (VarSize);
   }
 
@@ -2352,15 +2404,23 @@ Done:
   if (!EFI_ERROR (Status)) {
     if (((Variable->CurrPtr != NULL) && !Variable->Volatile) || ((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0)) {
       VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache);
+      CacheStore            = mNvVariableCache;
     } else {
       VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache);
+      CacheStore            = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
     }
 
     if (VolatileCacheInstance->Store != NULL) {
+      //
+      // Only the State of the old variable and the new variable have changed
+      // in the variable store, a reclaim synchronizes the whole store itself.
+      //
+      AddRuntimeVariableCacheStateUpdate (VolatileCacheInstance, CacheStore, CacheVariable->CurrPtr);
+      AddRuntimeVariableCacheStateUpdate (VolatileCacheInstance, CacheStore, CacheVariable->InDeletedTransitionPtr);
       Status =  SynchronizeRuntimeVariableCache (
                   VolatileCacheInstance,
-                  0,
-                  VolatileCacheInstance->Store->Size
+                  NewVariableOffset,
+                  NewVariableSize
                   );
       ASSERT_EFI_ERROR (Status);
     }
@@ -3397,6 +3457,7 @@ FlushHobVariableToFlash (
         *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.HobFlushComplete) = TRUE;
       }
 
+      InvalidateVariableStoreIndex (VariableStoreHeader);
       if (!AtRuntime ()) {
         FreePool ((VOID *)VariableStoreHeader);
       }
@@ -61,16 +61,29 @@ typedef enum {
   VariableStoreTypeMax
 } VARIABLE_STORE_TYPE;
 
+///
+/// The maximum number of dirty extents tracked per runtime cache. When more
+/// extents are dirty, the closest ones are merged.
+///
+#define VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS  8
+
+typedef struct {
+  UINT32    Offset;
+  UINT32    Length;
+} VARIABLE_RUNTIME_CACHE_EXTENT;
+
 typedef struct {
-  UINT32                   PendingUpdateOffset;
-  UINT32                   PendingUpdateLength;
-  VARIABLE_STORE_HEADER    *Store;
+  UINT32                           DirtyExtentCount;
+  VARIABLE_RUNTIME_CACHE_EXTENT    DirtyExtent[VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS];
+  VARIABLE_STORE_HEADER            *Store;
 } VARIABLE_RUNTIME_CACHE;
 
 typedef struct {
   BOOLEAN                   *ReadLock;
   BOOLEAN                   *PendingUpdate;
   BOOLEAN                   *HobFlushComplete;
+  UINT32                    *UpdateCount;
+  UINT64                    SynchronizedBytes; ///< Bytes copied to the runtime caches.
   VARIABLE_RUNTIME_CACHE    VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeVolatileCache;
@@ -142,6 +155,8 @@ FlushHobVariableToFlash (
   This function writes a buffer to variable storage space into a firmware
   volume block device. The destination is specified by the parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
+  Only the blocks of the variable storage space whose content changes are
+  written.
 
   @param  VariableBase   Base address of the variable to write.
   @param  VariableBuffer Point to the variable data buffer.
@@ -705,12 +720,13 @@ InitializeVariableQuota (
   VOID
   );
 
-extern VARIABLE_MODULE_GLOBAL      *mVariableModuleGlobal;
-extern EFI_FIRMWARE_VOLUME_HEADER  *mNvFvHeaderCache;
-extern VARIABLE_STORE_HEADER       *mNvVariableCache;
-extern VARIABLE_INFO_ENTRY         *gVariableInfo;
-extern BOOLEAN                     mEndOfDxe;
-extern VAR_CHECK_REQUEST_SOURCE    mRequestSource;
+extern VARIABLE_MODULE_GLOBAL       *mVariableModuleGlobal;
+extern EFI_FIRMWARE_VOLUME_HEADER   *mNvFvHeaderCache;
+extern VARIABLE_STORE_HEADER        *mNvVariableCache;
+extern VARIABLE_INFO_ENTRY          *gVariableInfo;
+extern VARIABLE_RECLAIM_STATISTICS  mVariableReclaimStatistics;
+extern BOOLEAN                      mEndOfDxe;
+extern VAR_CHECK_REQUEST_SOURCE     mRequestSource;
 
 extern AUTH_VAR_LIB_CONTEXT_OUT  mAuthContextOut;
 
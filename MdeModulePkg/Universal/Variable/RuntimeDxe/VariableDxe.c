@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "Variable.h"
+#include "VariableParsing.h"
 
 #include <Protocol/VariablePolicy.h>
 #include <Library/VariablePolicyLib.h>
@@ -268,6 +269,11 @@ VariableClassAddressChangeEvent (
   EfiConvertPointer (0x0, (VOID **)&mNvVariableCache);
   EfiConvertPointer (0x0, (VOID **)&mNvFvHeaderCache);
 
+  for (Index = 0; Index < VARIABLE_STORE_INDEX_COUNT; Index++) {
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableStoreIndex[Index].StartPtr);
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableStoreIndex[Index].Slot);
+  }
+
   if (mAuthContextOut.AddressPointer != NULL) {
     for (Index = 0; Index < mAuthContextOut.AddressPointerCount; Index++) {
       EfiConvertPointer (0x0, (VOID **)mAuthContextOut.AddressPointer[Index]);
@@ -324,6 +330,8 @@ OnReadyToBoot (
     } else {
       gBS->InstallConfigurationTable (&gEfiVariableGuid, gVariableInfo);
     }
+
+    gBS->InstallConfigurationTable (&gEdkiiVariableReclaimStatisticsGuid, &mVariableReclaimStatistics);
   }
 
   gBS->CloseEvent (Event);
@@ -9,6 +9,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "VariableParsing.h"
 
+//
+// Bytes of variable store per slot of a hash index. Variables are larger than
+// that in practice, so the indexes are at most 3/4 full and searches probe few
+// slots. An index that gets fuller is disabled until its store is reclaimed.
+//
+#define VARIABLE_STORE_BYTES_PER_INDEX_SLOT  64
+#define VARIABLE_STORE_INDEX_MIN_SLOT_COUNT  16
+
+VARIABLE_STORE_INDEX        mVariableStoreIndex[VARIABLE_STORE_INDEX_COUNT];
+VARIABLE_SEARCH_STATISTICS  mVariableSearchStatistics;
+
+//
+// FALSE when the variable stores may change without InvalidateVariableStoreIndex ()
+// being called, so that every search walks the store.
+//
+BOOLEAN  mVariableStoreIndexEnabled = TRUE;
+
 /**
 
   This code checks if variable header is valid or not.
@@ -445,6 +462,315 @@ VariableCompareTimeStampInternal (
   return (BOOLEAN)(FirstTime->Second <= SecondTime->Second);
 }
 
+/**
+  Get the hash value of the vendor GUID and the name of a variable.
+
+  @param[in]  VendorGuid  Vendor GUID of the variable.
+  @param[in]  Name        Name of the variable.
+  @param[in]  NameSize    Size of the name in bytes, including the terminator.
+
+  @return The hash value.
+
+**/
+STATIC
+UINT32
+GetVariableIndexHash (
+  IN CONST EFI_GUID  *VendorGuid,
+  IN CONST CHAR16    *Name,
+  IN UINTN           NameSize
+  )
+{
+  CONST UINT8  *Bytes;
+  UINT32       Hash;
+  UINTN        Index;
+
+  //
+  // FNV-1a of the GUID and the name, followed by the MurmurHash3 finalizer
+  // to spread the entropy to the low bits used as slot index.
+  //
+  Hash  = 0x811C9DC5;
+  Bytes = (CONST UINT8 *)VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  Bytes = (CONST UINT8 *)Name;
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  Hash ^= Hash >> 16;
+  Hash *= 0x85EBCA6B;
+  Hash ^= Hash >> 13;
+  Hash *= 0xC2B2AE35;
+  Hash ^= Hash >> 16;
+  return Hash;
+}
+
+/**
+  Add the variables appended to a variable store since the last search to its
+  hash index.
+
+  The index is disabled if it gets too full, or if a variable that can be found
+  by a search has a name that is not terminated by its only null character, as
+  only a walk of the store finds it then.
+
+  @param[in, out]  StoreIndex  The hash index of the variable store.
+  @param[in]       AuthFormat  TRUE indicates authenticated variables are used.
+                               FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+UpdateVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     BOOLEAN               AuthFormat
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *EndPtr;
+  CHAR16           *Name;
+  UINTN            NameSize;
+  UINTN            Length;
+  UINT32           SlotIndex;
+
+  EndPtr   = (VARIABLE_HEADER *)((UINTN)StoreIndex->StartPtr + StoreIndex->StoreSize);
+  Variable = (VARIABLE_HEADER *)((UINTN)StoreIndex->StartPtr + StoreIndex->IndexedSize);
+
+  while (!StoreIndex->Disabled && IsValidVariableHeader (Variable, EndPtr)) {
+    Name     = GetVariableNamePtr (Variable, AuthFormat);
+    NameSize = NameSizeOfVariable (Variable, AuthFormat);
+    Length   = 0;
+    if ((NameSize >= sizeof (CHAR16)) && ((NameSize % sizeof (CHAR16)) == 0) &&
+        ((UINTN)Name + NameSize <= (UINTN)EndPtr))
+    {
+      while ((Length < NameSize / sizeof (CHAR16)) && (Name[Length] != 0)) {
+        Length++;
+      }
+
+      Length++;
+    }
+
+    if ((Length != 0) && (Length * sizeof (CHAR16) == NameSize)) {
+      SlotIndex = GetVariableIndexHash (GetVendorGuidPtr (Variable, AuthFormat), Name, NameSize) & (StoreIndex->SlotCount - 1);
+      while (StoreIndex->Slot[SlotIndex] != 0) {
+        SlotIndex = (SlotIndex + 1) & (StoreIndex->SlotCount - 1);
+      }
+
+      StoreIndex->Slot[SlotIndex] = (UINT32)((UINTN)Variable - (UINTN)StoreIndex->StartPtr) + 1;
+      StoreIndex->EntryCount++;
+      if (StoreIndex->EntryCount > StoreIndex->SlotCount / 4 * 3) {
+        StoreIndex->Disabled = TRUE;
+      }
+    } else if ((Variable->State == VAR_ADDED) || (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED))) {
+      StoreIndex->Disabled = TRUE;
+    }
+
+    Variable = GetNextVariablePtr (Variable, AuthFormat);
+  }
+
+  if (!StoreIndex->Disabled) {
+    StoreIndex->IndexedSize = (UINTN)Variable - (UINTN)StoreIndex->StartPtr;
+  }
+}
+
+/**
+  Get the hash index of a variable store, creating it at the first search of
+  the store, and bring it up to date with the variables of the store.
+
+  @param[in]  StartPtr    Pointer to the first variable of the store.
+  @param[in]  EndPtr      Pointer to the end of the store.
+  @param[in]  AuthFormat  TRUE indicates authenticated variables are used.
+                          FALSE indicates authenticated variables are not used.
+
+  @return The hash index of the variable store, or NULL if the store has to
+          be walked.
+
+**/
+STATIC
+VARIABLE_STORE_INDEX *
+GetVariableStoreIndex (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN VARIABLE_HEADER  *EndPtr,
+  IN BOOLEAN          AuthFormat
+  )
+{
+  VARIABLE_STORE_INDEX  *StoreIndex;
+  VARIABLE_STORE_INDEX  *FreeIndex;
+  UINTN                 StoreSize;
+  UINTN                 Index;
+  UINT32                SlotCount;
+
+  if (!mVariableStoreIndexEnabled) {
+    return NULL;
+  }
+
+  if ((StartPtr == NULL) || ((UINTN)EndPtr <= (UINTN)StartPtr) || ((UINTN)EndPtr - (UINTN)StartPtr > MAX_UINT32)) {
+    return NULL;
+  }
+
+  StoreSize  = (UINTN)EndPtr - (UINTN)StartPtr;
+  StoreIndex = NULL;
+  FreeIndex  = NULL;
+  for (Index = 0; Index < VARIABLE_STORE_INDEX_COUNT; Index++) {
+    if ((mVariableStoreIndex[Index].StartPtr == StartPtr) && (mVariableStoreIndex[Index].StoreSize == StoreSize)) {
+      StoreIndex = &mVariableStoreIndex[Index];
+      break;
+    }
+
+    if ((mVariableStoreIndex[Index].StartPtr == NULL) &&
+        ((FreeIndex == NULL) || ((FreeIndex->Slot == NULL) && (mVariableStoreIndex[Index].Slot != NULL))))
+    {
+      FreeIndex = &mVariableStoreIndex[Index];
+    }
+  }
+
+  if (StoreIndex == NULL) {
+    if (FreeIndex == NULL) {
+      return NULL;
+    }
+
+    if (FreeIndex->Slot == NULL) {
+      //
+      // The index must be allocated before runtime, its slots are reused by
+      // the indexes built at runtime.
+      //
+      if (AtRuntime ()) {
+        return NULL;
+      }
+
+      SlotCount = GetPowerOfTwo32 ((UINT32)(StoreSize / VARIABLE_STORE_BYTES_PER_INDEX_SLOT));
+      SlotCount = MAX (SlotCount, VARIABLE_STORE_INDEX_MIN_SLOT_COUNT);
+      FreeIndex->Slot = AllocateRuntimeZeroPool (SlotCount * sizeof (UINT32));
+      if (FreeIndex->Slot == NULL) {
+        return NULL;
+      }
+
+      FreeIndex->SlotCount = SlotCount;
+    }
+
+    StoreIndex              = FreeIndex;
+    StoreIndex->StartPtr    = StartPtr;
+    StoreIndex->StoreSize   = StoreSize;
+    StoreIndex->IndexedSize = 0;
+    StoreIndex->EntryCount  = 0;
+    StoreIndex->Disabled    = FALSE;
+  }
+
+  UpdateVariableStoreIndex (StoreIndex, AuthFormat);
+  if (StoreIndex->Disabled) {
+    return NULL;
+  }
+
+  return StoreIndex;
+}
+
+/**
+  Discard the hash index of a variable store.
+
+  This must be called when the variables of the store are rewritten rather
+  than appended, e.g. after a reclaim, and when the store is freed.
+
+  @param[in]  VariableStore  Pointer to the variable store header.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  IN VARIABLE_STORE_HEADER  *VariableStore
+  )
+{
+  VARIABLE_HEADER  *StartPtr;
+  UINTN            Index;
+
+  if (VariableStore == NULL) {
+    return;
+  }
+
+  StartPtr = GetStartPointer (VariableStore);
+  for (Index = 0; Index < VARIABLE_STORE_INDEX_COUNT; Index++) {
+    if (mVariableStoreIndex[Index].StartPtr == StartPtr) {
+      ZeroMem (mVariableStoreIndex[Index].Slot, mVariableStoreIndex[Index].SlotCount * sizeof (UINT32));
+      mVariableStoreIndex[Index].StartPtr    = NULL;
+      mVariableStoreIndex[Index].StoreSize   = 0;
+      mVariableStoreIndex[Index].IndexedSize = 0;
+      mVariableStoreIndex[Index].EntryCount  = 0;
+      mVariableStoreIndex[Index].Disabled    = FALSE;
+    }
+  }
+}
+
+/**
+  Find the variable in the hash index of a variable store.
+
+  The variables with the name and GUID searched are found in the order of the
+  store, so the result is the same as the one of a walk of the store.
+
+  @param[in]       StoreIndex          The hash index of the variable store.
+  @param[in]       VariableName        Name of the variable to be found.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+STATIC
+EFI_STATUS
+FindVariableInStoreIndex (
+  IN     VARIABLE_STORE_INDEX    *StoreIndex,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *InDeletedVariable;
+  UINTN            NameSize;
+  UINT32           SlotIndex;
+
+  mVariableSearchStatistics.IndexedSearches++;
+
+  NameSize          = StrSize (VariableName);
+  InDeletedVariable = NULL;
+
+  for (SlotIndex = GetVariableIndexHash (VendorGuid, VariableName, NameSize) & (StoreIndex->SlotCount - 1);
+       StoreIndex->Slot[SlotIndex] != 0;
+       SlotIndex = (SlotIndex + 1) & (StoreIndex->SlotCount - 1)
+       )
+  {
+    Variable = (VARIABLE_HEADER *)((UINTN)StoreIndex->StartPtr + StoreIndex->Slot[SlotIndex] - 1);
+    if ((Variable->State != VAR_ADDED) && (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED))) {
+      continue;
+    }
+
+    if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+      continue;
+    }
+
+    mVariableSearchStatistics.VariablesCompared++;
+    if ((NameSizeOfVariable (Variable, AuthFormat) == NameSize) &&
+        CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) &&
+        (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSize) == 0))
+    {
+      if (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+        InDeletedVariable = Variable;
+      } else {
+        PtrTrack->CurrPtr                = Variable;
+        PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  PtrTrack->CurrPtr = InDeletedVariable;
+  return (PtrTrack->CurrPtr  == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
 /**
   Find the variable in the specified variable store.
 
@@ -468,11 +794,20 @@ FindVariableEx (
   IN     BOOLEAN                 AuthFormat
   )
 {
-  VARIABLE_HEADER  *InDeletedVariable;
-  VOID             *Point;
+  VARIABLE_HEADER       *InDeletedVariable;
+  VOID                  *Point;
+  VARIABLE_STORE_INDEX  *StoreIndex;
 
   PtrTrack->InDeletedTransitionPtr = NULL;
 
+  if (VariableName[0] != 0) {
+    mVariableSearchStatistics.Searches++;
+    StoreIndex = GetVariableStoreIndex (PtrTrack->StartPtr, PtrTrack->EndPtr, AuthFormat);
+    if (StoreIndex != NULL) {
+      return FindVariableInStoreIndex (StoreIndex, VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    }
+  }
+
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
@@ -496,6 +831,7 @@ FindVariableEx (
             return EFI_SUCCESS;
           }
         } else {
+          mVariableSearchStatistics.VariablesCompared++;
           if (CompareGuid (VendorGuid, GetVendorGuidPtr (PtrTrack->CurrPtr, AuthFormat))) {
             Point = (VOID *)GetVariableNamePtr (PtrTrack->CurrPtr, AuthFormat);
 
@@ -13,6 +13,46 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/ImageAuthentication.h>
 #include "Variable.h"
 
+///
+/// Number of variable stores that can have a hash index at the same time:
+/// the HOB, volatile and non-volatile variable stores, or their runtime
+/// caches, and a spare one.
+///
+#define VARIABLE_STORE_INDEX_COUNT  4
+
+///
+/// Hash index of the variables of a variable store, keyed on the vendor GUID
+/// and the name of the variables.
+///
+/// Variables are only appended to a variable store until it is reclaimed, so
+/// the variables appended since the last search are added to the index by the
+/// next search, and the index is only rebuilt after the store is rewritten.
+/// Deleted variables are kept in the index; searches check the state of the
+/// variables they find as a walk of the store does.
+///
+typedef struct {
+  VARIABLE_HEADER    *StartPtr;     ///< First variable of the store, NULL if the index is free.
+  UINTN              StoreSize;     ///< Size of the variables area of the store.
+  UINTN              IndexedSize;   ///< Size of the variables already in the index.
+  UINT32             SlotCount;     ///< Number of slots, a power of two.
+  UINT32             EntryCount;    ///< Number of used slots.
+  BOOLEAN            Disabled;      ///< Searches walk the store, as the index is full or a name is malformed.
+  UINT32             *Slot;         ///< Offset + 1 of the variables from StartPtr, 0 for a free slot.
+} VARIABLE_STORE_INDEX;
+
+///
+/// Statistics of the variable searches done by FindVariableEx ().
+///
+typedef struct {
+  UINT64    Searches;           ///< Searches for a variable by name.
+  UINT64    IndexedSearches;    ///< Searches done through a hash index.
+  UINT64    VariablesCompared;  ///< Variables compared with the name and GUID searched.
+} VARIABLE_SEARCH_STATISTICS;
+
+extern VARIABLE_STORE_INDEX        mVariableStoreIndex[VARIABLE_STORE_INDEX_COUNT];
+extern VARIABLE_SEARCH_STATISTICS  mVariableSearchStatistics;
+extern BOOLEAN                     mVariableStoreIndexEnabled;
+
 /**
 
   This code checks if variable header is valid or not.
@@ -280,6 +320,20 @@ FindVariableEx (
   IN     BOOLEAN                 AuthFormat
   );
 
+/**
+  Discard the hash index of a variable store.
+
+  This must be called when the variables of the store are rewritten rather
+  than appended, e.g. after a reclaim, and when the store is freed.
+
+  @param[in]  VariableStore  Pointer to the variable store header.
+
+**/
+VOID
+InvalidateVariableStoreIndex (
+  IN VARIABLE_STORE_HEADER  *VariableStore
+  );
+
 /**
   This code finds the next available variable.
 
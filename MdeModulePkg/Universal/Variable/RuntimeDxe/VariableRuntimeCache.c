@@ -18,6 +18,36 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 extern VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
 extern VARIABLE_STORE_HEADER   *mNvVariableCache;
 
+/**
+  Copies the dirty extents of a runtime variable cache from its variable store.
+
+  @param[in, out] VariableRuntimeCache  Variable runtime cache structure for the runtime cache being flushed.
+  @param[in]      VariableStore         The variable store the runtime cache is a copy of.
+
+**/
+STATIC
+VOID
+FlushRuntimeVariableCacheExtents (
+  IN OUT VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN     VARIABLE_STORE_HEADER   *VariableStore
+  )
+{
+  VARIABLE_RUNTIME_CACHE_EXTENT  *Extent;
+  UINT32                         Index;
+
+  for (Index = 0; Index < VariableRuntimeCache->DirtyExtentCount; Index++) {
+    Extent = &VariableRuntimeCache->DirtyExtent[Index];
+    CopyMem (
+      (UINT8 *)VariableRuntimeCache->Store + Extent->Offset,
+      (UINT8 *)VariableStore + Extent->Offset,
+      Extent->Length
+      );
+    mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.SynchronizedBytes += Extent->Length;
+  }
+
+  VariableRuntimeCache->DirtyExtentCount = 0;
+}
+
 /**
   Copies any pending updates to runtime variable caches.
 
@@ -45,78 +75,63 @@ FlushPendingRuntimeVariableCacheUpdates (
     if ((VariableRuntimeCacheContext->VariableRuntimeHobCache.Store != NULL) &&
         (mVariableModuleGlobal->VariableGlobal.HobVariableBase > 0))
     {
-      CopyMem (
-        (VOID *)(
-                 ((UINT8 *)(UINTN)VariableRuntimeCacheContext->VariableRuntimeHobCache.Store) +
-                 VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset
-                 ),
-        (VOID *)(
-                 ((UINT8 *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase) +
-                 VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset
-                 ),
-        VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateLength
+      FlushRuntimeVariableCacheExtents (
+        &VariableRuntimeCacheContext->VariableRuntimeHobCache,
+        (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase
         );
-      VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateLength = 0;
-      VariableRuntimeCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
     }
 
-    CopyMem (
-      (VOID *)(
-               ((UINT8 *)(UINTN)VariableRuntimeCacheContext->VariableRuntimeNvCache.Store) +
-               VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset
-               ),
-      (VOID *)(
-               ((UINT8 *)(UINTN)mNvVariableCache) +
-               VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset
-               ),
-      VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateLength
+    FlushRuntimeVariableCacheExtents (
+      &VariableRuntimeCacheContext->VariableRuntimeNvCache,
+      mNvVariableCache
       );
-    VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateLength = 0;
-    VariableRuntimeCacheContext->VariableRuntimeNvCache.PendingUpdateOffset = 0;
-
-    CopyMem (
-      (VOID *)(
-               ((UINT8 *)(UINTN)VariableRuntimeCacheContext->VariableRuntimeVolatileCache.Store) +
-               VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset
-               ),
-      (VOID *)(
-               ((UINT8 *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase) +
-               VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset
-               ),
-      VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength
+    FlushRuntimeVariableCacheExtents (
+      &VariableRuntimeCacheContext->VariableRuntimeVolatileCache,
+      (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase
       );
-    VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = 0;
-    VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
-    *(VariableRuntimeCacheContext->PendingUpdate)                                 = FALSE;
+    *(VariableRuntimeCacheContext->PendingUpdate) = FALSE;
+
+    //
+    // Let the runtime DXE driver know that the hash indexes of its runtime
+    // caches may be stale.
+    //
+    if (VariableRuntimeCacheContext->UpdateCount != NULL) {
+      (*(VariableRuntimeCacheContext->UpdateCount))++;
+    }
   }
 
   return EFI_SUCCESS;
 }
 
 /**
-  Synchronizes the runtime variable caches with all pending updates outside runtime.
+  Adds an update to the pending updates of a runtime variable cache, without copying it to the runtime cache.
 
-  Ensures all conditions are met to maintain coherency for runtime cache updates. This function will attempt
-  to write the given update (and any other pending updates) if the ReadLock is available. Otherwise, the
-  update is added as a pending update for the given variable store and it will be flushed to the runtime cache
-  at the next opportunity the ReadLock is available.
+  The update is added to the dirty extents of the runtime cache, merged with the dirty extents it overlaps or
+  touches. When all the dirty extents are used, the update is merged with the closest dirty extent.
 
-  @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being synchronized.
+  @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being updated.
   @param[in] Offset               Offset in bytes to apply the update.
   @param[in] Length               Length of data in bytes of the update.
 
-  @retval EFI_SUCCESS             The update was added as a pending update successfully. If the variable runtime
-                                  cache ReadLock was available, the runtime cache was updated successfully.
+  @retval EFI_SUCCESS             The update was added as a pending update successfully.
+  @retval EFI_INVALID_PARAMETER   VariableRuntimeCache is NULL, or the update is beyond 4 GB.
   @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
 
 **/
 EFI_STATUS
-SynchronizeRuntimeVariableCache (
+AddPendingRuntimeVariableCacheUpdate (
   IN  VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
   IN  UINTN                   Offset,
   IN  UINTN                   Length
   )
 {
+  VARIABLE_RUNTIME_CACHE_EXTENT  *Extent;
+  UINTN                          End;
+  UINTN                          Gap;
+  UINTN                          ClosestGap;
+  UINT32                         Closest;
+  UINT32                         Index;
+
   if (VariableRuntimeCache == NULL) {
     return EFI_INVALID_PARAMETER;
   } else if (VariableRuntimeCache->Store == NULL) {
@@ -131,25 +146,101 @@ SynchronizeRuntimeVariableCache (
     return EFI_UNSUPPORTED;
   }
 
-  if (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) &&
-      (VariableRuntimeCache->PendingUpdateLength > 0))
-  {
-    VariableRuntimeCache->PendingUpdateLength =
-      (UINT32)(
-               MAX (
-                 (UINTN)(VariableRuntimeCache->PendingUpdateOffset + VariableRuntimeCache->PendingUpdateLength),
-                 Offset + Length
-                 ) - MIN ((UINTN)VariableRuntimeCache->PendingUpdateOffset, Offset)
-               );
-    VariableRuntimeCache->PendingUpdateOffset =
-      (UINT32)MIN ((UINTN)VariableRuntimeCache->PendingUpdateOffset, Offset);
-  } else {
-    VariableRuntimeCache->PendingUpdateLength = (UINT32)Length;
-    VariableRuntimeCache->PendingUpdateOffset = (UINT32)Offset;
+  if ((Offset > MAX_UINT32) || (Length > MAX_UINT32 - Offset)) {
+    return EFI_INVALID_PARAMETER;
   }
 
+  if (!*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate)) {
+    VariableRuntimeCache->DirtyExtentCount = 0;
+  }
+
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Merge the dirty extents that overlap or touch the update.
+  //
+  End   = Offset + Length;
+  Index = 0;
+  while (Index < VariableRuntimeCache->DirtyExtentCount) {
+    Extent = &VariableRuntimeCache->DirtyExtent[Index];
+    if ((Extent->Offset <= End) && (Offset <= (UINTN)Extent->Offset + Extent->Length)) {
+      End    = MAX (End, (UINTN)Extent->Offset + Extent->Length);
+      Offset = MIN (Offset, (UINTN)Extent->Offset);
+      VariableRuntimeCache->DirtyExtentCount--;
+      Extent->Offset = VariableRuntimeCache->DirtyExtent[VariableRuntimeCache->DirtyExtentCount].Offset;
+      Extent->Length = VariableRuntimeCache->DirtyExtent[VariableRuntimeCache->DirtyExtentCount].Length;
+    } else {
+      Index++;
+    }
+  }
+
+  //
+  // Merge the update with the closest dirty extent if all of them are used.
+  //
+  if (VariableRuntimeCache->DirtyExtentCount == VARIABLE_RUNTIME_CACHE_MAX_DIRTY_EXTENTS) {
+    Closest    = 0;
+    ClosestGap = MAX_UINTN;
+    for (Index = 0; Index < VariableRuntimeCache->DirtyExtentCount; Index++) {
+      Extent = &VariableRuntimeCache->DirtyExtent[Index];
+      Gap    = (Extent->Offset > End) ? Extent->Offset - End : Offset - ((UINTN)Extent->Offset + Extent->Length);
+      if (Gap < ClosestGap) {
+        Closest    = Index;
+        ClosestGap = Gap;
+      }
+    }
+
+    Extent = &VariableRuntimeCache->DirtyExtent[Closest];
+    End    = MAX (End, (UINTN)Extent->Offset + Extent->Length);
+    Offset = MIN (Offset, (UINTN)Extent->Offset);
+    VariableRuntimeCache->DirtyExtentCount--;
+    Extent->Offset = VariableRuntimeCache->DirtyExtent[VariableRuntimeCache->DirtyExtentCount].Offset;
+    Extent->Length = VariableRuntimeCache->DirtyExtent[VariableRuntimeCache->DirtyExtentCount].Length;
+  }
+
+  Extent         = &VariableRuntimeCache->DirtyExtent[VariableRuntimeCache->DirtyExtentCount++];
+  Extent->Offset = (UINT32)Offset;
+  Extent->Length = (UINT32)(End - Offset);
+
   *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingUpdate) = TRUE;
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Synchronizes the runtime variable caches with all pending updates outside runtime.
+
+  Ensures all conditions are met to maintain coherency for runtime cache updates. This function will attempt
+  to write the given update (and any other pending updates) if the ReadLock is available. Otherwise, the
+  update is added as a pending update for the given variable store and it will be flushed to the runtime cache
+  at the next opportunity the ReadLock is available.
+
+  @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being synchronized.
+  @param[in] Offset               Offset in bytes to apply the update.
+  @param[in] Length               Length of data in bytes of the update. It may be 0 to only write the
+                                  updates added with AddPendingRuntimeVariableCacheUpdate().
+
+  @retval EFI_SUCCESS             The update was added as a pending update successfully. If the variable runtime
+                                  cache ReadLock was available, the runtime cache was updated successfully.
+  @retval EFI_INVALID_PARAMETER   VariableRuntimeCache is NULL, or the update is beyond 4 GB.
+  @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
+
+**/
+EFI_STATUS
+SynchronizeRuntimeVariableCache (
+  IN  VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN  UINTN                   Offset,
+  IN  UINTN                   Length
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = AddPendingRuntimeVariableCacheUpdate (VariableRuntimeCache, Offset, Length);
+  if (EFI_ERROR (Status) || (VariableRuntimeCache->Store == NULL)) {
+    return Status;
+  }
+
   if (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.ReadLock) == FALSE) {
     return FlushPendingRuntimeVariableCacheUpdates ();
   }
@@ -24,6 +24,28 @@ FlushPendingRuntimeVariableCacheUpdates (
   VOID
   );
 
+/**
+  Adds an update to the pending updates of a runtime variable cache, without copying it to the runtime cache.
+
+  The update is added to the dirty extents of the runtime cache, merged with the dirty extents it overlaps or
+  touches. When all the dirty extents are used, the update is merged with the closest dirty extent.
+
+  @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being updated.
+  @param[in] Offset               Offset in bytes to apply the update.
+  @param[in] Length               Length of data in bytes of the update.
+
+  @retval EFI_SUCCESS             The update was added as a pending update successfully.
+  @retval EFI_INVALID_PARAMETER   VariableRuntimeCache is NULL, or the update is beyond 4 GB.
+  @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
+
+**/
+EFI_STATUS
+AddPendingRuntimeVariableCacheUpdate (
+  IN  VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN  UINTN                   Offset,
+  IN  UINTN                   Length
+  );
+
 /**
   Synchronizes the runtime variable caches with all pending updates outside runtime.
 
@@ -34,10 +56,12 @@ FlushPendingRuntimeVariableCacheUpdates (
 
   @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache being synchronized.
   @param[in] Offset               Offset in bytes to apply the update.
-  @param[in] Length               Length of data in bytes of the update.
+  @param[in] Length               Length of data in bytes of the update. It may be 0 to only write the
+                                  updates added with AddPendingRuntimeVariableCacheUpdate().
 
   @retval EFI_SUCCESS             The update was added as a pending update successfully. If the variable runtime
                                   cache ReadLock was available, the runtime cache was updated successfully.
+  @retval EFI_INVALID_PARAMETER   VariableRuntimeCache is NULL, or the update is beyond 4 GB.
   @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
 
 **/
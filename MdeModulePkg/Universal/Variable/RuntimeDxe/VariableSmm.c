@@ -30,6 +30,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/VariablePolicyLib.h>
 
 #include <Guid/SmmVariableCommon.h>
+#include <Guid/VariableRuntimeCacheInfo.h>
 #include "Variable.h"
 #include "VariableParsing.h"
 #include "VariableRuntimeCache.h"
@@ -472,6 +473,7 @@ SmmVariableHandler (
   VARIABLE_INFO_ENTRY                                      *VariableInfo;
   VARIABLE_RUNTIME_CACHE_CONTEXT                           *VariableCacheContext;
   VARIABLE_STORE_HEADER                                    *VariableCache;
+  CACHE_INFO_FLAG                                          *CacheInfoFlag;
   UINTN                                                    InfoSize;
   UINTN                                                    NameBufferSize;
   UINTN                                                    CommBufferPayloadSize;
@@ -737,6 +739,21 @@ SmmVariableHandler (
       *CommBufferSize = InfoSize + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE;
       break;
 
+    case SMM_VARIABLE_FUNCTION_GET_RECLAIM_STATISTICS:
+      if (!FeaturePcdGet (PcdVariableCollectStatistics)) {
+        Status = EFI_UNSUPPORTED;
+        break;
+      }
+
+      if (CommBufferPayloadSize < sizeof (VARIABLE_RECLAIM_STATISTICS)) {
+        DEBUG ((DEBUG_ERROR, "GetReclaimStatistics: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+
+      CopyMem (SmmVariableFunctionHeader->Data, &mVariableReclaimStatistics, sizeof (VARIABLE_RECLAIM_STATISTICS));
+      Status = EFI_SUCCESS;
+      break;
+
     case SMM_VARIABLE_FUNCTION_LOCK_VARIABLE:
       if (mEndOfDxe) {
         Status = EFI_ACCESS_DENIED;
@@ -924,6 +941,23 @@ SmmVariableHandler (
         goto EXIT;
       }
 
+      //
+      // The update count is optional. It is only used when the flags point
+      // into one CACHE_INFO_FLAG buffer, where it follows HobFlushComplete.
+      //
+      CacheInfoFlag = BASE_CR (RuntimeVariableCacheContext->ReadLock, CACHE_INFO_FLAG, ReadLock);
+      if ((RuntimeVariableCacheContext->PendingUpdate != &CacheInfoFlag->PendingUpdate) ||
+          (RuntimeVariableCacheContext->HobFlushComplete != &CacheInfoFlag->HobFlushComplete) ||
+          !VariableSmmIsNonPrimaryBufferValid ((UINTN)CacheInfoFlag, sizeof (CACHE_INFO_FLAG)))
+      {
+        CacheInfoFlag = NULL;
+      } else {
+        //
+        // Tell the runtime DXE driver that UpdateCount changes on every flush
+        //
+        CacheInfoFlag->UpdateCountSupported = TRUE;
+      }
+
       VariableCacheContext                                     = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
       VariableCacheContext->VariableRuntimeHobCache.Store      = RuntimeVariableCacheContext->RuntimeHobCache;
       VariableCacheContext->VariableRuntimeVolatileCache.Store = RuntimeVariableCacheContext->RuntimeVolatileCache;
@@ -931,26 +965,30 @@ SmmVariableHandler (
       VariableCacheContext->PendingUpdate                      = RuntimeVariableCacheContext->PendingUpdate;
       VariableCacheContext->ReadLock                           = RuntimeVariableCacheContext->ReadLock;
       VariableCacheContext->HobFlushComplete                   = RuntimeVariableCacheContext->HobFlushComplete;
+      VariableCacheContext->UpdateCount                        = (CacheInfoFlag != NULL) ? &CacheInfoFlag->UpdateCount : NULL;
 
       // Set up the intial pending request since the RT cache needs to be in sync with SMM cache
-      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeHobCache.PendingUpdateLength = 0;
+      VariableCacheContext->VariableRuntimeHobCache.DirtyExtentCount = 0;
       if ((mVariableModuleGlobal->VariableGlobal.HobVariableBase > 0) &&
           (VariableCacheContext->VariableRuntimeHobCache.Store != NULL))
       {
-        VariableCache                                                     = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase;
-        VariableCacheContext->VariableRuntimeHobCache.PendingUpdateLength = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
+        VariableCache                                                       = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase;
+        VariableCacheContext->VariableRuntimeHobCache.DirtyExtentCount      = 1;
+        VariableCacheContext->VariableRuntimeHobCache.DirtyExtent[0].Offset = 0;
+        VariableCacheContext->VariableRuntimeHobCache.DirtyExtent[0].Length = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
         CopyGuid (&(VariableCacheContext->VariableRuntimeHobCache.Store->Signature), &(VariableCache->Signature));
       }
 
-      VariableCache                                                          = (VARIABLE_STORE_HEADER  *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
-      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
+      VariableCache                                                            = (VARIABLE_STORE_HEADER  *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
+      VariableCacheContext->VariableRuntimeVolatileCache.DirtyExtentCount      = 1;
+      VariableCacheContext->VariableRuntimeVolatileCache.DirtyExtent[0].Offset = 0;
+      VariableCacheContext->VariableRuntimeVolatileCache.DirtyExtent[0].Length = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
       CopyGuid (&(VariableCacheContext->VariableRuntimeVolatileCache.Store->Signature), &(VariableCache->Signature));
 
-      VariableCache                                                    = (VARIABLE_STORE_HEADER  *)(UINTN)mNvVariableCache;
-      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateOffset = 0;
-      VariableCacheContext->VariableRuntimeNvCache.PendingUpdateLength = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
+      VariableCache                                                      = (VARIABLE_STORE_HEADER  *)(UINTN)mNvVariableCache;
+      VariableCacheContext->VariableRuntimeNvCache.DirtyExtentCount      = 1;
+      VariableCacheContext->VariableRuntimeNvCache.DirtyExtent[0].Offset = 0;
+      VariableCacheContext->VariableRuntimeNvCache.DirtyExtent[0].Length = (UINT32)((UINTN)GetEndPointer (VariableCache) - (UINTN)VariableCache);
       CopyGuid (&(VariableCacheContext->VariableRuntimeNvCache.Store->Signature), &(VariableCache->Signature));
 
       *(VariableCacheContext->PendingUpdate)    = TRUE;
@@ -58,6 +58,7 @@ EFI_LOCK                        mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL    mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL        mVarCheck;
 VARIABLE_RUNTIME_CACHE_INFO     mVariableRtCacheInfo;
+UINT32                          mVariableRtCacheUpdateCount;
 BOOLEAN                         mIsRuntimeCacheEnabled = FALSE;
 
 /**
@@ -487,7 +488,9 @@ SyncRuntimeCache (
   Check whether a SMI must be triggered to retrieve pending cache updates.
 
   If the variable HOB was finished being flushed since the last check for a runtime cache update, this function
-  will prevent the HOB cache from being used for future runtime cache hits.
+  will prevent the HOB cache from being used for future runtime cache hits. If updates were flushed to the
+  runtime caches since the last check, the hash indexes of the runtime caches are discarded. The runtime caches
+  are only indexed when the MM variable driver reports the updates.
 
 **/
 VOID
@@ -509,8 +512,19 @@ CheckForRuntimeCacheSync (
   // The HOB variable data may have finished being flushed in the runtime cache sync update
   //
   if ((CacheInfoFlag->HobFlushComplete) && (mVariableRtCacheInfo.RuntimeHobCacheBuffer != 0)) {
+    InvalidateVariableStoreIndex ((VARIABLE_STORE_HEADER *)(UINTN)mVariableRtCacheInfo.RuntimeHobCacheBuffer);
     mVariableRtCacheInfo.RuntimeHobCacheBuffer = 0;
   }
+
+  if (CacheInfoFlag->UpdateCount != mVariableRtCacheUpdateCount) {
+    if (mVariableRtCacheInfo.RuntimeHobCacheBuffer != 0) {
+      InvalidateVariableStoreIndex ((VARIABLE_STORE_HEADER *)(UINTN)mVariableRtCacheInfo.RuntimeHobCacheBuffer);
+    }
+
+    InvalidateVariableStoreIndex ((VARIABLE_STORE_HEADER *)(UINTN)mVariableRtCacheInfo.RuntimeNvCacheBuffer);
+    InvalidateVariableStoreIndex ((VARIABLE_STORE_HEADER *)(UINTN)mVariableRtCacheInfo.RuntimeVolatileCacheBuffer);
+    mVariableRtCacheUpdateCount = CacheInfoFlag->UpdateCount;
+  }
 }
 
 /**
@@ -854,9 +868,13 @@ GetNextVariableNameInRuntimeCache (
   //
   ASSERT (!(CacheInfoFlag->ReadLock));
 
+  //
+  // Hold the read lock while checking for a runtime cache sync, so that no
+  // update can be flushed to the runtime caches before they are searched.
+  //
+  CacheInfoFlag->ReadLock = TRUE;
   CheckForRuntimeCacheSync ();
 
-  CacheInfoFlag->ReadLock = TRUE;
   if (!(CacheInfoFlag->PendingUpdate)) {
     //
     // 0: Volatile, 1: HOB, 2: Non-Volatile.
@@ -1342,12 +1360,19 @@ VariableAddressChangeEvent (
   IN VOID       *Context
   )
 {
+  UINTN  Index;
+
   EfiConvertPointer (0x0, (VOID **)&mVariableBuffer);
   EfiConvertPointer (0x0, (VOID **)&mMmCommunication2);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.CacheInfoFlagBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeVolatileCacheBuffer);
+
+  for (Index = 0; Index < VARIABLE_STORE_INDEX_COUNT; Index++) {
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableStoreIndex[Index].StartPtr);
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableStoreIndex[Index].Slot);
+  }
 }
 
 /**
@@ -1599,6 +1624,7 @@ SendRuntimeVariableCacheContextToSmm (
 {
   EFI_STATUS                                               Status;
   SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT  *SmmRuntimeVarCacheContext;
+  CACHE_INFO_FLAG                                          *CacheInfoFlag;
   EFI_MM_COMMUNICATE_HEADER                                *SmmCommunicateHeader;
   SMM_VARIABLE_COMMUNICATE_HEADER                          *SmmVariableFunctionHeader;
   UINTN                                                    CommSize;
@@ -1635,6 +1661,14 @@ SendRuntimeVariableCacheContextToSmm (
   SmmRuntimeVarCacheContext->ReadLock             = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->ReadLock;
   SmmRuntimeVarCacheContext->HobFlushComplete     = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->HobFlushComplete;
 
+  //
+  // An MM driver that does not set UpdateCountSupported never tells when the
+  // runtime caches change, so their hash indexes would get stale.
+  //
+  CacheInfoFlag                       = (CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer;
+  CacheInfoFlag->UpdateCountSupported = FALSE;
+  mVariableStoreIndexEnabled          = FALSE;
+
   //
   // Send data to SMM.
   //
@@ -1650,6 +1684,11 @@ SendRuntimeVariableCacheContextToSmm (
     goto Done;
   }
 
+  mVariableStoreIndexEnabled = CacheInfoFlag->UpdateCountSupported;
+  if (!mVariableStoreIndexEnabled) {
+    DEBUG ((DEBUG_INFO, "Variable runtime caches are not indexed, the MM variable driver does not report updates.\n"));
+  }
+
 Done:
   ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
   return Status;
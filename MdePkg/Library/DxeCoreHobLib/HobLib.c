@@ -1,7 +1,17 @@
 /** @file
   HOB Library implementation for DxeCore driver.
 
-Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+  The HOB list is read-only in DXE. Once the DXE Core has relocated the HOB list
+  and initialized the memory services, the library constructor indexes the GUID
+  HOBs by GUID, so that GetFirstGuidHob() and GetNextGuidHob() do not walk the
+  whole HOB list. The HOB list is walked before the index is built, or if the
+  index cannot be allocated.
+
+  Only the lookups of the DXE Core itself use the index. The drivers it
+  dispatches link their own HobLib instance, such as DxeHobLib, which still
+  walks the HOB list.
+
+Copyright (c) 2006 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -12,6 +22,137 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DxeCoreEntryPoint.h>
+#include <Library/MemoryAllocationLib.h>
+
+#define GUID_HOB_INDEX_MIN_SIZE  16
+
+///
+/// Entry of the GUID HOB index, for the GUID HOBs of one GUID.
+///
+typedef struct {
+  EFI_HOB_GUID_TYPE    *First;
+  EFI_HOB_GUID_TYPE    *Last;
+} GUID_HOB_INDEX_ENTRY;
+
+///
+/// Open addressing hash table of the GUID HOBs, with mGuidHobIndexMask + 1 entries.
+/// An entry with First set to NULL is free.
+///
+GUID_HOB_INDEX_ENTRY  *mGuidHobIndex = NULL;
+UINTN                 mGuidHobIndexMask;
+
+///
+/// The HOB list indexed, and its end of HOB list HOB.
+///
+VOID  *mGuidHobIndexHobList = NULL;
+VOID  *mGuidHobIndexHobListEnd;
+
+/**
+  Hash a GUID into the GUID HOB index.
+
+  @param  Guid          The GUID to hash.
+
+  @return The hash of the GUID.
+**/
+STATIC
+UINTN
+HashGuid (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINT32  Hash;
+
+  Hash  = ((CONST UINT32 *)Guid)[0] ^ ((CONST UINT32 *)Guid)[1] ^
+          ((CONST UINT32 *)Guid)[2] ^ ((CONST UINT32 *)Guid)[3];
+  Hash *= 0x9E3779B1;
+  return (UINTN)(Hash ^ (Hash >> 16));
+}
+
+/**
+  Find the entry of a GUID in the GUID HOB index.
+
+  @param  Guid          The GUID to find.
+
+  @return The entry of the GUID, or the free entry to record the GUID into
+          if the GUID is not in the index.
+**/
+STATIC
+GUID_HOB_INDEX_ENTRY *
+FindGuidHobIndexEntry (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINTN  Index;
+
+  Index = HashGuid (Guid) & mGuidHobIndexMask;
+  while ((mGuidHobIndex[Index].First != NULL) && !CompareGuid (Guid, &mGuidHobIndex[Index].First->Name)) {
+    Index = (Index + 1) & mGuidHobIndexMask;
+  }
+
+  return &mGuidHobIndex[Index];
+}
+
+/**
+  The constructor function builds the GUID HOB index of the HOB list.
+
+  The DXE Core runs the library constructors after it has relocated the HOB
+  list and initialized the memory services. If the index cannot be allocated,
+  the GUID HOBs are searched in the HOB list.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS   The constructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeCoreHobLibConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  GUID_HOB_INDEX_ENTRY  *Entry;
+  UINTN                 GuidHobCount;
+  UINTN                 Size;
+
+  GuidHobCount = 0;
+  for (Hob.Raw = GetHobList (); !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      GuidHobCount++;
+    }
+  }
+
+  //
+  // Keep the index at most half full.
+  //
+  Size = GUID_HOB_INDEX_MIN_SIZE;
+  while (Size < GuidHobCount * 2) {
+    Size *= 2;
+  }
+
+  mGuidHobIndex = AllocateZeroPool (Size * sizeof (GUID_HOB_INDEX_ENTRY));
+  if (mGuidHobIndex == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  mGuidHobIndexMask = Size - 1;
+  for (Hob.Raw = GetHobList (); !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Entry = FindGuidHobIndexEntry (&Hob.Guid->Name);
+      if (Entry->First == NULL) {
+        Entry->First = Hob.Guid;
+      }
+
+      Entry->Last = Hob.Guid;
+    }
+  }
+
+  mGuidHobIndexHobList    = GetHobList ();
+  mGuidHobIndexHobListEnd = Hob.Raw;
+  return EFI_SUCCESS;
+}
 
 /**
   Returns the pointer to the HOB list.
@@ -137,6 +278,25 @@ GetNextGuidHob (
   )
 {
   EFI_PEI_HOB_POINTERS  GuidHob;
+  GUID_HOB_INDEX_ENTRY  *Entry;
+
+  //
+  // The HOBs of the HOB list are in the order of their addresses. The index gives the
+  // first and the last GUID HOB of the GUID, so the HOB list is only walked to find
+  // the GUID HOBs between them.
+  //
+  if ((mGuidHobIndexHobList != NULL) && (mGuidHobIndexHobList == gHobList) &&
+      ((UINTN)HobStart >= (UINTN)mGuidHobIndexHobList) && ((UINTN)HobStart <= (UINTN)mGuidHobIndexHobListEnd))
+  {
+    Entry = FindGuidHobIndexEntry (Guid);
+    if ((Entry->First == NULL) || ((UINTN)HobStart > (UINTN)Entry->Last)) {
+      return NULL;
+    }
+
+    if ((UINTN)HobStart <= (UINTN)Entry->First) {
+      return Entry->First;
+    }
+  }
 
   GuidHob.Raw = (UINT8 *)HobStart;
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
@@ -0,0 +1,363 @@
+/** @file
+  Host based test and benchmark for the GUID HOB index of the DXE Core HOB
+  Library.
+
+  A HOB list of the size of the HOB lists of FSP based platforms is filled
+  with resource descriptor, memory allocation and GUID HOBs. The GUID HOBs
+  are looked up with GetFirstGuidHob() and GetNextGuidHob() before and after
+  the library constructor indexes them, the results are compared and the time
+  of the lookups is reported.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <PiDxe.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE Core GUID HOB Index Test and Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_HOB_COUNT          4000
+#define TEST_GUID_COUNT         200
+#define TEST_ABSENT_GUID_COUNT  56
+#define TEST_LOOKUP_COUNT       20000
+
+//
+// HOB list pointer of the DXE Core Entry Point Library
+//
+VOID  *gHobList = NULL;
+
+EFI_STATUS
+EFIAPI
+DxeCoreHobLibConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  );
+
+///
+/// The result of the lookups of one GUID.
+///
+typedef struct {
+  VOID     *First;
+  VOID     *Last;
+  UINTN    Count;
+} GUID_HOB_LOOKUP;
+
+STATIC EFI_GUID         mGuids[TEST_GUID_COUNT + TEST_ABSENT_GUID_COUNT];
+STATIC GUID_HOB_LOOKUP  mLinearLookup[TEST_GUID_COUNT + TEST_ABSENT_GUID_COUNT];
+
+/**
+  Returns the next value of a pseudo random sequence.
+
+  @param  Seed  The state of the sequence.
+
+  @return The next value.
+**/
+STATIC
+UINT32
+NextRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return (*Seed >> 16) & 0x7FFF;
+}
+
+/**
+  Appends a HOB to the HOB list being built.
+
+  @param  Cursor  The end of the HOB list, updated to the end of the new HOB.
+  @param  Type    The type of the HOB.
+  @param  Length  The length of the HOB.
+
+  @return The new HOB.
+**/
+STATIC
+VOID *
+AppendHob (
+  IN OUT UINT8  **Cursor,
+  IN     UINT16  Type,
+  IN     UINT16  Length
+  )
+{
+  EFI_HOB_GENERIC_HEADER  *Header;
+
+  Header            = (EFI_HOB_GENERIC_HEADER *)*Cursor;
+  Header->HobType   = Type;
+  Header->HobLength = Length;
+  Header->Reserved  = 0;
+  *Cursor          += Length;
+  return Header;
+}
+
+/**
+  Builds a HOB list with a PHIT HOB followed by TEST_HOB_COUNT resource
+  descriptor, memory allocation and GUID HOBs. A few GUIDs have many GUID HOBs,
+  as the GUIDs of the FSP HOBs, the others have one or a few.
+
+  @return The HOB list, or NULL if out of resources.
+**/
+STATIC
+VOID *
+BuildTestHobList (
+  VOID
+  )
+{
+  UINT8                *HobList;
+  UINT8                *Cursor;
+  EFI_HOB_GUID_TYPE    *GuidHob;
+  UINT32               Seed;
+  UINTN                Index;
+  UINTN                GuidIndex;
+  UINT16               DataSize;
+
+  HobList = AllocateZeroPool (TEST_HOB_COUNT * (sizeof (EFI_HOB_GUID_TYPE) + 512) + SIZE_4KB);
+  if (HobList == NULL) {
+    return NULL;
+  }
+
+  Seed = 1;
+  for (Index = 0; Index < ARRAY_SIZE (mGuids); Index++) {
+    mGuids[Index].Data1 = NextRandom (&Seed);
+    mGuids[Index].Data2 = (UINT16)NextRandom (&Seed);
+    mGuids[Index].Data3 = (UINT16)NextRandom (&Seed);
+    *(UINT32 *)&mGuids[Index].Data4[0] = NextRandom (&Seed);
+    *(UINT32 *)&mGuids[Index].Data4[4] = NextRandom (&Seed);
+  }
+
+  Cursor = HobList;
+  AppendHob (&Cursor, EFI_HOB_TYPE_HANDOFF, sizeof (EFI_HOB_HANDOFF_INFO_TABLE));
+  for (Index = 0; Index < TEST_HOB_COUNT; Index++) {
+    switch (NextRandom (&Seed) % 4) {
+      case 0:
+        AppendHob (&Cursor, EFI_HOB_TYPE_RESOURCE_DESCRIPTOR, sizeof (EFI_HOB_RESOURCE_DESCRIPTOR));
+        break;
+
+      case 1:
+        AppendHob (&Cursor, EFI_HOB_TYPE_MEMORY_ALLOCATION, sizeof (EFI_HOB_MEMORY_ALLOCATION));
+        break;
+
+      default:
+        if ((NextRandom (&Seed) % 2) == 0) {
+          GuidIndex = NextRandom (&Seed) % 5;
+        } else {
+          GuidIndex = NextRandom (&Seed) % TEST_GUID_COUNT;
+        }
+
+        DataSize = (UINT16)ALIGN_VALUE (NextRandom (&Seed) % 512, 8);
+        GuidHob  = AppendHob (&Cursor, EFI_HOB_TYPE_GUID_EXTENSION, (UINT16)(sizeof (EFI_HOB_GUID_TYPE) + DataSize));
+        CopyGuid (&GuidHob->Name, &mGuids[GuidIndex]);
+        break;
+    }
+  }
+
+  AppendHob (&Cursor, EFI_HOB_TYPE_END_OF_HOB_LIST, sizeof (EFI_HOB_GENERIC_HEADER));
+  return HobList;
+}
+
+/**
+  Looks up all the GUID HOBs of a GUID, as the callers of GetNextGuidHob() do.
+
+  @param  Guid    The GUID to look up.
+  @param  Lookup  Returns the first and last GUID HOB and their number.
+**/
+STATIC
+VOID
+LookupGuidHobs (
+  IN  CONST EFI_GUID   *Guid,
+  OUT GUID_HOB_LOOKUP  *Lookup
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+
+  Lookup->First = GetFirstGuidHob (Guid);
+  Lookup->Last  = NULL;
+  Lookup->Count = 0;
+  for (Hob.Raw = Lookup->First; Hob.Raw != NULL; Hob.Raw = GetNextGuidHob (Guid, GET_NEXT_HOB (Hob))) {
+    Lookup->Last = Hob.Raw;
+    Lookup->Count++;
+  }
+}
+
+/**
+  Times TEST_LOOKUP_COUNT lookups of the first GUID HOB of random GUIDs.
+
+  @return The average time of a lookup, in nanoseconds.
+**/
+STATIC
+UINT64
+TimeGetFirstGuidHob (
+  VOID
+  )
+{
+  UINT32   Seed;
+  UINTN    Lookup;
+  UINTN    Found;
+  clock_t  Start;
+
+  Seed  = 7;
+  Found = 0;
+  Start = clock ();
+  for (Lookup = 0; Lookup < TEST_LOOKUP_COUNT; Lookup++) {
+    if (GetFirstGuidHob (&mGuids[NextRandom (&Seed) % ARRAY_SIZE (mGuids)]) != NULL) {
+      Found++;
+    }
+  }
+
+  return (UINT64)(clock () - Start) * 1000000000 / CLOCKS_PER_SEC / TEST_LOOKUP_COUNT;
+}
+
+/**
+  Looks up the GUID HOBs of the HOB list before and after the library
+  constructor indexes them, and checks that the results are the same.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GuidHobLookupTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  GUID_HOB_LOOKUP       Lookup;
+  UINTN                 Index;
+  UINTN                 HobListSize;
+  UINT64                LinearNs;
+  UINT64                IndexedNs;
+
+  gHobList = BuildTestHobList ();
+  UT_ASSERT_NOT_NULL (gHobList);
+
+  for (Hob.Raw = gHobList; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+  }
+
+  HobListSize = (UINTN)Hob.Raw - (UINTN)gHobList;
+
+  //
+  // Before the constructor, the HOB list is walked.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (mGuids); Index++) {
+    LookupGuidHobs (&mGuids[Index], &mLinearLookup[Index]);
+  }
+
+  UT_ASSERT_NOT_NULL (mLinearLookup[0].First);
+  UT_ASSERT_EQUAL ((UINTN)mLinearLookup[TEST_GUID_COUNT].First, (UINTN)NULL);
+  LinearNs = TimeGetFirstGuidHob ();
+
+  UT_ASSERT_NOT_EFI_ERROR (DxeCoreHobLibConstructor (NULL, NULL));
+
+  for (Index = 0; Index < ARRAY_SIZE (mGuids); Index++) {
+    LookupGuidHobs (&mGuids[Index], &Lookup);
+    UT_ASSERT_EQUAL ((UINTN)Lookup.First, (UINTN)mLinearLookup[Index].First);
+    UT_ASSERT_EQUAL ((UINTN)Lookup.Last, (UINTN)mLinearLookup[Index].Last);
+    UT_ASSERT_EQUAL (Lookup.Count, mLinearLookup[Index].Count);
+  }
+
+  //
+  // A search from the end of the HOB list finds nothing.
+  //
+  UT_ASSERT_EQUAL ((UINTN)GetNextGuidHob (&mGuids[0], Hob.Raw), (UINTN)NULL);
+
+  IndexedNs = TimeGetFirstGuidHob ();
+
+  UT_LOG_INFO (
+    "%Lu HOBs, %Lu KB: GetFirstGuidHob() %Lu ns walking the HOB list, %Lu ns with the index\n",
+    (UINT64)TEST_HOB_COUNT,
+    (UINT64)(HobListSize / SIZE_1KB),
+    LinearNs,
+    IndexedNs
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the GUID HOB
+  index of the DXE Core HOB Library and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      GuidHobIndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&GuidHobIndexTests, Framework, "DXE Core GUID HOB Index Tests", "DxeCoreHobLib.GuidHobIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the DXE Core GUID HOB Index Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (GuidHobIndexTests, "GUID HOB lookups with and without the index", "GuidHobLookup", GuidHobLookupTest, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define GuidHobIndexBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+GuidHobIndexBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,120 @@
+/** @file
+  This library calculates the Authenticode digests of a PE/COFF image, as
+  described in PE/COFF Specification 8.0 Appendix A.
+
+  The header, the sections and the extra data of the image are walked once,
+  and each range is fed to all the hash algorithms the caller asks for, so
+  that the image is only read once for all the digests it needs.
+
+  Caution: The image is external input. The caller must validate it with
+  PeCoffLoaderGetImageInfo() before it calls these functions.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef PE_IMAGE_HASH_LIB_H_
+#define PE_IMAGE_HASH_LIB_H_
+
+#include <Uefi.h>
+
+//
+// Hash algorithms of PeImageHashAll(), with the values of the
+// EFI_TCG2_BOOT_HASH_ALG_* bits of the TCG2 protocol.
+//
+#define PE_IMAGE_HASH_SHA1     0x00000001
+#define PE_IMAGE_HASH_SHA256   0x00000002
+#define PE_IMAGE_HASH_SHA384   0x00000004
+#define PE_IMAGE_HASH_SHA512   0x00000008
+#define PE_IMAGE_HASH_SM3_256  0x00000010
+
+//
+// Digests of a PE/COFF image, only the ones of the hash algorithms asked for
+// are set.
+//
+typedef struct {
+  UINT8    Sha1[20];
+  UINT8    Sha256[32];
+  UINT8    Sha384[48];
+  UINT8    Sha512[64];
+  UINT8    Sm3[32];
+} PE_IMAGE_DIGESTS;
+
+/**
+  Hash a range of the PE/COFF image.
+
+  @param[in, out]  Context    The context given to PeImageHashRanges().
+  @param[in]       Data       The range of the image to hash.
+  @param[in]       DataSize   Size of the range.
+
+  @retval TRUE     The range was hashed.
+  @retval FALSE    The hash failed.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *PE_IMAGE_HASH_UPDATE)(
+  IN OUT VOID        *Context,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  );
+
+/**
+  Walk the ranges of a PE/COFF image which are part of its Authenticode hash,
+  in order, and give each of them to HashUpdate.
+
+  The image checksum, the certificate directory entry and the attribute
+  certificate table are excluded, and the sections are hashed in the order
+  of their file offsets.
+
+  @param[in]       ImageAddress   The PE/COFF image, checked by PeCoffLoaderGetImageInfo().
+  @param[in]       ImageSize      Size of the image.
+  @param[in]       HashUpdate     Function which hashes the ranges.
+  @param[in, out]  Context        Context of HashUpdate.
+
+  @retval EFI_SUCCESS             All the ranges were hashed.
+  @retval EFI_INVALID_PARAMETER   ImageAddress or HashUpdate is NULL.
+  @retval EFI_UNSUPPORTED         The image is not a PE32 or PE32+ image, or its
+                                  size is inconsistent with its certificate table.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to sort the sections.
+  @retval EFI_ABORTED             HashUpdate failed.
+
+**/
+EFI_STATUS
+EFIAPI
+PeImageHashRanges (
+  IN     CONST VOID            *ImageAddress,
+  IN     UINTN                 ImageSize,
+  IN     PE_IMAGE_HASH_UPDATE  HashUpdate,
+  IN OUT VOID                  *Context
+  );
+
+/**
+  Calculate the Authenticode digests of a PE/COFF image with several hash
+  algorithms, in one walk of the image.
+
+  @param[in]   ImageAddress   The PE/COFF image, checked by PeCoffLoaderGetImageInfo().
+  @param[in]   ImageSize      Size of the image.
+  @param[in]   HashMask       The PE_IMAGE_HASH_* algorithms of the digests.
+  @param[out]  Digests        The digests of the image.
+
+  @retval EFI_SUCCESS             The digests of all the algorithms of HashMask are
+                                  returned.
+  @retval EFI_INVALID_PARAMETER   ImageAddress or Digests is NULL, or HashMask is zero.
+  @retval EFI_UNSUPPORTED         An algorithm of HashMask is not supported, or the
+                                  image is not a valid PE32 or PE32+ image.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the hash contexts.
+  @retval EFI_ABORTED             A hash operation failed.
+
+**/
+EFI_STATUS
+EFIAPI
+PeImageHashAll (
+  IN  CONST VOID        *ImageAddress,
+  IN  UINTN             ImageSize,
+  IN  UINT32            HashMask,
+  OUT PE_IMAGE_DIGESTS  *Digests
+  );
+
+#endif
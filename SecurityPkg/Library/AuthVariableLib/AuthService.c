@@ -1062,22 +1062,9 @@ FilterSignatureList (
   IN OUT UINTN  *NewDataSize
   )
 {
-  EFI_SIGNATURE_LIST  *CertList;
-  EFI_SIGNATURE_DATA  *Cert;
-  UINTN               CertCount;
-  EFI_SIGNATURE_LIST  *NewCertList;
-  EFI_SIGNATURE_DATA  *NewCert;
-  UINTN               NewCertCount;
-  UINTN               Index;
-  UINTN               Index2;
-  UINTN               Size;
-  UINT8               *Tail;
-  UINTN               CopiedCount;
-  UINTN               SignatureListSize;
-  BOOLEAN             IsNewCert;
-  UINT8               *TempData;
-  UINTN               TempDataSize;
-  EFI_STATUS          Status;
+  UINT8       *TempData;
+  UINTN       TempDataSize;
+  EFI_STATUS  Status;
 
   if (*NewDataSize == 0) {
     return EFI_SUCCESS;
@@ -1089,80 +1076,13 @@ FilterSignatureList (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Tail = TempData;
-
-  NewCertList = (EFI_SIGNATURE_LIST *)NewData;
-  while ((*NewDataSize > 0) && (*NewDataSize >= NewCertList->SignatureListSize)) {
-    NewCert      = (EFI_SIGNATURE_DATA *)((UINT8 *)NewCertList + sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize);
-    NewCertCount = (NewCertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - NewCertList->SignatureHeaderSize) / NewCertList->SignatureSize;
-
-    CopiedCount = 0;
-    for (Index = 0; Index < NewCertCount; Index++) {
-      IsNewCert = TRUE;
-
-      Size     = DataSize;
-      CertList = (EFI_SIGNATURE_LIST *)Data;
-      while ((Size > 0) && (Size >= CertList->SignatureListSize)) {
-        if (CompareGuid (&CertList->SignatureType, &NewCertList->SignatureType) &&
-            (CertList->SignatureSize == NewCertList->SignatureSize))
-        {
-          Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-          CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-          for (Index2 = 0; Index2 < CertCount; Index2++) {
-            //
-            // Iterate each Signature Data in this Signature List.
-            //
-            if (CompareMem (NewCert, Cert, CertList->SignatureSize) == 0) {
-              IsNewCert = FALSE;
-              break;
-            }
-
-            Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
-          }
-        }
-
-        if (!IsNewCert) {
-          break;
-        }
-
-        Size    -= CertList->SignatureListSize;
-        CertList = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
-      }
-
-      if (IsNewCert) {
-        //
-        // New EFI_SIGNATURE_DATA, keep it.
-        //
-        if (CopiedCount == 0) {
-          //
-          // Copy EFI_SIGNATURE_LIST header for only once.
-          //
-          CopyMem (Tail, NewCertList, sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize);
-          Tail = Tail + sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize;
-        }
-
-        CopyMem (Tail, NewCert, NewCertList->SignatureSize);
-        Tail += NewCertList->SignatureSize;
-        CopiedCount++;
-      }
-
-      NewCert = (EFI_SIGNATURE_DATA *)((UINT8 *)NewCert + NewCertList->SignatureSize);
-    }
-
-    //
-    // Update SignatureListSize in the kept EFI_SIGNATURE_LIST.
-    //
-    if (CopiedCount != 0) {
-      SignatureListSize           = sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize + (CopiedCount * NewCertList->SignatureSize);
-      CertList                    = (EFI_SIGNATURE_LIST *)(Tail - SignatureListSize);
-      CertList->SignatureListSize = (UINT32)SignatureListSize;
-    }
-
-    *NewDataSize -= NewCertList->SignatureListSize;
-    NewCertList   = (EFI_SIGNATURE_LIST *)((UINT8 *)NewCertList + NewCertList->SignatureListSize);
-  }
+  //
+  // Index the original signatures once, instead of scanning all of them for
+  // each new signature. The set scans them if they do not fit in it.
+  //
+  SignatureSetBuild (&mSignatureSet, Data, DataSize);
 
-  TempDataSize = (Tail - (UINT8 *)TempData);
+  TempDataSize = SignatureSetFilter (&mSignatureSet, NewData, *NewDataSize, TempData);
 
   CopyMem (NewData, TempData, TempDataSize);
   *NewDataSize = TempDataSize;
@@ -12,7 +12,7 @@
   may not be modified without authorization. If platform fails to protect these resources,
   the authentication service provided in this driver will be broken, and the behavior is undefined.
 
-Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2009 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -20,6 +20,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _AUTHSERVICE_INTERNAL_H_
 #define _AUTHSERVICE_INTERNAL_H_
 
+#include <Uefi.h>
+
 #include <Library/AuthVariableLib.h>
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -87,6 +89,35 @@ typedef struct {
 } AUTH_CERT_DB_DATA;
 #pragma pack()
 
+///
+/// Entry of the hashed set of the EFI_SIGNATURE_DATA of signature lists.
+/// The offsets are from the start of the signature lists.
+///
+typedef struct {
+  UINT32    ListOffset;
+  UINT32    CertOffset;
+  UINT32    Hash;
+  /// Index plus one of the next entry of the bucket, zero for the last one.
+  UINT32    Next;
+} SIGNATURE_SET_ENTRY;
+
+///
+/// Hashed set of the EFI_SIGNATURE_DATA of signature lists, used to look up a
+/// signature without scanning all the lists. The entries and the buckets are
+/// allocated once, and the set falls back to a scan of the lists when they
+/// have more signatures than MaxEntries.
+///
+typedef struct {
+  SIGNATURE_SET_ENTRY    *Entries;
+  UINT32                 *Buckets;
+  UINTN                  MaxEntries;
+  UINTN                  BucketMask;
+  UINTN                  Count;
+  BOOLEAN                Indexed;
+  UINT8                  *Data;
+  UINTN                  DataSize;
+} SIGNATURE_SET;
+
 extern UINT8   *mCertDbStore;
 extern UINT32  mMaxCertDbSize;
 extern UINT32  mPlatformMode;
@@ -98,6 +129,8 @@ extern VOID  *mHashSha512Ctx;
 
 extern AUTH_VAR_LIB_CONTEXT_IN  *mAuthVarLibContextIn;
 
+extern SIGNATURE_SET  mSignatureSet;
+
 /**
   Process variable with EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS set
 
@@ -367,4 +400,82 @@ AuthServiceInternalUpdateVariableWithTimeStamp (
   IN EFI_TIME  *TimeStamp
   );
 
+/**
+  Allocate the entries and the buckets of a signature set.
+
+  @param[out] Set               The signature set.
+  @param[in]  MaxEntries        The maximum number of signatures indexed by the set.
+
+  @retval EFI_SUCCESS           The signature set is allocated.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough resource.
+
+**/
+EFI_STATUS
+SignatureSetInit (
+  OUT SIGNATURE_SET  *Set,
+  IN  UINTN          MaxEntries
+  );
+
+/**
+  Index the EFI_SIGNATURE_DATA of signature lists in a signature set.
+
+  The set keeps pointing to the signature lists, which must not change while
+  the set is used.
+
+  @param[in, out] Set           The signature set.
+  @param[in]      Data          Pointer to the EFI_SIGNATURE_LIST.
+  @param[in]      DataSize      Size of Data buffer.
+
+  @retval EFI_SUCCESS           The signatures are indexed.
+  @retval EFI_BUFFER_TOO_SMALL  The lists have more signatures than the set can
+                                index. The set scans the lists instead.
+
+**/
+EFI_STATUS
+SignatureSetBuild (
+  IN OUT SIGNATURE_SET  *Set,
+  IN     VOID           *Data,
+  IN     UINTN          DataSize
+  );
+
+/**
+  Check whether a signature is in the signature lists of a signature set.
+
+  @param[in]  Set               The signature set.
+  @param[in]  SignatureType     Type of the signature list of the signature.
+  @param[in]  SignatureSize     SignatureSize of the signature list of the signature.
+  @param[in]  Cert              The EFI_SIGNATURE_DATA, owner included.
+
+  @retval TRUE                  A list of the same type and signature size has the signature.
+  @retval FALSE                 The signature is not in the set.
+
+**/
+BOOLEAN
+SignatureSetContains (
+  IN SIGNATURE_SET       *Set,
+  IN EFI_GUID            *SignatureType,
+  IN UINT32              SignatureSize,
+  IN EFI_SIGNATURE_DATA  *Cert
+  );
+
+/**
+  Copy the EFI_SIGNATURE_DATA of new signature lists which are not in a
+  signature set, as signature lists without the signatures of the set.
+
+  @param[in]  Set               The signature set of the original data.
+  @param[in]  NewData           Pointer to new EFI_SIGNATURE_LIST.
+  @param[in]  NewDataSize       Size of NewData buffer.
+  @param[out] Buffer            Buffer of NewDataSize bytes for the filtered lists.
+
+  @return The size of the filtered lists in Buffer.
+
+**/
+UINTN
+SignatureSetFilter (
+  IN  SIGNATURE_SET  *Set,
+  IN  VOID           *NewData,
+  IN  UINTN          NewDataSize,
+  OUT VOID           *Buffer
+  );
+
 #endif
@@ -11,7 +11,7 @@
   may not be modified without authorization. If platform fails to protect these resources,
   the authentication service provided in this driver will be broken, and the behavior is undefined.
 
-Copyright (c) 2015 - 2016, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -35,6 +35,11 @@ VOID  *mHashSha256Ctx = NULL;
 VOID  *mHashSha384Ctx = NULL;
 VOID  *mHashSha512Ctx = NULL;
 
+//
+// Signature set of the original data of signature list variables appended to
+//
+SIGNATURE_SET  mSignatureSet;
+
 VARIABLE_ENTRY_PROPERTY  mAuthVarEntry[] = {
   {
     &gEfiSecureBootEnableDisableGuid,
@@ -93,7 +98,7 @@ VARIABLE_ENTRY_PROPERTY  mAuthVarEntry[] = {
   },
 };
 
-VOID  **mAuthVarAddressPointer[11];
+VOID  **mAuthVarAddressPointer[13];
 
 AUTH_VAR_LIB_CONTEXT_IN  *mAuthVarLibContextIn = NULL;
 
@@ -161,6 +166,18 @@ AuthVariableLibInitialize (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Reserve runtime buffer for the signature set, for as many SHA-1 signatures
+  // as a variable can hold. Signature lists with more signatures are scanned.
+  //
+  Status = SignatureSetInit (
+             &mSignatureSet,
+             mAuthVarLibContextIn->MaxAuthVariableSize / (sizeof (EFI_GUID) + SHA1_DIGEST_SIZE)
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   Status = AuthServiceInternalFindVariable (EFI_PLATFORM_KEY_NAME, &gEfiGlobalVariableGuid, (VOID **)&Data, &DataSize);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "Variable %s does not exist.\n", EFI_PLATFORM_KEY_NAME));
@@ -376,6 +393,8 @@ AuthVariableLibInitialize (
   mAuthVarAddressPointer[8]                 = (VOID **)&(mAuthVarLibContextIn->GetScratchBuffer),
   mAuthVarAddressPointer[9]                 = (VOID **)&(mAuthVarLibContextIn->CheckRemainingSpaceForConsistency),
   mAuthVarAddressPointer[10]                = (VOID **)&(mAuthVarLibContextIn->AtRuntime),
+  mAuthVarAddressPointer[11]                = (VOID **)&mSignatureSet.Entries;
+  mAuthVarAddressPointer[12]                = (VOID **)&mSignatureSet.Buckets;
   AuthVarLibContextOut->AddressPointer      = mAuthVarAddressPointer;
   AuthVarLibContextOut->AddressPointerCount = ARRAY_SIZE (mAuthVarAddressPointer);
 
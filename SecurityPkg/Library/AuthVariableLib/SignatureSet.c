@@ -0,0 +1,349 @@
+/** @file
+  Hashed set of the EFI_SIGNATURE_DATA of signature lists.
+
+  Appending to db, dbx, dbt or KEK drops the signatures which are already in
+  the variable. With a dbx of thousands of hashes, looking up each new
+  signature in all the original signature lists is slow, so the original
+  signatures are indexed once in a hash table, and each new signature is only
+  compared with the signatures of its bucket.
+
+  Caution: This module requires additional review when modified.
+  This driver will have external input - variable data. It may be input in SMM mode.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "AuthServiceInternal.h"
+
+//
+// Minimum number of buckets of a signature set
+//
+#define SIGNATURE_SET_MIN_BUCKETS  16
+
+#define SIGNATURE_SET_FNV_OFFSET  0x811c9dc5
+#define SIGNATURE_SET_FNV_PRIME   0x01000193
+
+/**
+  Hash an EFI_SIGNATURE_DATA.
+
+  @param[in]  Cert              The EFI_SIGNATURE_DATA, owner included.
+  @param[in]  SignatureSize     Size of Cert.
+
+  @return The 32-bit FNV-1a hash of the signature.
+
+**/
+STATIC
+UINT32
+GetSignatureHash (
+  IN EFI_SIGNATURE_DATA  *Cert,
+  IN UINTN               SignatureSize
+  )
+{
+  UINT8   *Byte;
+  UINT32  Hash;
+
+  Hash = SIGNATURE_SET_FNV_OFFSET;
+  for (Byte = (UINT8 *)Cert; Byte < (UINT8 *)Cert + SignatureSize; Byte++) {
+    Hash = (Hash ^ *Byte) * SIGNATURE_SET_FNV_PRIME;
+  }
+
+  return Hash;
+}
+
+/**
+  Allocate the entries and the buckets of a signature set.
+
+  @param[out] Set               The signature set.
+  @param[in]  MaxEntries        The maximum number of signatures indexed by the set.
+
+  @retval EFI_SUCCESS           The signature set is allocated.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough resource.
+
+**/
+EFI_STATUS
+SignatureSetInit (
+  OUT SIGNATURE_SET  *Set,
+  IN  UINTN          MaxEntries
+  )
+{
+  UINTN  BucketCount;
+
+  ZeroMem (Set, sizeof (*Set));
+  if (MaxEntries == 0) {
+    return EFI_SUCCESS;
+  }
+
+  BucketCount = SIGNATURE_SET_MIN_BUCKETS;
+  while (BucketCount < MaxEntries) {
+    BucketCount *= 2;
+  }
+
+  Set->Entries = AllocateRuntimePool (MaxEntries * sizeof (SIGNATURE_SET_ENTRY));
+  Set->Buckets = AllocateRuntimePool (BucketCount * sizeof (UINT32));
+  if ((Set->Entries == NULL) || (Set->Buckets == NULL)) {
+    if (Set->Entries != NULL) {
+      FreePool (Set->Entries);
+      Set->Entries = NULL;
+    }
+
+    if (Set->Buckets != NULL) {
+      FreePool (Set->Buckets);
+      Set->Buckets = NULL;
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Set->MaxEntries = MaxEntries;
+  Set->BucketMask = BucketCount - 1;
+  return EFI_SUCCESS;
+}
+
+/**
+  Index the EFI_SIGNATURE_DATA of signature lists in a signature set.
+
+  The set keeps pointing to the signature lists, which must not change while
+  the set is used.
+
+  @param[in, out] Set           The signature set.
+  @param[in]      Data          Pointer to the EFI_SIGNATURE_LIST.
+  @param[in]      DataSize      Size of Data buffer.
+
+  @retval EFI_SUCCESS           The signatures are indexed.
+  @retval EFI_BUFFER_TOO_SMALL  The lists have more signatures than the set can
+                                index. The set scans the lists instead.
+
+**/
+EFI_STATUS
+SignatureSetBuild (
+  IN OUT SIGNATURE_SET  *Set,
+  IN     VOID           *Data,
+  IN     UINTN          DataSize
+  )
+{
+  EFI_SIGNATURE_LIST   *CertList;
+  EFI_SIGNATURE_DATA   *Cert;
+  UINTN                CertCount;
+  UINTN                Index;
+  UINTN                Size;
+  UINTN                Bucket;
+  SIGNATURE_SET_ENTRY  *Entry;
+
+  Set->Data     = Data;
+  Set->DataSize = DataSize;
+  Set->Count    = 0;
+  Set->Indexed  = FALSE;
+
+  if ((Set->MaxEntries == 0) || (DataSize > MAX_UINT32)) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  ZeroMem (Set->Buckets, (Set->BucketMask + 1) * sizeof (UINT32));
+
+  Size     = DataSize;
+  CertList = (EFI_SIGNATURE_LIST *)Data;
+  while ((Size > 0) && (Size >= CertList->SignatureListSize)) {
+    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    for (Index = 0; Index < CertCount; Index++) {
+      if (Set->Count == Set->MaxEntries) {
+        return EFI_BUFFER_TOO_SMALL;
+      }
+
+      Entry             = &Set->Entries[Set->Count];
+      Entry->ListOffset = (UINT32)((UINT8 *)CertList - Set->Data);
+      Entry->CertOffset = (UINT32)((UINT8 *)Cert - Set->Data);
+      Entry->Hash       = GetSignatureHash (Cert, CertList->SignatureSize);
+      Bucket            = Entry->Hash & Set->BucketMask;
+      Entry->Next       = Set->Buckets[Bucket];
+      Set->Count++;
+      Set->Buckets[Bucket] = (UINT32)Set->Count;
+
+      Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+    }
+
+    Size    -= CertList->SignatureListSize;
+    CertList = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+
+  Set->Indexed = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether a signature is in the signature lists of a signature set, by
+  scanning all the lists.
+
+  @param[in]  Set               The signature set.
+  @param[in]  SignatureType     Type of the signature list of the signature.
+  @param[in]  SignatureSize     SignatureSize of the signature list of the signature.
+  @param[in]  Cert              The EFI_SIGNATURE_DATA, owner included.
+
+  @retval TRUE                  A list of the same type and signature size has the signature.
+  @retval FALSE                 The signature is not in the set.
+
+**/
+STATIC
+BOOLEAN
+ScanSignatureLists (
+  IN SIGNATURE_SET       *Set,
+  IN EFI_GUID            *SignatureType,
+  IN UINT32              SignatureSize,
+  IN EFI_SIGNATURE_DATA  *Cert
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *OrgCert;
+  UINTN               CertCount;
+  UINTN               Index;
+  UINTN               Size;
+
+  Size     = Set->DataSize;
+  CertList = (EFI_SIGNATURE_LIST *)Set->Data;
+  while ((Size > 0) && (Size >= CertList->SignatureListSize)) {
+    if (CompareGuid (&CertList->SignatureType, SignatureType) &&
+        (CertList->SignatureSize == SignatureSize))
+    {
+      OrgCert   = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+      for (Index = 0; Index < CertCount; Index++) {
+        if (CompareMem (Cert, OrgCert, SignatureSize) == 0) {
+          return TRUE;
+        }
+
+        OrgCert = (EFI_SIGNATURE_DATA *)((UINT8 *)OrgCert + CertList->SignatureSize);
+      }
+    }
+
+    Size    -= CertList->SignatureListSize;
+    CertList = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+
+  return FALSE;
+}
+
+/**
+  Check whether a signature is in the signature lists of a signature set.
+
+  @param[in]  Set               The signature set.
+  @param[in]  SignatureType     Type of the signature list of the signature.
+  @param[in]  SignatureSize     SignatureSize of the signature list of the signature.
+  @param[in]  Cert              The EFI_SIGNATURE_DATA, owner included.
+
+  @retval TRUE                  A list of the same type and signature size has the signature.
+  @retval FALSE                 The signature is not in the set.
+
+**/
+BOOLEAN
+SignatureSetContains (
+  IN SIGNATURE_SET       *Set,
+  IN EFI_GUID            *SignatureType,
+  IN UINT32              SignatureSize,
+  IN EFI_SIGNATURE_DATA  *Cert
+  )
+{
+  SIGNATURE_SET_ENTRY  *Entry;
+  EFI_SIGNATURE_LIST   *CertList;
+  UINT32               Hash;
+  UINT32               Next;
+
+  if (!Set->Indexed) {
+    return ScanSignatureLists (Set, SignatureType, SignatureSize, Cert);
+  }
+
+  Hash = GetSignatureHash (Cert, SignatureSize);
+  for (Next = Set->Buckets[Hash & Set->BucketMask]; Next != 0; Next = Entry->Next) {
+    Entry = &Set->Entries[Next - 1];
+    if (Entry->Hash != Hash) {
+      continue;
+    }
+
+    CertList = (EFI_SIGNATURE_LIST *)(Set->Data + Entry->ListOffset);
+    if ((CertList->SignatureSize == SignatureSize) &&
+        CompareGuid (&CertList->SignatureType, SignatureType) &&
+        (CompareMem (Cert, Set->Data + Entry->CertOffset, SignatureSize) == 0))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Copy the EFI_SIGNATURE_DATA of new signature lists which are not in a
+  signature set, as signature lists without the signatures of the set.
+
+  @param[in]  Set               The signature set of the original data.
+  @param[in]  NewData           Pointer to new EFI_SIGNATURE_LIST.
+  @param[in]  NewDataSize       Size of NewData buffer.
+  @param[out] Buffer            Buffer of NewDataSize bytes for the filtered lists.
+
+  @return The size of the filtered lists in Buffer.
+
+**/
+UINTN
+SignatureSetFilter (
+  IN  SIGNATURE_SET  *Set,
+  IN  VOID           *NewData,
+  IN  UINTN          NewDataSize,
+  OUT VOID           *Buffer
+  )
+{
+  EFI_SIGNATURE_LIST  *NewCertList;
+  EFI_SIGNATURE_DATA  *NewCert;
+  UINTN               NewCertCount;
+  EFI_SIGNATURE_LIST  *CertList;
+  UINTN               Index;
+  UINT8               *Tail;
+  UINTN               CopiedCount;
+  UINTN               SignatureListSize;
+
+  Tail = Buffer;
+
+  NewCertList = (EFI_SIGNATURE_LIST *)NewData;
+  while ((NewDataSize > 0) && (NewDataSize >= NewCertList->SignatureListSize)) {
+    NewCert      = (EFI_SIGNATURE_DATA *)((UINT8 *)NewCertList + sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize);
+    NewCertCount = (NewCertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - NewCertList->SignatureHeaderSize) / NewCertList->SignatureSize;
+
+    CopiedCount = 0;
+    for (Index = 0; Index < NewCertCount; Index++) {
+      if (!SignatureSetContains (Set, &NewCertList->SignatureType, NewCertList->SignatureSize, NewCert)) {
+        //
+        // New EFI_SIGNATURE_DATA, keep it.
+        //
+        if (CopiedCount == 0) {
+          //
+          // Copy EFI_SIGNATURE_LIST header for only once.
+          //
+          CopyMem (Tail, NewCertList, sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize);
+          Tail = Tail + sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize;
+        }
+
+        CopyMem (Tail, NewCert, NewCertList->SignatureSize);
+        Tail += NewCertList->SignatureSize;
+        CopiedCount++;
+      }
+
+      NewCert = (EFI_SIGNATURE_DATA *)((UINT8 *)NewCert + NewCertList->SignatureSize);
+    }
+
+    //
+    // Update SignatureListSize in the kept EFI_SIGNATURE_LIST.
+    //
+    if (CopiedCount != 0) {
+      SignatureListSize           = sizeof (EFI_SIGNATURE_LIST) + NewCertList->SignatureHeaderSize + (CopiedCount * NewCertList->SignatureSize);
+      CertList                    = (EFI_SIGNATURE_LIST *)(Tail - SignatureListSize);
+      CertList->SignatureListSize = (UINT32)SignatureListSize;
+    }
+
+    NewDataSize -= NewCertList->SignatureListSize;
+    NewCertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)NewCertList + NewCertList->SignatureListSize);
+  }
+
+  return (UINTN)(Tail - (UINT8 *)Buffer);
+}
@@ -0,0 +1,330 @@
+/** @file
+  Host based test and benchmark for the signature set used to filter out the
+  duplicated signatures of appended signature lists.
+
+  A dbx of increasing size is filled with SHA-256 hashes, as the revocation
+  lists published for Secure Boot, and an append of new hashes, half of them
+  already in dbx, is filtered as FilterSignatureList() does. The signatures
+  kept are checked against a scan of dbx, and the time to filter the append is
+  reported with and without the hashed index.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "../AuthServiceInternal.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "Signature Set Test and Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// Number of SHA-256 hashes appended to dbx
+//
+#define TEST_APPEND_COUNT  1000
+
+#define TEST_SHA256_SIGNATURE_SIZE  (sizeof (EFI_GUID) + SHA256_DIGEST_SIZE)
+
+STATIC UINTN  mDbxSizes[] = { 431, 2000, 10000 };
+
+STATIC EFI_GUID  mOwner = {
+  0x77fa9abd, 0x0359, 0x4d32, { 0xbd, 0x60, 0x28, 0xf4, 0xe7, 0x8f, 0x78, 0x4b }
+};
+
+STATIC EFI_GUID  mOtherOwner = {
+  0x8be4df61, 0x93ca, 0x11d2, { 0xaa, 0x0d, 0x00, 0xe0, 0x98, 0x03, 0x2b, 0x8c }
+};
+
+/**
+  Fill the digest of the n-th hash of the test.
+
+  @param[out] Digest  The SHA-256 sized digest.
+  @param[in]  Number  The number of the hash.
+**/
+STATIC
+VOID
+FillTestDigest (
+  OUT UINT8   *Digest,
+  IN  UINT32  Number
+  )
+{
+  UINT32  Seed;
+  UINTN   Index;
+
+  Seed = Number * 2654435761u + 1;
+  for (Index = 0; Index < SHA256_DIGEST_SIZE; Index++) {
+    Seed          = Seed * 1103515245 + 12345;
+    Digest[Index] = (UINT8)(Seed >> 16);
+  }
+}
+
+/**
+  Write a signature list of SHA-256 sized signatures.
+
+  @param[out] Buffer        The buffer of the signature list.
+  @param[in]  SignatureType Type of the signature list.
+  @param[in]  Owner         Owner of the signatures.
+  @param[in]  Numbers       The numbers of the hashes of the signatures.
+  @param[in]  Count         Number of signatures.
+
+  @return The size of the signature list.
+**/
+STATIC
+UINTN
+WriteSignatureList (
+  OUT UINT8     *Buffer,
+  IN  EFI_GUID  *SignatureType,
+  IN  EFI_GUID  *Owner,
+  IN  UINT32    *Numbers,
+  IN  UINTN     Count
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINTN               Index;
+
+  CertList = (EFI_SIGNATURE_LIST *)Buffer;
+  CopyGuid (&CertList->SignatureType, SignatureType);
+  CertList->SignatureListSize   = (UINT32)(sizeof (EFI_SIGNATURE_LIST) + Count * TEST_SHA256_SIGNATURE_SIZE);
+  CertList->SignatureHeaderSize = 0;
+  CertList->SignatureSize       = TEST_SHA256_SIGNATURE_SIZE;
+
+  Cert = (EFI_SIGNATURE_DATA *)(CertList + 1);
+  for (Index = 0; Index < Count; Index++) {
+    CopyGuid (&Cert->SignatureOwner, Owner);
+    FillTestDigest (Cert->SignatureData, Numbers[Index]);
+    Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + TEST_SHA256_SIGNATURE_SIZE);
+  }
+
+  return CertList->SignatureListSize;
+}
+
+/**
+  Filter the append of the test and time it.
+
+  @param[in]  Set             The signature set of dbx.
+  @param[in]  NewData         The appended signature lists.
+  @param[in]  NewDataSize     Size of NewData.
+  @param[out] Buffer          Buffer of NewDataSize bytes for the filtered lists.
+  @param[out] Microseconds    Time to filter the append.
+
+  @return The size of the filtered lists.
+**/
+STATIC
+UINTN
+TimeFilter (
+  IN  SIGNATURE_SET  *Set,
+  IN  VOID           *NewData,
+  IN  UINTN          NewDataSize,
+  OUT VOID           *Buffer,
+  OUT UINT64         *Microseconds
+  )
+{
+  clock_t  Start;
+  UINTN    Size;
+
+  Start         = clock ();
+  Size          = SignatureSetFilter (Set, NewData, NewDataSize, Buffer);
+  *Microseconds = (UINT64)(clock () - Start) * 1000000 / CLOCKS_PER_SEC;
+  return Size;
+}
+
+/**
+  Filter appends to dbx of increasing size, with and without the hashed index.
+
+  @param[in]  Context  Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DbxAppendTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SIGNATURE_SET       Set;
+  SIGNATURE_SET       ScanSet;
+  SIGNATURE_SET       SmallSet;
+  UINT32              *Numbers;
+  UINT8               *Dbx;
+  UINTN               DbxSize;
+  UINT8               *NewData;
+  UINTN               NewDataSize;
+  UINT8               *Filtered;
+  UINT8               *Expected;
+  UINTN               FilteredSize;
+  UINTN               ExpectedSize;
+  UINTN               SizeIndex;
+  UINTN               DbxCount;
+  UINTN               Index;
+  EFI_SIGNATURE_LIST  *CertList;
+  UINT64              IndexedUs;
+  UINT64              ScanUs;
+
+  for (SizeIndex = 0; SizeIndex < ARRAY_SIZE (mDbxSizes); SizeIndex++) {
+    DbxCount = mDbxSizes[SizeIndex];
+    Numbers  = AllocatePool (MAX (DbxCount, TEST_APPEND_COUNT) * sizeof (UINT32));
+    Dbx      = AllocatePool (2 * sizeof (EFI_SIGNATURE_LIST) + DbxCount * TEST_SHA256_SIGNATURE_SIZE);
+    NewData  = AllocatePool (3 * sizeof (EFI_SIGNATURE_LIST) + (TEST_APPEND_COUNT + 2) * TEST_SHA256_SIGNATURE_SIZE);
+    Filtered = AllocatePool (3 * sizeof (EFI_SIGNATURE_LIST) + (TEST_APPEND_COUNT + 2) * TEST_SHA256_SIGNATURE_SIZE);
+    Expected = AllocatePool (3 * sizeof (EFI_SIGNATURE_LIST) + (TEST_APPEND_COUNT + 2) * TEST_SHA256_SIGNATURE_SIZE);
+    UT_ASSERT_NOT_NULL (Numbers);
+    UT_ASSERT_NOT_NULL (Dbx);
+    UT_ASSERT_NOT_NULL (NewData);
+    UT_ASSERT_NOT_NULL (Filtered);
+    UT_ASSERT_NOT_NULL (Expected);
+
+    //
+    // dbx holds the hashes 0 to DbxCount - 1, in two signature lists.
+    //
+    for (Index = 0; Index < DbxCount; Index++) {
+      Numbers[Index] = (UINT32)Index;
+    }
+
+    DbxSize  = WriteSignatureList (Dbx, &gEfiCertSha256Guid, &mOwner, Numbers, DbxCount / 2);
+    DbxSize += WriteSignatureList (Dbx + DbxSize, &gEfiCertSha256Guid, &mOwner, Numbers + DbxCount / 2, DbxCount - DbxCount / 2);
+
+    //
+    // Every other appended hash is already in dbx. The same hash with another
+    // owner, or in a list of another type, is not a duplicate.
+    //
+    for (Index = 0; Index < TEST_APPEND_COUNT; Index++) {
+      Numbers[Index] = (UINT32)(((Index % 2) == 0) ? (Index * 7) % DbxCount : DbxCount + Index);
+    }
+
+    NewDataSize  = WriteSignatureList (NewData, &gEfiCertSha256Guid, &mOwner, Numbers, TEST_APPEND_COUNT);
+    NewDataSize += WriteSignatureList (NewData + NewDataSize, &gEfiCertSha256Guid, &mOtherOwner, Numbers, 1);
+    NewDataSize += WriteSignatureList (NewData + NewDataSize, &gEfiCertSha384Guid, &mOwner, Numbers, 1);
+
+    ExpectedSize = 3 * sizeof (EFI_SIGNATURE_LIST) + (TEST_APPEND_COUNT / 2 + 2) * TEST_SHA256_SIGNATURE_SIZE;
+
+    //
+    // A set without entries scans dbx for each signature, as
+    // FilterSignatureList() did.
+    //
+    UT_ASSERT_NOT_EFI_ERROR (SignatureSetInit (&ScanSet, 0));
+    UT_ASSERT_STATUS_EQUAL (SignatureSetBuild (&ScanSet, Dbx, DbxSize), EFI_BUFFER_TOO_SMALL);
+    UT_ASSERT_EQUAL (TimeFilter (&ScanSet, NewData, NewDataSize, Expected, &ScanUs), ExpectedSize);
+
+    UT_ASSERT_NOT_EFI_ERROR (SignatureSetInit (&Set, DbxCount));
+    UT_ASSERT_NOT_EFI_ERROR (SignatureSetBuild (&Set, Dbx, DbxSize));
+    UT_ASSERT_EQUAL (Set.Count, DbxCount);
+    FilteredSize = TimeFilter (&Set, NewData, NewDataSize, Filtered, &IndexedUs);
+    UT_ASSERT_EQUAL (FilteredSize, ExpectedSize);
+    UT_ASSERT_MEM_EQUAL (Filtered, Expected, ExpectedSize);
+
+    CertList = (EFI_SIGNATURE_LIST *)Filtered;
+    UT_ASSERT_EQUAL (CertList->SignatureListSize, sizeof (EFI_SIGNATURE_LIST) + (TEST_APPEND_COUNT / 2) * TEST_SHA256_SIGNATURE_SIZE);
+
+    //
+    // A set too small for dbx falls back to the scan.
+    //
+    UT_ASSERT_NOT_EFI_ERROR (SignatureSetInit (&SmallSet, DbxCount - 1));
+    UT_ASSERT_STATUS_EQUAL (SignatureSetBuild (&SmallSet, Dbx, DbxSize), EFI_BUFFER_TOO_SMALL);
+    UT_ASSERT_FALSE (SmallSet.Indexed);
+    UT_ASSERT_EQUAL (SignatureSetFilter (&SmallSet, NewData, NewDataSize, Filtered), ExpectedSize);
+    UT_ASSERT_MEM_EQUAL (Filtered, Expected, ExpectedSize);
+
+    UT_LOG_INFO (
+      "dbx of %Lu hashes, %Lu appended: %Lu us indexed, %Lu us scanned\n",
+      (UINT64)DbxCount,
+      (UINT64)TEST_APPEND_COUNT,
+      IndexedUs,
+      ScanUs
+      );
+
+    FreePool (Set.Entries);
+    FreePool (Set.Buckets);
+    FreePool (SmallSet.Entries);
+    FreePool (SmallSet.Buckets);
+    FreePool (Numbers);
+    FreePool (Dbx);
+    FreePool (NewData);
+    FreePool (Filtered);
+    FreePool (Expected);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the signature
+  set and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SignatureSetTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&SignatureSetTests, Framework, "Signature Set Tests", "AuthVariableLib.SignatureSet", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the Signature Set Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (SignatureSetTests, "Filter appends to dbx of increasing size", "DbxAppend", DbxAppendTest, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define SignatureSetBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+SignatureSetBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
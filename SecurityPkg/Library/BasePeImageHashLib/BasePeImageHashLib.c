@@ -0,0 +1,510 @@
+/** @file
+  Calculate the Authenticode digests of a PE/COFF image with several hash
+  algorithms in one walk of the image.
+
+  Caution: This file requires additional review when modified.
+  This library will have external input - PE/COFF image.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+  PeImageHashRanges() and PeImageHashAll() will accept untrusted PE/COFF image
+  which was checked by PeCoffLoaderGetImageInfo().
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <IndustryStandard/PeImage.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PeImageHashLib.h>
+
+typedef
+UINTN
+(EFIAPI *HASH_GET_CONTEXT_SIZE)(
+  VOID
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_INIT)(
+  OUT VOID  *HashContext
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_UPDATE)(
+  IN OUT VOID        *HashContext,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *HASH_FINAL)(
+  IN OUT VOID   *HashContext,
+  OUT    UINT8  *HashValue
+  );
+
+typedef struct {
+  UINT32                   HashMask;
+  UINTN                    DigestOffset;
+  HASH_GET_CONTEXT_SIZE    GetContextSize;
+  HASH_INIT                HashInit;
+  HASH_UPDATE              HashUpdate;
+  HASH_FINAL               HashFinal;
+} PE_IMAGE_HASH_ALGORITHM;
+
+STATIC CONST PE_IMAGE_HASH_ALGORITHM  mPeImageHashAlgorithm[] = {
+ #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+  { PE_IMAGE_HASH_SHA1,    OFFSET_OF (PE_IMAGE_DIGESTS, Sha1),   Sha1GetContextSize,   Sha1Init,   Sha1Update,   Sha1Final   },
+ #endif
+  { PE_IMAGE_HASH_SHA256,  OFFSET_OF (PE_IMAGE_DIGESTS, Sha256), Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final },
+  { PE_IMAGE_HASH_SHA384,  OFFSET_OF (PE_IMAGE_DIGESTS, Sha384), Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final },
+  { PE_IMAGE_HASH_SHA512,  OFFSET_OF (PE_IMAGE_DIGESTS, Sha512), Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final },
+  { PE_IMAGE_HASH_SM3_256, OFFSET_OF (PE_IMAGE_DIGESTS, Sm3),    Sm3GetContextSize,    Sm3Init,    Sm3Update,    Sm3Final    }
+};
+
+#define PE_IMAGE_HASH_ALGORITHM_COUNT  ARRAY_SIZE (mPeImageHashAlgorithm)
+
+//
+// Hash contexts of the algorithms of PeImageHashAll(), NULL for the ones not
+// asked for.
+//
+typedef struct {
+  VOID    *HashContext[PE_IMAGE_HASH_ALGORITHM_COUNT];
+} PE_IMAGE_HASH_CONTEXT;
+
+/**
+  Walk the ranges of a PE/COFF image which are part of its Authenticode hash,
+  in order, and give each of them to HashUpdate.
+
+  The image checksum, the certificate directory entry and the attribute
+  certificate table are excluded, and the sections are hashed in the order
+  of their file offsets.
+
+  @param[in]       ImageAddress   The PE/COFF image, checked by PeCoffLoaderGetImageInfo().
+  @param[in]       ImageSize      Size of the image.
+  @param[in]       HashUpdate     Function which hashes the ranges.
+  @param[in, out]  Context        Context of HashUpdate.
+
+  @retval EFI_SUCCESS             All the ranges were hashed.
+  @retval EFI_INVALID_PARAMETER   ImageAddress or HashUpdate is NULL.
+  @retval EFI_UNSUPPORTED         The image is not a PE32 or PE32+ image, or its
+                                  size is inconsistent with its certificate table.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to sort the sections.
+  @retval EFI_ABORTED             HashUpdate failed.
+
+**/
+EFI_STATUS
+EFIAPI
+PeImageHashRanges (
+  IN     CONST VOID            *ImageAddress,
+  IN     UINTN                 ImageSize,
+  IN     PE_IMAGE_HASH_UPDATE  HashUpdate,
+  IN OUT VOID                  *Context
+  )
+{
+  EFI_STATUS                           Status;
+  UINT8                                *ImageBase;
+  EFI_IMAGE_DOS_HEADER                 *DosHdr;
+  UINT32                               PeCoffHeaderOffset;
+  EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION  Hdr;
+  EFI_IMAGE_SECTION_HEADER             *Section;
+  EFI_IMAGE_SECTION_HEADER             *SectionHeader;
+  UINT8                                *HashBase;
+  UINTN                                HashSize;
+  UINTN                                SumOfBytesHashed;
+  UINTN                                Index;
+  UINTN                                Pos;
+  UINT32                               CertSize;
+  UINT32                               NumberOfRvaAndSizes;
+
+  if ((ImageAddress == NULL) || (HashUpdate == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ImageBase     = (UINT8 *)ImageAddress;
+  SectionHeader = NULL;
+  Status        = EFI_ABORTED;
+
+  DosHdr             = (EFI_IMAGE_DOS_HEADER *)ImageBase;
+  PeCoffHeaderOffset = 0;
+  if (DosHdr->e_magic == EFI_IMAGE_DOS_SIGNATURE) {
+    PeCoffHeaderOffset = DosHdr->e_lfanew;
+  }
+
+  Hdr.Pe32 = (EFI_IMAGE_NT_HEADERS32 *)(ImageBase + PeCoffHeaderOffset);
+  if (Hdr.Pe32->Signature != EFI_IMAGE_NT_SIGNATURE) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // PE/COFF Image Measurement
+  //
+  //    NOTE: The following codes/steps are based upon the authenticode image hashing in
+  //      PE/COFF Specification 8.0 Appendix A.
+  //
+  //
+
+  // 1.  Load the image header into memory.
+
+  // 2.  Initialize a SHA hash context.
+
+  //
+  // Measuring PE/COFF Image Header;
+  // But CheckSum field and SECURITY data directory (certificate) are excluded
+  //
+
+  //
+  // 3.  Calculate the distance from the base of the image header to the image checksum address.
+  // 4.  Hash the image header from its base to beginning of the image checksum.
+  //
+  HashBase = ImageBase;
+  if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+    //
+    // Use PE32 offset.
+    //
+    HashSize            = (UINTN)(&Hdr.Pe32->OptionalHeader.CheckSum) - (UINTN)HashBase;
+    NumberOfRvaAndSizes = Hdr.Pe32->OptionalHeader.NumberOfRvaAndSizes;
+  } else if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
+    //
+    // Use PE32+ offset.
+    //
+    HashSize            = (UINTN)(&Hdr.Pe32Plus->OptionalHeader.CheckSum) - (UINTN)HashBase;
+    NumberOfRvaAndSizes = Hdr.Pe32Plus->OptionalHeader.NumberOfRvaAndSizes;
+  } else {
+    //
+    // Invalid header magic number.
+    //
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!HashUpdate (Context, HashBase, HashSize)) {
+    goto Done;
+  }
+
+  //
+  // 5.  Skip over the image checksum (it occupies a single ULONG).
+  //
+  if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
+    //
+    // 6.  Since there is no Cert Directory in optional header, hash everything
+    //     from the end of the checksum to the end of image header.
+    //
+    if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+      //
+      // Use PE32 offset.
+      //
+      HashBase = (UINT8 *)&Hdr.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = Hdr.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)ImageBase);
+    } else {
+      //
+      // Use PE32+ offset.
+      //
+      HashBase = (UINT8 *)&Hdr.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = Hdr.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)ImageBase);
+    }
+
+    if (HashSize != 0) {
+      if (!HashUpdate (Context, HashBase, HashSize)) {
+        goto Done;
+      }
+    }
+  } else {
+    //
+    // 7.  Hash everything from the end of the checksum to the start of the Cert Directory.
+    //
+    if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+      //
+      // Use PE32 offset.
+      //
+      HashBase = (UINT8 *)&Hdr.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = (UINTN)(&Hdr.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
+    } else {
+      //
+      // Use PE32+ offset.
+      //
+      HashBase = (UINT8 *)&Hdr.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
+      HashSize = (UINTN)(&Hdr.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
+    }
+
+    if (HashSize != 0) {
+      if (!HashUpdate (Context, HashBase, HashSize)) {
+        goto Done;
+      }
+    }
+
+    //
+    // 8.  Skip over the Cert Directory. (It is sizeof(IMAGE_DATA_DIRECTORY) bytes.)
+    // 9.  Hash everything from the end of the Cert Directory to the end of image header.
+    //
+    if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+      //
+      // Use PE32 offset
+      //
+      HashBase = (UINT8 *)&Hdr.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
+      HashSize = Hdr.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)ImageBase);
+    } else {
+      //
+      // Use PE32+ offset.
+      //
+      HashBase = (UINT8 *)&Hdr.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
+      HashSize = Hdr.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)ImageBase);
+    }
+
+    if (HashSize != 0) {
+      if (!HashUpdate (Context, HashBase, HashSize)) {
+        goto Done;
+      }
+    }
+  }
+
+  //
+  // 10. Set the SUM_OF_BYTES_HASHED to the size of the header.
+  //
+  if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+    //
+    // Use PE32 offset.
+    //
+    SumOfBytesHashed = Hdr.Pe32->OptionalHeader.SizeOfHeaders;
+  } else {
+    //
+    // Use PE32+ offset
+    //
+    SumOfBytesHashed = Hdr.Pe32Plus->OptionalHeader.SizeOfHeaders;
+  }
+
+  Section = (EFI_IMAGE_SECTION_HEADER *)(
+                                         ImageBase +
+                                         PeCoffHeaderOffset +
+                                         sizeof (UINT32) +
+                                         sizeof (EFI_IMAGE_FILE_HEADER) +
+                                         Hdr.Pe32->FileHeader.SizeOfOptionalHeader
+                                         );
+
+  //
+  // 11. Build a temporary table of pointers to all the IMAGE_SECTION_HEADER
+  //     structures in the image. The 'NumberOfSections' field of the image
+  //     header indicates how big the table should be. Do not include any
+  //     IMAGE_SECTION_HEADERs in the table whose 'SizeOfRawData' field is zero.
+  //
+  SectionHeader = (EFI_IMAGE_SECTION_HEADER *)AllocateZeroPool (sizeof (EFI_IMAGE_SECTION_HEADER) * Hdr.Pe32->FileHeader.NumberOfSections);
+  if (SectionHeader == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  //
+  // 12.  Using the 'PointerToRawData' in the referenced section headers as
+  //      a key, arrange the elements in the table in ascending order. In other
+  //      words, sort the section headers according to the disk-file offset of
+  //      the section.
+  //
+  for (Index = 0; Index < Hdr.Pe32->FileHeader.NumberOfSections; Index++) {
+    Pos = Index;
+    while ((Pos > 0) && (Section->PointerToRawData < SectionHeader[Pos - 1].PointerToRawData)) {
+      CopyMem (&SectionHeader[Pos], &SectionHeader[Pos - 1], sizeof (EFI_IMAGE_SECTION_HEADER));
+      Pos--;
+    }
+
+    CopyMem (&SectionHeader[Pos], Section, sizeof (EFI_IMAGE_SECTION_HEADER));
+    Section += 1;
+  }
+
+  //
+  // 13.  Walk through the sorted table, bring the corresponding section
+  //      into memory, and hash the entire section (using the 'SizeOfRawData'
+  //      field in the section header to determine the amount of data to hash).
+  // 14.  Add the section's 'SizeOfRawData' to SUM_OF_BYTES_HASHED .
+  // 15.  Repeat steps 13 and 14 for all the sections in the sorted table.
+  //
+  for (Index = 0; Index < Hdr.Pe32->FileHeader.NumberOfSections; Index++) {
+    Section = &SectionHeader[Index];
+    if (Section->SizeOfRawData == 0) {
+      continue;
+    }
+
+    HashBase = ImageBase + Section->PointerToRawData;
+    HashSize = (UINTN)Section->SizeOfRawData;
+
+    if (!HashUpdate (Context, HashBase, HashSize)) {
+      goto Done;
+    }
+
+    SumOfBytesHashed += HashSize;
+  }
+
+  //
+  // 16.  If the file size is greater than SUM_OF_BYTES_HASHED, there is extra
+  //      data in the file that needs to be added to the hash. This data begins
+  //      at file offset SUM_OF_BYTES_HASHED and its length is:
+  //             FileSize  -  (CertDirectory->Size)
+  //
+  if (ImageSize > SumOfBytesHashed) {
+    HashBase = ImageBase + SumOfBytesHashed;
+
+    if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
+      CertSize = 0;
+    } else {
+      if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+        //
+        // Use PE32 offset.
+        //
+        CertSize = Hdr.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
+      } else {
+        //
+        // Use PE32+ offset.
+        //
+        CertSize = Hdr.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
+      }
+    }
+
+    if (ImageSize > CertSize + SumOfBytesHashed) {
+      HashSize = (UINTN)(ImageSize - CertSize - SumOfBytesHashed);
+
+      if (!HashUpdate (Context, HashBase, HashSize)) {
+        goto Done;
+      }
+    } else if (ImageSize < CertSize + SumOfBytesHashed) {
+      Status = EFI_UNSUPPORTED;
+      goto Done;
+    }
+  }
+
+  Status = EFI_SUCCESS;
+
+Done:
+  if (SectionHeader != NULL) {
+    FreePool (SectionHeader);
+  }
+
+  return Status;
+}
+
+/**
+  Hash a range of the PE/COFF image with all the algorithms of PeImageHashAll().
+
+  @param[in, out]  Context    The PE_IMAGE_HASH_CONTEXT of the algorithms.
+  @param[in]       Data       The range of the image to hash.
+  @param[in]       DataSize   Size of the range.
+
+  @retval TRUE     The range was hashed.
+  @retval FALSE    The hash failed.
+
+**/
+STATIC
+BOOLEAN
+EFIAPI
+PeImageHashAllUpdate (
+  IN OUT VOID        *Context,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  )
+{
+  PE_IMAGE_HASH_CONTEXT  *HashContext;
+  UINTN                  Index;
+
+  HashContext = (PE_IMAGE_HASH_CONTEXT *)Context;
+  for (Index = 0; Index < PE_IMAGE_HASH_ALGORITHM_COUNT; Index++) {
+    if (HashContext->HashContext[Index] != NULL) {
+      if (!mPeImageHashAlgorithm[Index].HashUpdate (HashContext->HashContext[Index], Data, DataSize)) {
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Calculate the Authenticode digests of a PE/COFF image with several hash
+  algorithms, in one walk of the image.
+
+  @param[in]   ImageAddress   The PE/COFF image, checked by PeCoffLoaderGetImageInfo().
+  @param[in]   ImageSize      Size of the image.
+  @param[in]   HashMask       The PE_IMAGE_HASH_* algorithms of the digests.
+  @param[out]  Digests        The digests of the image.
+
+  @retval EFI_SUCCESS             The digests of all the algorithms of HashMask are
+                                  returned.
+  @retval EFI_INVALID_PARAMETER   ImageAddress or Digests is NULL, or HashMask is zero.
+  @retval EFI_UNSUPPORTED         An algorithm of HashMask is not supported, or the
+                                  image is not a valid PE32 or PE32+ image.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the hash contexts.
+  @retval EFI_ABORTED             A hash operation failed.
+
+**/
+EFI_STATUS
+EFIAPI
+PeImageHashAll (
+  IN  CONST VOID        *ImageAddress,
+  IN  UINTN             ImageSize,
+  IN  UINT32            HashMask,
+  OUT PE_IMAGE_DIGESTS  *Digests
+  )
+{
+  EFI_STATUS             Status;
+  PE_IMAGE_HASH_CONTEXT  HashContext;
+  UINT32                 SupportedMask;
+  UINTN                  Index;
+
+  if ((ImageAddress == NULL) || (Digests == NULL) || (HashMask == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  SupportedMask = 0;
+  for (Index = 0; Index < PE_IMAGE_HASH_ALGORITHM_COUNT; Index++) {
+    SupportedMask |= mPeImageHashAlgorithm[Index].HashMask;
+  }
+
+  if ((HashMask & ~SupportedMask) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ZeroMem (&HashContext, sizeof (HashContext));
+  Status = EFI_OUT_OF_RESOURCES;
+  for (Index = 0; Index < PE_IMAGE_HASH_ALGORITHM_COUNT; Index++) {
+    if ((HashMask & mPeImageHashAlgorithm[Index].HashMask) == 0) {
+      continue;
+    }
+
+    HashContext.HashContext[Index] = AllocatePool (mPeImageHashAlgorithm[Index].GetContextSize ());
+    if (HashContext.HashContext[Index] == NULL) {
+      goto Done;
+    }
+
+    if (!mPeImageHashAlgorithm[Index].HashInit (HashContext.HashContext[Index])) {
+      Status = EFI_ABORTED;
+      goto Done;
+    }
+  }
+
+  Status = PeImageHashRanges (ImageAddress, ImageSize, PeImageHashAllUpdate, &HashContext);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  for (Index = 0; Index < PE_IMAGE_HASH_ALGORITHM_COUNT; Index++) {
+    if (HashContext.HashContext[Index] != NULL) {
+      if (!mPeImageHashAlgorithm[Index].HashFinal (HashContext.HashContext[Index], (UINT8 *)Digests + mPeImageHashAlgorithm[Index].DigestOffset)) {
+        Status = EFI_ABORTED;
+        goto Done;
+      }
+    }
+  }
+
+Done:
+  for (Index = 0; Index < PE_IMAGE_HASH_ALGORITHM_COUNT; Index++) {
+    if (HashContext.HashContext[Index] != NULL) {
+      FreePool (HashContext.HashContext[Index]);
+    }
+  }
+
+  return Status;
+}
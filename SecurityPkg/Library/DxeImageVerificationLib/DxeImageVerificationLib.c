@@ -36,6 +36,13 @@ UINT8  *mImageBase = NULL;
 UINT8  mImageDigest[MAX_DIGEST_SIZE];
 UINTN  mImageDigestSize;
 
+//
+// Authenticode digests of the current image, and the PE_IMAGE_HASH_* mask of
+// the ones already calculated
+//
+PE_IMAGE_DIGESTS  mImageDigests;
+UINT32            mImageDigestsMask;
+
 //
 // Notify string for authorization UI.
 //
@@ -271,10 +278,51 @@ GetImageType (
   return IMAGE_UNKNOWN;
 }
 
+/**
+  Calculate the Authenticode digests of the current image which are not
+  calculated yet, with all the hash algorithms of HashMask in one walk of the
+  image.
+
+  Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
+  its caller function DxeImageVerificationHandler().
+
+  @param[in]    HashMask  PE_IMAGE_HASH_* hash algorithms of the digests.
+
+  @retval TRUE            The digests of HashMask are in mImageDigests.
+  @retval FALSE           Fail in hash image.
+
+**/
+BOOLEAN
+HashPeImageDigests (
+  IN  UINT32  HashMask
+  )
+{
+  EFI_STATUS  Status;
+
+  HashMask &= ~mImageDigestsMask;
+  if (HashMask == 0) {
+    return TRUE;
+  }
+
+  PERF_INMODULE_BEGIN ("DxeImageVerificationHash");
+  Status = PeImageHashAll (mImageBase, mImageSize, HashMask, &mImageDigests);
+  PERF_INMODULE_END ("DxeImageVerificationHash");
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Fail to hash image (0x%x) - %r\n", HashMask, Status));
+    return FALSE;
+  }
+
+  mImageDigestsMask |= HashMask;
+  return TRUE;
+}
+
 /**
   Calculate hash of Pe/Coff image based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A
 
+  The digests are calculated by HashPeImageDigests(), so the image is only
+  hashed again for an algorithm which has not been used for it yet.
+
   Caution: This function may receive untrusted input.
   PE/COFF image is external input, so this function will validate its data structure
   within this image buffer before use.
@@ -293,22 +341,8 @@ HashPeImage (
   IN  UINT32  HashAlg
   )
 {
-  BOOLEAN                   Status;
-  EFI_IMAGE_SECTION_HEADER  *Section;
-  VOID                      *HashCtx;
-  UINTN                     CtxSize;
-  UINT8                     *HashBase;
-  UINTN                     HashSize;
-  UINTN                     SumOfBytesHashed;
-  EFI_IMAGE_SECTION_HEADER  *SectionHeader;
-  UINTN                     Index;
-  UINTN                     Pos;
-  UINT32                    CertSize;
-  UINT32                    NumberOfRvaAndSizes;
-
-  HashCtx       = NULL;
-  SectionHeader = NULL;
-  Status        = FALSE;
+  UINT32  HashMask;
+  UINT8   *Digest;
 
   if ((HashAlg >= HASHALG_MAX)) {
     return FALSE;
@@ -324,22 +358,30 @@ HashPeImage (
     case HASHALG_SHA1:
       mImageDigestSize = SHA1_DIGEST_SIZE;
       mCertType        = gEfiCertSha1Guid;
+      HashMask         = PE_IMAGE_HASH_SHA1;
+      Digest           = mImageDigests.Sha1;
       break;
  #endif
 
     case HASHALG_SHA256:
       mImageDigestSize = SHA256_DIGEST_SIZE;
       mCertType        = gEfiCertSha256Guid;
+      HashMask         = PE_IMAGE_HASH_SHA256;
+      Digest           = mImageDigests.Sha256;
       break;
 
     case HASHALG_SHA384:
       mImageDigestSize = SHA384_DIGEST_SIZE;
       mCertType        = gEfiCertSha384Guid;
+      HashMask         = PE_IMAGE_HASH_SHA384;
+      Digest           = mImageDigests.Sha384;
       break;
 
     case HASHALG_SHA512:
       mImageDigestSize = SHA512_DIGEST_SIZE;
       mCertType        = gEfiCertSha512Guid;
+      HashMask         = PE_IMAGE_HASH_SHA512;
+      Digest           = mImageDigests.Sha512;
       break;
 
     default:
@@ -347,262 +389,13 @@ HashPeImage (
   }
 
   mHashTypeStr = mHash[HashAlg].Name;
-  CtxSize      = mHash[HashAlg].GetContextSize ();
 
-  HashCtx = AllocatePool (CtxSize);
-  if (HashCtx == NULL) {
+  if (!HashPeImageDigests (HashMask)) {
     return FALSE;
   }
 
-  // 1.  Load the image header into memory.
-
-  // 2.  Initialize a SHA hash context.
-  Status = mHash[HashAlg].HashInit (HashCtx);
-
-  if (!Status) {
-    goto Done;
-  }
-
-  //
-  // Measuring PE/COFF Image Header;
-  // But CheckSum field and SECURITY data directory (certificate) are excluded
-  //
-
-  //
-  // 3.  Calculate the distance from the base of the image header to the image checksum address.
-  // 4.  Hash the image header from its base to beginning of the image checksum.
-  //
-  HashBase = mImageBase;
-  if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-    //
-    // Use PE32 offset.
-    //
-    HashSize            = (UINTN)(&mNtHeader.Pe32->OptionalHeader.CheckSum) - (UINTN)HashBase;
-    NumberOfRvaAndSizes = mNtHeader.Pe32->OptionalHeader.NumberOfRvaAndSizes;
-  } else if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
-    //
-    // Use PE32+ offset.
-    //
-    HashSize            = (UINTN)(&mNtHeader.Pe32Plus->OptionalHeader.CheckSum) - (UINTN)HashBase;
-    NumberOfRvaAndSizes = mNtHeader.Pe32Plus->OptionalHeader.NumberOfRvaAndSizes;
-  } else {
-    //
-    // Invalid header magic number.
-    //
-    Status = FALSE;
-    goto Done;
-  }
-
-  Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-  if (!Status) {
-    goto Done;
-  }
-
-  //
-  // 5.  Skip over the image checksum (it occupies a single ULONG).
-  //
-  if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
-    //
-    // 6.  Since there is no Cert Directory in optional header, hash everything
-    //     from the end of the checksum to the end of image header.
-    //
-    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-      //
-      // Use PE32 offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    } else {
-      //
-      // Use PE32+ offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    }
-
-    if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    }
-  } else {
-    //
-    // 7.  Hash everything from the end of the checksum to the start of the Cert Directory.
-    //
-    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-      //
-      // Use PE32 offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = (UINTN)(&mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
-    } else {
-      //
-      // Use PE32+ offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.CheckSum + sizeof (UINT32);
-      HashSize = (UINTN)(&mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY]) - (UINTN)HashBase;
-    }
-
-    if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    }
-
-    //
-    // 8.  Skip over the Cert Directory. (It is sizeof(IMAGE_DATA_DIRECTORY) bytes.)
-    // 9.  Hash everything from the end of the Cert Directory to the end of image header.
-    //
-    if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-      //
-      // Use PE32 offset
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
-      HashSize = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    } else {
-      //
-      // Use PE32+ offset.
-      //
-      HashBase = (UINT8 *)&mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY + 1];
-      HashSize = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders - ((UINTN)HashBase - (UINTN)mImageBase);
-    }
-
-    if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    }
-  }
-
-  //
-  // 10. Set the SUM_OF_BYTES_HASHED to the size of the header.
-  //
-  if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-    //
-    // Use PE32 offset.
-    //
-    SumOfBytesHashed = mNtHeader.Pe32->OptionalHeader.SizeOfHeaders;
-  } else {
-    //
-    // Use PE32+ offset
-    //
-    SumOfBytesHashed = mNtHeader.Pe32Plus->OptionalHeader.SizeOfHeaders;
-  }
-
-  Section = (EFI_IMAGE_SECTION_HEADER *)(
-                                         mImageBase +
-                                         mPeCoffHeaderOffset +
-                                         sizeof (UINT32) +
-                                         sizeof (EFI_IMAGE_FILE_HEADER) +
-                                         mNtHeader.Pe32->FileHeader.SizeOfOptionalHeader
-                                         );
-
-  //
-  // 11. Build a temporary table of pointers to all the IMAGE_SECTION_HEADER
-  //     structures in the image. The 'NumberOfSections' field of the image
-  //     header indicates how big the table should be. Do not include any
-  //     IMAGE_SECTION_HEADERs in the table whose 'SizeOfRawData' field is zero.
-  //
-  SectionHeader = (EFI_IMAGE_SECTION_HEADER *)AllocateZeroPool (sizeof (EFI_IMAGE_SECTION_HEADER) * mNtHeader.Pe32->FileHeader.NumberOfSections);
-  if (SectionHeader == NULL) {
-    Status = FALSE;
-    goto Done;
-  }
-
-  //
-  // 12.  Using the 'PointerToRawData' in the referenced section headers as
-  //      a key, arrange the elements in the table in ascending order. In other
-  //      words, sort the section headers according to the disk-file offset of
-  //      the section.
-  //
-  for (Index = 0; Index < mNtHeader.Pe32->FileHeader.NumberOfSections; Index++) {
-    Pos = Index;
-    while ((Pos > 0) && (Section->PointerToRawData < SectionHeader[Pos - 1].PointerToRawData)) {
-      CopyMem (&SectionHeader[Pos], &SectionHeader[Pos - 1], sizeof (EFI_IMAGE_SECTION_HEADER));
-      Pos--;
-    }
-
-    CopyMem (&SectionHeader[Pos], Section, sizeof (EFI_IMAGE_SECTION_HEADER));
-    Section += 1;
-  }
-
-  //
-  // 13.  Walk through the sorted table, bring the corresponding section
-  //      into memory, and hash the entire section (using the 'SizeOfRawData'
-  //      field in the section header to determine the amount of data to hash).
-  // 14.  Add the section's 'SizeOfRawData' to SUM_OF_BYTES_HASHED .
-  // 15.  Repeat steps 13 and 14 for all the sections in the sorted table.
-  //
-  for (Index = 0; Index < mNtHeader.Pe32->FileHeader.NumberOfSections; Index++) {
-    Section = &SectionHeader[Index];
-    if (Section->SizeOfRawData == 0) {
-      continue;
-    }
-
-    HashBase = mImageBase + Section->PointerToRawData;
-    HashSize = (UINTN)Section->SizeOfRawData;
-
-    Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-    if (!Status) {
-      goto Done;
-    }
-
-    SumOfBytesHashed += HashSize;
-  }
-
-  //
-  // 16.  If the file size is greater than SUM_OF_BYTES_HASHED, there is extra
-  //      data in the file that needs to be added to the hash. This data begins
-  //      at file offset SUM_OF_BYTES_HASHED and its length is:
-  //             FileSize  -  (CertDirectory->Size)
-  //
-  if (mImageSize > SumOfBytesHashed) {
-    HashBase = mImageBase + SumOfBytesHashed;
-
-    if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_SECURITY) {
-      CertSize = 0;
-    } else {
-      if (mNtHeader.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
-        //
-        // Use PE32 offset.
-        //
-        CertSize = mNtHeader.Pe32->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
-      } else {
-        //
-        // Use PE32+ offset.
-        //
-        CertSize = mNtHeader.Pe32Plus->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_SECURITY].Size;
-      }
-    }
-
-    if (mImageSize > CertSize + SumOfBytesHashed) {
-      HashSize = (UINTN)(mImageSize - CertSize - SumOfBytesHashed);
-
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
-      if (!Status) {
-        goto Done;
-      }
-    } else if (mImageSize < CertSize + SumOfBytesHashed) {
-      Status = FALSE;
-      goto Done;
-    }
-  }
-
-  Status = mHash[HashAlg].HashFinal (HashCtx, mImageDigest);
-
-Done:
-  if (HashCtx != NULL) {
-    FreePool (HashCtx);
-  }
-
-  if (SectionHeader != NULL) {
-    FreePool (SectionHeader);
-  }
-
-  return Status;
+  CopyMem (mImageDigest, Digest, mImageDigestSize);
+  return TRUE;
 }
 
 /**
@@ -831,8 +624,7 @@ AddImageExeInfo (
 
   @param[in]  Certificate       Pointer to X.509 Certificate that is searched for.
   @param[in]  CertSize          Size of X.509 Certificate.
-  @param[in]  SignatureList     Pointer to the Signature List in forbidden database.
-  @param[in]  SignatureListSize Size of Signature List.
+  @param[in]  Dbx               The forbidden database.
   @param[out] RevocationTime    Return the time that the certificate was revoked.
   @param[out] IsFound           Search result. Only valid if EFI_SUCCESS returned.
 
@@ -844,34 +636,28 @@ EFI_STATUS
 IsCertHashFoundInDbx (
   IN  UINT8               *Certificate,
   IN  UINTN               CertSize,
-  IN  EFI_SIGNATURE_LIST  *SignatureList,
-  IN  UINTN               SignatureListSize,
+  IN  SIGNATURE_DATABASE  *Dbx,
   OUT EFI_TIME            *RevocationTime,
   OUT BOOLEAN             *IsFound
   )
 {
   EFI_STATUS          Status;
   EFI_SIGNATURE_LIST  *DbxList;
-  UINTN               DbxSize;
   EFI_SIGNATURE_DATA  *CertHash;
-  UINTN               CertHashCount;
   UINTN               Index;
   UINT32              HashAlg;
   VOID                *HashCtx;
   UINT8               CertDigest[MAX_DIGEST_SIZE];
-  UINT8               *DbxCertHash;
-  UINTN               SiglistHeaderSize;
   UINT8               *TBSCert;
   UINTN               TBSCertSize;
+  EFI_GUID            *CertHashType[] = { &gEfiCertX509Sha256Guid, &gEfiCertX509Sha384Guid, &gEfiCertX509Sha512Guid };
+  UINT32              CertHashAlg[]   = { HASHALG_SHA256, HASHALG_SHA384, HASHALG_SHA512 };
 
   Status   = EFI_ABORTED;
   *IsFound = FALSE;
-  DbxList  = SignatureList;
-  DbxSize  = SignatureListSize;
   HashCtx  = NULL;
-  HashAlg  = HASHALG_MAX;
 
-  if ((RevocationTime == NULL) || (DbxList == NULL)) {
+  if ((RevocationTime == NULL) || (Dbx == NULL) || EFI_ERROR (Dbx->Status)) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -882,25 +668,20 @@ IsCertHashFoundInDbx (
     return Status;
   }
 
-  while ((DbxSize > 0) && (SignatureListSize >= DbxList->SignatureListSize)) {
-    //
-    // Determine Hash Algorithm of Certificate in the forbidden database.
-    //
-    if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha256Guid)) {
-      HashAlg = HASHALG_SHA256;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha384Guid)) {
-      HashAlg = HASHALG_SHA384;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha512Guid)) {
-      HashAlg = HASHALG_SHA512;
-    } else {
-      DbxSize -= DbxList->SignatureListSize;
-      DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
+  //
+  // The TBSCertificate is hashed once with each hash algorithm of the
+  // certificates in the forbidden database, and the digest is looked up in
+  // the index of the database.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (CertHashType); Index++) {
+    if (!IsSignatureTypeInDatabase (Dbx, CertHashType[Index])) {
       continue;
     }
 
     //
     // Calculate the hash value of current TBSCertificate for comparision.
     //
+    HashAlg = CertHashAlg[Index];
     if (mHash[HashAlg].GetContextSize == NULL) {
       goto Done;
     }
@@ -926,33 +707,26 @@ IsCertHashFoundInDbx (
     FreePool (HashCtx);
     HashCtx = NULL;
 
-    SiglistHeaderSize = sizeof (EFI_SIGNATURE_LIST) + DbxList->SignatureHeaderSize;
-    CertHash          = (EFI_SIGNATURE_DATA *)((UINT8 *)DbxList + SiglistHeaderSize);
-    CertHashCount     = (DbxList->SignatureListSize - SiglistHeaderSize) / DbxList->SignatureSize;
-    for (Index = 0; Index < CertHashCount; Index++) {
+    CertHash = FindSignatureInDatabase (Dbx, CertHashType[Index], CertDigest, mHash[HashAlg].DigestLength, 0, &DbxList);
+    if (CertHash != NULL) {
       //
-      // Iterate each Signature Data Node within this CertList for verify.
+      // Hash of Certificate is found in forbidden database.
       //
-      DbxCertHash = CertHash->SignatureData;
-      if (CompareMem (DbxCertHash, CertDigest, mHash[HashAlg].DigestLength) == 0) {
-        //
-        // Hash of Certificate is found in forbidden database.
-        //
-        Status   = EFI_SUCCESS;
-        *IsFound = TRUE;
+      Status   = EFI_SUCCESS;
+      *IsFound = TRUE;
 
-        //
-        // Return the revocation time.
-        //
-        CopyMem (RevocationTime, (EFI_TIME *)(DbxCertHash + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
-        goto Done;
+      //
+      // Return the revocation time, or zero (always revoked) if the signature
+      // is too short to hold it.
+      //
+      if (DbxList->SignatureSize - sizeof (EFI_GUID) - mHash[HashAlg].DigestLength >= sizeof (EFI_TIME)) {
+        CopyMem (RevocationTime, (EFI_TIME *)(CertHash->SignatureData + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
+      } else {
+        ZeroMem (RevocationTime, sizeof (EFI_TIME));
       }
 
-      CertHash = (EFI_SIGNATURE_DATA *)((UINT8 *)CertHash + DbxList->SignatureSize);
+      goto Done;
     }
-
-    DbxSize -= DbxList->SignatureListSize;
-    DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
   }
 
   Status = EFI_SUCCESS;
@@ -987,84 +761,48 @@ IsSignatureFoundInDatabase (
   OUT BOOLEAN   *IsFound
   )
 {
-  EFI_STATUS          Status;
+  SIGNATURE_DATABASE  *Database;
   EFI_SIGNATURE_LIST  *CertList;
   EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
 
   //
-  // Read signature database variable.
+  // Use the copy of the signature database variable read for this image.
   //
   *IsFound = FALSE;
-  Data     = NULL;
-  DataSize = 0;
-  Status   = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status == EFI_NOT_FOUND) {
+  Database = GetSignatureDatabase (VariableName);
+  if (Database == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (EFI_ERROR (Database->Status)) {
+    if (Database->Status == EFI_NOT_FOUND) {
       //
       // No database, no need to search.
       //
-      Status = EFI_SUCCESS;
+      return EFI_SUCCESS;
     }
 
-    return Status;
-  }
-
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
+    return Database->Status;
   }
 
   //
-  // Enumerate all signature data in SigDB to check if signature exists for executable.
+  // Look up the signature in the index of the signatures of SigDB.
   //
-  CertList = (EFI_SIGNATURE_LIST *)Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-    if ((CertList->SignatureSize == sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid (&CertList->SignatureType, CertType))) {
-      for (Index = 0; Index < CertCount; Index++) {
-        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
-          //
-          // Find the signature in database.
-          //
-          *IsFound = TRUE;
-          //
-          // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
-          //
-          if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
-            SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
-          }
-
-          break;
-        }
-
-        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
-      }
-
-      if (*IsFound) {
-        break;
-      }
+  Cert = FindSignatureInDatabase (Database, CertType, Signature, SignatureSize, sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize, &CertList);
+  if (Cert != NULL) {
+    //
+    // Find the signature in database.
+    //
+    *IsFound = TRUE;
+    //
+    // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
+    //
+    if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+      SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
     }
-
-    DataSize -= CertList->SignatureListSize;
-    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
-  }
-
-Done:
-  if (Data != NULL) {
-    FreePool (Data);
   }
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1142,11 +880,10 @@ PassTimestampCheck (
   IN EFI_TIME  *RevocationTime
   )
 {
-  EFI_STATUS          Status;
   BOOLEAN             VerifyStatus;
+  SIGNATURE_DATABASE  *Dbt;
   EFI_SIGNATURE_LIST  *CertList;
   EFI_SIGNATURE_DATA  *Cert;
-  UINT8               *DbtData;
   UINTN               DbtDataSize;
   UINT8               *RootCert;
   UINTN               RootCertSize;
@@ -1158,7 +895,6 @@ PassTimestampCheck (
   // Variable Initialization
   //
   VerifyStatus = FALSE;
-  DbtData      = NULL;
   CertList     = NULL;
   Cert         = NULL;
   RootCert     = NULL;
@@ -1175,23 +911,13 @@ PassTimestampCheck (
   // RevocationTime is non-zero, the certificate should be considered to be revoked from that time and onwards.
   // Using the dbt to get the trusted TSA certificates.
   //
-  DbtDataSize = 0;
-  Status      = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  Dbt = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE2);
+  if (EFI_ERROR (Dbt->Status)) {
     goto Done;
   }
 
-  DbtData = (UINT8 *)AllocateZeroPool (DbtDataSize);
-  if (DbtData == NULL) {
-    goto Done;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE2, &gEfiImageSecurityDatabaseGuid, NULL, &DbtDataSize, (VOID *)DbtData);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
-  CertList = (EFI_SIGNATURE_LIST *)DbtData;
+  DbtDataSize = Dbt->DataSize;
+  CertList    = (EFI_SIGNATURE_LIST *)Dbt->Data;
   while ((DbtDataSize > 0) && (DbtDataSize >= CertList->SignatureListSize)) {
     if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
       Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
@@ -1224,10 +950,6 @@ PassTimestampCheck (
   }
 
 Done:
-  if (DbtData != NULL) {
-    FreePool (DbtData);
-  }
-
   return VerifyStatus;
 }
 
@@ -1251,8 +973,7 @@ IsForbiddenByDbx (
   EFI_STATUS          Status;
   BOOLEAN             IsForbidden;
   BOOLEAN             IsFound;
-  UINT8               *Data;
-  UINTN               DataSize;
+  SIGNATURE_DATABASE  *Dbx;
   EFI_SIGNATURE_LIST  *CertList;
   UINTN               CertListSize;
   EFI_SIGNATURE_DATA  *CertData;
@@ -1274,7 +995,6 @@ IsForbiddenByDbx (
   // Variable Initialization
   //
   IsForbidden       = TRUE;
-  Data              = NULL;
   CertList          = NULL;
   CertData          = NULL;
   RootCert          = NULL;
@@ -1288,11 +1008,9 @@ IsForbiddenByDbx (
   //
   // The image will not be forbidden if dbx can't be got.
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status == EFI_NOT_FOUND) {
+  Dbx = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1);
+  if (EFI_ERROR (Dbx->Status)) {
+    if (Dbx->Status == EFI_NOT_FOUND) {
       //
       // Evidently not in dbx if the database doesn't exist.
       //
@@ -1302,22 +1020,12 @@ IsForbiddenByDbx (
     return IsForbidden;
   }
 
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return IsForbidden;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
   //
   // Verify image signature with RAW X509 certificates in DBX database.
   // If passed, the image will be forbidden.
   //
-  CertList     = (EFI_SIGNATURE_LIST *)Data;
-  CertListSize = DataSize;
+  CertList     = (EFI_SIGNATURE_LIST *)Dbx->Data;
+  CertListSize = Dbx->DataSize;
   while ((CertListSize > 0) && (CertListSize >= CertList->SignatureListSize)) {
     if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
       CertData  = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
@@ -1389,7 +1097,7 @@ IsForbiddenByDbx (
     //
     CertPtr = CertPtr + sizeof (UINT32) + CertSize;
 
-    Status = IsCertHashFoundInDbx (Cert, CertSize, (EFI_SIGNATURE_LIST *)Data, DataSize, &RevocationTime, &IsFound);
+    Status = IsCertHashFoundInDbx (Cert, CertSize, Dbx, &RevocationTime, &IsFound);
     if (EFI_ERROR (Status)) {
       //
       // Error in searching dbx. Consider it as 'found'. RevocationTime might
@@ -1418,10 +1126,6 @@ IsForbiddenByDbx (
   IsForbidden = FALSE;
 
 Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   Pkcs7FreeSigners (CertBuffer);
   Pkcs7FreeSigners (TrustedCert);
 
@@ -1447,23 +1151,20 @@ IsAllowedByDb (
   EFI_STATUS          Status;
   BOOLEAN             VerifyStatus;
   BOOLEAN             IsFound;
+  SIGNATURE_DATABASE  *Db;
+  SIGNATURE_DATABASE  *Dbx;
   EFI_SIGNATURE_LIST  *CertList;
   EFI_SIGNATURE_DATA  *CertData;
   UINTN               DataSize;
-  UINT8               *Data;
   UINT8               *RootCert;
   UINTN               RootCertSize;
   UINTN               Index;
   UINTN               CertCount;
-  UINTN               DbxDataSize;
-  UINT8               *DbxData;
   EFI_TIME            RevocationTime;
 
-  Data         = NULL;
   CertList     = NULL;
   CertData     = NULL;
   RootCert     = NULL;
-  DbxData      = NULL;
   RootCertSize = 0;
   VerifyStatus = FALSE;
 
@@ -1471,58 +1172,33 @@ IsAllowedByDb (
   // Fetch 'db' content. If 'db' doesn't exist or encounters problem to get the
   // data, return not-allowed-by-db (FALSE).
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    return VerifyStatus;
-  }
-
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
+  Db = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE);
+  if (EFI_ERROR (Db->Status)) {
     return VerifyStatus;
   }
 
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
   //
   // Fetch 'dbx' content. If 'dbx' doesn't exist, continue to check 'db'.
   // If any other errors occurred, no need to check 'db' but just return
   // not-allowed-by-db (FALSE) to avoid bypass.
   //
-  DbxDataSize = 0;
-  Status      = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status != EFI_NOT_FOUND) {
-      goto Done;
+  Dbx = GetSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1);
+  if (EFI_ERROR (Dbx->Status)) {
+    if (Dbx->Status != EFI_NOT_FOUND) {
+      return VerifyStatus;
     }
 
     //
     // 'dbx' does not exist. Continue to check 'db'.
     //
-  } else {
-    //
-    // 'dbx' exists. Get its content.
-    //
-    DbxData = (UINT8 *)AllocateZeroPool (DbxDataSize);
-    if (DbxData == NULL) {
-      goto Done;
-    }
-
-    Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, (VOID *)DbxData);
-    if (EFI_ERROR (Status)) {
-      goto Done;
-    }
+    Dbx = NULL;
   }
 
   //
   // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
   //
-  CertList = (EFI_SIGNATURE_LIST *)Data;
+  DataSize = Db->DataSize;
+  CertList = (EFI_SIGNATURE_LIST *)Db->Data;
   while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
     if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
       CertData  = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
@@ -1550,11 +1226,11 @@ IsAllowedByDb (
           //
           // The image is signed and its signature is found in 'db'.
           //
-          if (DbxData != NULL) {
+          if (Dbx != NULL) {
             //
             // Here We still need to check if this RootCert's Hash is revoked
             //
-            Status = IsCertHashFoundInDbx (RootCert, RootCertSize, (EFI_SIGNATURE_LIST *)DbxData, DbxDataSize, &RevocationTime, &IsFound);
+            Status = IsCertHashFoundInDbx (RootCert, RootCertSize, Dbx, &RevocationTime, &IsFound);
             if (EFI_ERROR (Status)) {
               //
               // Error in searching dbx. Consider it as 'found'. RevocationTime might
@@ -1595,14 +1271,6 @@ Done:
     SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, CertData);
   }
 
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
-  if (DbxData != NULL) {
-    FreePool (DbxData);
-  }
-
   return VerifyStatus;
 }
 
@@ -1692,6 +1360,8 @@ DxeImageVerificationHandler (
   BOOLEAN                       IsFound;
   UINT8                         HashAlg;
   BOOLEAN                       IsFoundInDatabase;
+  EFI_STATUS                    CacheStatus;
+  UINT8                         ImageDigest[SHA256_DIGEST_SIZE];
 
   SignatureList     = NULL;
   SignatureListSize = 0;
@@ -1778,6 +1448,18 @@ DxeImageVerificationHandler (
   mImageBase = (UINT8 *)FileBuffer;
   mImageSize = FileSize;
 
+  //
+  // Read the signature databases once for this image, and skip the verification
+  // of an image which already passed it with the same databases. The entries of
+  // db which allowed it have already been measured.
+  //
+  RefreshSignatureDatabases ();
+  CacheStatus = LookupVerifiedImage (FileBuffer, FileSize, ImageDigest);
+  if (CacheStatus == EFI_SUCCESS) {
+    DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image already verified with the same DB/DBX/DBT.\n"));
+    return EFI_SUCCESS;
+  }
+
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *)FileBuffer;
   ImageContext.ImageRead = (PE_COFF_LOADER_READ_FILE)DxeImageVerificationLibImageRead;
@@ -1794,6 +1476,8 @@ DxeImageVerificationHandler (
     goto Failed;
   }
 
+  mImageDigestsMask = 0;
+
   DosHdr = (EFI_IMAGE_DOS_HEADER *)mImageBase;
   if (DosHdr->e_magic == EFI_IMAGE_DOS_SIGNATURE) {
     //
@@ -1842,7 +1526,9 @@ DxeImageVerificationHandler (
     //
     // This image is not signed. The hash value of the image must match a record in the security database "db",
     // and not be reflected in the security data base "dbx".
+    // Calculate the digests of all the hash algorithms in one walk of the image.
     //
+    HashPeImageDigests (IMAGE_DIGEST_HASH_MASK);
     HashAlg = sizeof (mHash) / sizeof (HASH_TABLE);
     while (HashAlg > 0) {
       HashAlg--;
@@ -1885,6 +1571,10 @@ DxeImageVerificationHandler (
     }
 
     if (IsFoundInDatabase) {
+      if (CacheStatus == EFI_NOT_FOUND) {
+        AddVerifiedImage (ImageDigest);
+      }
+
       return EFI_SUCCESS;
     }
 
@@ -2021,6 +1711,10 @@ DxeImageVerificationHandler (
   }
 
   if (IsVerified) {
+    if (CacheStatus == EFI_NOT_FOUND) {
+      AddVerifiedImage (ImageDigest);
+    }
+
     return EFI_SUCCESS;
   }
 
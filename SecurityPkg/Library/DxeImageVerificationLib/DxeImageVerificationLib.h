@@ -23,6 +23,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DevicePathLib.h>
 #include <Library/SecurityManagementLib.h>
 #include <Library/PeCoffLib.h>
+#include <Library/PeImageHashLib.h>
+#include <Library/PerformanceLib.h>
 #include <Protocol/FirmwareVolume2.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/BlockIo.h>
@@ -73,6 +75,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Set max digest size as SHA512 Output (64 bytes) by far
 //
 #define MAX_DIGEST_SIZE  SHA512_DIGEST_SIZE
+
+//
+// Hash algorithms of the image digests looked up in db and dbx, calculated in
+// one walk of the image for unsigned images
+//
+#ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+#define IMAGE_DIGEST_HASH_MASK  (PE_IMAGE_HASH_SHA1 | PE_IMAGE_HASH_SHA256 | PE_IMAGE_HASH_SHA384 | PE_IMAGE_HASH_SHA512)
+#else
+#define IMAGE_DIGEST_HASH_MASK  (PE_IMAGE_HASH_SHA256 | PE_IMAGE_HASH_SHA384 | PE_IMAGE_HASH_SHA512)
+#endif
 //
 //
 // PKCS7 Certificate definition
@@ -195,4 +207,149 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+//
+// Number of images whose successful verification is remembered
+//
+#define VERIFIED_IMAGE_CACHE_SIZE  64
+
+//
+// Entry of the hashed index of the signatures of a signature database
+//
+typedef struct {
+  //
+  // Signature list and signature data of the entry
+  //
+  EFI_SIGNATURE_LIST    *CertList;
+  EFI_SIGNATURE_DATA    *Cert;
+  //
+  // Index plus one of the next entry of the bucket, zero for the last one
+  //
+  UINTN                 Next;
+} SIGNATURE_INDEX_ENTRY;
+
+//
+// Copy of a signature database variable
+//
+typedef struct {
+  //
+  // Name of the variable
+  //
+  CHAR16                   *VariableName;
+  //
+  // Status of the last read of the variable, the content and the index are
+  // only valid when it is EFI_SUCCESS
+  //
+  EFI_STATUS               Status;
+  UINT8                    *Data;
+  UINTN                    DataSize;
+  //
+  // Hashed index of the signatures of the lists of hashes, in database order
+  // in each bucket
+  //
+  SIGNATURE_INDEX_ENTRY    *Entries;
+  UINTN                    *Buckets;
+  UINTN                    BucketMask;
+} SIGNATURE_DATABASE;
+
+/**
+  Read the signature databases db, dbx and dbt again, and index the ones whose
+  content changed since the last read.
+
+  The databases can be updated by authenticated variable writes at any time,
+  so they are read again before each image verification. The version stamp of
+  the databases is increased when any of them changed, which invalidates the
+  images verified before.
+
+**/
+VOID
+RefreshSignatureDatabases (
+  VOID
+  );
+
+/**
+  Get the copy of a signature database read by RefreshSignatureDatabases().
+
+  @param[in]  VariableName    Name of the database variable.
+
+  @return The copy of the database, or NULL if it is not db, dbx or dbt.
+
+**/
+SIGNATURE_DATABASE *
+GetSignatureDatabase (
+  IN CHAR16  *VariableName
+  );
+
+/**
+  Check whether a database has a signature list of the given type.
+
+  @param[in]  Database        The signature database.
+  @param[in]  CertType        The type of the signature list.
+
+  @retval TRUE                A signature list of the type is in the database.
+  @retval FALSE               No signature list of the type is in the database.
+
+**/
+BOOLEAN
+IsSignatureTypeInDatabase (
+  IN SIGNATURE_DATABASE  *Database,
+  IN EFI_GUID            *CertType
+  );
+
+/**
+  Look up a signature in the hashed index of a signature database.
+
+  @param[in]  Database        The signature database.
+  @param[in]  CertType        The type of the signature list of the signature.
+  @param[in]  Signature       The signature data, or its first bytes.
+  @param[in]  SignatureSize   Size of Signature, at least the size of a SHA-1 digest.
+  @param[in]  EntrySize       The SignatureSize of the signature list, or zero
+                              for any list whose signatures start with Signature.
+  @param[out] CertList        The signature list of the signature found.
+
+  @return The first signature of the database that matches, or NULL if none.
+
+**/
+EFI_SIGNATURE_DATA *
+FindSignatureInDatabase (
+  IN  SIGNATURE_DATABASE  *Database,
+  IN  EFI_GUID            *CertType,
+  IN  UINT8               *Signature,
+  IN  UINTN               SignatureSize,
+  IN  UINTN               EntrySize,
+  OUT EFI_SIGNATURE_LIST  **CertList
+  );
+
+/**
+  Check whether an image already passed the verification with the current
+  signature databases.
+
+  @param[in]  FileBuffer      The image file.
+  @param[in]  FileSize        Size of the image file.
+  @param[out] ImageDigest     The SHA-256 digest of the image file, which is the
+                              key of the image in the cache.
+
+  @retval EFI_SUCCESS         The image was verified with the current databases.
+  @retval EFI_NOT_FOUND       The image must be verified.
+  @retval EFI_ABORTED         The digest of the image could not be computed.
+
+**/
+EFI_STATUS
+LookupVerifiedImage (
+  IN  VOID   *FileBuffer,
+  IN  UINTN  FileSize,
+  OUT UINT8  *ImageDigest
+  );
+
+/**
+  Remember an image which passed the verification with the current signature
+  databases.
+
+  @param[in]  ImageDigest     The digest returned by LookupVerifiedImage().
+
+**/
+VOID
+AddVerifiedImage (
+  IN UINT8  *ImageDigest
+  );
+
 #endif
@@ -0,0 +1,469 @@
+/** @file
+  Copies of the signature databases and cache of the verified images.
+
+  The signature databases db, dbx and dbt are read once per image verification,
+  and the signatures of their lists of hashes are indexed by their first bytes,
+  so that looking up the hash of an image or of a certificate does not scan the
+  whole database. The index is only built again when the content of a database
+  changes.
+
+  The images which passed the verification are remembered by the SHA-256 digest
+  of their file with the version stamp of the databases, so that the same Option
+  ROM, driver or shell image is not hashed and verified again on each connect or
+  boot option attempt, as long as the databases are not updated.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+//
+// Minimum number of buckets of the index of a database
+//
+#define SIGNATURE_INDEX_MIN_BUCKETS  16
+
+typedef struct {
+  UINT8     Digest[SHA256_DIGEST_SIZE];
+  UINT64    Stamp;
+} VERIFIED_IMAGE;
+
+STATIC SIGNATURE_DATABASE  mSignatureDatabase[] = {
+  { EFI_IMAGE_SECURITY_DATABASE,  EFI_NOT_READY, NULL, 0, NULL, NULL, 0 },
+  { EFI_IMAGE_SECURITY_DATABASE1, EFI_NOT_READY, NULL, 0, NULL, NULL, 0 },
+  { EFI_IMAGE_SECURITY_DATABASE2, EFI_NOT_READY, NULL, 0, NULL, NULL, 0 }
+};
+
+//
+// Version stamp of the signature databases, increased when any of them changes
+//
+STATIC UINT64  mSignatureDatabaseStamp = 1;
+
+STATIC VERIFIED_IMAGE  mVerifiedImage[VERIFIED_IMAGE_CACHE_SIZE];
+STATIC UINTN           mVerifiedImageCount = 0;
+STATIC UINTN           mVerifiedImageNext  = 0;
+
+/**
+  Get the next well-formed signature list of a database.
+
+  @param[in]  Database        The signature database.
+  @param[in]  CertList        The current signature list, or NULL for the first one.
+
+  @return The next signature list, or NULL at the end of the database or of its
+          well-formed lists.
+
+**/
+STATIC
+EFI_SIGNATURE_LIST *
+GetNextSignatureList (
+  IN SIGNATURE_DATABASE  *Database,
+  IN EFI_SIGNATURE_LIST  *CertList  OPTIONAL
+  )
+{
+  UINTN  Offset;
+
+  if (CertList == NULL) {
+    Offset = 0;
+  } else {
+    Offset = (UINTN)((UINT8 *)CertList - Database->Data) + CertList->SignatureListSize;
+  }
+
+  if ((Offset > Database->DataSize) || (Database->DataSize - Offset < sizeof (EFI_SIGNATURE_LIST))) {
+    return NULL;
+  }
+
+  CertList = (EFI_SIGNATURE_LIST *)(Database->Data + Offset);
+  if ((CertList->SignatureListSize > Database->DataSize - Offset) ||
+      (CertList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST)) ||
+      (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) < CertList->SignatureHeaderSize) ||
+      (CertList->SignatureSize <= sizeof (EFI_GUID)))
+  {
+    return NULL;
+  }
+
+  return CertList;
+}
+
+/**
+  Get the bucket of a signature in the index of a database.
+
+  @param[in]  Database        The signature database.
+  @param[in]  Signature       The signature data, at least 4 bytes.
+
+  @return The index of the bucket.
+
+**/
+STATIC
+UINTN
+GetSignatureBucket (
+  IN SIGNATURE_DATABASE  *Database,
+  IN UINT8               *Signature
+  )
+{
+  //
+  // The signatures indexed are digests, so their first bytes are uniformly
+  // distributed.
+  //
+  return ReadUnaligned32 ((UINT32 *)Signature) & Database->BucketMask;
+}
+
+/**
+  Enumerate the signatures of the lists of hashes of a database.
+
+  @param[in]  Database        The signature database.
+  @param[out] Entries         The entries of the signatures, or NULL to count them.
+
+  @return The number of signatures.
+
+**/
+STATIC
+UINTN
+EnumerateSignatures (
+  IN  SIGNATURE_DATABASE     *Database,
+  OUT SIGNATURE_INDEX_ENTRY  *Entries  OPTIONAL
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINTN               CertCount;
+  UINTN               Index;
+  UINTN               Count;
+
+  Count = 0;
+  for (CertList = GetNextSignatureList (Database, NULL);
+       CertList != NULL;
+       CertList = GetNextSignatureList (Database, CertList))
+  {
+    //
+    // The X.509 certificates are not looked up by their content.
+    //
+    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid) ||
+        (CertList->SignatureSize < sizeof (EFI_GUID) + sizeof (UINT32)))
+    {
+      continue;
+    }
+
+    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    for (Index = 0; Index < CertCount; Index++) {
+      if (Entries != NULL) {
+        Entries[Count].CertList = CertList;
+        Entries[Count].Cert     = Cert;
+        Entries[Count].Next     = 0;
+      }
+
+      Count++;
+      Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Build the hashed index of the signatures of a database.
+
+  @param[in, out]  Database   The signature database. Its status is set to
+                              EFI_OUT_OF_RESOURCES if the index cannot be allocated.
+
+**/
+STATIC
+VOID
+BuildSignatureIndex (
+  IN OUT SIGNATURE_DATABASE  *Database
+  )
+{
+  UINTN  Count;
+  UINTN  BucketCount;
+  UINTN  Bucket;
+  UINTN  Index;
+
+  Count       = EnumerateSignatures (Database, NULL);
+  BucketCount = SIGNATURE_INDEX_MIN_BUCKETS;
+  while (BucketCount < Count) {
+    BucketCount *= 2;
+  }
+
+  Database->Entries    = AllocatePool (MAX (Count, 1) * sizeof (SIGNATURE_INDEX_ENTRY));
+  Database->Buckets    = AllocateZeroPool (BucketCount * sizeof (UINTN));
+  Database->BucketMask = BucketCount - 1;
+  if ((Database->Entries == NULL) || (Database->Buckets == NULL)) {
+    Database->Status = EFI_OUT_OF_RESOURCES;
+    return;
+  }
+
+  EnumerateSignatures (Database, Database->Entries);
+
+  //
+  // Insert the entries backwards at the head of their bucket, so that each
+  // bucket is in database order and the first match is the one a scan of the
+  // database finds.
+  //
+  for (Index = Count; Index > 0; Index--) {
+    Bucket                            = GetSignatureBucket (Database, Database->Entries[Index - 1].Cert->SignatureData);
+    Database->Entries[Index - 1].Next = Database->Buckets[Bucket];
+    Database->Buckets[Bucket]         = Index;
+  }
+}
+
+/**
+  Free the content and the index of the copy of a database.
+
+  @param[in, out]  Database   The signature database.
+
+**/
+STATIC
+VOID
+FreeSignatureDatabase (
+  IN OUT SIGNATURE_DATABASE  *Database
+  )
+{
+  if (Database->Data != NULL) {
+    FreePool (Database->Data);
+    Database->Data = NULL;
+  }
+
+  if (Database->Entries != NULL) {
+    FreePool (Database->Entries);
+    Database->Entries = NULL;
+  }
+
+  if (Database->Buckets != NULL) {
+    FreePool (Database->Buckets);
+    Database->Buckets = NULL;
+  }
+
+  Database->DataSize   = 0;
+  Database->BucketMask = 0;
+}
+
+/**
+  Read the signature databases db, dbx and dbt again, and index the ones whose
+  content changed since the last read.
+
+  The databases can be updated by authenticated variable writes at any time,
+  so they are read again before each image verification. The version stamp of
+  the databases is increased when any of them changed, which invalidates the
+  images verified before.
+
+**/
+VOID
+RefreshSignatureDatabases (
+  VOID
+  )
+{
+  SIGNATURE_DATABASE  *Database;
+  EFI_STATUS          Status;
+  UINT8               *Data;
+  UINTN               DataSize;
+  UINTN               Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDatabase); Index++) {
+    Database = &mSignatureDatabase[Index];
+    Status   = GetVariable2 (Database->VariableName, &gEfiImageSecurityDatabaseGuid, (VOID **)&Data, &DataSize);
+    if (!EFI_ERROR (Status) && (Data == NULL)) {
+      Status = EFI_NOT_FOUND;
+    }
+
+    if ((Status == Database->Status) &&
+        (EFI_ERROR (Status) ||
+         ((DataSize == Database->DataSize) && (CompareMem (Data, Database->Data, DataSize) == 0))))
+    {
+      if (Data != NULL) {
+        FreePool (Data);
+      }
+
+      continue;
+    }
+
+    FreeSignatureDatabase (Database);
+    Database->Status = Status;
+    if (!EFI_ERROR (Status)) {
+      Database->Data     = Data;
+      Database->DataSize = DataSize;
+      BuildSignatureIndex (Database);
+    } else if (Data != NULL) {
+      FreePool (Data);
+    }
+
+    mSignatureDatabaseStamp++;
+  }
+}
+
+/**
+  Get the copy of a signature database read by RefreshSignatureDatabases().
+
+  @param[in]  VariableName    Name of the database variable.
+
+  @return The copy of the database, or NULL if it is not db, dbx or dbt.
+
+**/
+SIGNATURE_DATABASE *
+GetSignatureDatabase (
+  IN CHAR16  *VariableName
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDatabase); Index++) {
+    if (StrCmp (VariableName, mSignatureDatabase[Index].VariableName) == 0) {
+      return &mSignatureDatabase[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Check whether a database has a signature list of the given type.
+
+  @param[in]  Database        The signature database.
+  @param[in]  CertType        The type of the signature list.
+
+  @retval TRUE                A signature list of the type is in the database.
+  @retval FALSE               No signature list of the type is in the database.
+
+**/
+BOOLEAN
+IsSignatureTypeInDatabase (
+  IN SIGNATURE_DATABASE  *Database,
+  IN EFI_GUID            *CertType
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+
+  if (EFI_ERROR (Database->Status)) {
+    return FALSE;
+  }
+
+  for (CertList = GetNextSignatureList (Database, NULL);
+       CertList != NULL;
+       CertList = GetNextSignatureList (Database, CertList))
+  {
+    if (CompareGuid (&CertList->SignatureType, CertType)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Look up a signature in the hashed index of a signature database.
+
+  @param[in]  Database        The signature database.
+  @param[in]  CertType        The type of the signature list of the signature.
+  @param[in]  Signature       The signature data, or its first bytes.
+  @param[in]  SignatureSize   Size of Signature, at least the size of a SHA-1 digest.
+  @param[in]  EntrySize       The SignatureSize of the signature list, or zero
+                              for any list whose signatures start with Signature.
+  @param[out] CertList        The signature list of the signature found.
+
+  @return The first signature of the database that matches, or NULL if none.
+
+**/
+EFI_SIGNATURE_DATA *
+FindSignatureInDatabase (
+  IN  SIGNATURE_DATABASE  *Database,
+  IN  EFI_GUID            *CertType,
+  IN  UINT8               *Signature,
+  IN  UINTN               SignatureSize,
+  IN  UINTN               EntrySize,
+  OUT EFI_SIGNATURE_LIST  **CertList
+  )
+{
+  SIGNATURE_INDEX_ENTRY  *Entry;
+  UINTN                  Next;
+
+  ASSERT (SignatureSize >= sizeof (UINT32));
+
+  if (EFI_ERROR (Database->Status) || (SignatureSize < sizeof (UINT32))) {
+    return NULL;
+  }
+
+  for (Next = Database->Buckets[GetSignatureBucket (Database, Signature)]; Next != 0; Next = Entry->Next) {
+    Entry = &Database->Entries[Next - 1];
+    if (EntrySize != 0) {
+      if (Entry->CertList->SignatureSize != EntrySize) {
+        continue;
+      }
+    } else if (Entry->CertList->SignatureSize - sizeof (EFI_GUID) < SignatureSize) {
+      continue;
+    }
+
+    if (CompareGuid (&Entry->CertList->SignatureType, CertType) &&
+        (CompareMem (Entry->Cert->SignatureData, Signature, SignatureSize) == 0))
+    {
+      *CertList = Entry->CertList;
+      return Entry->Cert;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Check whether an image already passed the verification with the current
+  signature databases.
+
+  @param[in]  FileBuffer      The image file.
+  @param[in]  FileSize        Size of the image file.
+  @param[out] ImageDigest     The SHA-256 digest of the image file, which is the
+                              key of the image in the cache.
+
+  @retval EFI_SUCCESS         The image was verified with the current databases.
+  @retval EFI_NOT_FOUND       The image must be verified.
+  @retval EFI_ABORTED         The digest of the image could not be computed.
+
+**/
+EFI_STATUS
+LookupVerifiedImage (
+  IN  VOID   *FileBuffer,
+  IN  UINTN  FileSize,
+  OUT UINT8  *ImageDigest
+  )
+{
+  UINTN  Index;
+
+  //
+  // The whole file is hashed, as the result of the verification also depends
+  // on the attribute certificate table, which the Authenticode hash excludes.
+  //
+  if (!Sha256HashAll (FileBuffer, FileSize, ImageDigest)) {
+    return EFI_ABORTED;
+  }
+
+  for (Index = 0; Index < mVerifiedImageCount; Index++) {
+    if ((mVerifiedImage[Index].Stamp == mSignatureDatabaseStamp) &&
+        (CompareMem (mVerifiedImage[Index].Digest, ImageDigest, SHA256_DIGEST_SIZE) == 0))
+    {
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Remember an image which passed the verification with the current signature
+  databases.
+
+  @param[in]  ImageDigest     The digest returned by LookupVerifiedImage().
+
+**/
+VOID
+AddVerifiedImage (
+  IN UINT8  *ImageDigest
+  )
+{
+  //
+  // The oldest entry is replaced when the cache is full.
+  //
+  CopyMem (mVerifiedImage[mVerifiedImageNext].Digest, ImageDigest, SHA256_DIGEST_SIZE);
+  mVerifiedImage[mVerifiedImageNext].Stamp = mSignatureDatabaseStamp;
+  mVerifiedImageNext                       = (mVerifiedImageNext + 1) % VERIFIED_IMAGE_CACHE_SIZE;
+  if (mVerifiedImageCount < VERIFIED_IMAGE_CACHE_SIZE) {
+    mVerifiedImageCount++;
+  }
+}
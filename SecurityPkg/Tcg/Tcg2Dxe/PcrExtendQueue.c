@@ -0,0 +1,260 @@
+/** @file
+  Queue of the PCR extends of the Tcg2Dxe data measurements.
+
+  When PcdTcg2PcrExtendQueueDepth is not 0, the digests of the measured data
+  are calculated with BaseCryptLib and the PCR extends are queued, so that a
+  measurement does not wait for the TPM. The queued extends are sent to the
+  TPM in the order they were queued, by Tcg2PcrExtendQueueFlush().
+
+  Each PCR extend sent from the queue is timed, and the counters are reported
+  by Tcg2PcrExtendQueueDumpTiming().
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+
+#include <Protocol/Tcg2Protocol.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/TimerLib.h>
+#include <Library/Tpm2CommandLib.h>
+#include <Library/BaseCryptLib.h>
+
+typedef
+BOOLEAN
+(EFIAPI *TCG2_HASH_ALL)(
+  IN   CONST VOID  *Data,
+  IN   UINTN       DataSize,
+  OUT  UINT8       *HashValue
+  );
+
+typedef struct {
+  UINT32           HashMask;
+  TPMI_ALG_HASH    HashAlg;
+  TCG2_HASH_ALL    HashAll;
+} TCG2_QUEUE_HASH_INFO;
+
+typedef struct {
+  TPMI_DH_PCR           PcrIndex;
+  TPML_DIGEST_VALUES    DigestList;
+} TCG2_PENDING_EXTEND;
+
+GLOBAL_REMOVE_IF_UNREFERENCED TCG2_QUEUE_HASH_INFO  mTcg2QueueHashInfo[] = {
+ #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+  { EFI_TCG2_BOOT_HASH_ALG_SHA1,    TPM_ALG_SHA1,    Sha1HashAll   },
+ #endif
+  { EFI_TCG2_BOOT_HASH_ALG_SHA256,  TPM_ALG_SHA256,  Sha256HashAll },
+  { EFI_TCG2_BOOT_HASH_ALG_SHA384,  TPM_ALG_SHA384,  Sha384HashAll },
+  { EFI_TCG2_BOOT_HASH_ALG_SHA512,  TPM_ALG_SHA512,  Sha512HashAll },
+  { EFI_TCG2_BOOT_HASH_ALG_SM3_256, TPM_ALG_SM3_256, Sm3HashAll    },
+};
+
+TCG2_PENDING_EXTEND  *mPendingExtend      = NULL;
+UINTN                mPendingExtendCount  = 0;
+UINTN                mPendingExtendDepth  = 0;
+UINT64               mPcrExtendCount      = 0;
+UINT64               mPcrExtendFlushCount = 0;
+UINT64               mPcrExtendTotalTime  = 0;
+UINT64               mPcrExtendMaxTime    = 0;
+
+/**
+  Allocate the PCR extend queue, with the depth of PcdTcg2PcrExtendQueueDepth.
+
+  If the queue cannot be allocated, the PCR extends are not queued.
+**/
+VOID
+Tcg2PcrExtendQueueInit (
+  VOID
+  )
+{
+  UINT32  Depth;
+
+  Depth = PcdGet32 (PcdTcg2PcrExtendQueueDepth);
+  if (Depth == 0) {
+    return;
+  }
+
+  mPendingExtend = AllocatePool (Depth * sizeof (TCG2_PENDING_EXTEND));
+  if (mPendingExtend == NULL) {
+    DEBUG ((DEBUG_WARN, "%a: no queue of %d PCR extends\n", __func__, Depth));
+    return;
+  }
+
+  mPendingExtendDepth = Depth;
+  mPendingExtendCount = 0;
+}
+
+/**
+  Check whether the PCR extends of the data measurements are queued.
+
+  @retval TRUE   The PCR extends are queued.
+  @retval FALSE  The PCR extends are sent to the TPM when the data is measured.
+**/
+BOOLEAN
+Tcg2PcrExtendQueueEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)(mPendingExtendDepth != 0);
+}
+
+/**
+  Hash the data with each active PCR bank algorithm, without extending a PCR.
+
+  @param[in]  ActivePcrBanks  The EFI_TCG2_BOOT_HASH_ALG_* bitmap of the active PCR banks.
+  @param[in]  HashData        The data to hash.
+  @param[in]  HashDataLen     The length, in bytes, of HashData.
+  @param[out] DigestList      The digests of HashData.
+
+  @retval EFI_SUCCESS       The digests are returned.
+  @retval EFI_UNSUPPORTED   No active PCR bank algorithm is supported.
+  @retval EFI_DEVICE_ERROR  The hash calculation failed.
+**/
+EFI_STATUS
+Tcg2PcrExtendQueueHashData (
+  IN  UINT32              ActivePcrBanks,
+  IN  UINT8               *HashData,
+  IN  UINTN               HashDataLen,
+  OUT TPML_DIGEST_VALUES  *DigestList
+  )
+{
+  UINTN   Index;
+  UINT32  Count;
+
+  ZeroMem (DigestList, sizeof (*DigestList));
+  Count = 0;
+  for (Index = 0; Index < ARRAY_SIZE (mTcg2QueueHashInfo); Index++) {
+    if ((ActivePcrBanks & mTcg2QueueHashInfo[Index].HashMask) == 0) {
+      continue;
+    }
+
+    DigestList->digests[Count].hashAlg = mTcg2QueueHashInfo[Index].HashAlg;
+    if (!mTcg2QueueHashInfo[Index].HashAll (HashData, HashDataLen, (UINT8 *)&DigestList->digests[Count].digest)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    Count++;
+  }
+
+  if (Count == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  DigestList->count = Count;
+  return EFI_SUCCESS;
+}
+
+/**
+  Send the queued PCR extends to the TPM, in the order they were queued.
+
+  @retval EFI_SUCCESS       All the queued PCR extends are done.
+  @retval EFI_DEVICE_ERROR  A PCR extend failed. The queue is emptied.
+**/
+EFI_STATUS
+Tcg2PcrExtendQueueFlush (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINT64      Start;
+  UINT64      End;
+  UINT64      CounterStart;
+  UINT64      CounterEnd;
+  UINT64      Time;
+
+  if (mPendingExtendCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < mPendingExtendCount; Index++) {
+    PERF_INMODULE_BEGIN ("Tcg2PcrExtend");
+    Start  = GetPerformanceCounter ();
+    Status = Tpm2PcrExtend (mPendingExtend[Index].PcrIndex, &mPendingExtend[Index].DigestList);
+    End    = GetPerformanceCounter ();
+    PERF_INMODULE_END ("Tcg2PcrExtend");
+
+    Time = GetTimeInNanoSecond ((CounterStart > CounterEnd) ? (Start - End) : (End - Start));
+    mPcrExtendCount++;
+    mPcrExtendTotalTime += Time;
+    if (Time > mPcrExtendMaxTime) {
+      mPcrExtendMaxTime = Time;
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: PCR %d extend - %r\n", __func__, mPendingExtend[Index].PcrIndex, Status));
+      Status = EFI_DEVICE_ERROR;
+      break;
+    }
+  }
+
+  mPcrExtendFlushCount++;
+  mPendingExtendCount = 0;
+  return Status;
+}
+
+/**
+  Queue a PCR extend. The queue is flushed first if it is full.
+
+  @param[in]  PcrIndex    The PCR to extend.
+  @param[in]  DigestList  The digests to extend the PCR with.
+
+  @retval EFI_SUCCESS       The PCR extend is queued.
+  @retval EFI_DEVICE_ERROR  The queue was full and could not be flushed.
+**/
+EFI_STATUS
+Tcg2PcrExtendQueueAdd (
+  IN TPMI_DH_PCR         PcrIndex,
+  IN TPML_DIGEST_VALUES  *DigestList
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (mPendingExtendDepth != 0);
+
+  if (mPendingExtendCount == mPendingExtendDepth) {
+    Status = Tcg2PcrExtendQueueFlush ();
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  mPendingExtend[mPendingExtendCount].PcrIndex = PcrIndex;
+  CopyMem (&mPendingExtend[mPendingExtendCount].DigestList, DigestList, sizeof (*DigestList));
+  mPendingExtendCount++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Report the timing counters of the PCR extends sent from the queue.
+**/
+VOID
+Tcg2PcrExtendQueueDumpTiming (
+  VOID
+  )
+{
+  if (mPcrExtendCount == 0) {
+    return;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Tcg2Dxe: %ld PCR extends in %ld flushes, %ld us, %ld us on average, %ld us at most\n",
+    mPcrExtendCount,
+    mPcrExtendFlushCount,
+    DivU64x32 (mPcrExtendTotalTime, 1000),
+    DivU64x32 (DivU64x64Remainder (mPcrExtendTotalTime, mPcrExtendCount, NULL), 1000),
+    DivU64x32 (mPcrExtendMaxTime, 1000)
+    ));
+}
@@ -1,7 +1,7 @@
 /** @file
   This module implements Tcg2 Protocol.
 
-Copyright (c) 2015 - 2024, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2015 - 2026, Intel Corporation. All rights reserved.<BR>
 (C) Copyright 2016 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -143,6 +143,112 @@ MeasurePeImageAndExtend (
   OUT TPML_DIGEST_VALUES    *DigestList
   );
 
+/**
+  Allocate the PCR extend queue, with the depth of PcdTcg2PcrExtendQueueDepth.
+
+  If the queue cannot be allocated, the PCR extends are not queued.
+**/
+VOID
+Tcg2PcrExtendQueueInit (
+  VOID
+  );
+
+/**
+  Check whether the PCR extends of the data measurements are queued.
+
+  @retval TRUE   The PCR extends are queued.
+  @retval FALSE  The PCR extends are sent to the TPM when the data is measured.
+**/
+BOOLEAN
+Tcg2PcrExtendQueueEnabled (
+  VOID
+  );
+
+/**
+  Hash the data with each active PCR bank algorithm, without extending a PCR.
+
+  @param[in]  ActivePcrBanks  The EFI_TCG2_BOOT_HASH_ALG_* bitmap of the active PCR banks.
+  @param[in]  HashData        The data to hash.
+  @param[in]  HashDataLen     The length, in bytes, of HashData.
+  @param[out] DigestList      The digests of HashData.
+
+  @retval EFI_SUCCESS       The digests are returned.
+  @retval EFI_UNSUPPORTED   No active PCR bank algorithm is supported.
+  @retval EFI_DEVICE_ERROR  The hash calculation failed.
+**/
+EFI_STATUS
+Tcg2PcrExtendQueueHashData (
+  IN  UINT32              ActivePcrBanks,
+  IN  UINT8               *HashData,
+  IN  UINTN               HashDataLen,
+  OUT TPML_DIGEST_VALUES  *DigestList
+  );
+
+/**
+  Send the queued PCR extends to the TPM, in the order they were queued.
+
+  @retval EFI_SUCCESS       All the queued PCR extends are done.
+  @retval EFI_DEVICE_ERROR  A PCR extend failed. The queue is emptied.
+**/
+EFI_STATUS
+Tcg2PcrExtendQueueFlush (
+  VOID
+  );
+
+/**
+  Queue a PCR extend. The queue is flushed first if it is full.
+
+  @param[in]  PcrIndex    The PCR to extend.
+  @param[in]  DigestList  The digests to extend the PCR with.
+
+  @retval EFI_SUCCESS       The PCR extend is queued.
+  @retval EFI_DEVICE_ERROR  The queue was full and could not be flushed.
+**/
+EFI_STATUS
+Tcg2PcrExtendQueueAdd (
+  IN TPMI_DH_PCR         PcrIndex,
+  IN TPML_DIGEST_VALUES  *DigestList
+  );
+
+/**
+  Report the timing counters of the PCR extends sent from the queue.
+**/
+VOID
+Tcg2PcrExtendQueueDumpTiming (
+  VOID
+  );
+
+/**
+  Send the queued PCR extends to the TPM. The TPM is disabled if an extend fails,
+  as it is when a measurement fails to extend a PCR.
+
+  This must be called before a measurement that has to be in the PCRs when it
+  returns, and before any other command is sent to the TPM.
+
+  @retval EFI_SUCCESS       No PCR extend is queued.
+  @retval EFI_DEVICE_ERROR  A PCR extend failed.
+**/
+STATIC
+EFI_STATUS
+FlushPcrExtends (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = Tcg2PcrExtendQueueFlush ();
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Tcg2PcrExtendQueueFlush - %r. Disable TPM.\n", Status));
+    mTcgDxeData.BsCap.TPMPresentFlag = FALSE;
+    REPORT_STATUS_CODE (
+      EFI_ERROR_CODE | EFI_ERROR_MINOR,
+      (PcdGet32 (PcdStatusCodeSubClassTpmDevice) | EFI_P_EC_INTERFACE_ERROR)
+      );
+  }
+
+  return Status;
+}
+
 /**
 
   This function dump raw data.
@@ -754,6 +860,11 @@ Tcg2GetEventLog (
     return EFI_SUCCESS;
   }
 
+  //
+  // The caller may replay the event log against the PCRs.
+  //
+  FlushPcrExtends ();
+
   if (EventLogLocation != NULL) {
     *EventLogLocation = mTcgDxeData.EventLogAreaStruct[Index].Lasa;
     DEBUG ((DEBUG_INFO, "Tcg2GetEventLog (EventLogLocation - %x)\n", *EventLogLocation));
@@ -1246,6 +1357,11 @@ TcgDxeHashLogExtendEvent (
       //
       // Extend to NvIndex
       //
+      Status = FlushPcrExtends ();
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
       Status = HashAndExtend (
                  NewEventHdr->PCRIndex,
                  HashData,
@@ -1260,12 +1376,29 @@ TcgDxeHashLogExtendEvent (
     return Status;
   }
 
-  Status = HashAndExtend (
-             NewEventHdr->PCRIndex,
-             HashData,
-             (UINTN)HashDataLen,
-             &DigestList
-             );
+  if (Tcg2PcrExtendQueueEnabled ()) {
+    //
+    // Only hash the data here. The PCR extend is queued and sent to the TPM
+    // in order with the other queued extends.
+    //
+    Status = Tcg2PcrExtendQueueHashData (
+               mTcgDxeData.BsCap.ActivePcrBanks,
+               HashData,
+               (UINTN)HashDataLen,
+               &DigestList
+               );
+    if (!EFI_ERROR (Status)) {
+      Status = Tcg2PcrExtendQueueAdd (NewEventHdr->PCRIndex, &DigestList);
+    }
+  } else {
+    Status = HashAndExtend (
+               NewEventHdr->PCRIndex,
+               HashData,
+               (UINTN)HashDataLen,
+               &DigestList
+               );
+  }
+
   if (!EFI_ERROR (Status)) {
     if ((Flags & EFI_TCG2_EXTEND_ONLY) == 0) {
       Status = TcgDxeLogHashEvent (&DigestList, NewEventHdr, NewEventData);
@@ -1346,6 +1479,14 @@ Tcg2HashLogExtendEvent (
   NewEventHdr.EventType = Event->Header.EventType;
   NewEventHdr.EventSize = Event->Size - sizeof (UINT32) - Event->Header.HeaderSize;
   if ((Flags & PE_COFF_IMAGE) != 0) {
+    //
+    // The image is measured before it runs, so its PCR extend is not queued.
+    //
+    Status = FlushPcrExtends ();
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
     Status = MeasurePeImageAndExtend (
                NewEventHdr.PCRIndex,
                DataToHash,
@@ -1427,6 +1568,11 @@ Tcg2SubmitCommand (
     return EFI_INVALID_PARAMETER;
   }
 
+  Status = FlushPcrExtends ();
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   Status = Tpm2SubmitCommand (
              InputParameterBlockSize,
              InputParameterBlock,
@@ -1490,6 +1636,10 @@ Tcg2SetActivePCRBanks (
     return EFI_INVALID_PARAMETER;
   }
 
+  if (mTcgDxeData.BsCap.TPMPresentFlag) {
+    FlushPcrExtends ();
+  }
+
   if (ActivePcrBanks == mTcgDxeData.BsCap.ActivePcrBanks) {
     //
     // Need clear previous SET_PCR_BANKS setting
@@ -2553,6 +2703,9 @@ OnReadyToBoot (
   // Increase boot attempt counter.
   //
   mBootAttempts++;
+
+  FlushPcrExtends ();
+  Tcg2PcrExtendQueueDumpTiming ();
   PERF_END_EX (mImageHandle, "EventRec", "Tcg2Dxe", 0, PERF_ID_TCG2_DXE + 1);
 }
 
@@ -2595,6 +2748,10 @@ OnExitBootServices (
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a not Measured. Error!\n", EFI_EXIT_BOOT_SERVICES_SUCCEEDED));
   }
+
+  if (mTcgDxeData.BsCap.TPMPresentFlag) {
+    FlushPcrExtends ();
+  }
 }
 
 /**
@@ -2636,6 +2793,10 @@ OnExitBootServicesFailed (
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a not Measured. Error!\n", EFI_EXIT_BOOT_SERVICES_FAILED));
   }
+
+  if (mTcgDxeData.BsCap.TPMPresentFlag) {
+    FlushPcrExtends ();
+  }
 }
 
 /**
@@ -2666,6 +2827,10 @@ ShutdownTpmOnReset (
 {
   EFI_STATUS  Status;
 
+  if (mTcgDxeData.BsCap.TPMPresentFlag) {
+    FlushPcrExtends ();
+  }
+
   Status = Tpm2Shutdown (TPM_SU_CLEAR);
   DEBUG ((DEBUG_VERBOSE, "Tpm2Shutdown (SU_CLEAR) - %r\n", Status));
 }
@@ -2854,6 +3019,8 @@ DriverEntry (
   DEBUG ((DEBUG_INFO, "Tcg2.ActivePcrBanks        - 0x%08x\n", mTcgDxeData.BsCap.ActivePcrBanks));
 
   if (mTcgDxeData.BsCap.TPMPresentFlag) {
+    Tcg2PcrExtendQueueInit ();
+
     //
     // Setup the log area and copy event log from hob list to it
     //